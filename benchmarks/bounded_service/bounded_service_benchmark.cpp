@@ -0,0 +1,308 @@
+/**
+ * @file bounded_service_benchmark.cpp
+ * @brief Worst-case bus transactions, callbacks, time and allocations of one interrupt service pass
+ *
+ * Drives HandleInterrupt() with adversarial input patterns and records the
+ * worst single pass, unbounded and with SetCallbackBudget():
+ *  - storm:     every pin pulses before every pass (32 edges per pass on
+ *               PCAL9555A; a PCA9555 cannot see pulses);
+ *  - alternate: all 16 inputs flip before every pass (0x5555 <-> 0xAAAA);
+ *  - walking:   one pin changes per pass (the cheap case, for reference);
+ *  - faults:    storm on a bus that NACKs 30 % of transactions in bursts,
+ *               so every read uses its retries.
+ * Every pin has a callback on both edges, every subscriber slot listens
+ * to all pins, and a global callback is set: the most work a pass can do.
+ *
+ * Each pass is checked against the bounds: transactions <=
+ * GetServiceTransactionBound(), callbacks <= the budget, zero heap
+ * allocations (global operator new is counted). The program exits with
+ * status 1 if any pass breaks a bound, so the run target doubles as a test.
+ * It also checks that deferral loses nothing: after a final drain, every
+ * edge delivered to a pin callback has also reached every subscriber. And
+ * it checks INT: with a backlog pending, the one pass run for a new INT
+ * edge must still read the inputs and release INT, or INT stays low and
+ * never asks for another pass. The same holds for a StatusLatch pass whose
+ * INT_STATUS read fails: it must still read the inputs and deliver the
+ * change it sees there.
+ *
+ * Host time is per pass on the simulated expander (max includes scheduler
+ * noise; p99.9 is the stable figure).
+ *
+ * Usage: pcal95555_bounded_service_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "pcal95555_fault_injection.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+uint64_t g_allocations = 0;
+} // namespace
+
+void* operator new(std::size_t size) {
+  ++g_allocations;
+  if (void* p = std::malloc(size != 0 ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t /*size*/) noexcept { std::free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+using pcal95555::bench::SimBus;
+
+using FaultyBus = pcal95555::FaultInjectionBus<SimBus>;
+using Driver = pcal95555::PCAL95555<FaultyBus>;
+
+uint64_t g_callbacks = 0;       // every callback invocation
+uint64_t g_pin_calls = 0;       // per-pin callback invocations
+uint64_t g_subscriber_edges = 0;
+
+enum class Pattern { Storm, Alternate, Walking, Faults };
+
+struct Result {
+  const char* chip;
+  const char* pattern;
+  uint8_t budget;
+  uint32_t passes;
+  uint32_t max_transactions;
+  uint32_t bound_transactions;
+  uint32_t max_callbacks;
+  uint32_t drain_passes;  // passes that deliver the backlog left when the pattern stops
+  double max_ns;
+  double p999_ns;
+  uint64_t allocations;
+  bool lossless;
+  bool ok;
+};
+
+Result run(pcal95555::ChipVariant variant, Pattern pattern, uint8_t budget, uint32_t passes,
+           std::vector<double>& samples) {
+  static constexpr const char* kNames[] = {"storm", "alternate", "walking", "faults"};
+  const bool pcal = variant == pcal95555::ChipVariant::PCAL9555A;
+  Result result{pcal ? "PCAL9555A" : "PCA9555", kNames[static_cast<int>(pattern)], budget, passes, 0, 0, 0, 0, 0, 0,
+                0, true, true};
+
+  SimBus sim;
+  sim.SetVariant(pcal95555::bench::kSimBaseAddr, variant);
+  sim.SetInputs(0x5555);
+  FaultyBus bus(&sim);
+  Driver driver(&bus, 0x20, variant);
+  driver.EnsureInitialized();
+  driver.SetRetries(2);
+  driver.SetCallbackBudget(budget);
+  driver.SetInterruptCallback([](uint16_t) { ++g_callbacks; });
+  for (uint8_t pin = 0; pin < 16; ++pin) {
+    driver.RegisterPinInterrupt(pin, InterruptEdge::Both, [](uint8_t, bool) {
+      ++g_callbacks;
+      ++g_pin_calls;
+    });
+  }
+  for (size_t i = 0; i < Driver::kMaxSubscribers; ++i) {
+    driver.Subscribe(0xFFFF, InterruptEdge::Both, [](const pcal95555::PinEvents& ev) {
+      ++g_callbacks;
+      g_subscriber_edges += static_cast<uint64_t>(std::popcount(ev.rising) + std::popcount(ev.falling));
+    });
+  }
+  if (pattern == Pattern::Faults) {
+    bus.SetConfig({.nack_ppm = 300000, .nack_burst = 2, .seed = 7});
+  }
+  result.bound_transactions = driver.GetServiceTransactionBound();
+
+  g_callbacks = 0;
+  g_pin_calls = 0;
+  g_subscriber_edges = 0;
+  samples.clear();
+  for (uint32_t i = 0; i < passes; ++i) {
+    switch (pattern) {
+      case Pattern::Storm:
+      case Pattern::Faults:
+        sim.Stimulate(0, 0xFFFF);
+        break;
+      case Pattern::Alternate:
+        sim.Stimulate(0xFFFF, 0);
+        break;
+      case Pattern::Walking:
+        sim.Stimulate(static_cast<uint16_t>(1U << (i & 15)), 0);
+        break;
+    }
+    const uint32_t tx0 = bus.Stats().transactions;
+    const uint64_t cb0 = g_callbacks;
+    const uint64_t alloc0 = g_allocations;
+    const auto start = Clock::now();
+    driver.HandleInterrupt();
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    const uint32_t tx = bus.Stats().transactions - tx0;
+    const auto calls = static_cast<uint32_t>(g_callbacks - cb0);
+    result.allocations += g_allocations - alloc0;
+    samples.push_back(ns);
+    result.max_transactions = std::max(result.max_transactions, tx);
+    result.max_callbacks = std::max(result.max_callbacks, calls);
+    if (tx > result.bound_transactions || (budget != 0 && calls > budget)) {
+      result.ok = false;
+    }
+  }
+  // Drain what is left, then check nothing was dropped: every pin edge went
+  // to both its pin callback and all subscribers (they listen to all pins)
+  while (driver.HasDeferredEvents()) {
+    driver.HandleInterrupt();
+    ++result.drain_passes;
+  }
+  if (Driver::kMaxSubscribers != 0) {
+    result.lossless = g_subscriber_edges == g_pin_calls * Driver::kMaxSubscribers;
+  }
+  result.ok = result.ok && result.allocations == 0 && result.lossless;
+
+  std::sort(samples.begin(), samples.end());
+  result.max_ns = samples.back();
+  result.p999_ns = samples[std::min(samples.size() - 1, static_cast<size_t>(samples.size() * 0.999))];
+  return result;
+}
+
+/// With a backlog pending, one pass per INT edge releases INT and the new edge is delivered after the backlog.
+bool releasesIntWithBacklog(pcal95555::ChipVariant variant) {
+  SimBus sim;
+  sim.SetVariant(pcal95555::bench::kSimBaseAddr, variant);
+  pcal95555::PCAL95555<SimBus> driver(&sim, 0x20, variant);
+  driver.EnsureInitialized();
+  driver.SetCallbackBudget(1);
+  uint16_t order[4] = {};
+  size_t seen = 0;
+  driver.Subscribe(0xFFFF, InterruptEdge::Both, [&order, &seen](const pcal95555::PinEvents& ev) {
+    if (seen < std::size(order)) {
+      order[seen] = static_cast<uint16_t>(ev.rising | ev.falling);
+    }
+    ++seen;
+  });
+  driver.Subscribe(0xFFFF, InterruptEdge::Both, [&seen](const pcal95555::PinEvents&) { ++seen; });
+  sim.Stimulate(0x0001);
+  driver.HandleInterrupt();  // reads pin 0, delivers to one of two subscribers
+  if (!driver.HasDeferredEvents() || sim.IntAsserted()) {
+    return false;
+  }
+  // A new edge while the backlog is pending: the single pass it gets must release INT
+  if (!sim.Stimulate(0x0002)) {
+    return false;
+  }
+  driver.HandleInterrupt();
+  const bool released = !sim.IntAsserted();
+  while (driver.HasDeferredEvents()) {
+    driver.HandleInterrupt();
+  }
+  // Pin 0 reaches both subscribers before pin 1 does (order[] logs the first one)
+  return released && seen == 4 && order[0] == 0x0001 && order[2] == 0x0002;
+}
+
+/// SimBus that NACKs every INT_STATUS read while nack_status is set.
+class StatusNackBus : public pcal95555::I2cInterface<StatusNackBus> {
+public:
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    return sim.Write(addr, reg, data, len);
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    if (nack_status && reg == static_cast<uint8_t>(Pcal95555Reg::INT_STATUS_0)) {
+      return false;
+    }
+    return sim.Read(addr, reg, data, len);
+  }
+
+  bool EnsureInitialized() noexcept { return true; }
+
+  SimBus sim;
+  bool nack_status = false;
+};
+
+/// A StatusLatch pass whose INT_STATUS read fails still releases INT and delivers the level change.
+bool releasesIntWithoutStatus() {
+  StatusNackBus bus;
+  pcal95555::PCAL95555<StatusNackBus> driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  driver.SetCallbackBudget(4);
+  uint16_t rising = 0;
+  driver.Subscribe(0xFFFF, InterruptEdge::Both, [&rising](const pcal95555::PinEvents& ev) {
+    rising = static_cast<uint16_t>(rising | ev.rising);
+  });
+  bus.nack_status = true;
+  bus.sim.Stimulate(0x0004);
+  driver.HandleInterrupt();
+  return !bus.sim.IntAsserted() && rising == 0x0004;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 200'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  std::vector<double> samples;
+  samples.reserve(calls);
+  std::vector<Result> results;
+  for (const auto variant : {pcal95555::ChipVariant::PCA9555, pcal95555::ChipVariant::PCAL9555A}) {
+    for (const auto pattern : {Pattern::Storm, Pattern::Alternate, Pattern::Walking, Pattern::Faults}) {
+      for (const uint8_t budget : {uint8_t{0}, uint8_t{16}, uint8_t{4}}) {
+        results.push_back(run(variant, pattern, budget, calls, samples));
+      }
+    }
+  }
+
+  const bool int_released = releasesIntWithBacklog(pcal95555::ChipVariant::PCA9555) &&
+                            releasesIntWithBacklog(pcal95555::ChipVariant::PCAL9555A);
+  const bool int_released_no_status = releasesIntWithoutStatus();
+
+  std::printf("PCAL95555 bounded interrupt service: worst pass\n\n");
+  std::printf("%u passes per row; %zu subscribers, 16 pin callbacks, 1 global callback\n", calls,
+              Driver::kMaxSubscribers);
+  std::printf("%-10s %-10s %6s %8s %6s %8s %8s %10s %10s %6s %s\n", "chip", "pattern", "budget", "max xfer", "bound",
+              "max cb", "drain", "max ns", "p99.9 ns", "alloc", "result");
+  bool ok = true;
+  for (const Result& r : results) {
+    std::printf("%-10s %-10s %6s %8u %6u %8u %8u %10.0f %10.0f %6llu %s\n", r.chip, r.pattern,
+                r.budget == 0 ? "-" : std::to_string(r.budget).c_str(), r.max_transactions, r.bound_transactions,
+                r.max_callbacks, r.drain_passes, r.max_ns, r.p999_ns,
+                static_cast<unsigned long long>(r.allocations), r.ok ? "ok" : "BOUND VIOLATED");
+    ok = ok && r.ok;
+  }
+  std::printf("\nINT released by a pass with a backlog pending: %s\n", int_released ? "ok" : "FAILED");
+  std::printf("INT released by a pass whose INT_STATUS read failed: %s\n", int_released_no_status ? "ok" : "FAILED");
+  ok = ok && int_released && int_released_no_status;
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"ok\": %s,\n  \"int_released\": %s,\n"
+                  "  \"int_released_without_status\": %s,\n  \"runs\": [\n",
+                  calls, ok ? "true" : "false", int_released ? "true" : "false",
+                  int_released_no_status ? "true" : "false");
+    for (size_t i = 0; i < results.size(); ++i) {
+      const Result& r = results[i];
+      report.Printf("    {\"chip\": \"%s\", \"pattern\": \"%s\", \"budget\": %u, \"max_transactions\": %u, "
+                    "\"transaction_bound\": %u, \"max_callbacks\": %u, \"drain_passes\": %u, "
+                    "\"max_ns\": %.0f, \"p999_ns\": %.0f, \"allocations\": %llu, \"lossless\": %s, \"ok\": %s}%s\n",
+                    r.chip, r.pattern, r.budget, r.max_transactions, r.bound_transactions, r.max_callbacks,
+                    r.drain_passes, r.max_ns, r.p999_ns, static_cast<unsigned long long>(r.allocations),
+                    r.lossless ? "true" : "false", r.ok ? "true" : "false", report.Sep(i, results.size()));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return (ok && !report.Failed()) ? 0 : 1;
+}
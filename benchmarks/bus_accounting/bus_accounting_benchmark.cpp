@@ -0,0 +1,254 @@
+/**
+ * @file bus_accounting_benchmark.cpp
+ * @brief Cost and effect of pcal95555::AccountingBus
+ *
+ * Part 1 times WritePins() on an in-memory register file directly and
+ * through AccountingBus (steady_clock time source), so the added host cost
+ * per transaction is visible.
+ *
+ * Part 2 simulates two seconds of a 400 kHz bus shared by three clients:
+ * interrupt service (1 kHz HandleInterrupt()), an LED animation that writes
+ * frames back to back, and the configuration scrubber. The simulated clock
+ * advances by the modelled wire time of every transaction. The run is done
+ * without quotas and with a 40 % Drop quota on the animation; the table
+ * shows each client's share of the bus, the worst interrupt latency, and
+ * the last window report as FormatBusReport() prints it.
+ *
+ * Part 3 checks QuotaAction::Wait: the throttled client must sleep with the
+ * bus lock released, and another client must get the bus during that
+ * sleep. The program exits 1 otherwise.
+ *
+ * Usage: pcal95555_bus_accounting_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "pcal95555_bus_accounting.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t g_sim_us = 0;  // simulated time (part 2)
+
+using pcal95555::bench::SimBus;
+using AccBus = pcal95555::AccountingBus<SimBus, 4>;
+
+uint64_t steadyUs() noexcept {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count());
+}
+
+uint64_t simUs() noexcept {
+  return g_sim_us;
+}
+
+volatile uint32_t g_sink = 0;
+
+/// ns per WritePins() call on @p driver (best of 5).
+template <typename Driver>
+double timeWrites(Driver& driver, uint32_t calls) {
+  double best = 0;
+  for (int run = 0; run < 5; ++run) {
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+      g_sink = g_sink + static_cast<uint32_t>(driver.WritePins({{0, (i & 1) != 0}}));
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+enum : uint8_t { kIrq = 0, kLeds = 1, kScrub = 2 };
+
+struct Scenario {
+  const char* name;
+  uint32_t leds_quota_us;
+  double share[3];  // irq, leds, scrub (fraction of wall time)
+  double idle;
+  uint64_t irq_max_latency_us;
+  uint64_t leds_frames;
+  uint64_t leds_dropped;
+  std::string last_report;
+};
+
+Scenario simulate(const char* name, uint32_t leds_quota_us) {
+  Scenario result{name, leds_quota_us, {}, 0, 0, 0, 0, {}};
+  g_sim_us = 0;
+  SimBus raw;
+  raw.clock = &g_sim_us;
+  AccBus bus(&raw, {.now_us = simUs, .sleep_us = nullptr, .window_us = 100000, .scl_hz = 400000});
+  bus.ConfigureClient(kIrq, {"irq"});
+  bus.ConfigureClient(kLeds, {"leds", leds_quota_us, pcal95555::QuotaAction::Drop});
+  bus.ConfigureClient(kScrub, {"scrub"});
+  static uint64_t dropped = 0;
+  dropped = 0;
+  bus.SetReportCallback([](const pcal95555::BusWindowReport& r) { dropped += r.clients[kLeds].dropped; });
+
+  pcal95555::PCAL95555<AccBus> driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  auto leds = bus.MakePort(kLeds);
+  pcal95555::PCAL95555<AccBus::Port> led_driver(&leds, 0x21, pcal95555::ChipVariant::PCAL9555A);
+  bus.SetClient(kIrq);
+  driver.EnsureInitialized();
+  led_driver.EnsureInitialized();
+  driver.SetMultipleDirections(0xFF00, GPIODir::Input);  // gives the scrubber registers to check
+  driver.SetPullEnable(8, true);
+  driver.SetScrubRate(100);
+
+  constexpr uint64_t kRunUs = 2'000'000;
+  constexpr uint64_t kIrqPeriodUs = 1000;
+  uint64_t next_irq = 1000;
+  uint16_t frame = 0;
+  while (g_sim_us < kRunUs) {
+    if (g_sim_us >= next_irq) {
+      result.irq_max_latency_us = std::max(result.irq_max_latency_us, g_sim_us - next_irq);
+      raw.Stimulate(0x0100);
+      AccBus::ClientScope scope(bus, kIrq);
+      driver.HandleInterrupt();
+      next_irq += kIrqPeriodUs;
+      continue;
+    }
+    bool scrubbed = false;
+    {
+      AccBus::ClientScope scope(bus, kScrub);
+      scrubbed = driver.ScrubTick(g_sim_us);
+    }
+    if (!scrubbed) {
+      frame = static_cast<uint16_t>(frame + 1);
+      if (led_driver.WritePins({{0, (frame & 1) != 0}, {1, (frame & 2) != 0}})) {
+        ++result.leds_frames;
+      } else {
+        g_sim_us += 100;  // animation task sleeps before the next attempt
+      }
+    }
+  }
+  bus.Tick();
+  for (uint8_t c = 0; c < 3; ++c) {
+    result.share[c] = static_cast<double>(bus.CurrentStats(c).total_wire_us) / static_cast<double>(g_sim_us);
+  }
+  result.idle = 1.0 - result.share[0] - result.share[1] - result.share[2];
+  result.leds_dropped = dropped;
+  char text[512];
+  const size_t n = pcal95555::FormatBusReport(bus.LastReport(), text);
+  result.last_report.assign(text, n);
+  return result;
+}
+
+bool g_locked = false;     // bus lock of part 3
+bool g_slept_locked = false;
+bool g_irq_during_wait = false;
+pcal95555::PCAL95555<AccBus::Port>* g_irq_driver = nullptr;
+
+void lockBus() noexcept {
+  g_locked = true;
+}
+void unlockBus() noexcept {
+  g_locked = false;
+}
+
+/// Sleep of the waiting client: interrupt service runs meanwhile, as another task would.
+void sleepWithIrq(uint32_t us) noexcept {
+  g_slept_locked = g_slept_locked || g_locked;
+  lockBus();  // the interrupt task takes the lock the waiting client released
+  unlockBus();
+  uint16_t inputs = 0;
+  g_irq_during_wait = g_irq_driver->ReadAllInputs(inputs) || g_irq_during_wait;
+  g_sim_us += us;
+}
+
+/// A Wait client over its quota sleeps without the bus lock; interrupt service gets the bus.
+bool waitReleasesLock() {
+  g_sim_us = 0;
+  SimBus raw;
+  raw.clock = &g_sim_us;
+  AccBus bus(&raw, {.now_us = simUs, .sleep_us = sleepWithIrq, .lock = lockBus, .unlock = unlockBus});
+  bus.ConfigureClient(kIrq, {"irq"});
+  bus.ConfigureClient(kScrub, {"scrub", 500, pcal95555::QuotaAction::Wait});
+  auto irq = bus.MakePort(kIrq);
+  auto scrub = bus.MakePort(kScrub);
+  pcal95555::PCAL95555<AccBus::Port> irq_driver(&irq, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  pcal95555::PCAL95555<AccBus::Port> scrub_driver(&scrub, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  irq_driver.EnsureInitialized();
+  scrub_driver.EnsureInitialized();
+  g_irq_driver = &irq_driver;
+  g_slept_locked = false;
+  g_irq_during_wait = false;
+  // 500 us of quota is five paired writes: the sixth waits for the next window
+  bool written = true;
+  for (int i = 0; i < 20 && !g_irq_during_wait; ++i) {
+    written = scrub_driver.WriteAllOutputs(static_cast<uint16_t>(i)) && written;
+  }
+  g_irq_driver = nullptr;
+  return written && g_irq_during_wait && !g_slept_locked && !g_locked;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 2'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  SimBus raw;
+  pcal95555::PCAL95555<SimBus> direct(&raw, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  const double direct_ns = timeWrites(direct, calls);
+  AccBus bus(&raw, {.now_us = steadyUs});
+  bus.ConfigureClient(0, {"app"});
+  pcal95555::PCAL95555<AccBus> accounted(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  const double accounted_ns = timeWrites(accounted, calls);
+
+  std::printf("PCAL95555 bus accounting\n\n");
+  std::printf("host cost per WritePins(): direct %.1f ns, through AccountingBus %.1f ns (+%.1f ns)\n\n", direct_ns,
+              accounted_ns, accounted_ns - direct_ns);
+
+  std::vector<Scenario> scenarios;
+  scenarios.push_back(simulate("no quota", 0));
+  scenarios.push_back(simulate("leds quota 40%", 40000));
+
+  std::printf("simulated 400 kHz bus, 2 s: irq 1 kHz, leds back to back, scrub 100/s\n");
+  std::printf("%-16s %8s %8s %8s %8s %14s %12s %12s\n", "scenario", "irq", "leds", "scrub", "idle",
+              "irq max lat us", "led frames", "led dropped");
+  for (const Scenario& s : scenarios) {
+    std::printf("%-16s %7.1f%% %7.1f%% %7.1f%% %7.1f%% %14llu %12llu %12llu\n", s.name, 100 * s.share[0],
+                100 * s.share[1], 100 * s.share[2], 100 * s.idle, static_cast<unsigned long long>(s.irq_max_latency_us),
+                static_cast<unsigned long long>(s.leds_frames), static_cast<unsigned long long>(s.leds_dropped));
+  }
+  for (const Scenario& s : scenarios) {
+    std::printf("\nlast window, %s:\n%s", s.name, s.last_report.c_str());
+  }
+  const bool wait_unlocked = waitReleasesLock();
+  std::printf("\nWait client sleeps without the bus lock, irq served meanwhile: %s\n", wait_unlocked ? "yes" : "NO");
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"direct_ns\": %.2f,\n  \"accounted_ns\": %.2f,\n"
+                  "  \"wait_releases_lock\": %s,\n  \"scenarios\": [\n",
+                  calls, direct_ns, accounted_ns, wait_unlocked ? "true" : "false");
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+      const Scenario& s = scenarios[i];
+      report.Printf("    {\"name\": \"%s\", \"leds_quota_us\": %u, \"irq_share\": %.4f, \"leds_share\": %.4f, "
+                    "\"scrub_share\": %.4f, \"idle\": %.4f, \"irq_max_latency_us\": %llu, \"leds_frames\": %llu, "
+                    "\"leds_dropped\": %llu}%s\n",
+                    s.name, s.leds_quota_us, s.share[0], s.share[1], s.share[2], s.idle,
+                    static_cast<unsigned long long>(s.irq_max_latency_us),
+                    static_cast<unsigned long long>(s.leds_frames), static_cast<unsigned long long>(s.leds_dropped),
+                    report.Sep(i, scenarios.size()));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return (wait_unlocked && !report.Failed()) ? 0 : 1;
+}
@@ -0,0 +1,372 @@
+/**
+ * @file capture_benchmark.cpp
+ * @brief Correctness and cost of pcal95555::InputCapture / CaptureReader
+ *
+ * Checks the capture against a reference model of the input image, each
+ * time through Export() and CaptureReader, comparing every decoded event
+ * (time, value, changed pins, trigger flag) exactly:
+ *  - round trip: 300 changes whose gaps need 1 to 6 varint bytes, with
+ *    unchanged samples in between; also a short Export() buffer and a
+ *    truncated stream;
+ *  - eviction: a 64-byte ring with a 40-byte pre-trigger window fed 200
+ *    changes of mixed record sizes (the ring wraps and evicts), then the
+ *    trigger and the post-trigger depth; the trigger index must name the
+ *    triggering change and the base state must be the one before the
+ *    oldest kept record;
+ *  - full: a triggered capture stops at the last record that fits;
+ *  - tiny window: a pre-trigger window smaller than one record only moves
+ *    the base state.
+ * The program exits with status 1 if any check fails, so the run target
+ * doubles as a test.
+ *
+ * It then reports the record size per change for typical gaps and the host
+ * cost of Sample() for unchanged and changed inputs (armed, evicting).
+ *
+ * Usage: pcal95555_capture_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555_capture.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// One state of the reference model: the input image from @p time_us on.
+struct State {
+  uint64_t time_us;
+  uint16_t value;
+};
+
+uint64_t g_rng = 0x9E3779B97F4A7C15ULL;
+
+uint64_t nextRandom() noexcept {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+/// Bytes of the LEB128 varint of @p value.
+size_t varintBytes(uint64_t value) noexcept {
+  size_t len = 1;
+  while ((value >>= 7) != 0) {
+    ++len;
+  }
+  return len;
+}
+
+/// Export @p capture and decode it with CaptureReader.
+template <size_t Bytes>
+std::vector<uint8_t> exportCapture(const pcal95555::InputCapture<Bytes>& capture) {
+  std::vector<uint8_t> bytes(capture.ExportSize());
+  if (capture.Export(bytes) != bytes.size()) {
+    bytes.clear();
+  }
+  return bytes;
+}
+
+/**
+ * @brief Decode @p bytes and compare every event with @p expected.
+ *
+ * @p expected starts with the base state; @p trigger_index is the expected
+ * index of the trigger event (kCaptureNoTrigger for none).
+ */
+bool decodeMatches(std::span<const uint8_t> bytes, std::span<const State> expected, uint32_t trigger_index,
+                   pcal95555::CaptureState state, uint64_t end_us) {
+  pcal95555::CaptureReader reader(bytes);
+  if (!reader.Valid() || reader.State() != state || reader.RecordCount() + 1 != expected.size() ||
+      reader.TriggerIndex() != trigger_index || reader.EndTimeUs() != end_us) {
+    return false;
+  }
+  pcal95555::CaptureEvent ev;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    if (!reader.Next(ev)) {
+      return false;
+    }
+    const uint16_t changed = i == 0 ? 0 : static_cast<uint16_t>(expected[i].value ^ expected[i - 1].value);
+    if (ev.time_us != expected[i].time_us || ev.value != expected[i].value || ev.changed != changed ||
+        ev.trigger != (i == trigger_index)) {
+      return false;
+    }
+  }
+  return !reader.Next(ev) && reader.Valid();
+}
+
+struct Check {
+  const char* name;
+  bool ok;
+  const char* detail;
+};
+
+/// Changes with gaps of 1 to 6 varint bytes round-trip exactly.
+Check checkRoundTrip() {
+  Check check{"round trip", false, ""};
+  // Gaps around every varint length boundary, then random ones.
+  static constexpr uint64_t kGaps[] = {1,         127,          128,          16383,          16384,
+                                       2097151,   2097152,      268435455,    268435456,      34359738367ULL,
+                                       34359738368ULL};
+  pcal95555::InputCapture<4096> capture;
+  capture.Arm({});  // every mask 0: triggers on the first sample, records until full
+  std::vector<State> expected;
+  uint64_t t = 1000;
+  uint16_t value = 0x1234;
+  capture.Sample(value, t);
+  expected.push_back({t, value});
+  size_t longest = 0;
+  for (uint32_t i = 0; i < 300; ++i) {
+    const uint64_t gap = i < std::size(kGaps) ? kGaps[i] : 1 + (nextRandom() >> (24 + nextRandom() % 40));
+    if (gap > 1 && (i & 3) == 0) {
+      capture.Sample(value, t + gap / 2);  // unchanged: only moves the end time
+    }
+    t += gap;
+    auto changed = static_cast<uint16_t>(nextRandom());
+    if (changed == 0) {
+      changed = 1;
+    }
+    value = static_cast<uint16_t>(value ^ changed);
+    capture.Sample(value, t);
+    expected.push_back({t, value});
+    longest = std::max(longest, varintBytes(gap));
+  }
+  capture.Sample(value, t + 77);  // trailing unchanged sample sets the end time
+  if (longest < 6) {
+    check.detail = "gaps do not cover 6-byte varints";
+    return check;
+  }
+  if (capture.State() != pcal95555::CaptureState::Triggered || capture.RecordCount() != 300) {
+    check.detail = "unexpected state or record count";
+    return check;
+  }
+  const std::vector<uint8_t> bytes = exportCapture(capture);
+  if (!decodeMatches(bytes, expected, 0, pcal95555::CaptureState::Triggered, t + 77)) {
+    check.detail = "decoded events differ from the samples";
+    return check;
+  }
+  std::vector<uint8_t> small(bytes.size() - 1);
+  if (capture.Export(small) != 0) {
+    check.detail = "Export() into a short buffer did not return 0";
+    return check;
+  }
+  if (pcal95555::CaptureReader(std::span<const uint8_t>(bytes).first(bytes.size() - 1)).Valid()) {
+    check.detail = "truncated stream decoded as valid";
+    return check;
+  }
+  check.ok = true;
+  return check;
+}
+
+/// The pre-trigger ring evicts the oldest records and keeps the base state consistent.
+Check checkEviction() {
+  Check check{"eviction", false, ""};
+  constexpr uint32_t kWindow = 40;
+  constexpr uint32_t kPost = 5;
+  static constexpr uint64_t kGaps[] = {5, 300, 20000};  // 3-, 4- and 5-byte records
+  pcal95555::InputCapture<64> capture;
+  capture.Arm({.trigger = {.rising_mask = 0x8000}, .pre_trigger_bytes = kWindow, .post_trigger_changes = kPost});
+  std::vector<State> states;  // every state since the first sample
+  uint64_t t = 50;
+  uint16_t value = 0;
+  capture.Sample(value, t);
+  states.push_back({t, value});
+  for (uint32_t i = 0; i < 200; ++i) {
+    t += kGaps[nextRandom() % std::size(kGaps)];
+    value = static_cast<uint16_t>(value ^ (1U << (nextRandom() % 15)));  // pins 0-14: never the trigger
+    capture.Sample(value, t);
+    states.push_back({t, value});
+    if (capture.UsedBytes() > kWindow || capture.State() != pcal95555::CaptureState::Armed) {
+      check.detail = "pre-trigger history exceeds its window";
+      return check;
+    }
+  }
+  const uint32_t kept = capture.RecordCount();
+  if (kept == 0 || kept >= 200 || !decodeMatches(exportCapture(capture), std::span(states).last(kept + 1),
+                                                 pcal95555::kCaptureNoTrigger, pcal95555::CaptureState::Armed, t)) {
+    check.detail = "armed history differs from the last samples";
+    return check;
+  }
+
+  t += 300;
+  value = static_cast<uint16_t>(value | 0x8000);  // trigger: pin 15 rises
+  capture.Sample(value, t);
+  states.push_back({t, value});
+  if (capture.State() != pcal95555::CaptureState::Triggered) {
+    check.detail = "rising edge on pin 15 did not trigger";
+    return check;
+  }
+  const uint32_t trigger_records = capture.RecordCount();  // the trigger change is the newest record
+  uint64_t done_us = 0;
+  for (uint32_t i = 0; i < kPost + 3; ++i) {
+    t += 5;
+    value = static_cast<uint16_t>(value ^ (1U << (i % 15)));
+    capture.Sample(value, t);
+    if (i < kPost) {
+      states.push_back({t, value});
+      done_us = t;
+    }
+  }
+  if (capture.State() != pcal95555::CaptureState::Done || capture.RecordCount() != trigger_records + kPost) {
+    check.detail = "post-trigger depth not honoured";
+    return check;
+  }
+  if (!decodeMatches(exportCapture(capture), std::span(states).last(trigger_records + kPost + 1), trigger_records,
+                     pcal95555::CaptureState::Done, done_us)) {
+    check.detail = "trigger index or post-trigger events wrong";
+    return check;
+  }
+  check.ok = true;
+  return check;
+}
+
+/// A triggered capture stops when the next record does not fit.
+Check checkFull() {
+  Check check{"full", false, ""};
+  pcal95555::InputCapture<64> capture;
+  capture.Arm({});
+  std::vector<State> states;
+  uint64_t t = 0;
+  uint16_t value = 0xFFFF;
+  capture.Sample(value, t);
+  states.push_back({t, value});
+  uint64_t last_us = t;
+  for (uint32_t i = 0; i < 30; ++i) {
+    t += 10;  // 3-byte records: 21 fit in 64 bytes
+    value = static_cast<uint16_t>(value ^ (1U << (i % 16)));
+    capture.Sample(value, t);
+    if (capture.State() == pcal95555::CaptureState::Triggered) {
+      states.push_back({t, value});
+    }
+    last_us = (i == 21) ? t : last_us;  // the sample that did not fit still set the end time
+  }
+  if (capture.State() != pcal95555::CaptureState::Done || capture.RecordCount() != 21 ||
+      capture.UsedBytes() != 63) {
+    check.detail = "capture did not stop at the last record that fits";
+    return check;
+  }
+  if (!decodeMatches(exportCapture(capture), states, 0, pcal95555::CaptureState::Done, last_us)) {
+    check.detail = "decoded events differ from the samples";
+    return check;
+  }
+  check.ok = true;
+  return check;
+}
+
+/// A window smaller than one record keeps no records; the base follows the inputs.
+Check checkTinyWindow() {
+  Check check{"tiny window", false, ""};
+  pcal95555::InputCapture<64> capture;
+  capture.Arm({.trigger = {.rising_mask = 0x8000}, .pre_trigger_bytes = 2});
+  uint64_t t = 0;
+  uint16_t value = 0;
+  capture.Sample(value, t);
+  for (uint32_t i = 0; i < 10; ++i) {
+    t += 1000;
+    value = static_cast<uint16_t>(value ^ (1U << i));
+    capture.Sample(value, t);
+  }
+  const State base[] = {{t, value}};
+  if (capture.RecordCount() != 0 ||
+      !decodeMatches(exportCapture(capture), base, pcal95555::kCaptureNoTrigger, pcal95555::CaptureState::Armed, t)) {
+    check.detail = "base state does not follow the inputs";
+    return check;
+  }
+  check.ok = true;
+  return check;
+}
+
+/// Record bytes per change when changes are @p gap_us apart.
+double bytesPerChange(uint64_t gap_us) {
+  pcal95555::InputCapture<4096> capture;
+  capture.Arm({});
+  uint16_t value = 0;
+  capture.Sample(value, 0);
+  for (uint32_t i = 1; i <= 100; ++i) {
+    value = static_cast<uint16_t>(value ^ 1U);
+    capture.Sample(value, i * gap_us);
+  }
+  return static_cast<double>(capture.UsedBytes()) / capture.RecordCount();
+}
+
+volatile uint32_t g_sink = 0;
+
+/// ns per Sample() (best of 5) on an armed capture that never triggers.
+double timeSample(uint32_t calls, bool changing) {
+  pcal95555::InputCapture<> capture;
+  capture.Arm({.trigger = {.rising_mask = 0x8000}});
+  double best = 0;
+  for (int run = 0; run < 5; ++run) {
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+      capture.Sample(static_cast<uint16_t>(changing ? (i & 1U) : 0U), i * 10ULL);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  g_sink = g_sink + capture.RecordCount();
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 2'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const Check checks[] = {checkRoundTrip(), checkEviction(), checkFull(), checkTinyWindow()};
+  bool all_ok = true;
+  for (const Check& c : checks) {
+    all_ok = all_ok && c.ok;
+  }
+  struct Gap {
+    const char* name;
+    uint64_t us;
+    double bytes;
+  };
+  Gap gaps[] = {{"10 us", 10, 0}, {"1 ms", 1000, 0}, {"1 s", 1000000, 0}, {"1 h", 3600000000ULL, 0}};
+  for (Gap& g : gaps) {
+    g.bytes = bytesPerChange(g.us);
+  }
+  const double unchanged_ns = timeSample(calls, false);
+  const double changed_ns = timeSample(calls, true);
+
+  std::printf("PCAL95555 input capture\n\n");
+  for (const Check& c : checks) {
+    std::printf("%-12s %s%s%s\n", c.name, c.ok ? "ok" : "FAILED", c.ok ? "" : ": ", c.detail);
+  }
+  std::printf("\nrecord bytes per change:");
+  for (const Gap& g : gaps) {
+    std::printf("  %s apart %.0f", g.name, g.bytes);
+  }
+  std::printf("\nhost cost per Sample() (armed, %zu-byte buffer): unchanged %.1f ns, changed %.1f ns\n",
+              pcal95555::InputCapture<>::Capacity(), unchanged_ns, changed_ns);
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"ok\": %s,\n  \"unchanged_ns\": %.2f,\n  \"changed_ns\": %.2f,\n", calls,
+                  all_ok ? "true" : "false", unchanged_ns, changed_ns);
+    report.Printf("  \"checks\": [\n");
+    for (size_t i = 0; i < std::size(checks); ++i) {
+      report.Printf("    {\"name\": \"%s\", \"ok\": %s}%s\n", checks[i].name, checks[i].ok ? "true" : "false",
+                    report.Sep(i, std::size(checks)));
+    }
+    report.Printf("  ],\n  \"bytes_per_change\": [\n");
+    for (size_t i = 0; i < std::size(gaps); ++i) {
+      report.Printf("    {\"gap_us\": %llu, \"bytes\": %.2f}%s\n", static_cast<unsigned long long>(gaps[i].us),
+                    gaps[i].bytes, report.Sep(i, std::size(gaps)));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return (all_ok && !report.Failed()) ? 0 : 1;
+}
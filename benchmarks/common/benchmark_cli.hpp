@@ -0,0 +1,211 @@
+/**
+ * @file benchmark_cli.hpp
+ * @brief Command line and JSON report helpers shared by the benchmark programs
+ *
+ * Every benchmark accepts `--report-json=PATH` plus its own numeric options
+ * (`--calls=N`, `--seconds=N`, ...) and flags. Its run target passes
+ * `--report-json` so the numbers land next to the build:
+ * @code
+ * int main(int argc, char** argv) {
+ *   uint32_t calls = 1'000'000;
+ *   pcal95555::bench::Cli cli;
+ *   cli.Option("calls", calls);
+ *   if (!cli.Parse(argc, argv)) {
+ *     return 2;
+ *   }
+ *   ...
+ *   pcal95555::bench::JsonReport report(cli.ReportPath());
+ *   if (report) {
+ *     report.Printf("{\n  \"calls\": %u\n}\n", calls);
+ *   }
+ *   return report.Failed() ? 1 : 0;
+ * }
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pcal95555::bench {
+
+/**
+ * @brief Parses `--name=N` options, `--flag` switches and `--report-json=PATH`.
+ *
+ * Unknown arguments, malformed numbers and values outside an option's range
+ * print the usage line (built from the registered options) and make Parse()
+ * fail; main() then returns 2.
+ */
+class Cli {
+public:
+  /**
+   * @brief Register `--<name>=N`; @p value keeps its default when absent.
+   *
+   * The text is range-checked before it is narrowed to @p T.
+   */
+  template <typename T>
+    requires std::is_arithmetic_v<T>
+  Cli& Option(const char* name, T& value, T min = T{1}, T max = std::numeric_limits<T>::max()) {
+    entries_.push_back({name, false, [&value, min, max](const char* text) {
+                          char* end = nullptr;
+                          if constexpr (std::is_floating_point_v<T>) {
+                            const double parsed = std::strtod(text, &end);
+                            if (end == text || *end != '\0' || parsed < static_cast<double>(min) ||
+                                parsed > static_cast<double>(max)) {
+                              return false;
+                            }
+                            value = static_cast<T>(parsed);
+                          } else if constexpr (std::is_signed_v<T>) {
+                            const long long parsed = std::strtoll(text, &end, 0);
+                            if (end == text || *end != '\0' || std::cmp_less(parsed, min) ||
+                                std::cmp_greater(parsed, max)) {
+                              return false;
+                            }
+                            value = static_cast<T>(parsed);
+                          } else {
+                            const unsigned long long parsed = std::strtoull(text, &end, 0);
+                            if (end == text || *end != '\0' || *text == '-' || std::cmp_less(parsed, min) ||
+                                std::cmp_greater(parsed, max)) {
+                              return false;
+                            }
+                            value = static_cast<T>(parsed);
+                          }
+                          return true;
+                        }});
+    return *this;
+  }
+
+  /// Register `--<name>`, which sets @p value to true.
+  Cli& Flag(const char* name, bool& value) {
+    entries_.push_back({name, true, [&value](const char* /*text*/) {
+                          value = true;
+                          return true;
+                        }});
+    return *this;
+  }
+
+  /// Parse the command line; prints the usage line and returns false on error.
+  [[nodiscard]] bool Parse(int argc, char** argv) {
+    static constexpr const char* kReport = "--report-json=";
+    for (int i = 1; i < argc; ++i) {
+      const char* arg = argv[i];
+      if (std::strncmp(arg, kReport, std::strlen(kReport)) == 0) {
+        report_path_ = arg + std::strlen(kReport);
+        continue;
+      }
+      if (!apply(arg)) {
+        usage(argv[0]);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// `--report-json` path; empty when no report was requested.
+  [[nodiscard]] const std::string& ReportPath() const noexcept { return report_path_; }
+
+private:
+  struct Entry {
+    std::string name;
+    bool flag;
+    std::function<bool(const char*)> set;
+  };
+
+  bool apply(const char* arg) const {
+    if (std::strncmp(arg, "--", 2) != 0) {
+      return false;
+    }
+    const std::string text(arg + 2);
+    for (const Entry& entry : entries_) {
+      if (entry.flag && text == entry.name) {
+        return entry.set(nullptr);
+      }
+      if (!entry.flag && text.size() > entry.name.size() && text.compare(0, entry.name.size(), entry.name) == 0 &&
+          text[entry.name.size()] == '=') {
+        return entry.set(text.c_str() + entry.name.size() + 1);
+      }
+    }
+    return false;
+  }
+
+  void usage(const char* argv0) const {
+    std::fprintf(stderr, "usage: %s", argv0);
+    for (const Entry& entry : entries_) {
+      std::fprintf(stderr, entry.flag ? " [--%s]" : " [--%s=N]", entry.name.c_str());
+    }
+    std::fprintf(stderr, " [--report-json=PATH]\n");
+  }
+
+  std::vector<Entry> entries_;
+  std::string report_path_;
+};
+
+/**
+ * @brief The `--report-json` output file; inactive when no path was given.
+ *
+ * Test it before writing (`if (report) ...`). A path that cannot be opened
+ * is reported on stderr once and Failed() returns true, so main() can exit 1.
+ */
+class JsonReport {
+public:
+  explicit JsonReport(const std::string& path) noexcept {
+    if (path.empty()) {
+      return;
+    }
+    file_ = std::fopen(path.c_str(), "w");
+    if (file_ == nullptr) {
+      std::fprintf(stderr, "cannot write %s\n", path.c_str());
+      failed_ = true;
+    }
+  }
+
+  ~JsonReport() {
+    if (file_ != nullptr) {
+      std::fclose(file_);
+    }
+  }
+
+  JsonReport(const JsonReport&) = delete;
+  JsonReport& operator=(const JsonReport&) = delete;
+
+  /// True when a report is being written.
+  explicit operator bool() const noexcept { return file_ != nullptr; }
+
+  /// True when a path was given but could not be opened.
+  [[nodiscard]] bool Failed() const noexcept { return failed_; }
+
+  /// printf() into the report; does nothing when inactive.
+#if defined(__GNUC__)
+  __attribute__((format(printf, 2, 3)))
+#endif
+  void Printf(const char* format, ...) const noexcept {
+    if (file_ == nullptr) {
+      return;
+    }
+    va_list args;
+    va_start(args, format);
+    std::vfprintf(file_, format, args);
+    va_end(args);
+  }
+
+  /// Separator after element @p i of a JSON array of @p n elements.
+  [[nodiscard]] static const char* Sep(size_t i, size_t n) noexcept { return i + 1 < n ? "," : ""; }
+
+private:
+  FILE* file_ = nullptr;
+  bool failed_ = false;
+};
+
+} // namespace pcal95555::bench
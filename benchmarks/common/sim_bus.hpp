@@ -0,0 +1,189 @@
+/**
+ * @file sim_bus.hpp
+ * @brief In-memory expander bus shared by the benchmark programs
+ *
+ * SimBus holds one 128-byte register file per address 0x20-0x27 and
+ * implements pcal95555::I2cInterface on top of them, so the driver runs
+ * unmodified against it. On top of the plain register file it models what
+ * the benchmarks need from the hardware:
+ *  - presence and chip variant per address (an absent address NACKs
+ *    everything, a PCA9555 NACKs the Agile I/O registers >= 0x40);
+ *  - inputs and interrupts: Stimulate() changes the inputs and latches the
+ *    changed pins in INT_STATUS, which holds INT low until the inputs are
+ *    read, as on the chip;
+ *  - accounting: reads, writes and modelled 400 kHz wire time of every
+ *    transaction, NACKed ones included, optionally advancing a simulated
+ *    clock.
+ *
+ * Register files start zeroed; PowerOnReset() loads the datasheet defaults.
+ * Fixtures that need more (e.g. one expander's outputs wired to another's
+ * inputs) wrap a SimBus in their own I2cInterface, like FaultInjectionBus
+ * does, rather than adding callbacks here: an opaque call per transaction
+ * would dominate the host timings the benchmarks report.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pcal95555.hpp"
+#include "pcal95555_bus_accounting.hpp"
+
+namespace pcal95555::bench {
+
+/// First simulated address; SimBus covers kSimBaseAddr .. kSimBaseAddr + 7.
+inline constexpr uint8_t kSimBaseAddr = 0x20;
+/// Bus clock used for the modelled wire time.
+inline constexpr uint32_t kSimBusHz = 400000;
+
+/**
+ * @brief Register files of eight expanders on one simulated bus.
+ */
+class SimBus : public I2cInterface<SimBus> {
+public:
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    account(false, len);
+    if (!acks(addr, reg)) {
+      return false;
+    }
+    auto& regs = regs_[addr & 7];
+    for (size_t i = 0; i < len; ++i) {
+      regs[(reg + i) & 0x7F] = data[i];
+    }
+    return true;
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    account(true, len);
+    if (!acks(addr, reg)) {
+      return false;
+    }
+    auto& regs = regs_[addr & 7];
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = regs[(reg + i) & 0x7F];
+    }
+    if (reg <= static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1) &&
+        reg + len > static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0)) {
+      setPair(addr, Pcal95555Reg::INT_STATUS_0, 0);  // reading the inputs releases INT
+    }
+    return true;
+  }
+
+  bool EnsureInitialized() noexcept { return true; }
+
+  // ---- Topology ----
+
+  /// An absent address NACKs every transaction.
+  void SetPresent(uint8_t addr, bool present) noexcept { setBit(present_, addr, present); }
+
+  /// A PCA9555 NACKs the Agile I/O registers (>= 0x40).
+  void SetVariant(uint8_t addr, ChipVariant variant) noexcept {
+    setBit(agile_io_, addr, variant != ChipVariant::PCA9555);
+  }
+
+  // ---- Register file ----
+
+  /// Load the power-up values (outputs high, all pins inputs, pulls disabled, interrupts masked).
+  void PowerOnReset(uint8_t addr = kSimBaseAddr) noexcept {
+    auto& regs = regs_[addr & 7];
+    regs.fill(0x00);
+    for (Pcal95555Reg reg : {Pcal95555Reg::OUTPUT_PORT_0, Pcal95555Reg::OUTPUT_PORT_1, Pcal95555Reg::CONFIG_PORT_0,
+                             Pcal95555Reg::CONFIG_PORT_1, Pcal95555Reg::DRIVE_STRENGTH_0,
+                             Pcal95555Reg::DRIVE_STRENGTH_1, Pcal95555Reg::DRIVE_STRENGTH_2,
+                             Pcal95555Reg::DRIVE_STRENGTH_3, Pcal95555Reg::PULL_SELECT_0,
+                             Pcal95555Reg::PULL_SELECT_1, Pcal95555Reg::INT_MASK_0, Pcal95555Reg::INT_MASK_1}) {
+      regs[static_cast<uint8_t>(reg)] = 0xFF;
+    }
+  }
+
+  /// 16-bit value of the register pair starting at @p reg0.
+  [[nodiscard]] uint16_t Pair(Pcal95555Reg reg0, uint8_t addr = kSimBaseAddr) const noexcept {
+    const auto& regs = regs_[addr & 7];
+    const auto r = static_cast<uint8_t>(reg0);
+    return static_cast<uint16_t>(regs[r] | (regs[r + 1] << 8));
+  }
+
+  [[nodiscard]] uint16_t Outputs(uint8_t addr = kSimBaseAddr) const noexcept {
+    return Pair(Pcal95555Reg::OUTPUT_PORT_0, addr);
+  }
+
+  // ---- Inputs and interrupts ----
+
+  [[nodiscard]] uint16_t Inputs(uint8_t addr = kSimBaseAddr) const noexcept {
+    return Pair(Pcal95555Reg::INPUT_PORT_0, addr);
+  }
+
+  /// Set the input levels without raising an interrupt.
+  void SetInputs(uint16_t inputs, uint8_t addr = kSimBaseAddr) noexcept {
+    setPair(addr, Pcal95555Reg::INPUT_PORT_0, inputs);
+  }
+
+  /**
+   * @brief Flip the inputs in @p toggle; pins in @p pulse change and come back.
+   *
+   * Both are latched in INT_STATUS and hold INT low until the inputs are read.
+   * @return true if INT was released before, i.e. this is a new falling edge on INT.
+   */
+  bool Stimulate(uint16_t toggle, uint16_t pulse = 0, uint8_t addr = kSimBaseAddr) noexcept {
+    const bool new_edge = !IntAsserted(addr);
+    SetInputs(static_cast<uint16_t>(Inputs(addr) ^ toggle), addr);
+    const auto status = static_cast<uint16_t>(Pair(Pcal95555Reg::INT_STATUS_0, addr) | toggle | pulse);
+    setPair(addr, Pcal95555Reg::INT_STATUS_0, status);
+    return new_edge && status != 0;
+  }
+
+  /// True while INT is held low (a latched change has not been read yet).
+  [[nodiscard]] bool IntAsserted(uint8_t addr = kSimBaseAddr) const noexcept {
+    return Pair(Pcal95555Reg::INT_STATUS_0, addr) != 0;
+  }
+
+  // ---- Accounting ----
+
+  [[nodiscard]] uint64_t Transactions() const noexcept { return reads + writes; }
+
+  uint64_t reads = 0;    ///< Read() calls
+  uint64_t writes = 0;   ///< Write() calls
+  uint64_t wire_us = 0;  ///< Modelled wire time of all transactions
+  /// When set, advanced by the wire time of every transaction (simulated time).
+  uint64_t* clock = nullptr;
+
+private:
+  // Per-address flags are bit masks (bit n = kSimBaseAddr + n): acks() runs on
+  // every transaction and shows up in the host timings.
+  static void setBit(uint8_t& mask, uint8_t addr, bool value) noexcept {
+    const unsigned n = static_cast<uint8_t>(addr - kSimBaseAddr);
+    if (n < 8) {
+      mask = static_cast<uint8_t>(value ? (mask | (1U << n)) : (mask & ~(1U << n)));
+    }
+  }
+
+  [[nodiscard]] bool acks(uint8_t addr, uint8_t reg) const noexcept {
+    const unsigned n = static_cast<uint8_t>(addr - kSimBaseAddr);
+    const uint8_t mask = reg < 0x40 ? present_ : static_cast<uint8_t>(present_ & agile_io_);
+    return n < 8 && ((mask >> n) & 1U) != 0;
+  }
+
+  void account(bool is_read, size_t len) noexcept {
+    const uint32_t us = ModelledWireUs(is_read, len, kSimBusHz);
+    (is_read ? reads : writes) += 1;
+    wire_us += us;
+    if (clock != nullptr) {
+      *clock += us;
+    }
+  }
+
+  void setPair(uint8_t addr, Pcal95555Reg reg0, uint16_t value) noexcept {
+    auto& regs = regs_[addr & 7];
+    regs[static_cast<uint8_t>(reg0)] = static_cast<uint8_t>(value & 0xFF);
+    regs[static_cast<uint8_t>(reg0) + 1] = static_cast<uint8_t>(value >> 8);
+  }
+
+  std::array<std::array<uint8_t, 0x80>, 8> regs_{};
+  uint8_t present_ = 0xFF;
+  uint8_t agile_io_ = 0xFF;  // cleared for PCA9555
+};
+
+} // namespace pcal95555::bench
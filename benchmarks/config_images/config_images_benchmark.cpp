@@ -0,0 +1,217 @@
+/**
+ * @file config_images_benchmark.cpp
+ * @brief Bus cost of drive strength / pull updates with packed register images
+ *
+ * Compares the shadow-backed drive strength and pull setters with the
+ * read-modify-write sequences they replaced (reproduced here directly on the
+ * simulated bus, byte for byte):
+ *  - drive, 1 pin:   single-register read + write    vs SetDriveStrength();
+ *  - drive, 3 pins:  both pairs read + both written  vs SetDriveStrengths();
+ *  - pulls, 4 pins:  PULL_SELECT RMW + PULL_ENABLE RMW (SetPullDirections()
+ *                    + SetPullEnables())             vs SetPulls();
+ *  - bulk get:       four paired reads               vs GetDriveImage() +
+ *                                                       GetPullImage().
+ *
+ * Each operation touches random pins (and random levels), so some updates
+ * leave a register pair unchanged. The table shows transactions and modelled
+ * 400 kHz wire time per operation, and host time per operation on the
+ * simulated expander. Images are loaded before timing starts.
+ *
+ * Usage: pcal95555_config_images_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint8_t kAddr = pcal95555::bench::kSimBaseAddr;
+
+using pcal95555::bench::SimBus;
+using Driver = pcal95555::PCAL95555<SimBus>;
+
+constexpr auto reg(Pcal95555Reg r) { return static_cast<uint8_t>(r); }
+
+// ---- The previous read-modify-write sequences ----
+
+void legacyDrivePin(SimBus& bus, uint8_t pin, uint8_t level) {
+  const uint8_t r = static_cast<uint8_t>(reg(Pcal95555Reg::DRIVE_STRENGTH_0) + pin / 4);
+  const uint8_t shift = (pin % 4) * 2;
+  uint8_t val = 0;
+  bus.Read(kAddr, r, &val, 1);
+  val = static_cast<uint8_t>((val & ~(0x3 << shift)) | (level << shift));
+  bus.Write(kAddr, r, &val, 1);
+}
+
+void legacyDrivePins(SimBus& bus, const uint8_t* pins, const uint8_t* levels, size_t count) {
+  uint8_t ds[4] = {};
+  bus.Read(kAddr, reg(Pcal95555Reg::DRIVE_STRENGTH_0), ds, 2);
+  bus.Read(kAddr, reg(Pcal95555Reg::DRIVE_STRENGTH_2), ds + 2, 2);
+  for (size_t i = 0; i < count; ++i) {
+    const uint8_t shift = (pins[i] % 4) * 2;
+    uint8_t& val = ds[pins[i] / 4];
+    val = static_cast<uint8_t>((val & ~(0x3 << shift)) | (levels[i] << shift));
+  }
+  bus.Write(kAddr, reg(Pcal95555Reg::DRIVE_STRENGTH_0), ds, 2);
+  bus.Write(kAddr, reg(Pcal95555Reg::DRIVE_STRENGTH_2), ds + 2, 2);
+}
+
+void legacyMaskRmw(SimBus& bus, uint8_t reg0, uint16_t mask, bool value) {
+  uint8_t port[2] = {};
+  bus.Read(kAddr, reg0, port, 2);
+  uint16_t image = static_cast<uint16_t>(port[0] | (port[1] << 8));
+  image = value ? static_cast<uint16_t>(image | mask) : static_cast<uint16_t>(image & ~mask);
+  port[0] = static_cast<uint8_t>(image & 0xFF);
+  port[1] = static_cast<uint8_t>(image >> 8);
+  bus.Write(kAddr, reg0, port, 2);
+}
+
+void legacyBulkGet(SimBus& bus) {
+  uint8_t buf[2] = {};
+  bus.Read(kAddr, reg(Pcal95555Reg::DRIVE_STRENGTH_0), buf, 2);
+  bus.Read(kAddr, reg(Pcal95555Reg::DRIVE_STRENGTH_2), buf, 2);
+  bus.Read(kAddr, reg(Pcal95555Reg::PULL_ENABLE_0), buf, 2);
+  bus.Read(kAddr, reg(Pcal95555Reg::PULL_SELECT_0), buf, 2);
+}
+
+enum class Op { DrivePin, DrivePins, Pulls, BulkGet };
+
+struct Result {
+  const char* op;
+  const char* path;
+  uint32_t calls;
+  uint64_t reads;
+  uint64_t writes;
+  uint64_t wire_us;
+  double host_ns;
+};
+
+/// Runs @p calls operations of kind @p op; returns counts and best-of-3 host time.
+Result run(Op op, bool images, uint32_t calls) {
+  static constexpr const char* kNames[] = {"drive, 1 pin", "drive, 3 pins", "pulls, 4 pins", "bulk get"};
+  Result result{kNames[static_cast<int>(op)], images ? "image" : "RMW", calls, 0, 0, 0, 0};
+  for (int pass = 0; pass < 3; ++pass) {
+    SimBus bus;
+    Driver driver(&bus, kAddr, pcal95555::ChipVariant::PCAL9555A);
+    driver.EnsureInitialized();
+    uint32_t drive = 0;
+    pcal95555::PullImage pulls;
+    driver.GetDriveImage(drive);  // load the images outside the measurement
+    driver.GetPullImage(pulls);
+    const uint64_t reads0 = bus.reads;
+    const uint64_t writes0 = bus.writes;
+    const uint64_t wire0 = bus.wire_us;
+    uint32_t rng = 12345;
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+      rng = rng * 1664525U + 1013904223U;
+      switch (op) {
+        case Op::DrivePin: {
+          const auto pin = static_cast<uint8_t>((rng >> 16) & 15);
+          const auto level = static_cast<uint8_t>((rng >> 24) & 3);
+          if (images) {
+            driver.SetDriveStrength(pin, static_cast<DriveStrength>(level));
+          } else {
+            legacyDrivePin(bus, pin, level);
+          }
+          break;
+        }
+        case Op::DrivePins: {
+          const std::array<uint8_t, 3> pins = {static_cast<uint8_t>((rng >> 8) & 15),
+                                               static_cast<uint8_t>((rng >> 12) & 15),
+                                               static_cast<uint8_t>((rng >> 16) & 15)};
+          const std::array<uint8_t, 3> levels = {static_cast<uint8_t>((rng >> 20) & 3),
+                                                 static_cast<uint8_t>((rng >> 22) & 3),
+                                                 static_cast<uint8_t>((rng >> 24) & 3)};
+          if (images) {
+            const std::array<std::pair<uint8_t, DriveStrength>, 3> configs = {
+                std::pair{pins[0], static_cast<DriveStrength>(levels[0])},
+                std::pair{pins[1], static_cast<DriveStrength>(levels[1])},
+                std::pair{pins[2], static_cast<DriveStrength>(levels[2])}};
+            driver.SetDriveStrengths(std::span<const std::pair<uint8_t, DriveStrength>>(configs));
+          } else {
+            legacyDrivePins(bus, pins.data(), levels.data(), pins.size());
+          }
+          break;
+        }
+        case Op::Pulls: {
+          uint16_t mask = 0;
+          for (int k = 0; k < 4; ++k) {
+            mask = static_cast<uint16_t>(mask | (1U << ((rng >> (8 + 4 * k)) & 15)));
+          }
+          const bool pull_up = ((rng >> 31) & 1) != 0;
+          if (images) {
+            driver.SetPulls(mask, true, pull_up);
+          } else {
+            legacyMaskRmw(bus, reg(Pcal95555Reg::PULL_SELECT_0), mask, pull_up);
+            legacyMaskRmw(bus, reg(Pcal95555Reg::PULL_ENABLE_0), mask, true);
+          }
+          break;
+        }
+        case Op::BulkGet:
+          if (images) {
+            driver.GetDriveImage(drive);
+            driver.GetPullImage(pulls);
+          } else {
+            legacyBulkGet(bus);
+          }
+          break;
+      }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+    result.host_ns = (pass == 0) ? ns : std::min(result.host_ns, ns);
+    result.reads = bus.reads - reads0;
+    result.writes = bus.writes - writes0;
+    result.wire_us = bus.wire_us - wire0;
+  }
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 1'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const Result results[] = {
+      run(Op::DrivePin, false, calls),  run(Op::DrivePin, true, calls), run(Op::DrivePins, false, calls),
+      run(Op::DrivePins, true, calls),  run(Op::Pulls, false, calls),   run(Op::Pulls, true, calls),
+      run(Op::BulkGet, false, calls),   run(Op::BulkGet, true, calls),
+  };
+
+  std::printf("PCAL95555 drive strength / pull configuration images\n\n");
+  std::printf("%u operations per row, random pins and levels\n", calls);
+  std::printf("%-14s %-6s %10s %10s %10s %10s\n", "operation", "path", "reads/op", "writes/op", "wire us", "host ns");
+  for (const Result& r : results) {
+    std::printf("%-14s %-6s %10.2f %10.2f %10.1f %10.1f\n", r.op, r.path, static_cast<double>(r.reads) / r.calls,
+                static_cast<double>(r.writes) / r.calls, static_cast<double>(r.wire_us) / r.calls, r.host_ns);
+  }
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"operations\": [\n", calls);
+    for (size_t i = 0; i < std::size(results); ++i) {
+      const Result& r = results[i];
+      report.Printf("    {\"operation\": \"%s\", \"path\": \"%s\", \"reads\": %llu, \"writes\": %llu, "
+                    "\"wire_us\": %llu, \"host_ns\": %.2f}%s\n",
+                    r.op, r.path, static_cast<unsigned long long>(r.reads), static_cast<unsigned long long>(r.writes),
+                    static_cast<unsigned long long>(r.wire_us), r.host_ns, report.Sep(i, std::size(results)));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return report.Failed() ? 1 : 0;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file edge_kernels_benchmark.cpp
+ * @brief Times the pcal95555::edges kernels against their scalar reference
+ *
+ * Builds a synthetic input capture (16-bit samples, bit N = pin N) with a mix
+ * of PWM-like pins, sparse random toggles and static pins, runs every kernel
+ * through both pcal95555::edges (SIMD when compiled for it) and
+ * pcal95555::edges::scalar, checks that both agree, and prints the best of
+ * several runs as ns/sample and GB/s of memory traffic. A memcpy of the
+ * buffer is timed as the memory-bandwidth reference.
+ *
+ * Usage: pcal95555_edge_kernels_benchmark [--samples=N] [--runs=N]
+ *                                         [--dense] [--report-json=PATH]
+ *
+ * --dense replaces the capture with random samples (every pin changes about
+ * every other sample), the worst case for the edge list kernels.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include "pcal95555_edge_kernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+
+namespace {
+
+namespace edges = pcal95555::edges;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  size_t samples = 4'000'000;
+  int runs = 7;
+  bool dense = false;
+};
+
+struct Row {
+  const char* kernel;
+  size_t bytes_per_sample;  // memory traffic per sample (input + output)
+  double scalar_ns;         // best run, whole buffer
+  double simd_ns;
+  bool match;
+};
+
+uint32_t g_rng = 0x2545F491;
+
+uint32_t nextRandom() noexcept {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+}
+
+std::vector<uint16_t> makeCapture(const Options& options) {
+  std::vector<uint16_t> samples(options.samples);
+  if (options.dense) {
+    for (auto& s : samples) {
+      s = static_cast<uint16_t>(nextRandom());
+    }
+    return samples;
+  }
+  // Pins 0-3: PWM with different periods and duties; pins 4-7: random
+  // toggles about once per 200 samples; pins 8-15: almost static.
+  static constexpr uint32_t kPeriods[4] = {40, 125, 333, 1000};
+  uint16_t slow = 0;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    uint16_t value = 0;
+    for (uint32_t pin = 0; pin < 4; ++pin) {
+      const uint32_t phase = static_cast<uint32_t>(i % kPeriods[pin]);
+      if (phase < kPeriods[pin] * (pin + 1) / 5) {
+        value = static_cast<uint16_t>(value | (1U << pin));
+      }
+    }
+    const uint32_t r = nextRandom();
+    if (r % 200 == 0) {
+      slow = static_cast<uint16_t>(slow ^ (0x10U << ((r >> 8) % 4)));
+    }
+    if (r % 100'000 == 1) {
+      slow = static_cast<uint16_t>(slow ^ (0x100U << ((r >> 8) % 8)));
+    }
+    samples[i] = static_cast<uint16_t>(value | slow);
+  }
+  return samples;
+}
+
+/// Best wall time of @p runs calls of @p fn, in ns.
+template <typename Fn>
+double bestOf(int runs, Fn&& fn) {
+  double best = 0;
+  for (int r = 0; r < runs; ++r) {
+    const auto start = Clock::now();
+    fn();
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    best = (r == 0) ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+volatile uint64_t g_sink = 0;  // keeps results alive across runs
+
+bool sameEvents(const std::vector<edges::EdgeEvent>& a, const std::vector<edges::EdgeEvent>& b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (a[i].index != b[i].index || a[i].rising != b[i].rising) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool samePulses(const std::vector<edges::Pulse>& a, const std::vector<edges::Pulse>& b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (a[i].start != b[i].start || a[i].width != b[i].width || a[i].level != b[i].level) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void writeJson(const pcal95555::bench::JsonReport& report, const Options& options, double copy_ns,
+               const std::vector<Row>& rows) {
+  report.Printf("{\n  \"backend\": \"%s\",\n  \"samples\": %zu,\n  \"dense\": %s,\n", edges::kBackend,
+                options.samples, options.dense ? "true" : "false");
+  report.Printf("  \"memcpy_gbps\": %.2f,\n  \"kernels\": [\n", static_cast<double>(options.samples * 4) / copy_ns);
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const Row& row = rows[i];
+    report.Printf("    {\"kernel\": \"%s\", \"scalar_ns_per_sample\": %.4f, \"simd_ns_per_sample\": %.4f, "
+                  "\"speedup\": %.2f, \"simd_gbps\": %.2f, \"match\": %s}%s\n",
+                  row.kernel, row.scalar_ns / static_cast<double>(options.samples),
+                  row.simd_ns / static_cast<double>(options.samples), row.scalar_ns / row.simd_ns,
+                  static_cast<double>(options.samples * row.bytes_per_sample) / row.simd_ns,
+                  row.match ? "true" : "false", report.Sep(i, rows.size()));
+  }
+  report.Printf("  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  pcal95555::bench::Cli cli;
+  cli.Option("samples", options.samples, size_t{2}, size_t{UINT32_MAX})
+      .Option("runs", options.runs)
+      .Flag("dense", options.dense);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const std::vector<uint16_t> capture = makeCapture(options);
+  const std::span<const uint16_t> samples(capture);
+  const uint16_t previous = 0;
+  const size_t n = capture.size();
+  std::vector<Row> rows;
+
+  std::vector<uint16_t> copy(n);
+  const double copy_ns = bestOf(options.runs, [&] {
+    std::memcpy(copy.data(), capture.data(), n * sizeof(uint16_t));
+    g_sink = g_sink + copy[n / 2];
+  });
+
+  {
+    std::vector<uint16_t> r1(n), f1(n), r2(n), f2(n);
+    const double s = bestOf(options.runs, [&] { edges::scalar::EdgeMasks(samples, previous, r1.data(), f1.data()); });
+    const double v = bestOf(options.runs, [&] { edges::EdgeMasks(samples, previous, r2.data(), f2.data()); });
+    rows.push_back({"EdgeMasks", 6, s, v, r1 == r2 && f1 == f2});
+  }
+  {
+    edges::EdgeCounts c1, c2;
+    const double s = bestOf(options.runs, [&] {
+      c1 = {};
+      edges::scalar::CountEdges(samples, previous, c1);
+    });
+    const double v = bestOf(options.runs, [&] {
+      c2 = {};
+      edges::CountEdges(samples, previous, c2);
+    });
+    rows.push_back({"CountEdges", 2, s, v, c1.rising == c2.rising && c1.falling == c2.falling});
+  }
+  {
+    std::vector<uint32_t> o1(n), o2(n);
+    size_t k1 = 0;
+    size_t k2 = 0;
+    const double s = bestOf(options.runs, [&] { k1 = edges::scalar::FindChanges(samples, previous, 0xFF00, o1); });
+    const double v = bestOf(options.runs, [&] { k2 = edges::FindChanges(samples, previous, 0xFF00, o2); });
+    rows.push_back({"FindChanges(8-15)", 2, s, v, k1 == k2 && std::equal(o1.begin(), o1.begin() + k1, o2.begin())});
+  }
+  {
+    std::vector<edges::EdgeEvent> e1(n), e2(n);
+    size_t k1 = 0;
+    size_t k2 = 0;
+    const double s = bestOf(options.runs, [&] { k1 = edges::scalar::PinEdges(samples, previous, 5, e1); });
+    const double v = bestOf(options.runs, [&] { k2 = edges::PinEdges(samples, previous, 5, e2); });
+    rows.push_back({"PinEdges(5)", 2, s, v, k1 == k2 && sameEvents(e1, e2, k1)});
+  }
+  {
+    std::vector<edges::Pulse> p1(n), p2(n);
+    size_t k1 = 0;
+    size_t k2 = 0;
+    const double s = bestOf(options.runs, [&] { k1 = edges::scalar::PulseWidths(samples, previous, 0, p1); });
+    const double v = bestOf(options.runs, [&] { k2 = edges::PulseWidths(samples, previous, 0, p2); });
+    rows.push_back({"PulseWidths(0)", 2, s, v, k1 == k2 && samePulses(p1, p2, k1)});
+  }
+
+  const auto perSample = [&](double ns) { return ns / static_cast<double>(n); };
+  const auto gbps = [&](double ns, size_t bytes) { return static_cast<double>(n * bytes) / ns; };
+  std::printf("PCAL95555 edge kernels: backend=%s samples=%zu capture=%s runs=%d\n", edges::kBackend, n,
+              options.dense ? "dense" : "mixed", options.runs);
+  std::printf("memcpy reference: %.3f ns/sample, %.2f GB/s\n\n", perSample(copy_ns), gbps(copy_ns, 4));
+  std::printf("%-20s %14s %14s %9s %10s %6s\n", "kernel", "scalar ns/smp", "simd ns/smp", "speedup", "simd GB/s",
+              "match");
+  bool all_match = true;
+  for (const Row& row : rows) {
+    std::printf("%-20s %14.3f %14.3f %8.2fx %10.2f %6s\n", row.kernel, perSample(row.scalar_ns),
+                perSample(row.simd_ns), row.scalar_ns / row.simd_ns, gbps(row.simd_ns, row.bytes_per_sample),
+                row.match ? "yes" : "NO");
+    all_match = all_match && row.match;
+  }
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    writeJson(report, options, copy_ns, rows);
+  }
+  return (all_match && !report.Failed()) ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+/**
+ * @file emergency_stop_benchmark.cpp
+ * @brief Completion time of PCAL95555::EmergencyStop()
+ *
+ * Drives 1, 2, 4 and 8 expanders to their safe state on a simulated 400 kHz
+ * bus whose clock advances by the modelled wire time of every transaction,
+ * and compares:
+ *  - SetMultipleOutputs() per device (paired read + paired write);
+ *  - EmergencyStop() per device (paired OUTPUT write);
+ *  - EmergencyStop() with directions (paired OUTPUT + paired CONFIG write).
+ * The worst case adds one transfer already on the wire when the fault hits
+ * (a paired read, the longest transfer of the driver).
+ *
+ * It then checks that one driver retargeted between two expanders keeps the
+ * state armed at each address, that the stop gets through an AccountingBus
+ * client whose
+ * Drop quota is used up, that it does not lift the quota of other clients,
+ * that every client's urgent section reaches the inner bus as its own
+ * SetUrgent() pair, and times EmergencyStop() on the host against the
+ * simulated expander.
+ *
+ * Usage: pcal95555_emergency_stop_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "pcal95555_bus_accounting.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t g_sim_us = 0;  // simulated time: advanced by every SimBus below
+
+using pcal95555::bench::SimBus;
+using Driver = pcal95555::PCAL95555<SimBus>;
+
+struct Row {
+  unsigned devices;
+  uint64_t rmw_us;
+  uint64_t estop_us;
+  uint64_t estop_dir_us;
+  uint64_t worst_us;  // in-flight paired read + estop_us
+  bool safe;          // every device ended at its safe image
+};
+
+constexpr uint16_t kSafeOutputs = 0x0000;
+
+std::vector<std::unique_ptr<Driver>> makeDrivers(SimBus& bus, unsigned devices, bool directions) {
+  std::vector<std::unique_ptr<Driver>> drivers;
+  for (unsigned i = 0; i < devices; ++i) {
+    auto& d = drivers.emplace_back(
+        std::make_unique<Driver>(&bus, static_cast<uint8_t>(0x20 + i), pcal95555::ChipVariant::PCAL9555A));
+    d->ArmEmergencyStop({.outputs = kSafeOutputs, .directions = 0xFF00, .write_directions = directions});
+    d->WriteAllOutputs(0xA5A5);
+  }
+  return drivers;
+}
+
+Row measure(unsigned devices) {
+  Row row{devices, 0, 0, 0, 0, true};
+  SimBus bus;
+  bus.clock = &g_sim_us;
+  auto drivers = makeDrivers(bus, devices, false);
+  uint64_t start = g_sim_us;
+  for (auto& d : drivers) {
+    d->SetMultipleOutputs(0xFFFF, false);
+  }
+  row.rmw_us = g_sim_us - start;
+
+  for (auto& d : drivers) {
+    d->WriteAllOutputs(0xA5A5);
+  }
+  start = g_sim_us;
+  for (auto& d : drivers) {
+    d->EmergencyStop();
+  }
+  row.estop_us = g_sim_us - start;
+  for (unsigned i = 0; i < devices; ++i) {
+    row.safe = row.safe && bus.Outputs(static_cast<uint8_t>(0x20 + i)) == kSafeOutputs;
+  }
+
+  SimBus bus_dir;
+  bus_dir.clock = &g_sim_us;
+  auto drivers_dir = makeDrivers(bus_dir, devices, true);
+  start = g_sim_us;
+  for (auto& d : drivers_dir) {
+    d->EmergencyStop();
+  }
+  row.estop_dir_us = g_sim_us - start;
+  row.worst_us = pcal95555::ModelledWireUs(true, 2, pcal95555::bench::kSimBusHz) + row.estop_us;
+  return row;
+}
+
+uint64_t simUs() noexcept {
+  return g_sim_us;
+}
+
+/// Arm at 0x20, retarget to 0x21 and back: 0x21 is not stopped, 0x20 still is.
+bool armedAcrossRetarget() {
+  SimBus bus;
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.WriteAllOutputs(0xFFFF);
+  driver.ArmEmergencyStop({.outputs = kSafeOutputs});
+  driver.RetargetAddress(0x21);
+  driver.WriteAllOutputs(0xFFFF);
+  const bool other_untouched = !driver.EmergencyStop() && bus.Outputs(0x21) == 0xFFFF;
+  driver.RetargetAddress(0x20);
+  return other_untouched && driver.IsEmergencyStopArmed() && driver.EmergencyStop() &&
+         bus.Outputs(0x20) == kSafeOutputs;
+}
+
+/// EmergencyStop() through an AccountingBus client whose Drop quota is used up.
+bool stopsThroughQuota() {
+  SimBus raw;
+  raw.clock = &g_sim_us;
+  pcal95555::AccountingBus<SimBus, 2> bus(&raw, {.now_us = simUs});
+  bus.ConfigureClient(1, {"leds", 500, pcal95555::QuotaAction::Drop});
+  auto leds = bus.MakePort(1);
+  pcal95555::PCAL95555<decltype(leds)> driver(&leds, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.ArmEmergencyStop({.outputs = kSafeOutputs});
+  uint16_t frame = 0;
+  while (driver.WriteAllOutputs(frame = static_cast<uint16_t>(frame + 1))) {
+  }
+  // Quota exhausted: normal writes are dropped, the stop must get through.
+  return !driver.WriteAllOutputs(0xFFFF) && driver.EmergencyStop() && raw.Outputs(0x20) == kSafeOutputs;
+}
+
+/// SimBus that logs the SetUrgent() calls it receives (true = '+', false = '-').
+class UrgencyLogBus : public pcal95555::I2cInterface<UrgencyLogBus> {
+public:
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    return sim.Write(addr, reg, data, len);
+  }
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept { return sim.Read(addr, reg, data, len); }
+  bool EnsureInitialized() noexcept { return true; }
+  void SetUrgent(bool urgent) noexcept {
+    if (length < sizeof(log) - 1) {
+      log[length++] = urgent ? '+' : '-';
+    }
+  }
+
+  SimBus sim;
+  char log[8] = {};
+  size_t length = 0;
+};
+
+/// While one client is inside its urgent section, another client over quota is
+/// still dropped; each client's section reaches the inner bus as its own pair.
+bool urgencyStaysWithCaller() {
+  UrgencyLogBus raw;
+  raw.sim.clock = &g_sim_us;
+  pcal95555::AccountingBus<UrgencyLogBus, 2> bus(&raw, {.now_us = simUs});
+  bus.ConfigureClient(0, {"motors", 500, pcal95555::QuotaAction::Drop});
+  bus.ConfigureClient(1, {"leds", 500, pcal95555::QuotaAction::Drop});
+  auto motors = bus.MakePort(0);
+  auto leds = bus.MakePort(1);
+  const auto reg = static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0);
+  const uint8_t frame[2] = {0x00, 0x00};
+  while (motors.Write(0x20, reg, frame, 2)) {
+  }
+  leds.SetUrgent(true);
+  const bool other_dropped = !motors.Write(0x20, reg, frame, 2);
+  // Overlapping sections, as from two tasks: the inner bus must see both ends of each
+  motors.SetUrgent(true);
+  leds.SetUrgent(false);
+  motors.SetUrgent(false);
+  return other_dropped && std::string_view(raw.log) == "++--";
+}
+
+volatile uint32_t g_sink = 0;
+
+/// ns per EmergencyStop() on the host (best of 5).
+double timeStop(uint32_t calls) {
+  SimBus bus;
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.ArmEmergencyStop({.outputs = kSafeOutputs});
+  double best = 0;
+  for (int run = 0; run < 5; ++run) {
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+      g_sink = g_sink + static_cast<uint32_t>(driver.EmergencyStop());
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 2'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  std::vector<Row> rows;
+  bool all_safe = true;
+  for (const unsigned devices : {1U, 2U, 4U, 8U}) {
+    rows.push_back(measure(devices));
+    all_safe = all_safe && rows.back().safe;
+  }
+  const bool retarget_armed = armedAcrossRetarget();
+  const bool quota_bypass = stopsThroughQuota();
+  const bool urgency_scoped = urgencyStaysWithCaller();
+  const double stop_ns = timeStop(calls);
+
+  std::printf("PCAL95555 emergency stop, simulated 400 kHz bus (wire time, us)\n\n");
+  std::printf("%8s %14s %14s %16s %12s %6s\n", "devices", "RMW outputs", "EmergencyStop", "+ directions",
+              "worst case", "safe");
+  for (const Row& r : rows) {
+    std::printf("%8u %14llu %14llu %16llu %12llu %6s\n", r.devices, static_cast<unsigned long long>(r.rmw_us),
+                static_cast<unsigned long long>(r.estop_us), static_cast<unsigned long long>(r.estop_dir_us),
+                static_cast<unsigned long long>(r.worst_us), r.safe ? "yes" : "NO");
+  }
+  std::printf("\nworst case = one paired read already on the wire + EmergencyStop() of every device\n");
+  std::printf("armed state kept per address across RetargetAddress(): %s\n", retarget_armed ? "yes" : "NO");
+  std::printf("stop through exhausted AccountingBus quota: %s\n", quota_bypass ? "yes" : "NO");
+  std::printf("other clients keep their quota, one inner SetUrgent() pair per client: %s\n",
+              urgency_scoped ? "yes" : "NO");
+  std::printf("host cost per EmergencyStop(): %.1f ns\n", stop_ns);
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"stop_ns\": %.2f,\n  \"retarget_armed\": %s,\n  \"quota_bypass\": %s,\n"
+                  "  \"urgency_scoped\": %s,\n  \"rows\": [\n",
+                  calls, stop_ns, retarget_armed ? "true" : "false", quota_bypass ? "true" : "false", urgency_scoped ? "true" : "false");
+    for (size_t i = 0; i < rows.size(); ++i) {
+      const Row& r = rows[i];
+      report.Printf("    {\"devices\": %u, \"rmw_us\": %llu, \"estop_us\": %llu, \"estop_dir_us\": %llu, "
+                    "\"worst_us\": %llu, \"safe\": %s}%s\n",
+                    r.devices, static_cast<unsigned long long>(r.rmw_us), static_cast<unsigned long long>(r.estop_us),
+                    static_cast<unsigned long long>(r.estop_dir_us), static_cast<unsigned long long>(r.worst_us),
+                    r.safe ? "true" : "false", report.Sep(i, rows.size()));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return (all_safe && retarget_armed && quota_bypass && urgency_scoped && !report.Failed()) ? 0 : 1;
+}
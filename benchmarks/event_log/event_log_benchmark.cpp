@@ -0,0 +1,175 @@
+/**
+ * @file event_log_benchmark.cpp
+ * @brief Size and speed of pcal95555::EventLogWriter
+ *
+ * For each scenario (mean event rate, number of devices) generates a stream
+ * of pin changes with exponentially distributed gaps, in which 90 % of the
+ * events change one pin and the rest several, appends it to a RAM ring,
+ * decodes the ring with EventLogReader and checks that every event comes
+ * back unchanged. Reports bytes per event (block headers and unused block
+ * tails included), the history one MiB of storage holds at that rate, and
+ * the time per Append().
+ *
+ * Usage: pcal95555_event_log_benchmark [--events=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555_event_log.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr size_t kBlockBytes = 4096;
+constexpr uint32_t kBlocks = 16;  // 64 KiB
+using Sink = pcal95555::RamRingSink<kBlockBytes, kBlocks>;
+using Writer = pcal95555::EventLogWriter<Sink>;
+
+struct Event {
+  uint64_t time_us;
+  uint16_t inputs;
+  uint8_t device;
+};
+
+struct Row {
+  double rate_hz;
+  unsigned devices;
+  double bytes_per_event;
+  double minutes_per_mib;  // history per MiB of storage
+  double append_ns;
+  bool match;
+};
+
+uint64_t g_rng = 0x9E3779B97F4A7C15ULL;
+
+uint64_t nextRandom() noexcept {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+std::vector<Event> makeStream(double rate_hz, unsigned devices, size_t count) {
+  std::vector<Event> events;
+  events.reserve(count);
+  uint16_t states[pcal95555::kEventLogMaxDevices]{};
+  double t = 1e6;
+  while (events.size() < count) {
+    const double u = (static_cast<double>(nextRandom() >> 11) + 0.5) / 9007199254740992.0;
+    t += -std::log(u) / rate_hz * 1e6;
+    const auto device = static_cast<uint8_t>(nextRandom() % devices);
+    const uint64_t r = nextRandom();
+    uint16_t changed = (r % 10 != 0) ? static_cast<uint16_t>(1U << ((r >> 8) % 16))
+                                     : static_cast<uint16_t>(r >> 16);
+    if (changed == 0) {
+      changed = 1;
+    }
+    states[device] = static_cast<uint16_t>(states[device] ^ changed);
+    events.push_back({static_cast<uint64_t>(t), states[device], device});
+  }
+  return events;
+}
+
+/// Append the whole stream; returns ns per event (best of 5) and leaves the last run in @p sink.
+double appendAll(const std::vector<Event>& events, Sink& sink, Writer& writer) {
+  double best = 0;
+  for (int run = 0; run < 5; ++run) {
+    sink = Sink();
+    writer = Writer(&sink);
+    writer.Open();
+    const auto start = Clock::now();
+    for (const Event& e : events) {
+      writer.Append(e.device, e.inputs, e.time_us);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  return best / static_cast<double>(events.size());
+}
+
+/// Decode @p sink and compare with the tail of @p events (older blocks were overwritten).
+bool decodeMatches(const std::vector<Event>& events, Sink& sink, size_t& decoded, size_t& storage) {
+  std::vector<uint8_t> scratch(kBlockBytes);
+  pcal95555::EventLogReader<Sink> reader(&sink, scratch);
+  std::vector<Event> got;
+  pcal95555::EventLogEvent ev;
+  while (reader.Next(ev)) {
+    got.push_back({ev.time_us, ev.inputs, ev.device});
+  }
+  decoded = got.size();
+  storage = reader.BlocksRead() == 0 ? 0 : (reader.BlocksRead() - 1) * kBlockBytes + reader.CurrentBlock().Offset();
+  if (got.empty() || got.size() > events.size()) {
+    return false;
+  }
+  const size_t offset = events.size() - got.size();
+  for (size_t i = 0; i < got.size(); ++i) {
+    const Event& a = got[i];
+    const Event& b = events[offset + i];
+    if (a.time_us != b.time_us || a.inputs != b.inputs || a.device != b.device) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  size_t count = 200'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("events", count);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  static constexpr double kRates[] = {100, 1'000, 10'000, 100'000};
+  static constexpr unsigned kDevices[] = {1, 4};
+  auto sink = std::make_unique<Sink>();
+  Writer writer(sink.get());
+  std::vector<Row> rows;
+  bool all_match = true;
+  for (const unsigned devices : kDevices) {
+    for (const double rate : kRates) {
+      const std::vector<Event> events = makeStream(rate, devices, count);
+      const double ns = appendAll(events, *sink, writer);
+      size_t decoded = 0;
+      size_t storage = 0;
+      const bool match = decodeMatches(events, *sink, decoded, storage);
+      const double bytes = static_cast<double>(storage) / static_cast<double>(decoded);
+      const double minutes = 1048576.0 / bytes / rate / 60.0;
+      rows.push_back({rate, devices, bytes, minutes, ns, match});
+      all_match = all_match && match;
+    }
+  }
+
+  std::printf("PCAL95555 event log: %zu events per scenario, %u x %zu byte ring\n\n", count, kBlocks, kBlockBytes);
+  std::printf("%9s %8s %12s %12s %10s %6s\n", "rate Hz", "devices", "bytes/event", "min per MiB", "ns/append",
+              "match");
+  for (const Row& row : rows) {
+    std::printf("%9.0f %8u %12.2f %12.1f %10.1f %6s\n", row.rate_hz, row.devices, row.bytes_per_event,
+                row.minutes_per_mib, row.append_ns, row.match ? "yes" : "NO");
+  }
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"events\": %zu,\n  \"ring_bytes\": %zu,\n  \"rows\": [\n", count, kBlockBytes * kBlocks);
+    for (size_t i = 0; i < rows.size(); ++i) {
+      const Row& row = rows[i];
+      report.Printf("    {\"rate_hz\": %.0f, \"devices\": %u, \"bytes_per_event\": %.3f, \"minutes_per_mib\": %.2f, "
+                    "\"append_ns\": %.2f, \"match\": %s}%s\n",
+                    row.rate_hz, row.devices, row.bytes_per_event, row.minutes_per_mib, row.append_ns,
+                    row.match ? "true" : "false", report.Sep(i, rows.size()));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return (all_match && !report.Failed()) ? 0 : 1;
+}
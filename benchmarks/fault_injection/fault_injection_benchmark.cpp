@@ -0,0 +1,309 @@
+/**
+ * @file fault_injection_benchmark.cpp
+ * @brief Degraded-mode throughput and recovery, measured with pcal95555::FaultInjectionBus
+ *
+ * Part 1 runs a fixed workload (alternating WriteAllOutputs() and
+ * ReadAllInputs(uint16_t&)) on a simulated 400 kHz bus through a
+ * FaultInjectionBus, for several fault models and SetRetries() 0, 1 and 3.
+ * The simulated clock advances by the modelled wire time of every
+ * transaction and by every injected wait. The table shows the share of
+ * driver calls that still failed, reads that returned wrong data,
+ * transactions per call (the cost of the retry loop) and the mean and
+ * worst simulated time per call.
+ *
+ * Part 2 measures recovery from device disappearance. A 1 kHz loop reads
+ * the inputs and calls ScrubTick(); after 300 ms the expander disappears
+ * for 50 ms and comes back reset to power-on defaults. The table shows the
+ * failed reads, the time from the return to the first good read, and the
+ * time until the configuration scrubber has restored the configuration,
+ * for several scrub rates.
+ *
+ * Part 3 freezes CONFIG_PORT_0 with FaultInjectionBus::SetStuck() after the
+ * driver made port 0 outputs. The configuration scrubber must report the
+ * register as a mismatch on every pass while it is stuck (its repairs reach
+ * the device but cannot change what reads return), and no more once it is
+ * released. The program exits 1 if it does not.
+ *
+ * Part 4 times WriteAllOutputs() on the simulated expander directly and
+ * through a FaultInjectionBus with every probability at zero.
+ *
+ * Usage: pcal95555_fault_injection_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "pcal95555_fault_injection.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t g_sim_us = 0;  // simulated time: wire time of the expanders below and injected waits
+
+void SimSleepUs(uint32_t us) noexcept {
+  g_sim_us += us;
+}
+
+constexpr uint16_t kInputs = 0xA55A;
+
+using pcal95555::bench::SimBus;
+
+/// Power-on defaults with the fixed input image.
+void powerUp(SimBus& bus) noexcept {
+  bus.PowerOnReset();
+  bus.SetInputs(kInputs);
+}
+
+using FaultBus = pcal95555::FaultInjectionBus<SimBus>;
+using Driver = pcal95555::PCAL95555<FaultBus>;
+
+struct Scenario {
+  const char* name;
+  pcal95555::FaultInjectionConfig faults;
+};
+
+struct Result {
+  const char* name;
+  int retries;
+  uint32_t calls;
+  uint32_t failed;
+  uint32_t wrong;
+  uint32_t transactions;
+  double mean_us;
+  uint64_t max_us;
+};
+
+Result runWorkload(const Scenario& scenario, int retries, uint32_t calls) {
+  SimBus inner;
+  powerUp(inner);
+  inner.clock = &g_sim_us;
+  FaultBus bus(&inner);
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  driver.SetRetries(retries);
+  pcal95555::FaultInjectionConfig faults = scenario.faults;
+  faults.sleep_us = SimSleepUs;
+  bus.SetConfig(faults);
+  bus.ResetStats();
+
+  Result result{scenario.name, retries, calls, 0, 0, 0, 0, 0};
+  const uint64_t start = g_sim_us;
+  for (uint32_t i = 0; i < calls; ++i) {
+    const uint64_t t0 = g_sim_us;
+    bool ok = false;
+    if ((i & 1U) == 0) {
+      ok = driver.WriteAllOutputs(static_cast<uint16_t>(i));
+    } else {
+      uint16_t inputs = 0;
+      ok = driver.ReadAllInputs(inputs);
+      result.wrong += (ok && inputs != kInputs) ? 1 : 0;
+    }
+    result.failed += ok ? 0 : 1;
+    result.max_us = std::max<uint64_t>(result.max_us, g_sim_us - t0);
+  }
+  result.transactions = bus.Stats().transactions;
+  result.mean_us = static_cast<double>(g_sim_us - start) / calls;
+  return result;
+}
+
+struct Recovery {
+  uint32_t scrub_rate;
+  uint32_t failed_reads;
+  uint32_t first_read_ms;  ///< After the return
+  uint32_t restored_ms;    ///< After the return; UINT32_MAX if never
+  uint32_t repairs;
+};
+
+constexpr uint16_t kDirections = 0xFF00;  // port 0 outputs, port 1 inputs
+constexpr uint16_t kOutputs = 0x003C;
+constexpr uint16_t kPullEnable = 0xFF00;
+
+Recovery runRecovery(uint32_t scrub_rate) {
+  SimBus inner;
+  powerUp(inner);
+  inner.clock = &g_sim_us;
+  FaultBus bus(&inner, {.sleep_us = SimSleepUs});
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  driver.SetScrubRate(scrub_rate);
+  driver.SetMultipleDirections(0x00FF, GPIODir::Output);
+  driver.WriteAllOutputs(kOutputs);
+  for (uint8_t pin = 8; pin < 16; ++pin) {
+    driver.SetPullEnable(pin, true);
+  }
+
+  Recovery result{scrub_rate, 0, UINT32_MAX, UINT32_MAX, 0};
+  constexpr uint32_t kGoneMs = 300;
+  constexpr uint32_t kBackMs = 350;
+  g_sim_us = 0;
+  for (uint32_t ms = 0; ms < 3000 && result.restored_ms == UINT32_MAX; ++ms) {
+    if (ms == kGoneMs) {
+      bus.SetPresent(0x20, false);
+    } else if (ms == kBackMs) {
+      powerUp(inner);
+      bus.SetPresent(0x20, true);
+    }
+    g_sim_us = std::max<uint64_t>(g_sim_us, uint64_t{ms} * 1000);
+    uint16_t inputs = 0;
+    if (!driver.ReadAllInputs(inputs)) {
+      ++result.failed_reads;
+    } else if (ms >= kBackMs && result.first_read_ms == UINT32_MAX) {
+      result.first_read_ms = ms - kBackMs;
+    }
+    driver.ScrubTick(g_sim_us);
+    if (ms >= kBackMs && inner.Pair(Pcal95555Reg::CONFIG_PORT_0) == kDirections &&
+        inner.Pair(Pcal95555Reg::OUTPUT_PORT_0) == kOutputs &&
+        inner.Pair(Pcal95555Reg::PULL_ENABLE_0) == kPullEnable) {
+      result.restored_ms = ms - kBackMs;
+    }
+  }
+  result.repairs = driver.GetScrubStats().repairs;
+  return result;
+}
+
+/// Scrub mismatches while CONFIG_PORT_0 reads stuck (two halves) and after it is released.
+struct StuckResult {
+  uint32_t first_half;
+  uint32_t second_half;
+  uint32_t released;
+  uint32_t stuck_reads;
+
+  [[nodiscard]] bool Detected() const noexcept { return first_half != 0 && second_half != 0 && released == 0; }
+};
+
+StuckResult runStuck() {
+  SimBus inner;
+  powerUp(inner);
+  FaultBus bus(&inner);
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  driver.SetScrubRate(1000);
+  driver.SetMultipleDirections(0x00FF, GPIODir::Output);
+  bus.SetStuck(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0), 0xFF);  // reads: all inputs
+
+  uint64_t now_us = 0;
+  const auto mismatchesOver = [&](uint32_t ticks) {
+    const uint32_t before = driver.GetScrubStats().mismatches;
+    for (uint32_t i = 0; i < ticks; ++i) {
+      driver.ScrubTick(now_us += 1000);
+    }
+    return driver.GetScrubStats().mismatches - before;
+  };
+  StuckResult result{};
+  result.first_half = mismatchesOver(50);
+  result.second_half = mismatchesOver(50);
+  bus.ClearStuck(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0));
+  result.released = mismatchesOver(50);
+  result.stuck_reads = bus.Stats().stuck;
+  return result;
+}
+
+volatile uint32_t g_sink = 0;
+
+/// ns per WriteAllOutputs() (best of 5), directly or through a fault-free FaultInjectionBus.
+template <typename Bus>
+double timeWrites(Bus& bus, uint32_t calls) {
+  pcal95555::PCAL95555<Bus> driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  double best = 0;
+  for (int run = 0; run < 5; ++run) {
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+      g_sink = g_sink + static_cast<uint32_t>(driver.WriteAllOutputs(static_cast<uint16_t>(i)));
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 2'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const Scenario scenarios[] = {
+      {"clean", {}},
+      {"nack 1%", {.nack_ppm = 10000}},
+      {"nack 10%", {.nack_ppm = 100000}},
+      {"storm 1% x8", {.nack_ppm = 10000, .nack_burst = 8}},
+      {"timeout 0.5%", {.timeout_ppm = 5000, .timeout_us = 1000}},
+      {"delay 5%", {.delay_ppm = 50000, .delay_us = 200}},
+      {"corrupt 1%", {.corrupt_ppm = 10000}},
+  };
+  constexpr uint32_t kWorkloadCalls = 20000;
+  std::vector<Result> results;
+  for (const Scenario& scenario : scenarios) {
+    for (int retries : {0, 1, 3}) {
+      results.push_back(runWorkload(scenario, retries, kWorkloadCalls));
+    }
+  }
+  const Recovery recoveries[] = {runRecovery(10), runRecovery(100), runRecovery(1000)};
+  const StuckResult stuck = runStuck();
+
+  SimBus direct;
+  SimBus wrapped_inner;
+  powerUp(direct);
+  powerUp(wrapped_inner);
+  FaultBus wrapped(&wrapped_inner);
+  const double direct_ns = timeWrites(direct, calls);
+  const double wrapped_ns = timeWrites(wrapped, calls);
+
+  std::printf("PCAL95555 fault injection\n\n");
+  std::printf("%u calls (WriteAllOutputs / ReadAllInputs alternating), 400 kHz\n", kWorkloadCalls);
+  std::printf("%-14s %7s %8s %7s %8s %9s %9s\n", "faults", "retries", "failed%", "wrong", "txn/call", "mean us",
+              "max us");
+  for (const Result& r : results) {
+    std::printf("%-14s %7d %8.3f %7u %8.3f %9.1f %9llu\n", r.name, r.retries, 100.0 * r.failed / r.calls, r.wrong,
+                static_cast<double>(r.transactions) / r.calls, r.mean_us, static_cast<unsigned long long>(r.max_us));
+  }
+  std::printf("\ndevice gone for 50 ms, back at power-on defaults (1 kHz input reads + ScrubTick())\n");
+  std::printf("%-12s %12s %14s %12s %8s\n", "scrub/s", "failed reads", "first read ms", "restored ms", "repairs");
+  for (const Recovery& r : recoveries) {
+    std::printf("%-12u %12u %14u %12u %8u\n", r.scrub_rate, r.failed_reads, r.first_read_ms, r.restored_ms,
+                r.repairs);
+  }
+  std::printf("\nCONFIG_PORT_0 stuck (%u frozen reads): scrub mismatches %u + %u while stuck, %u after release: %s\n",
+              stuck.stuck_reads, stuck.first_half, stuck.second_half, stuck.released,
+              stuck.Detected() ? "detected" : "MISSED");
+  std::printf("\nhost cost per WriteAllOutputs(): direct %.1f ns, through FaultInjectionBus %.1f ns\n", direct_ns,
+              wrapped_ns);
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"direct_ns\": %.2f,\n  \"wrapped_ns\": %.2f,\n  \"workload\": [\n", calls,
+                  direct_ns, wrapped_ns);
+    for (size_t i = 0; i < results.size(); ++i) {
+      const Result& r = results[i];
+      report.Printf("    {\"faults\": \"%s\", \"retries\": %d, \"calls\": %u, \"failed\": %u, \"wrong\": %u, "
+                    "\"transactions\": %u, \"mean_us\": %.2f, \"max_us\": %llu}%s\n",
+                    r.name, r.retries, r.calls, r.failed, r.wrong, r.transactions, r.mean_us,
+                    static_cast<unsigned long long>(r.max_us), report.Sep(i, results.size()));
+    }
+    report.Printf("  ],\n  \"recovery\": [\n");
+    for (size_t i = 0; i < std::size(recoveries); ++i) {
+      const Recovery& r = recoveries[i];
+      report.Printf("    {\"scrub_rate\": %u, \"failed_reads\": %u, \"first_read_ms\": %u, \"restored_ms\": %u, "
+                    "\"repairs\": %u}%s\n",
+                    r.scrub_rate, r.failed_reads, r.first_read_ms, r.restored_ms, r.repairs,
+                    report.Sep(i, std::size(recoveries)));
+    }
+    report.Printf("  ],\n  \"stuck\": {\"mismatches_first_half\": %u, \"mismatches_second_half\": %u, "
+                  "\"mismatches_released\": %u, \"detected\": %s}\n}\n",
+                  stuck.first_half, stuck.second_half, stuck.released, stuck.Detected() ? "true" : "false");
+  }
+  return (report.Failed() || !stuck.Detected()) ? 1 : 0;
+}
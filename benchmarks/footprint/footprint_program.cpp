@@ -0,0 +1,114 @@
+/**
+ * @file footprint_program.cpp
+ * @brief Minimal application used to measure the driver's flash and RAM cost
+ *
+ * One source file is compiled once per entry of the footprint matrix (see
+ * CMakeLists.txt next to this file). The feature macros select which slice of
+ * the public API the "application" uses, so the linker keeps only the code an
+ * equivalent firmware image would pull in:
+ *
+ * | Macro                       | API surface exercised                            |
+ * |-----------------------------|--------------------------------------------------|
+ * | HF_FP_FEATURE_OUTPUT        | Direction, WritePin/WritePins, toggle, masks     |
+ * | HF_FP_FEATURE_INPUT         | ReadPin/ReadPins/ReadAllInputs, polarity         |
+ * | HF_FP_FEATURE_INTERRUPT     | Interrupt mask, pin callbacks, HandleInterrupt   |
+ * | HF_FP_FEATURE_AGILE         | Pull, drive strength, input latch, output mode   |
+ *
+ * The build configuration (CONFIG_PCAL95555_* overrides such as the service
+ * engine or subscriber capacity) comes in as compile definitions from the
+ * matrix. With none of the feature macros set (HF_FP_WITH_DRIVER=0) the program only contains
+ * the stub bus and serves as the reference the driver's cost is measured
+ * against.
+ *
+ * The driver instance is a global named g_pcal95555_footprint_driver so the
+ * report script can read sizeof(PCAL95555<...>) from the symbol table. Bus
+ * and driver are constinit, as firmware should declare them: the image
+ * carries no static constructor for them.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include "footprint_stub_bus.hpp"
+
+#ifndef HF_FP_WITH_DRIVER
+#define HF_FP_WITH_DRIVER 1
+#endif
+#ifndef HF_FP_FEATURE_OUTPUT
+#define HF_FP_FEATURE_OUTPUT 0
+#endif
+#ifndef HF_FP_FEATURE_INPUT
+#define HF_FP_FEATURE_INPUT 0
+#endif
+#ifndef HF_FP_FEATURE_INTERRUPT
+#define HF_FP_FEATURE_INTERRUPT 0
+#endif
+#ifndef HF_FP_FEATURE_AGILE
+#define HF_FP_FEATURE_AGILE 0
+#endif
+
+constinit FootprintStubBus g_pcal95555_footprint_bus;
+
+#if HF_FP_WITH_DRIVER
+using FootprintDriver = pcal95555::PCAL95555<FootprintStubBus>;
+
+constinit FootprintDriver g_pcal95555_footprint_driver(&g_pcal95555_footprint_bus, static_cast<uint8_t>(0x20),
+                                             pcal95555::ChipVariant::Unknown);
+#endif
+
+// Results are folded into a volatile so nothing the application asked for is
+// optimised away.
+static volatile uint32_t g_sink = 0;
+
+int main() {
+  uint32_t acc = 0;
+
+#if HF_FP_WITH_DRIVER
+  FootprintDriver& drv = g_pcal95555_footprint_driver;
+  acc += drv.EnsureInitialized() ? 1U : 0U;
+
+#if HF_FP_FEATURE_OUTPUT
+  acc += drv.SetPinDirection(0, GPIODir::Output) ? 1U : 0U;
+  acc += drv.SetMultipleDirections(0xFF00, GPIODir::Output) ? 1U : 0U;
+  acc += drv.SetDirections({{1, GPIODir::Output}, {2, GPIODir::Output}}) ? 1U : 0U;
+  acc += drv.WritePin(0, true) ? 1U : 0U;
+  acc += drv.TogglePin(0) ? 1U : 0U;
+  acc += drv.SetMultipleOutputs(0x00F0, true) ? 1U : 0U;
+  acc += drv.WritePins({{1, true}, {2, false}}) ? 1U : 0U;
+#endif
+
+#if HF_FP_FEATURE_INPUT
+  acc += drv.SetMultipleDirections(0x00FF, GPIODir::Input) ? 1U : 0U;
+  acc += drv.SetPinPolarity(3, Polarity::Inverted) ? 1U : 0U;
+  acc += drv.ReadPin(3) ? 1U : 0U;
+  acc += drv.ReadAllInputs();
+  for (const auto& [pin, value] : drv.ReadPins({3, 4, 5})) {
+    acc += static_cast<uint32_t>(pin) + (value ? 1U : 0U);
+  }
+#endif
+
+#if HF_FP_FEATURE_INTERRUPT
+  acc += drv.ConfigureInterrupts({{4, InterruptState::Enabled}, {5, InterruptState::Enabled}}) ? 1U : 0U;
+  acc += drv.RegisterPinInterrupt(4, InterruptEdge::Both,
+                                  [](uint8_t pin, bool state) { g_sink = pin + (state ? 1U : 0U); })
+             ? 1U
+             : 0U;
+  drv.SetInterruptCallback([](uint16_t status) { g_sink = status; });
+  acc += drv.RegisterInterruptHandler() ? 1U : 0U;
+  drv.HandleInterrupt();
+  acc += drv.GetInterruptStatus();
+#endif
+
+#if HF_FP_FEATURE_AGILE
+  acc += drv.SetPullEnables({{6, true}, {7, true}}) ? 1U : 0U;
+  acc += drv.SetPullDirection(6, true) ? 1U : 0U;
+  acc += drv.SetDriveStrengths({{0, DriveStrength::Level1}, {1, DriveStrength::Level2}}) ? 1U : 0U;
+  acc += drv.EnableMultipleInputLatches(0x00C0, true) ? 1U : 0U;
+  acc += drv.SetOutputMode(true, false) ? 1U : 0U;
+#endif
+
+  acc += drv.GetErrorFlags();
+#endif  // HF_FP_WITH_DRIVER
+
+  g_sink = acc;
+  return 0;
+}
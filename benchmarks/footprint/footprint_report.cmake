@@ -0,0 +1,178 @@
+#===============================================================================
+# PCAL95555 Driver - Footprint Report (cmake -P script)
+#
+# Inputs (all passed with -D by benchmarks/footprint/CMakeLists.txt):
+#   FOOTPRINT_MANIFEST         Generated file listing "name=path" programs
+#   FOOTPRINT_SIZE_TOOL        size / <prefix>size
+#   FOOTPRINT_NM_TOOL          nm / <prefix>nm
+#   FOOTPRINT_TOOLCHAIN        Compiler id/version/arch the numbers belong to
+#   FOOTPRINT_REPORT           JSON report written by this script
+#   FOOTPRINT_BASELINE         Checked-in baseline JSON to compare against
+#   FOOTPRINT_TOLERANCE        Allowed growth in bytes
+#   FOOTPRINT_FAIL_ON_GROWTH   Fail when growth exceeds the tolerance
+#   FOOTPRINT_UPDATE_BASELINE  Copy the report over the baseline instead
+#
+# Flash = .text* + .rodata* + .data* (initialised data lives in flash too),
+# RAM   = .data* + .bss*. Every number except driver_sizeof is the delta
+# against the "reference" program, i.e. what the driver adds.
+#===============================================================================
+
+cmake_minimum_required(VERSION 3.19)
+
+include("${FOOTPRINT_MANIFEST}")
+if(NOT FOOTPRINT_TOLERANCE)
+    set(FOOTPRINT_TOLERANCE 0)
+endif()
+
+# Sum section sizes of one program into <prefix>_text/_rodata/_data/_bss.
+function(_fp_measure path prefix)
+    execute_process(COMMAND "${FOOTPRINT_SIZE_TOOL}" -A -d "${path}"
+        OUTPUT_VARIABLE _out RESULT_VARIABLE _rc)
+    if(NOT _rc EQUAL 0)
+        message(FATAL_ERROR "size failed on ${path}")
+    endif()
+    set(_text 0)
+    set(_rodata 0)
+    set(_data 0)
+    set(_bss 0)
+    string(REPLACE "\n" ";" _lines "${_out}")
+    foreach(_line IN LISTS _lines)
+        if(_line MATCHES "^(\\.[A-Za-z0-9_.]+)[ \t]+([0-9]+)")
+            set(_name "${CMAKE_MATCH_1}")
+            set(_size "${CMAKE_MATCH_2}")
+            if(_name MATCHES "^\\.text")
+                math(EXPR _text "${_text} + ${_size}")
+            elseif(_name MATCHES "^\\.rodata")
+                math(EXPR _rodata "${_rodata} + ${_size}")
+            elseif(_name MATCHES "^\\.data")
+                math(EXPR _data "${_data} + ${_size}")
+            elseif(_name MATCHES "^\\.bss")
+                math(EXPR _bss "${_bss} + ${_size}")
+            endif()
+        endif()
+    endforeach()
+
+    # sizeof(PCAL95555<...>) straight from the symbol table.
+    set(_sizeof 0)
+    execute_process(COMMAND "${FOOTPRINT_NM_TOOL}" -S --defined-only "${path}"
+        OUTPUT_VARIABLE _syms RESULT_VARIABLE _rc)
+    if(_rc EQUAL 0 AND _syms MATCHES "[0-9a-fA-F]+ ([0-9a-fA-F]+) [A-Za-z] g_pcal95555_footprint_driver\n")
+        math(EXPR _sizeof "0x${CMAKE_MATCH_1}")
+    endif()
+
+    set(${prefix}_text ${_text} PARENT_SCOPE)
+    set(${prefix}_rodata ${_rodata} PARENT_SCOPE)
+    set(${prefix}_data ${_data} PARENT_SCOPE)
+    set(${prefix}_bss ${_bss} PARENT_SCOPE)
+    set(${prefix}_sizeof ${_sizeof} PARENT_SCOPE)
+endfunction()
+
+#===============================================================================
+# Measure
+#===============================================================================
+set(_names)
+foreach(_entry IN LISTS FOOTPRINT_PROGRAMS)
+    string(FIND "${_entry}" "=" _eq)
+    string(SUBSTRING "${_entry}" 0 ${_eq} _name)
+    math(EXPR _eq "${_eq} + 1")
+    string(SUBSTRING "${_entry}" ${_eq} -1 _path)
+    _fp_measure("${_path}" "m_${_name}")
+    if(NOT _name STREQUAL "reference")
+        list(APPEND _names ${_name})
+    endif()
+endforeach()
+if(NOT DEFINED m_reference_text)
+    message(FATAL_ERROR "footprint manifest has no reference program")
+endif()
+
+set(_json "{}")
+string(JSON _json SET "${_json}" toolchain "\"${FOOTPRINT_TOOLCHAIN}\"")
+string(JSON _json SET "${_json}" configurations "{}")
+foreach(_name IN LISTS _names)
+    foreach(_sec text rodata data bss)
+        math(EXPR d_${_sec} "${m_${_name}_${_sec}} - ${m_reference_${_sec}}")
+    endforeach()
+    math(EXPR _flash "${d_text} + ${d_rodata} + ${d_data}")
+    math(EXPR _ram "${d_data} + ${d_bss}")
+    set(_obj "{}")
+    string(JSON _obj SET "${_obj}" flash ${_flash})
+    string(JSON _obj SET "${_obj}" ram ${_ram})
+    string(JSON _obj SET "${_obj}" text ${d_text})
+    string(JSON _obj SET "${_obj}" rodata ${d_rodata})
+    string(JSON _obj SET "${_obj}" data ${d_data})
+    string(JSON _obj SET "${_obj}" bss ${d_bss})
+    string(JSON _obj SET "${_obj}" driver_sizeof ${m_${_name}_sizeof})
+    string(JSON _json SET "${_json}" configurations ${_name} "${_obj}")
+    set(r_${_name}_flash ${_flash})
+    set(r_${_name}_ram ${_ram})
+    set(r_${_name}_sizeof ${m_${_name}_sizeof})
+endforeach()
+
+file(WRITE "${FOOTPRINT_REPORT}" "${_json}\n")
+
+#===============================================================================
+# Print table
+#===============================================================================
+message(STATUS "PCAL95555 footprint (${FOOTPRINT_TOOLCHAIN}), bytes added over the empty program:")
+message(STATUS "  configuration          flash      ram   sizeof(driver)")
+foreach(_name IN LISTS _names)
+    string(LENGTH "${_name}" _len)
+    math(EXPR _pad "22 - ${_len}")
+    string(REPEAT " " ${_pad} _spaces)
+    set(_f "        ${r_${_name}_flash}")
+    set(_r "        ${r_${_name}_ram}")
+    string(LENGTH "${_f}" _fl)
+    math(EXPR _fl "${_fl} - 8")
+    string(SUBSTRING "${_f}" ${_fl} 8 _f)
+    string(LENGTH "${_r}" _rl)
+    math(EXPR _rl "${_rl} - 8")
+    string(SUBSTRING "${_r}" ${_rl} 8 _r)
+    message(STATUS "  ${_name}${_spaces} ${_f} ${_r}   ${r_${_name}_sizeof}")
+endforeach()
+message(STATUS "Report written to ${FOOTPRINT_REPORT}")
+
+if(FOOTPRINT_UPDATE_BASELINE)
+    file(WRITE "${FOOTPRINT_BASELINE}" "${_json}\n")
+    message(STATUS "Baseline updated: ${FOOTPRINT_BASELINE}")
+    return()
+endif()
+
+#===============================================================================
+# Compare with baseline
+#===============================================================================
+if(NOT EXISTS "${FOOTPRINT_BASELINE}")
+    message(STATUS "No baseline at ${FOOTPRINT_BASELINE}; run pcal95555_footprint_update_baseline")
+    return()
+endif()
+file(READ "${FOOTPRINT_BASELINE}" _base)
+string(JSON _base_toolchain ERROR_VARIABLE _err GET "${_base}" toolchain)
+if(NOT _base_toolchain STREQUAL FOOTPRINT_TOOLCHAIN)
+    message(WARNING "Footprint baseline was recorded with '${_base_toolchain}', "
+                    "this build uses '${FOOTPRINT_TOOLCHAIN}'; differences may be toolchain noise")
+endif()
+
+set(_regressions 0)
+foreach(_name IN LISTS _names)
+    foreach(_metric flash ram sizeof)
+        set(_key ${_metric})
+        if(_metric STREQUAL "sizeof")
+            set(_key driver_sizeof)
+        endif()
+        string(JSON _old ERROR_VARIABLE _err GET "${_base}" configurations ${_name} ${_key})
+        if(_err)
+            message(STATUS "  ${_name}: not in baseline")
+            break()
+        endif()
+        math(EXPR _delta "${r_${_name}_${_metric}} - ${_old}")
+        if(_delta GREATER FOOTPRINT_TOLERANCE)
+            message(WARNING "Footprint regression: ${_name} ${_metric} ${_old} -> ${r_${_name}_${_metric}} (+${_delta})")
+            math(EXPR _regressions "${_regressions} + 1")
+        elseif(NOT _delta EQUAL 0)
+            message(STATUS "  ${_name} ${_metric}: ${_old} -> ${r_${_name}_${_metric}} (${_delta})")
+        endif()
+    endforeach()
+endforeach()
+
+if(_regressions GREATER 0 AND FOOTPRINT_FAIL_ON_GROWTH)
+    message(FATAL_ERROR "${_regressions} footprint regression(s) above ${FOOTPRINT_TOLERANCE} byte(s)")
+endif()
@@ -0,0 +1,39 @@
+/**
+ * @file footprint_stub_bus.hpp
+ * @brief Do-nothing I2C bus used by the footprint benchmark programs
+ *
+ * The stub acknowledges every transfer and returns zeroes on reads. Its
+ * methods touch a volatile sink so the compiler cannot prove the driver's
+ * bus traffic is dead and strip the code being measured.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pcal95555.hpp"
+
+class FootprintStubBus : public pcal95555::I2cInterface<FootprintStubBus> {
+public:
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    sink_ = static_cast<uint8_t>(addr ^ reg ^ ((len > 0 && data != nullptr) ? data[0] : 0U));
+    return true;
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = sink_;
+    }
+    sink_ = static_cast<uint8_t>(addr ^ reg);
+    return true;
+  }
+
+  bool EnsureInitialized() noexcept {
+    return true;
+  }
+
+private:
+  volatile uint8_t sink_{0};
+};
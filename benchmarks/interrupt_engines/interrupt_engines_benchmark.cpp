@@ -0,0 +1,218 @@
+/**
+ * @file interrupt_engines_benchmark.cpp
+ * @brief Cost and edge coverage of the PCA9555 / PCAL9555A interrupt engines
+ *
+ * Compares HandleInterrupt() with its per-variant engine against the
+ * previous combined service, which branched on the chip variant inside the
+ * service (reproduced here on the public API):
+ *  - PCA9555:   combined = input read diffed for the status + a second input
+ *               read for the levels; InputDiff engine = one input read;
+ *  - PCAL9555A: combined = GetInterruptStatus() + input read, edges only
+ *               where the level changed; StatusLatch engine = the same two
+ *               reads, but flagged pins back at their old level count as a
+ *               pulse (both edges).
+ *
+ * The simulated expander latches INT_STATUS on every input change and clears
+ * it when the inputs are read. Each service follows one stimulus on a random
+ * pin: 75 % a level change (one edge), 25 % a pulse that returns before the
+ * service (two edges). The table shows paired reads and modelled 400 kHz
+ * wire time per service, host time per service on the simulated expander, and
+ * the edges delivered to a subscriber out of those that happened.
+ *
+ * It then checks that StatusLatch also delivers changes INT_STATUS does not
+ * name: a pin that changes between the INT_STATUS read and the input read
+ * (the input read clears it), and a pin whose interrupt is masked. The
+ * program exits 1 if either edge is lost.
+ *
+ * Usage: pcal95555_interrupt_engines_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+using pcal95555::bench::SimBus;
+using Driver = pcal95555::PCAL95555<SimBus>;
+
+uint64_t g_edges = 0;
+
+/// The service before the engine split, on the public API.
+void combinedService(Driver& driver, uint16_t& previous) {
+  uint16_t status = 0;
+  if (driver.GetChipVariant() == pcal95555::ChipVariant::PCAL9555A) {
+    status = driver.GetInterruptStatus();
+  } else {
+    status = static_cast<uint16_t>(driver.ReadAllInputs() ^ previous);
+  }
+  const uint16_t current = driver.ReadAllInputs();
+  for (uint8_t pin = 0; pin < 16; ++pin) {
+    if ((status & (1U << pin)) == 0) {
+      continue;
+    }
+    const bool was = (previous & (1U << pin)) != 0;
+    const bool is = (current & (1U << pin)) != 0;
+    g_edges += (was != is) ? 1 : 0;
+  }
+  previous = current;
+}
+
+struct Result {
+  const char* chip;
+  const char* path;
+  uint32_t services;
+  uint64_t reads;
+  uint64_t wire_us;
+  double host_ns;
+  uint64_t edges;
+  uint64_t expected;
+};
+
+/// Runs @p services stimulus/service pairs; returns counts and best-of-3 host time.
+Result run(pcal95555::ChipVariant variant, bool engine, uint32_t services) {
+  Result result{variant == pcal95555::ChipVariant::PCAL9555A ? "PCAL9555A" : "PCA9555", "", services, 0, 0, 0, 0, 0};
+  for (int pass = 0; pass < 3; ++pass) {
+    SimBus bus;
+    bus.SetVariant(pcal95555::bench::kSimBaseAddr, variant);
+    Driver driver(&bus, 0x20, variant);
+    driver.EnsureInitialized();
+    driver.Subscribe(0xFFFF, InterruptEdge::Both, [](const pcal95555::PinEvents& ev) {
+      g_edges += static_cast<uint64_t>(std::popcount(ev.rising) + std::popcount(ev.falling));
+    });
+    result.path = engine ? (driver.GetInterruptEngine() == pcal95555::InterruptEngine::StatusLatch ? "StatusLatch"
+                                                                                                     : "InputDiff")
+                         : "combined";
+    uint16_t previous = driver.ReadAllInputs();
+    const uint64_t reads0 = bus.reads;
+    const uint64_t wire0 = bus.wire_us;
+    g_edges = 0;
+    uint64_t expected = 0;
+    uint32_t rng = 12345;
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < services; ++i) {
+      rng = rng * 1664525U + 1013904223U;
+      const bool pulse = (rng >> 30) == 0;  // 25 %
+      const auto bit = static_cast<uint16_t>(1U << ((rng >> 16) & 15));
+      bus.Stimulate(pulse ? 0 : bit, pulse ? bit : 0);
+      expected += pulse ? 2 : 1;
+      if (engine) {
+        driver.HandleInterrupt();
+      } else {
+        combinedService(driver, previous);
+      }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / services;
+    result.host_ns = (pass == 0) ? ns : std::min(result.host_ns, ns);
+    result.reads = bus.reads - reads0;
+    result.wire_us = bus.wire_us - wire0;
+    result.edges = g_edges;
+    result.expected = expected;
+  }
+  return result;
+}
+
+/// SimBus whose inputs change right after the next INT_STATUS read.
+class RacingBus : public pcal95555::I2cInterface<RacingBus> {
+public:
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    return sim.Write(addr, reg, data, len);
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    const bool ok = sim.Read(addr, reg, data, len);
+    if (reg == static_cast<uint8_t>(Pcal95555Reg::INT_STATUS_0) && race != 0) {
+      sim.Stimulate(race);  // latched too, but the coming input read clears it
+      race = 0;
+    }
+    return ok;
+  }
+
+  bool EnsureInitialized() noexcept { return true; }
+
+  SimBus sim;
+  uint16_t race = 0;  ///< Pins to flip after the next INT_STATUS read
+};
+
+/// StatusLatch edges for pins INT_STATUS does not name; false if one is lost.
+bool checkUnflaggedChanges() {
+  RacingBus bus;
+  pcal95555::PCAL95555<RacingBus> driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  uint16_t rising = 0;
+  uint16_t falling = 0;
+  driver.Subscribe(0xFFFF, InterruptEdge::Both, [&](const pcal95555::PinEvents& ev) {
+    rising = static_cast<uint16_t>(rising | ev.rising);
+    falling = static_cast<uint16_t>(falling | ev.falling);
+  });
+
+  // Pin 3 changes between the two reads of the service that pin 0 triggered
+  bus.sim.Stimulate(0x0001);
+  bus.race = 0x0008;
+  driver.HandleInterrupt();
+  const bool raced = rising == 0x0009 && falling == 0;
+  // Pin 5 has its interrupt masked: it never appears in INT_STATUS
+  rising = falling = 0;
+  bus.sim.SetInputs(static_cast<uint16_t>(bus.sim.Inputs() | 0x0020));
+  bus.sim.Stimulate(0x0001);
+  driver.HandleInterrupt();
+  const bool masked = rising == 0x0020 && falling == 0x0001;
+
+  std::printf("StatusLatch, change after the INT_STATUS read: %s; masked pin: %s\n", raced ? "delivered" : "LOST",
+              masked ? "delivered" : "LOST");
+  return raced && masked;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 1'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const Result results[] = {
+      run(pcal95555::ChipVariant::PCA9555, false, calls),
+      run(pcal95555::ChipVariant::PCA9555, true, calls),
+      run(pcal95555::ChipVariant::PCAL9555A, false, calls),
+      run(pcal95555::ChipVariant::PCAL9555A, true, calls),
+  };
+
+  std::printf("PCAL95555 interrupt service engines\n\n");
+  std::printf("%u services; 25 %% of stimuli are pulses that return before the service\n", calls);
+  std::printf("%-10s %-12s %10s %10s %10s %12s\n", "chip", "path", "reads/svc", "wire us", "host ns", "edges seen");
+  for (const Result& r : results) {
+    std::printf("%-10s %-12s %10.2f %10.1f %10.1f %11.1f%%\n", r.chip, r.path,
+                static_cast<double>(r.reads) / r.services, static_cast<double>(r.wire_us) / r.services, r.host_ns,
+                100.0 * static_cast<double>(r.edges) / static_cast<double>(r.expected));
+  }
+
+  std::printf("\n");
+  const bool unflagged_ok = checkUnflaggedChanges();
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"paths\": [\n", calls);
+    for (size_t i = 0; i < std::size(results); ++i) {
+      const Result& r = results[i];
+      report.Printf("    {\"chip\": \"%s\", \"path\": \"%s\", \"reads\": %llu, \"wire_us\": %llu, \"host_ns\": %.2f, "
+                    "\"edges\": %llu, \"expected_edges\": %llu}%s\n",
+                    r.chip, r.path, static_cast<unsigned long long>(r.reads),
+                    static_cast<unsigned long long>(r.wire_us), r.host_ns, static_cast<unsigned long long>(r.edges),
+                    static_cast<unsigned long long>(r.expected), report.Sep(i, std::size(results)));
+    }
+    report.Printf("  ],\n  \"unflagged_changes_delivered\": %s\n}\n", unflagged_ok ? "true" : "false");
+  }
+  return (report.Failed() || !unflagged_ok) ? 1 : 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file interrupt_moderation_benchmark.cpp
+ * @brief Bus time and latency of per-edge, moderated, polled and adaptive service
+ *
+ * Simulates an expander whose inputs change at random (Poisson) times and a
+ * 400 kHz bus whose clock advances by the modelled wire time of every
+ * transaction. The expander latches changes in its interrupt status and
+ * asserts INT until the inputs are read, like the real part. The interrupt
+ * task calls PCAL95555::ServiceInterrupts() on every INT edge and whenever
+ * InterruptModerator::NextWakeUs() elapses.
+ *
+ * Part 1 sweeps the event rate with the moderator fixed to each mode and in
+ * adaptive mode, and reports bus utilization, services per second and the
+ * mean delay from an input change to the end of the service that reports it.
+ *
+ * Part 2 ramps the rate up and down again in adaptive mode and lists the
+ * mode transitions and the bus time it used against per-edge service.
+ *
+ * Finally a PCA9555 pin toggles twice per poll period, so every poll reads it
+ * unchanged; the moderator must still see the load through the INT edges and
+ * stay in Polling. The program exits 1 if it leaves.
+ *
+ * Usage: pcal95555_interrupt_moderation_benchmark [--seconds=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using pcal95555::bench::SimBus;
+
+uint64_t g_now_us = 0;  // simulated time, advanced by the bus
+
+uint64_t g_rng = 0x9E3779B97F4A7C15ULL;
+
+uint64_t nextRandom() noexcept {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+double exponentialUs(double rate_hz) noexcept {
+  const double u = (static_cast<double>(nextRandom() >> 11) + 0.5) / 9007199254740992.0;
+  return -std::log(u) / rate_hz * 1e6;
+}
+
+/// Event rate as a function of time.
+using RateFn = double (*)(uint64_t t_us, double param);
+
+struct RunResult {
+  double busy_fraction;
+  double services_per_s;
+  double mean_latency_us;
+  pcal95555::ModerationStats stats;
+  pcal95555::ServiceMode final_mode;
+  std::vector<pcal95555::ModeTransition> transitions;
+};
+
+std::vector<pcal95555::ModeTransition>* g_transitions = nullptr;
+
+RunResult run(const pcal95555::ModerationConfig& config, RateFn rate_fn, double param, uint64_t duration_us) {
+  g_now_us = 0;
+  SimBus bus;
+  bus.clock = &g_now_us;
+  pcal95555::PCAL95555<SimBus> driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  pcal95555::InterruptModerator moderator(config);
+  RunResult result{};
+  g_transitions = &result.transitions;
+  moderator.SetTransitionCallback([](const pcal95555::ModeTransition& t) { g_transitions->push_back(t); });
+  const uint64_t busy0 = bus.wire_us;
+
+  std::vector<uint64_t> unserviced;  // times of changes not yet reported
+  double latency_sum = 0;
+  uint64_t latency_count = 0;
+  auto service = [&](bool edge) {
+    if (driver.ServiceInterrupts(moderator, g_now_us, edge)) {
+      for (const uint64_t t : unserviced) {
+        latency_sum += static_cast<double>(g_now_us - t);  // until the service completed
+      }
+      latency_count += unserviced.size();
+      unserviced.clear();
+    }
+  };
+
+  double next_event = static_cast<double>(g_now_us) + exponentialUs(rate_fn(g_now_us, param));
+  while (g_now_us < duration_us) {
+    const uint32_t wait = moderator.NextWakeUs(g_now_us);
+    const double wake = wait == pcal95555::InterruptModerator::kNoWake ? 1e30 : static_cast<double>(g_now_us + wait);
+    if (next_event <= wake) {
+      g_now_us = std::max<uint64_t>(g_now_us, static_cast<uint64_t>(next_event));
+      const auto pin = static_cast<unsigned>(nextRandom() % 8);
+      const bool edge = bus.Stimulate(static_cast<uint16_t>(1U << pin));
+      unserviced.push_back(g_now_us);
+      next_event += exponentialUs(rate_fn(g_now_us, param));
+      if (edge) {
+        service(true);
+      }
+    } else {
+      g_now_us = static_cast<uint64_t>(wake);
+      service(false);
+    }
+  }
+  const double seconds = static_cast<double>(duration_us) / 1e6;
+  result.busy_fraction = static_cast<double>(bus.wire_us - busy0) / static_cast<double>(duration_us);
+  result.stats = moderator.Stats();
+  result.final_mode = moderator.Mode();
+  result.services_per_s = result.stats.services / seconds;
+  result.mean_latency_us = latency_count != 0 ? latency_sum / static_cast<double>(latency_count) : 0;
+  return result;
+}
+
+double constantRate(uint64_t /*t_us*/, double rate_hz) {
+  return rate_hz;
+}
+
+/// 50 Hz, ramping to 20 kHz and back down over @p seconds.
+double rampRate(uint64_t t_us, double seconds) {
+  const double x = static_cast<double>(t_us) / (seconds * 1e6);  // 0..1
+  const double tri = x < 0.5 ? 2 * x : 2 * (1 - x);
+  return 50.0 * std::pow(400.0, tri);
+}
+
+const char* modeName(pcal95555::ServiceMode mode) {
+  switch (mode) {
+    case pcal95555::ServiceMode::PerEdge:
+      return "per-edge";
+    case pcal95555::ServiceMode::Moderated:
+      return "moderated";
+    case pcal95555::ServiceMode::Polling:
+      return "polling";
+  }
+  return "?";
+}
+
+/// Two toggles per poll period: the polls see no change, only the edges show the load.
+bool staysPollingOnDoubleToggle() {
+  g_now_us = 0;
+  SimBus bus;
+  bus.clock = &g_now_us;
+  bus.SetVariant(0x20, pcal95555::ChipVariant::PCA9555);
+  pcal95555::PCAL95555<SimBus> driver(&bus, 0x20, pcal95555::ChipVariant::PCA9555);
+  driver.EnsureInitialized();
+  // 1 ms polls, 2 kHz of changes, 1 kHz of INT edges
+  pcal95555::InterruptModerator moderator(
+      {.poll_enter_hz = 1000, .poll_exit_hz = 500, .initial_mode = pcal95555::ServiceMode::Polling});
+  uint64_t next_toggle = 250;
+  while (g_now_us < 1000000) {
+    const uint32_t wait = moderator.NextWakeUs(g_now_us);
+    const uint64_t wake = wait == pcal95555::InterruptModerator::kNoWake ? UINT64_MAX : g_now_us + wait;
+    if (next_toggle <= wake) {
+      g_now_us = std::max(g_now_us, next_toggle);
+      next_toggle += 500;
+      if (bus.Stimulate(0x0001)) {
+        driver.ServiceInterrupts(moderator, g_now_us, true);
+      }
+    } else {
+      g_now_us = wake;
+      driver.ServiceInterrupts(moderator, g_now_us, false);
+    }
+  }
+  const pcal95555::ModerationStats& stats = moderator.Stats();
+  const bool ok = moderator.Mode() == pcal95555::ServiceMode::Polling && stats.transitions == 0;
+  std::printf("\npin toggling twice per poll (PCA9555): %u edges, %u changes found, %u transitions, %s\n",
+              stats.edges, stats.events, stats.transitions, ok ? "stays polling" : "LEFT polling");
+  return ok;
+}
+
+struct SweepRow {
+  double rate_hz;
+  const char* policy;
+  RunResult result;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  double seconds = 2;
+  pcal95555::bench::Cli cli;
+  cli.Option("seconds", seconds, 0.001);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+  const auto duration_us = static_cast<uint64_t>(seconds * 1e6);
+
+  struct Policy {
+    const char* name;
+    pcal95555::ModerationConfig config;
+  };
+  const Policy policies[] = {
+      {"per-edge", {.initial_mode = pcal95555::ServiceMode::PerEdge, .adaptive = false}},
+      {"moderated", {.initial_mode = pcal95555::ServiceMode::Moderated, .adaptive = false}},
+      {"polling", {.initial_mode = pcal95555::ServiceMode::Polling, .adaptive = false}},
+      {"adaptive", {}},
+  };
+  static constexpr double kRates[] = {10, 100, 500, 2000, 10000};
+
+  std::vector<SweepRow> sweep;
+  for (const double rate : kRates) {
+    for (const Policy& policy : policies) {
+      sweep.push_back({rate, policy.name, run(policy.config, constantRate, rate, duration_us)});
+    }
+  }
+  const double ramp_seconds = 4 * seconds;
+  const RunResult ramp = run({}, rampRate, ramp_seconds, static_cast<uint64_t>(ramp_seconds * 1e6));
+  const RunResult ramp_edge = run({.adaptive = false}, rampRate, ramp_seconds,
+                                  static_cast<uint64_t>(ramp_seconds * 1e6));
+
+  std::printf("PCAL95555 interrupt moderation, simulated 400 kHz bus, %.1f s per run\n\n", seconds);
+  std::printf("%9s %-10s %8s %12s %14s %10s\n", "rate Hz", "policy", "bus %", "services/s", "mean delay us",
+              "final mode");
+  for (const SweepRow& row : sweep) {
+    std::printf("%9.0f %-10s %7.1f%% %12.0f %14.0f %10s\n", row.rate_hz, row.policy, 100 * row.result.busy_fraction,
+                row.result.services_per_s, row.result.mean_latency_us,
+                modeName(row.result.final_mode));
+  }
+
+  std::printf("\nramp 50 Hz -> 20 kHz -> 50 Hz over %.1f s (adaptive):\n", ramp_seconds);
+  for (const pcal95555::ModeTransition& t : ramp.transitions) {
+    std::printf("  %8.3f s  %-9s -> %-9s at %6u Hz\n", static_cast<double>(t.time_us) / 1e6, modeName(t.from),
+                modeName(t.to), t.rate_hz);
+  }
+  std::printf("  bus: adaptive %.1f%%, per-edge %.1f%%\n", 100 * ramp.busy_fraction, 100 * ramp_edge.busy_fraction);
+  std::printf("  stats: %u edges, %u changes, %u services (%u empty), bus_us_saved %.1f ms\n", ramp.stats.edges,
+              ramp.stats.events, ramp.stats.services, ramp.stats.empty_services,
+              static_cast<double>(ramp.stats.bus_us_saved) / 1000.0);
+
+  const bool double_toggle_ok = staysPollingOnDoubleToggle();
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"seconds\": %.3f,\n  \"sweep\": [\n", seconds);
+    for (size_t i = 0; i < sweep.size(); ++i) {
+      const SweepRow& row = sweep[i];
+      report.Printf("    {\"rate_hz\": %.0f, \"policy\": \"%s\", \"busy\": %.4f, \"services_per_s\": %.1f, "
+                    "\"mean_latency_us\": %.1f}%s\n",
+                    row.rate_hz, row.policy, row.result.busy_fraction, row.result.services_per_s,
+                    row.result.mean_latency_us, report.Sep(i, sweep.size()));
+    }
+    report.Printf("  ],\n  \"ramp\": {\"busy\": %.4f, \"per_edge_busy\": %.4f, \"bus_us_saved\": %lld, ",
+                  ramp.busy_fraction, ramp_edge.busy_fraction, static_cast<long long>(ramp.stats.bus_us_saved));
+    report.Printf("\"transitions\": [");
+    for (size_t i = 0; i < ramp.transitions.size(); ++i) {
+      const pcal95555::ModeTransition& t = ramp.transitions[i];
+      report.Printf("%s{\"time_us\": %llu, \"from\": \"%s\", \"to\": \"%s\", \"rate_hz\": %u}", i == 0 ? "" : ", ",
+                    static_cast<unsigned long long>(t.time_us), modeName(t.from), modeName(t.to), t.rate_hz);
+    }
+    report.Printf("]},\n  \"double_toggle_stays_polling\": %s\n}\n", double_toggle_ok ? "true" : "false");
+  }
+  return (report.Failed() || !double_toggle_ok) ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file output_compositor_benchmark.cpp
+ * @brief Bus traffic and cost of pcal95555::OutputCompositor
+ *
+ * Simulates two seconds of four clients sharing the outputs of one expander,
+ * stepped in 1 ms ticks:
+ *  - status:  pins 0-3, a counter pattern at 50 Hz;
+ *  - leds:    pins 4-11, a running light at 200 Hz;
+ *  - buzzer:  pins 12-15, toggled at 10 Hz;
+ *  - fault:   forces pins 0-11 to a fixed pattern from 0.5 s to 1.5 s.
+ *
+ * The run is done twice. With per-client read-modify-write every update is
+ * a WritePins<Pins<...>>() (one paired read + one paired write), and the
+ * fault override is lost as soon as another client writes. With the
+ * compositor every update is SetLayer() + ComposeOutputs(), which writes
+ * only when the composed image changed. The table shows the transactions,
+ * the modelled 400 kHz wire time, and the milliseconds in which the pins did
+ * not show the intended (composed) image.
+ *
+ * The host cost of ComposeOutputs() is timed on the simulated expander,
+ * for an unchanged image (no bus access) and a changed one (one write).
+ *
+ * Usage: pcal95555_output_compositor_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+using pcal95555::bench::SimBus;
+using Driver = pcal95555::PCAL95555<SimBus>;
+
+enum : size_t { kStatus = 0, kLeds = 1, kBuzzer = 2, kFault = 3 };
+constexpr uint16_t kFaultMask = 0x0FFF;
+constexpr uint16_t kFaultPattern = 0x0555;
+
+struct Result {
+  const char* name;
+  uint64_t updates;
+  uint64_t reads;
+  uint64_t writes;
+  uint64_t wire_us;
+  uint64_t wrong_ms;
+};
+
+/// Runs the scenario; @p composed selects the compositor or per-client RMW.
+Result simulate(bool composed) {
+  SimBus bus;
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  pcal95555::OutputCompositor<4> outputs;
+  const uint64_t reads0 = bus.reads;
+  const uint64_t writes0 = bus.writes;
+  const uint64_t wire0 = bus.wire_us;
+
+  Result result{composed ? "compositor" : "per-client RMW", 0, 0, 0, 0, 0};
+  uint16_t status = 0;
+  uint16_t leds = 0x0010;
+  uint16_t buzzer = 0;
+  for (uint32_t ms = 0; ms < 2000; ++ms) {
+    const bool fault = ms >= 500 && ms < 1500;
+    if (ms % 20 == 0) {
+      status = static_cast<uint16_t>((status + 1) & 0x000F);
+      ++result.updates;
+      if (composed) {
+        outputs.SetLayer(kStatus, status, 0x000F, 1);
+        driver.ComposeOutputs(outputs);
+      } else {
+        driver.WritePins<pcal95555::Pins<0, 1, 2, 3>>(status);
+      }
+    }
+    if (ms % 5 == 0) {
+      leds = static_cast<uint16_t>(leds << 1);
+      if ((leds & 0x0FF0) == 0) {
+        leds = 0x0010;
+      }
+      ++result.updates;
+      if (composed) {
+        outputs.SetLayer(kLeds, leds, 0x0FF0, 1);
+        driver.ComposeOutputs(outputs);
+      } else {
+        driver.WritePins<pcal95555::Pins<4, 5, 6, 7, 8, 9, 10, 11>>(leds);
+      }
+    }
+    if (ms % 100 == 0) {
+      buzzer = static_cast<uint16_t>(buzzer ^ 0xF000);
+      ++result.updates;
+      if (composed) {
+        outputs.SetLayer(kBuzzer, buzzer, 0xF000, 1);
+        driver.ComposeOutputs(outputs);
+      } else {
+        driver.WritePins<pcal95555::Pins<12, 13, 14, 15>>(buzzer);
+      }
+    }
+    if (ms == 500 || ms == 1500) {
+      if (composed) {
+        ++result.updates;
+        if (fault) {
+          outputs.SetLayer(kFault, kFaultPattern, kFaultMask, 10);
+        } else {
+          outputs.ClearLayer(kFault);
+        }
+        driver.ComposeOutputs(outputs);
+      } else if (fault) {
+        ++result.updates;  // nothing to undo: the clients overwrite the pattern anyway
+        driver.WritePins<pcal95555::Pins<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11>>(kFaultPattern);
+      }
+    }
+    // Intended image: the fault pattern on top of the clients' pins.
+    uint16_t intended = static_cast<uint16_t>(status | leds | buzzer);
+    if (fault) {
+      intended = static_cast<uint16_t>((intended & ~kFaultMask) | kFaultPattern);
+    }
+    if (bus.Outputs() != intended) {
+      ++result.wrong_ms;
+    }
+  }
+  result.reads = bus.reads - reads0;
+  result.writes = bus.writes - writes0;
+  result.wire_us = bus.wire_us - wire0;
+  return result;
+}
+
+volatile uint32_t g_sink = 0;
+
+/// ns per ComposeOutputs() (best of 5); @p change alternates the layer value.
+double timeCompose(uint32_t calls, bool change) {
+  SimBus bus;
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  driver.EnsureInitialized();
+  pcal95555::OutputCompositor<4> outputs;
+  outputs.SetLayer(kStatus, 0x0005, 0x000F, 1);
+  outputs.SetLayer(kLeds, 0x0100, 0x0FF0, 1);
+  outputs.SetLayer(kBuzzer, 0xF000, 0xF000, 1);
+  double best = 0;
+  for (int run = 0; run < 5; ++run) {
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+      outputs.SetLayerValue(kStatus, change ? static_cast<uint16_t>(i) : 0x0005);
+      g_sink = g_sink + static_cast<uint32_t>(driver.ComposeOutputs(outputs));
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 2'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const Result results[] = {simulate(false), simulate(true)};
+  const double unchanged_ns = timeCompose(calls, false);
+  const double changed_ns = timeCompose(calls, true);
+
+  std::printf("PCAL95555 output compositor\n\n");
+  std::printf("simulated 2 s: status 50 Hz, leds 200 Hz, buzzer 10 Hz, fault override 0.5-1.5 s\n");
+  std::printf("%-16s %8s %8s %8s %12s %10s\n", "mode", "updates", "reads", "writes", "wire us", "wrong ms");
+  for (const Result& r : results) {
+    std::printf("%-16s %8llu %8llu %8llu %12llu %10llu\n", r.name, static_cast<unsigned long long>(r.updates),
+                static_cast<unsigned long long>(r.reads), static_cast<unsigned long long>(r.writes),
+                static_cast<unsigned long long>(r.wire_us), static_cast<unsigned long long>(r.wrong_ms));
+  }
+  std::printf("\nhost cost per ComposeOutputs(): unchanged image %.1f ns, changed image %.1f ns\n", unchanged_ns,
+              changed_ns);
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"unchanged_ns\": %.2f,\n  \"changed_ns\": %.2f,\n  \"modes\": [\n", calls,
+                  unchanged_ns, changed_ns);
+    for (size_t i = 0; i < std::size(results); ++i) {
+      const Result& r = results[i];
+      report.Printf("    {\"name\": \"%s\", \"updates\": %llu, \"reads\": %llu, \"writes\": %llu, \"wire_us\": %llu, "
+                    "\"wrong_ms\": %llu}%s\n",
+                    r.name, static_cast<unsigned long long>(r.updates), static_cast<unsigned long long>(r.reads),
+                    static_cast<unsigned long long>(r.writes), static_cast<unsigned long long>(r.wire_us),
+                    static_cast<unsigned long long>(r.wrong_ms), report.Sep(i, std::size(results)));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return report.Failed() ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+/**
+ * @file retarget_benchmark.cpp
+ * @brief Cost of switching one driver between expanders: ChangeAddress() vs RetargetAddress()
+ *
+ * One driver object serves four expanders on the same simulated bus
+ * (0x20/0x22: PCAL9555A, 0x21/0x23: PCA9555), visiting them round-robin
+ * and writing each one's outputs after the switch. The address pins are
+ * hardwired, so SetAddressPins() is not supported, as on most boards.
+ *
+ * ChangeAddress() verifies the device and re-detects the variant at every
+ * switch (on PCA9555 the probe of OUTPUT_CONF is a NACK). RetargetAddress()
+ * does that once per address and then switches from the identity cache.
+ * Halfway through, 0x23 is removed for a while: its writes fail, the
+ * address is forgotten, and the first retarget after it returns verifies
+ * again.
+ *
+ * The table shows, per switch, transactions, modelled 400 kHz wire time
+ * and host time, and the writes that failed.
+ *
+ * It also checks that a switch drops the previous expander's pending
+ * events and edge baseline (no edges made up from another chip's levels),
+ * and exits with status 1 if it does not.
+ *
+ * Usage: pcal95555_retarget_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+using pcal95555::bench::SimBus;
+
+/// Four expanders at 0x20-0x23; odd addresses are PCA9555 (NACK >= 0x40).
+void fourExpanders(SimBus& bus) noexcept {
+  for (uint8_t addr = 0x24; addr <= 0x27; ++addr) {
+    bus.SetPresent(addr, false);
+  }
+  bus.SetVariant(0x21, pcal95555::ChipVariant::PCA9555);
+  bus.SetVariant(0x23, pcal95555::ChipVariant::PCA9555);
+}
+
+using Driver = pcal95555::PCAL95555<SimBus>;
+
+struct Result {
+  const char* path;
+  uint32_t switches;
+  uint64_t transactions;
+  uint64_t wire_us;
+  double host_ns;
+  uint32_t failed_writes;
+};
+
+/// Runs @p switches switch+write rounds; returns counts and best-of-3 host time.
+Result run(bool retarget, uint32_t switches) {
+  Result result{retarget ? "RetargetAddress" : "ChangeAddress", switches, 0, 0, 0, 0};
+  for (int pass = 0; pass < 3; ++pass) {
+    SimBus bus;
+    fourExpanders(bus);
+    Driver driver(&bus, 0x20);
+    driver.SetRetries(0);
+    driver.EnsureInitialized();
+    uint32_t failed = 0;
+    uint64_t switch_transactions = 0;
+    uint64_t switch_wire = 0;
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < switches; ++i) {
+      bus.SetPresent(0x23, !(i >= switches / 2 && i < switches / 2 + 40));
+      const auto addr = static_cast<uint8_t>(0x20 + (i & 3));
+      const uint64_t t0 = bus.Transactions();
+      const uint64_t w0 = bus.wire_us;
+      if (retarget) {
+        driver.RetargetAddress(addr);
+      } else {
+        driver.ChangeAddress(addr);
+      }
+      switch_transactions += bus.Transactions() - t0;
+      switch_wire += bus.wire_us - w0;
+      if (!driver.WriteAllOutputs(static_cast<uint16_t>(i))) {
+        ++failed;
+      }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / switches;
+    result.host_ns = (pass == 0) ? ns : std::min(result.host_ns, ns);
+    result.transactions = switch_transactions;
+    result.wire_us = switch_wire;
+    result.failed_writes = failed;
+  }
+  return result;
+}
+
+/// Edges seen by the subscribers of checkFreshBaseline().
+struct EdgeLog {
+  uint16_t rising = 0;
+  uint16_t falling = 0;
+  uint32_t calls = 0;
+};
+
+/// After a cached switch, the first service reports only edges of the new expander.
+bool checkFreshBaseline() {
+  SimBus bus;
+  fourExpanders(bus);
+  bus.SetInputs(0x0F00, 0x21);
+  bus.SetInputs(0x00F0, 0x22);
+  Driver driver(&bus, 0x20);
+  // Verify every address once, so the switches below come from the cache
+  if (!driver.ChangeAddress(0x21) || !driver.ChangeAddress(0x22) || !driver.ChangeAddress(0x20)) {
+    return false;
+  }
+  EdgeLog log;
+  const auto record = [&log](const pcal95555::PinEvents& ev) {
+    log.rising = static_cast<uint16_t>(log.rising | ev.rising);
+    log.falling = static_cast<uint16_t>(log.falling | ev.falling);
+    ++log.calls;
+  };
+  driver.Subscribe(0xFFFF, InterruptEdge::Both, record);
+  driver.Subscribe(0xFFFF, InterruptEdge::Both, record);
+  driver.SetCallbackBudget(1);
+  bus.Stimulate(0x0001, 0, 0x20);
+  driver.HandleInterrupt();  // one subscriber called, the other deferred
+  const bool deferred = log.calls == 1 && driver.HasDeferredEvents();
+
+  // PCA9555 (InputDiff): the pending 0x20 event is dropped, 0x21 is not diffed against 0x20's levels
+  log = EdgeLog{};
+  const uint64_t transactions = bus.Transactions();
+  const bool cached = driver.RetargetAddress(0x21) && bus.Transactions() == transactions;
+  bus.Stimulate(0x0100, 0, 0x21);
+  driver.HandleInterrupt();
+  const bool diff_clean = !driver.HasDeferredEvents() && log.calls == 0 && !bus.IntAsserted(0x21);
+  bus.Stimulate(0x0200, 0, 0x21);
+  driver.HandleInterrupt();
+  driver.HandleInterrupt();
+  const bool diff_next = log.falling == 0x0200 && log.rising == 0;
+
+  // PCAL9555A (StatusLatch): only the flagged pin, towards its current level
+  log = EdgeLog{};
+  driver.RetargetAddress(0x22);
+  bus.Stimulate(0x0002, 0, 0x22);
+  driver.HandleInterrupt();
+  driver.HandleInterrupt();
+  const bool status_clean = log.rising == 0x0002 && log.falling == 0;
+  return deferred && cached && diff_clean && diff_next && status_clean;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 1'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const Result results[] = {run(false, calls), run(true, calls)};
+  const bool baseline_ok = checkFreshBaseline();
+
+  std::printf("PCAL95555 address switching\n\n");
+  std::printf("%u switches over 4 expanders; 0x23 absent for 40 of them\n", calls);
+  std::printf("%-16s %12s %10s %10s %14s\n", "path", "xfers/switch", "wire us", "host ns", "failed writes");
+  for (const Result& r : results) {
+    std::printf("%-16s %12.3f %10.1f %10.1f %14u\n", r.path, static_cast<double>(r.transactions) / r.switches,
+                static_cast<double>(r.wire_us) / r.switches, r.host_ns, r.failed_writes);
+  }
+  std::printf("\nno stale events or edges after a switch: %s\n", baseline_ok ? "ok" : "FAILED");
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"fresh_baseline\": %s,\n  \"paths\": [\n", calls,
+                  baseline_ok ? "true" : "false");
+    for (size_t i = 0; i < std::size(results); ++i) {
+      const Result& r = results[i];
+      report.Printf("    {\"path\": \"%s\", \"transactions\": %llu, \"wire_us\": %llu, \"host_ns\": %.2f, "
+                    "\"failed_writes\": %u}%s\n",
+                    r.path, static_cast<unsigned long long>(r.transactions), static_cast<unsigned long long>(r.wire_us),
+                    r.host_ns, r.failed_writes, report.Sep(i, std::size(results)));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return (baseline_ok && !report.Failed()) ? 0 : 1;
+}
@@ -0,0 +1,354 @@
+/**
+ * @file subscribers_benchmark.cpp
+ * @brief Cost of interrupt fan-out through PCAL95555::Subscribe()
+ *
+ * Runs HandleInterrupt() against an in-memory register file (no I2C), with
+ * the table holding 0-32 subscribers, in two scenarios:
+ *  - miss: no subscriber listens to the pin that changed (mask test only);
+ *  - hit:  every subscriber listens to it (mask test + one call each).
+ * The 0-subscriber row is the fixed cost of HandleInterrupt() itself; the
+ * "per sub" column is the added cost divided by the subscriber count.
+ *
+ * It also checks that subscribers can unsubscribe from inside a callback
+ * (themselves, or one due later in the same pass), that pin and global
+ * callbacks can unregister or replace themselves, that moving a driver
+ * moves its bus interrupt registration and resets the source, and that
+ * destroying a bound driver releases the registration, and exits with
+ * status 1 if any of them misbehaves.
+ *
+ * Usage: pcal95555_subscribers_benchmark [--interrupts=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using pcal95555::bench::SimBus;
+using Driver = pcal95555::PCAL95555<SimBus>;
+using Clock = std::chrono::steady_clock;
+
+struct Row {
+  size_t subscribers;
+  double miss_ns;  // per HandleInterrupt()
+  double hit_ns;
+};
+
+volatile uint32_t g_sink = 0;
+
+/// ns per HandleInterrupt() with @p count subscribers on @p pin_mask (best of 5).
+double measure(size_t count, uint16_t pin_mask, uint32_t interrupts) {
+  SimBus bus;
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  uint32_t calls = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (driver.Subscribe(pin_mask, InterruptEdge::Both, [&calls](const pcal95555::PinEvents& ev) {
+          calls += static_cast<uint32_t>(ev.rising | ev.falling);
+        }) < 0) {
+      std::fprintf(stderr, "Subscribe() failed at %zu\n", i);
+      std::exit(1);
+    }
+  }
+  double best = 0;
+  for (int run = 0; run < 5; ++run) {
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < interrupts; ++i) {
+      bus.Stimulate(0x0001);
+      driver.HandleInterrupt();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / interrupts;
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  g_sink = g_sink + calls;
+  return best;
+}
+
+/// State of the re-entrancy check; callbacks capture a pointer to it (inline storage is small).
+struct ReentrancyFixture {
+  Driver* driver;
+  int self = -1;
+  int victim = -1;
+  uint32_t self_calls = 0;
+  uint32_t remover_calls = 0;
+  uint32_t victim_calls = 0;
+  uint32_t destroyed = 0;  // SelfRemover destructor calls
+};
+
+/// Calls Unsubscribe() on its own handle and checks that did not destroy it.
+struct SelfRemover {
+  ReentrancyFixture* fixture;
+
+  ~SelfRemover() { ++fixture->destroyed; }
+
+  void operator()(const pcal95555::PinEvents& /*ev*/) const noexcept {
+    const uint32_t destroyed = fixture->destroyed;
+    fixture->driver->Unsubscribe(fixture->self);
+    fixture->self_calls += (fixture->destroyed == destroyed) ? 1 : 1000;
+  }
+};
+
+/// Unsubscribe() from inside callbacks: the running callable survives, removed ones are not called.
+bool unsubscribeFromCallback() {
+  SimBus bus;
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  ReentrancyFixture f{&driver};
+  f.self = driver.Subscribe(0x0001, InterruptEdge::Both, SelfRemover{&f});
+  const int remover = driver.Subscribe(0x0001, InterruptEdge::Both, [&f](const pcal95555::PinEvents&) {
+    ++f.remover_calls;
+    f.driver->Unsubscribe(f.victim);  // due later in this pass
+  });
+  f.victim = driver.Subscribe(0x0001, InterruptEdge::Both, [&f](const pcal95555::PinEvents&) { ++f.victim_calls; });
+  if (f.self != 0 || remover != 1 || f.victim != 2) {
+    return false;
+  }
+  for (int i = 0; i < 2; ++i) {
+    bus.Stimulate(0x0001);
+    driver.HandleInterrupt();
+  }
+  // Both slots are free again once the pass is over
+  const auto noop = [](const pcal95555::PinEvents&) {};
+  return f.self_calls == 1 && f.remover_calls == 2 && f.victim_calls == 0 && driver.GetSubscriberCount() == 1 &&
+         driver.Subscribe(0x0001, InterruptEdge::Both, noop) == 0 &&
+         driver.Subscribe(0x0001, InterruptEdge::Both, noop) == 2;
+}
+
+/// State of the setter re-entrancy check.
+struct SetterFixture {
+  Driver* driver;
+  uint32_t destroyed = 0;  // destructor calls of the callables below
+  uint32_t irq_calls = 0;  // each call adds 1, or 1000 if its callable was destroyed while running
+  uint32_t irq_replacement_calls = 0;
+  uint32_t pin0_calls = 0;
+  uint32_t pin1_calls = 0;
+  uint32_t pin1_replacement_calls = 0;
+};
+
+/// Global callback that replaces itself.
+struct IrqReplacer {
+  SetterFixture* fixture;
+
+  ~IrqReplacer() { ++fixture->destroyed; }
+
+  void operator()(uint16_t /*status*/) const noexcept {
+    const uint32_t destroyed = fixture->destroyed;
+    fixture->driver->SetInterruptCallback([f = fixture](uint16_t) { ++f->irq_replacement_calls; });
+    fixture->irq_calls += (fixture->destroyed == destroyed) ? 1 : 1000;
+  }
+};
+
+/// Pin callback that unregisters itself.
+struct PinUnregisterer {
+  SetterFixture* fixture;
+
+  ~PinUnregisterer() { ++fixture->destroyed; }
+
+  void operator()(uint8_t pin, bool /*state*/) const noexcept {
+    const uint32_t destroyed = fixture->destroyed;
+    fixture->driver->UnregisterPinInterrupt(pin);
+    fixture->pin0_calls += (fixture->destroyed == destroyed) ? 1 : 1000;
+  }
+};
+
+/// Pin callback that registers a replacement for itself.
+struct PinReplacer {
+  SetterFixture* fixture;
+
+  ~PinReplacer() { ++fixture->destroyed; }
+
+  void operator()(uint8_t pin, bool /*state*/) const noexcept {
+    const uint32_t destroyed = fixture->destroyed;
+    fixture->driver->RegisterPinInterrupt(pin, InterruptEdge::Both,
+                                          [f = fixture](uint8_t, bool) { ++f->pin1_replacement_calls; });
+    fixture->pin1_calls += (fixture->destroyed == destroyed) ? 1 : 1000;
+  }
+};
+
+/// RegisterPinInterrupt(), UnregisterPinInterrupt() and SetInterruptCallback() from inside the callback they replace.
+bool settersFromCallback() {
+  SimBus bus;
+  Driver driver(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  SetterFixture f{&driver};
+  driver.SetInterruptCallback(IrqReplacer{&f});
+  if (!driver.RegisterPinInterrupt(0, InterruptEdge::Both, PinUnregisterer{&f}) ||
+      !driver.RegisterPinInterrupt(1, InterruptEdge::Both, PinReplacer{&f})) {
+    return false;
+  }
+  for (int i = 0; i < 2; ++i) {
+    bus.Stimulate(0x0003);
+    driver.HandleInterrupt();
+  }
+  // First pass: the originals run once each and survive; second pass: only the replacements
+  return f.irq_calls == 1 && f.irq_replacement_calls == 1 && f.pin0_calls == 1 && f.pin1_calls == 1 &&
+         f.pin1_replacement_calls == 1;
+}
+
+/// SimBus with an INT line: keeps the registered handler and calls it on Fire().
+class IntBus : public pcal95555::I2cInterface<IntBus> {
+public:
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    return sim.Write(addr, reg, data, len);
+  }
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept { return sim.Read(addr, reg, data, len); }
+  bool EnsureInitialized() noexcept { return true; }
+  bool RegisterInterruptHandler(std::function<void()> h) noexcept {
+    if (!accept) {
+      return false;
+    }
+    handler = std::move(h);
+    return true;
+  }
+
+  /// Change pin 0 and call the registered handler.
+  void Fire() {
+    sim.Stimulate(0x0001);
+    if (handler) {
+      handler();
+    }
+  }
+
+  SimBus sim;
+  std::function<void()> handler;
+  bool accept = true;  ///< false: refuse registrations
+};
+
+using IntDriver = pcal95555::PCAL95555<IntBus>;
+
+/// Move a bound driver over another bound one, and move one while the bus refuses the rebind.
+bool moveRebindsHandler() {
+  uint32_t calls = 0;
+  const auto count = [&calls](const pcal95555::PinEvents&) { ++calls; };
+  const uint16_t bind_fail = static_cast<uint16_t>(Error::InterruptBindFail);
+
+  // Assignment: the bus of the source calls the target, the target's old bus calls nobody
+  IntBus bus_a;
+  IntBus bus_b;
+  IntDriver a(&bus_a, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  IntDriver b(&bus_b, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  const int handle = a.Subscribe(0x0001, InterruptEdge::Both, count);
+  if (!a.RegisterInterruptHandler() || !b.RegisterInterruptHandler()) {
+    return false;
+  }
+  b = std::move(a);
+  const bool source_reset = a.GetSubscriberCount() == 0;
+  bus_a.Fire();
+  const bool assigned = source_reset && calls == 1 && (b.GetErrorFlags() & bind_fail) == 0;
+  bus_a.sim.Stimulate(0x0001);
+  bus_b.Fire();  // b reads bus_a: a call here means b's old registration survived
+  const bool released = calls == 1;
+
+  // Construction with a refused rebind: the reset source stays bound and the target reports it
+  IntBus bus_c;
+  IntDriver source(&bus_c, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  source.Subscribe(0x0001, InterruptEdge::Both, count);
+  if (!source.RegisterInterruptHandler()) {
+    return false;
+  }
+  bus_c.accept = false;
+  IntDriver target(std::move(source));
+  bus_c.Fire();  // reaches the reset source: no callbacks left there
+  const bool refused = calls == 1 && (target.GetErrorFlags() & bind_fail) != 0;
+  bus_c.accept = true;
+  const bool rebound = target.RegisterInterruptHandler();
+  bus_c.Fire();
+  return assigned && released && refused && rebound && calls == 2;
+}
+
+/// Destroy a bound driver, then a moved-from one whose registration moved on.
+bool destroyReleasesHandler() {
+  uint32_t calls = 0;
+  const auto count = [&calls](const pcal95555::PinEvents&) { ++calls; };
+
+  IntBus bus;
+  {
+    IntDriver temporary(&bus, 0x20, pcal95555::ChipVariant::PCAL9555A);
+    if (!temporary.RegisterInterruptHandler()) {
+      return false;
+    }
+  }
+  const uint64_t reads = bus.sim.reads;
+  bus.Fire();  // a read here would come from the destroyed driver
+  const bool released = bus.sim.reads == reads;
+
+  IntBus bus_m;
+  std::optional<IntDriver> source(std::in_place, &bus_m, 0x20, pcal95555::ChipVariant::PCAL9555A);
+  source->Subscribe(0x0001, InterruptEdge::Both, count);
+  source->ArmEmergencyStop({});
+  if (!source->RegisterInterruptHandler()) {
+    return false;
+  }
+  IntDriver target(std::move(*source));
+  const bool reset = source->GetSubscriberCount() == 0 && !source->IsEmergencyStopArmed();
+  source.reset();  // must leave the target's registration alone
+  bus_m.Fire();
+  return released && reset && calls == 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t interrupts = 200'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("interrupts", interrupts);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const bool reentrant_ok = Driver::kMaxSubscribers < 3 || unsubscribeFromCallback();
+  const bool setters_ok = settersFromCallback();
+  const bool move_ok = moveRebindsHandler();
+  const bool destroy_ok = destroyReleasesHandler();
+
+  static constexpr size_t kCounts[] = {0, 1, 2, 4, 8, 16, 32};
+  std::vector<Row> rows;
+  for (const size_t count : kCounts) {
+    // miss: subscribers watch port 1 while pin 0 toggles; hit: they watch pin 0
+    rows.push_back({count, measure(count, 0xFF00, interrupts), measure(count, 0x0001, interrupts)});
+  }
+
+  const double base_miss = rows.front().miss_ns;
+  const double base_hit = rows.front().hit_ns;
+  const auto perSub = [](double ns, double base, size_t count) {
+    return count == 0 ? 0.0 : (ns - base) / static_cast<double>(count);
+  };
+  std::printf("PCAL95555 interrupt subscribers: %u interrupts per run, best of 5\n\n", interrupts);
+  std::printf("%11s %12s %12s %12s %12s\n", "subscribers", "miss ns/irq", "miss per sub", "hit ns/irq",
+              "hit per sub");
+  for (const Row& row : rows) {
+    std::printf("%11zu %12.1f %12.2f %12.1f %12.2f\n", row.subscribers, row.miss_ns,
+                perSub(row.miss_ns, base_miss, row.subscribers), row.hit_ns,
+                perSub(row.hit_ns, base_hit, row.subscribers));
+  }
+  std::printf("\nunsubscribe from inside a callback: %s\n", reentrant_ok ? "ok" : "FAILED");
+  std::printf("unregister / replace a callback from inside itself: %s\n", setters_ok ? "ok" : "FAILED");
+  std::printf("interrupt handler follows a moved driver: %s\n", move_ok ? "ok" : "FAILED");
+  std::printf("destroyed driver releases its interrupt handler: %s\n", destroy_ok ? "ok" : "FAILED");
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"interrupts\": %u,\n  \"reentrant_unsubscribe\": %s,\n  \"reentrant_setters\": %s,\n"
+                  "  \"move_rebind\": %s,\n  \"destroy_release\": %s,\n  \"rows\": [\n",
+                  interrupts, reentrant_ok ? "true" : "false", setters_ok ? "true" : "false",
+                  move_ok ? "true" : "false", destroy_ok ? "true" : "false");
+    for (size_t i = 0; i < rows.size(); ++i) {
+      const Row& row = rows[i];
+      report.Printf("    {\"subscribers\": %zu, \"miss_ns\": %.2f, \"miss_ns_per_subscriber\": %.3f, "
+                    "\"hit_ns\": %.2f, \"hit_ns_per_subscriber\": %.3f}%s\n",
+                    row.subscribers, row.miss_ns, perSub(row.miss_ns, base_miss, row.subscribers), row.hit_ns,
+                    perSub(row.hit_ns, base_hit, row.subscribers), report.Sep(i, rows.size()));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return (reentrant_ok && setters_ok && move_ok && destroy_ok && !report.Failed()) ? 0 : 1;
+}
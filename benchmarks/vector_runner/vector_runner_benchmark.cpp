@@ -0,0 +1,297 @@
+/**
+ * @file vector_runner_benchmark.cpp
+ * @brief Throughput of pcal95555::VectorRunner on a simulated test fixture
+ *
+ * Simulates a fixture with two expanders on one 400 kHz bus: the stimulus
+ * device (0x20) drives a board under test whose outputs come back on the
+ * inputs of the sense device (0x21). The board echoes the stimulus after a
+ * 30 us propagation delay, and pin 11 of the echo is stuck low (the fault
+ * the table should find). The simulated clock advances by the modelled
+ * wire time of every transaction and by every sleep.
+ *
+ * The table has 512 vectors: 256 stimulus patterns (walking ones, walking
+ * zeros, counting), each followed by a hold vector that applies the same
+ * stimulus again and checks the response is stable. Every vector asks for
+ * 40 us of settle time. It is run three ways:
+ *  - per-pin:  WritePin() for every stimulus pin, sleep, ReadPin() for every
+ *              compared pin (what fixture scripts written against the pin
+ *              API end up doing);
+ *  - naive:    WriteAllOutputs() for each device, sleep the settle time,
+ *              ReadAllInputs() for each device;
+ *  - runner:   VectorRunner::Run() (skips unchanged writes and unread
+ *              devices, settle as a deadline from the last write).
+ *
+ * The table shows transactions, simulated run time, vectors per second and
+ * failed vectors; all three must find the same failures. The host cost per
+ * vector of Run() is timed with a clock that never waits.
+ *
+ * Usage: pcal95555_vector_runner_benchmark [--calls=N] [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "benchmark_cli.hpp"
+#include "pcal95555.hpp"
+#include "pcal95555_bus_accounting.hpp"
+#include "pcal95555_vector_runner.hpp"
+#include "sim_bus.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint8_t kStimulusAddr = 0x20;
+constexpr uint8_t kSenseAddr = 0x21;
+constexpr uint32_t kPropagationUs = 30;
+constexpr uint32_t kSettleUs = 40;
+constexpr uint16_t kStuckLowMask = 1U << 11;
+
+uint64_t g_sim_us = 0;  // simulated time: wire time of the fixture bus and sleeps
+
+uint64_t SimNowUs() noexcept { return g_sim_us; }
+void SimSleepUs(uint32_t us) noexcept { g_sim_us += us; }
+
+/// The simulated expanders, with the inputs of 0x21 echoing the outputs of 0x20.
+class FixtureBus : public pcal95555::I2cInterface<FixtureBus> {
+public:
+  /// With @p frozen_clock the wire time does not advance g_sim_us.
+  explicit FixtureBus(bool frozen_clock = false) noexcept { sim.clock = frozen_clock ? nullptr : &g_sim_us; }
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    const bool ok = sim.Write(addr, reg, data, len);
+    if (addr == kStimulusAddr) {
+      const uint16_t out = sim.Outputs(kStimulusAddr);
+      if (out != echo_now_) {
+        echo_before_ = echoAt(g_sim_us);
+        echo_now_ = out;
+        echo_since_us_ = g_sim_us;
+      }
+    }
+    return ok;
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    if (addr == kSenseAddr) {
+      // The inputs are sampled as the transfer completes.
+      const uint64_t t = g_sim_us + pcal95555::ModelledWireUs(true, len, pcal95555::bench::kSimBusHz);
+      sim.SetInputs(static_cast<uint16_t>(echoAt(t) & ~kStuckLowMask), kSenseAddr);
+    }
+    return sim.Read(addr, reg, data, len);
+  }
+
+  bool EnsureInitialized() noexcept { return true; }
+
+  pcal95555::bench::SimBus sim;
+
+private:
+  /// Level seen by the sense device at @p t: the new stimulus only after the propagation delay.
+  uint16_t echoAt(uint64_t t) const noexcept {
+    return t >= echo_since_us_ + kPropagationUs ? echo_now_ : echo_before_;
+  }
+
+  uint16_t echo_now_ = 0;
+  uint16_t echo_before_ = 0;
+  uint64_t echo_since_us_ = 0;
+};
+
+using Driver = pcal95555::PCAL95555<FixtureBus>;
+using Vector = pcal95555::TestVector<2>;
+
+std::vector<Vector> makeTable() {
+  std::vector<uint16_t> patterns;
+  for (int pin = 0; pin < 16; ++pin) {
+    patterns.push_back(static_cast<uint16_t>(1U << pin));
+  }
+  for (int pin = 0; pin < 16; ++pin) {
+    patterns.push_back(static_cast<uint16_t>(~(1U << pin)));
+  }
+  for (uint32_t i = 0; patterns.size() < 256; ++i) {
+    patterns.push_back(static_cast<uint16_t>(i * 0x0101U + 0x1357U));
+  }
+  std::vector<Vector> table;
+  for (uint16_t pattern : patterns) {
+    const Vector vector{{pattern, 0x0000}, kSettleUs, {0x0000, pattern}, {0x0000, 0xFFFF}};
+    table.push_back(vector);  // apply the stimulus
+    table.push_back(vector);  // hold: the response must stay stable
+  }
+  return table;
+}
+
+struct Result {
+  const char* name;
+  uint32_t vectors;
+  uint32_t failed;
+  uint64_t reads;
+  uint64_t writes;
+  uint64_t sim_us;
+  uint32_t vectors_per_sec;
+};
+
+/// Stimulus as outputs, sense as inputs; returns the drivers ready to run.
+void setUp(Driver& stimulus, Driver& sense) {
+  stimulus.EnsureInitialized();
+  sense.EnsureInitialized();
+  stimulus.SetMultipleDirections(0xFFFF, GPIODir::Output);
+  sense.SetMultipleDirections(0xFFFF, GPIODir::Input);
+}
+
+Result runPerPin(std::span<const Vector> table) {
+  FixtureBus bus;
+  Driver stimulus(&bus, kStimulusAddr, pcal95555::ChipVariant::PCAL9555A);
+  Driver sense(&bus, kSenseAddr, pcal95555::ChipVariant::PCAL9555A);
+  setUp(stimulus, sense);
+  const uint64_t reads0 = bus.sim.reads;
+  const uint64_t writes0 = bus.sim.writes;
+  const uint64_t start = g_sim_us;
+  Result result{"per-pin", 0, 0, 0, 0, 0, 0};
+  for (const Vector& v : table) {
+    for (uint8_t pin = 0; pin < 16; ++pin) {
+      stimulus.WritePin(pin, ((v.outputs[0] >> pin) & 1U) != 0);
+    }
+    SimSleepUs(v.settle_us);
+    bool failed = false;
+    for (uint8_t pin = 0; pin < 16; ++pin) {
+      if (((v.compare_mask[1] >> pin) & 1U) != 0 &&
+          sense.ReadPin(pin) != (((v.expected[1] >> pin) & 1U) != 0)) {
+        failed = true;
+      }
+    }
+    ++result.vectors;
+    result.failed += failed ? 1 : 0;
+  }
+  result.reads = bus.sim.reads - reads0;
+  result.writes = bus.sim.writes - writes0;
+  result.sim_us = g_sim_us - start;
+  result.vectors_per_sec = static_cast<uint32_t>(uint64_t{result.vectors} * 1000000U / result.sim_us);
+  return result;
+}
+
+Result runNaive(std::span<const Vector> table) {
+  FixtureBus bus;
+  Driver stimulus(&bus, kStimulusAddr, pcal95555::ChipVariant::PCAL9555A);
+  Driver sense(&bus, kSenseAddr, pcal95555::ChipVariant::PCAL9555A);
+  setUp(stimulus, sense);
+  std::array<Driver*, 2> devices{&stimulus, &sense};
+  const uint64_t reads0 = bus.sim.reads;
+  const uint64_t writes0 = bus.sim.writes;
+  const uint64_t start = g_sim_us;
+  Result result{"naive", 0, 0, 0, 0, 0, 0};
+  for (const Vector& v : table) {
+    for (size_t d = 0; d < devices.size(); ++d) {
+      devices[d]->WriteAllOutputs(v.outputs[d]);
+    }
+    SimSleepUs(v.settle_us);
+    bool failed = false;
+    for (size_t d = 0; d < devices.size(); ++d) {
+      uint16_t actual = 0;
+      devices[d]->ReadAllInputs(actual);
+      failed |= ((v.expected[d] ^ actual) & v.compare_mask[d]) != 0;
+    }
+    ++result.vectors;
+    result.failed += failed ? 1 : 0;
+  }
+  result.reads = bus.sim.reads - reads0;
+  result.writes = bus.sim.writes - writes0;
+  result.sim_us = g_sim_us - start;
+  result.vectors_per_sec = static_cast<uint32_t>(uint64_t{result.vectors} * 1000000U / result.sim_us);
+  return result;
+}
+
+Result runRunner(std::span<const Vector> table, uint16_t& first_fail_pins) {
+  FixtureBus bus;
+  Driver stimulus(&bus, kStimulusAddr, pcal95555::ChipVariant::PCAL9555A);
+  Driver sense(&bus, kSenseAddr, pcal95555::ChipVariant::PCAL9555A);
+  setUp(stimulus, sense);
+  pcal95555::VectorRunner<Driver, 2> runner({&stimulus, &sense}, {.now_us = SimNowUs, .sleep_us = SimSleepUs});
+  first_fail_pins = 0;
+  runner.SetMismatchCallback([&first_fail_pins](const pcal95555::VectorMismatch& m) {
+    if (first_fail_pins == 0) {
+      first_fail_pins = static_cast<uint16_t>((m.expected ^ m.actual) & m.mask);
+    }
+  });
+  const uint64_t reads0 = bus.sim.reads;
+  const uint64_t writes0 = bus.sim.writes;
+  const pcal95555::VectorRunStats stats = runner.Run(table);
+  return {"runner", stats.vectors, stats.failed, bus.sim.reads - reads0, bus.sim.writes - writes0, stats.elapsed_us,
+          stats.vectors_per_sec};
+}
+
+volatile uint32_t g_sink = 0;
+
+/// Host ns per vector of Run() (best of 5), with the simulated clock frozen.
+double timeRunner(std::span<const Vector> table, uint32_t calls) {
+  FixtureBus bus(true);
+  Driver stimulus(&bus, kStimulusAddr, pcal95555::ChipVariant::PCAL9555A);
+  Driver sense(&bus, kSenseAddr, pcal95555::ChipVariant::PCAL9555A);
+  setUp(stimulus, sense);
+  // Zero settle: with a frozen clock a deadline would never pass.
+  std::vector<Vector> fast(table.begin(), table.end());
+  for (Vector& v : fast) {
+    v.settle_us = 0;
+  }
+  pcal95555::VectorRunner<Driver, 2> runner({&stimulus, &sense});
+  const uint32_t rounds = std::max<uint32_t>(1, calls / static_cast<uint32_t>(fast.size()));
+  double best = 0;
+  for (int run = 0; run < 5; ++run) {
+    const auto start = Clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) {
+      g_sink = g_sink + runner.Run(fast).failed;
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                      (static_cast<double>(rounds) * fast.size());
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t calls = 1'000'000;
+  pcal95555::bench::Cli cli;
+  cli.Option("calls", calls);
+  if (!cli.Parse(argc, argv)) {
+    return 2;
+  }
+
+  const std::vector<Vector> table = makeTable();
+  uint16_t fail_pins = 0;
+  const Result results[] = {runPerPin(table), runNaive(table), runRunner(table, fail_pins)};
+  const double runner_ns = timeRunner(table, calls);
+
+  std::printf("PCAL95555 vector runner\n\n");
+  std::printf("%zu vectors, 2 devices, %u us settle, %u us propagation, pin 11 stuck low\n", table.size(), kSettleUs,
+              kPropagationUs);
+  std::printf("%-10s %8s %8s %8s %12s %12s %8s\n", "mode", "vectors", "reads", "writes", "sim us", "vectors/s",
+              "failed");
+  for (const Result& r : results) {
+    std::printf("%-10s %8u %8llu %8llu %12llu %12u %8u\n", r.name, r.vectors, static_cast<unsigned long long>(r.reads),
+                static_cast<unsigned long long>(r.writes), static_cast<unsigned long long>(r.sim_us),
+                r.vectors_per_sec, r.failed);
+  }
+  std::printf("\nfirst failing pins reported by the runner: 0x%04X\n", fail_pins);
+  std::printf("host cost per vector in Run(): %.1f ns\n", runner_ns);
+
+  pcal95555::bench::JsonReport report(cli.ReportPath());
+  if (report) {
+    report.Printf("{\n  \"calls\": %u,\n  \"vectors\": %zu,\n  \"runner_ns_per_vector\": %.2f,\n  \"modes\": [\n",
+                  calls, table.size(), runner_ns);
+    for (size_t i = 0; i < std::size(results); ++i) {
+      const Result& r = results[i];
+      report.Printf("    {\"name\": \"%s\", \"vectors\": %u, \"reads\": %llu, \"writes\": %llu, \"sim_us\": %llu, "
+                    "\"vectors_per_sec\": %u, \"failed\": %u}%s\n",
+                    r.name, r.vectors, static_cast<unsigned long long>(r.reads),
+                    static_cast<unsigned long long>(r.writes), static_cast<unsigned long long>(r.sim_us),
+                    r.vectors_per_sec, r.failed, report.Sep(i, std::size(results)));
+    }
+    report.Printf("  ]\n}\n");
+  }
+  return report.Failed() ? 1 : 0;
+}
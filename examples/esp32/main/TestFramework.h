@@ -155,6 +155,20 @@ inline void ensure_gpio14_initialized() noexcept {
   }
 }
 
+//=============================================================================
+// HOST BUILD HOOKS
+//=============================================================================
+// No-ops on target. The host build (examples/host) defines them to split its
+// bus report per test and to exit once the suite has finished.
+
+#ifndef TEST_FRAMEWORK_TEST_HOOK
+#define TEST_FRAMEWORK_TEST_HOOK(name) ((void)0)
+#endif
+
+#ifndef TEST_FRAMEWORK_SUITE_COMPLETE_HOOK
+#define TEST_FRAMEWORK_SUITE_COMPLETE_HOOK(results) ((void)(results))
+#endif
+
 /**
  * @brief Test execution tracking and results accumulation
  */
@@ -215,6 +229,7 @@ struct TestResults {
 #define RUN_TEST(test_func)                                                                        \
   do {                                                                                             \
     ensure_gpio14_initialized();                                                                   \
+    TEST_FRAMEWORK_TEST_HOOK(#test_func);                                                          \
     ESP_LOGI(TAG,                                                                                  \
              "\n"                                                                                  \
              "╔══════════════════════════════════════════════════════════════════════════════╗\n"  \
@@ -286,6 +301,7 @@ inline void test_task_trampoline(void* param) {
 #define RUN_TEST_IN_TASK(name, func, stack_size_bytes, priority)                                   \
   do {                                                                                             \
     ensure_gpio14_initialized();                                                                   \
+    TEST_FRAMEWORK_TEST_HOOK(name);                                                                \
     static TestTaskContext ctx;                                                                    \
     ctx.test_name = name;                                                                          \
     ctx.test_func = func;                                                                          \
@@ -386,7 +402,7 @@ inline void print_test_section_header(const char* tag, const char* section_name,
  * @param section_name Name of the test section
  * @param enabled Whether the section is enabled
  */
-inline void print_test_section_footer(const char* tag, const char* section_name,
+inline void print_test_section_footer(const char* tag, [[maybe_unused]] const char* section_name,
                                       bool enabled = true) noexcept {
   if (enabled) {
     ESP_LOGI(tag,
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include "esp32_pcal95555_interrupt_dispatcher.hpp"
 #include "pcal95555.hpp"
 #include <array>
 #include <cstring>
@@ -26,7 +27,6 @@ extern "C" {
 #include "esp_err.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
 #include "freertos/task.h"
 #ifdef __cplusplus
 }
@@ -56,25 +56,28 @@ public:
   /**
    * @brief Constructor with default configuration
    */
-  Esp32Pcal9555I2cBus() : Esp32Pcal9555I2cBus(I2CConfig{}) {}
+  constexpr Esp32Pcal9555I2cBus() : Esp32Pcal9555I2cBus(I2CConfig{}) {}
 
   /**
    * @brief Constructor with custom I2C configuration
    * @param config I2C bus configuration
+   *
+   * Only stores the configuration; GPIOs and the I2C peripheral are set up by
+   * Init(). The constructor is constexpr so the bus can be declared
+   * `constinit` next to a constinit driver:
+   * @code
+   *   constinit Esp32Pcal9555I2cBus g_bus;
+   *   constinit PCAL95555Driver g_driver(&g_bus, false, false, false);
+   * @endcode
    */
-  explicit Esp32Pcal9555I2cBus(const I2CConfig& config)
-      : config_(config), bus_handle_(nullptr), initialized_(false) {
-    // Initialize address pins as outputs if configured
-    if (config_.a0_pin != GPIO_NUM_NC || config_.a1_pin != GPIO_NUM_NC ||
-        config_.a2_pin != GPIO_NUM_NC) {
-      initAddressPins();
-    }
-  }
+  constexpr explicit Esp32Pcal9555I2cBus(const I2CConfig& config)
+      : config_(config), bus_handle_(nullptr), initialized_(false) {}
 
   /**
    * @brief Destructor - cleans up I2C resources
    */
   ~Esp32Pcal9555I2cBus() {
+    RemoveInterrupt();
     Deinit();
   }
 
@@ -99,6 +102,13 @@ public:
     ESP_LOGI(g_TAG_I2C, "Initializing I2C bus on port %d (SDA:GPIO%d, SCL:GPIO%d, Freq:%lu Hz)",
              config_.port, config_.sda_pin, config_.scl_pin, config_.frequency);
 
+    // Initialize address pins as outputs if configured (the driver sets their
+    // levels through SetAddressPins() right after EnsureInitialized())
+    if (config_.a0_pin != GPIO_NUM_NC || config_.a1_pin != GPIO_NUM_NC ||
+        config_.a2_pin != GPIO_NUM_NC) {
+      initAddressPins();
+    }
+
     // Configure I2C master bus
     i2c_master_bus_config_t bus_config = {};
     bus_config.i2c_port = config_.port;
@@ -222,6 +232,33 @@ public:
     return true;
   }
 
+  /**
+   * @brief Run the transfers of an urgent section at the highest task priority
+   *
+   * The ESP-IDF master driver serialises devices on one bus with a lock;
+   * raising the calling task's priority for the urgent section (the writes of
+   * PCAL95555::EmergencyStop()) gets it the lock ahead of lower-priority
+   * tasks waiting on the same bus. The previous priority is restored by
+   * SetUrgent(false). Only the calling task is affected: the bus is shared
+   * by several drivers and tasks, so the saved priority is kept per task,
+   * and nested sections (a task urgent on two buses) restore it once, at
+   * the end of the outermost one.
+   *
+   * @param urgent true at the start of the urgent section, false at its end
+   */
+  void SetUrgent(bool urgent) noexcept {
+    thread_local UBaseType_t saved_priority = 0;  // per task, across every bus
+    thread_local uint8_t depth = 0;
+    if (urgent) {
+      if (depth++ == 0) {
+        saved_priority = uxTaskPriorityGet(nullptr);
+        vTaskPrioritySet(nullptr, configMAX_PRIORITIES - 1);
+      }
+    } else if (depth != 0 && --depth == 0) {
+      vTaskPrioritySet(nullptr, saved_priority);
+    }
+  }
+
   /**
    * @brief Get the I2C configuration
    * @return Reference to the I2C configuration
@@ -315,9 +352,10 @@ public:
    * @brief Register interrupt handler for PCAL95555 INT pin
    *
    * This method implements the I2cInterface::RegisterInterruptHandler() method.
-   * It configures the ESP32 GPIO pin connected to the PCAL95555 INT pin and sets
-   * up an interrupt handler that will call the provided handler function when an
-   * interrupt occurs.
+   * It registers the INT GPIO as a source of the shared
+   * Esp32Pcal9555InterruptDispatcher: the ISR only flags the source, and the
+   * one interrupt task shared by all bus instances calls @p handler.
+   * Calling it again replaces the handler.
    *
    * @param handler Function to call when INT pin interrupt occurs
    * @return true if setup successful, false otherwise
@@ -344,62 +382,17 @@ public:
       return false;
     }
 
-    // Configure GPIO pin for interrupt if not already configured
-    if (interrupt_queue_ == nullptr) {
-      gpio_config_t io_conf = {};
-      io_conf.intr_type = GPIO_INTR_NEGEDGE; // Falling edge (active low)
-      io_conf.pin_bit_mask = (1ULL << interrupt_pin_);
-      io_conf.mode = GPIO_MODE_INPUT;
-      io_conf.pull_up_en = GPIO_PULLUP_ENABLE; // Enable pull-up (INT is open-drain)
-      io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-
-      esp_err_t ret = gpio_config(&io_conf);
-      if (ret != ESP_OK) {
-        ESP_LOGE(g_TAG_I2C, "Failed to configure GPIO %d for interrupt: %s", interrupt_pin_,
-                 esp_err_to_name(ret));
-        return false;
-      }
-
-      // Create interrupt queue
-      interrupt_queue_ = xQueueCreate(10, sizeof(uint32_t));
-      if (interrupt_queue_ == nullptr) {
-        ESP_LOGE(g_TAG_I2C, "Failed to create interrupt queue");
-        return false;
-      }
-
-      // Install GPIO ISR service if not already installed
-      static bool isr_service_installed = false;
-      if (!isr_service_installed) {
-        ret = gpio_install_isr_service(0);
-        if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
-          ESP_LOGE(g_TAG_I2C, "Failed to install GPIO ISR service: %s", esp_err_to_name(ret));
-          return false;
-        }
-        isr_service_installed = true;
-      }
-
-      // Hook ISR handler for this pin
-      ret = gpio_isr_handler_add(interrupt_pin_, interruptHandler, this);
-      if (ret != ESP_OK) {
-        ESP_LOGE(g_TAG_I2C, "Failed to add ISR handler for GPIO %d: %s", interrupt_pin_,
-                 esp_err_to_name(ret));
-        return false;
-      }
-
-      // Create task to process interrupts
-      if (interruptTask_handle_ == nullptr) {
-        xTaskCreate(interruptTask, "pcal9555_int", 4096, this, 5, &interruptTask_handle_);
-        if (interruptTask_handle_ == nullptr) {
-          ESP_LOGE(g_TAG_I2C, "Failed to create interrupt task");
-          return false;
-        }
-      }
+    // All buses share one ISR service and one worker task
+    const int source = Esp32Pcal9555InterruptDispatcher::Instance().AddSource(
+        interrupt_pin_, interrupt_priority_, std::move(handler));
+    if (source < 0) {
+      ESP_LOGE(g_TAG_I2C, "Failed to register interrupt source for GPIO %d", interrupt_pin_);
+      return false;
     }
+    interrupt_source_ = source;
 
-    // Store handler for interrupt processing
-    interrupt_callback_ = handler;
-
-    ESP_LOGI(g_TAG_I2C, "Interrupt handler registered on GPIO %d", interrupt_pin_);
+    ESP_LOGI(g_TAG_I2C, "Interrupt handler registered on GPIO %d (priority %u)", interrupt_pin_,
+             interrupt_priority_);
     return true;
   }
 
@@ -410,10 +403,16 @@ public:
    * Must be called before RegisterInterruptHandler().
    *
    * @param int_pin GPIO pin number connected to PCAL95555 INT pin
+   * @param priority Service order when several expanders' INT lines are pending
+   *                 at once (higher first, see Esp32Pcal9555InterruptDispatcher)
    * @return true if setup successful, false otherwise
    */
-  bool SetupInterruptPin(gpio_num_t int_pin) noexcept {
+  bool SetupInterruptPin(gpio_num_t int_pin, uint8_t priority = 0) noexcept {
+    if (interrupt_source_ >= 0 && int_pin != interrupt_pin_) {
+      RemoveInterrupt(); // moving to another GPIO: stop routing the old one
+    }
     interrupt_pin_ = int_pin;
+    interrupt_priority_ = priority;
     ESP_LOGI(g_TAG_I2C, "Interrupt pin configured: GPIO %d", int_pin);
     return true;
   }
@@ -424,83 +423,19 @@ public:
    */
   [[deprecated("Use SetupInterruptPin() + RegisterInterruptHandler() instead")]]
   bool SetupInterrupt(gpio_num_t int_pin, std::function<void()> interrupt_callback) noexcept {
-    if (!interrupt_callback) {
-      ESP_LOGE(g_TAG_I2C, "Interrupt callback is null");
-      return false;
-    }
-
-    // Configure GPIO pin for interrupt
-    gpio_config_t io_conf = {};
-    io_conf.intr_type = GPIO_INTR_NEGEDGE; // Falling edge (active low)
-    io_conf.pin_bit_mask = (1ULL << int_pin);
-    io_conf.mode = GPIO_MODE_INPUT;
-    io_conf.pull_up_en = GPIO_PULLUP_ENABLE; // Enable pull-up (INT is open-drain)
-    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-
-    esp_err_t ret = gpio_config(&io_conf);
-    if (ret != ESP_OK) {
-      ESP_LOGE(g_TAG_I2C, "Failed to configure GPIO %d for interrupt: %s", int_pin,
-               esp_err_to_name(ret));
-      return false;
-    }
-
-    // Create interrupt queue if not exists
-    if (interrupt_queue_ == nullptr) {
-      interrupt_queue_ = xQueueCreate(10, sizeof(uint32_t));
-      if (interrupt_queue_ == nullptr) {
-        ESP_LOGE(g_TAG_I2C, "Failed to create interrupt queue");
-        return false;
-      }
-    }
-
-    // Store callback for interrupt handler
-    interrupt_callback_ = interrupt_callback;
-    interrupt_pin_ = int_pin;
-
-    // Install GPIO ISR service if not already installed
-    static bool isr_service_installed = false;
-    if (!isr_service_installed) {
-      ret = gpio_install_isr_service(0);
-      if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
-        ESP_LOGE(g_TAG_I2C, "Failed to install GPIO ISR service: %s", esp_err_to_name(ret));
-        return false;
-      }
-      isr_service_installed = true;
-    }
-
-    // Hook ISR handler for this pin
-    ret = gpio_isr_handler_add(int_pin, interruptHandler, this);
-    if (ret != ESP_OK) {
-      ESP_LOGE(g_TAG_I2C, "Failed to add ISR handler for GPIO %d: %s", int_pin, esp_err_to_name(ret));
-      return false;
-    }
-
-    // Create task to process interrupts
-    if (interruptTask_handle_ == nullptr) {
-      xTaskCreate(interruptTask, "pcal9555_int", 4096, this, 5, &interruptTask_handle_);
-      if (interruptTask_handle_ == nullptr) {
-        ESP_LOGE(g_TAG_I2C, "Failed to create interrupt task");
-        return false;
-      }
-    }
-
-    ESP_LOGI(g_TAG_I2C, "Interrupt setup complete on GPIO %d", int_pin);
-    return true;
+    return SetupInterruptPin(int_pin, interrupt_priority_) &&
+           RegisterInterruptHandler(std::move(interrupt_callback));
   }
 
   /**
    * @brief Remove interrupt handler for the INT pin
    */
   void RemoveInterrupt() noexcept {
-    if (interrupt_pin_ != GPIO_NUM_NC) {
-      gpio_isr_handler_remove(interrupt_pin_);
-      interrupt_pin_ = GPIO_NUM_NC;
-    }
-    interrupt_callback_ = nullptr;
-    if (interruptTask_handle_ != nullptr) {
-      vTaskDelete(interruptTask_handle_);
-      interruptTask_handle_ = nullptr;
+    if (interrupt_source_ >= 0) {
+      Esp32Pcal9555InterruptDispatcher::Instance().RemoveSource(interrupt_source_);
+      interrupt_source_ = -1;
     }
+    interrupt_pin_ = GPIO_NUM_NC;
   }
 
 private:
@@ -512,6 +447,7 @@ private:
   i2c_master_dev_handle_t dev_handle_{nullptr};
   uint8_t cached_dev_addr_{0xFF};
 
+
   /**
    * @brief Get or create a cached I2C device handle for the given address.
    *
@@ -552,40 +488,10 @@ private:
     return dev_handle_;
   }
 
-  // Interrupt handling members
+  // Interrupt handling members (service runs on the shared dispatcher task)
   gpio_num_t interrupt_pin_ = GPIO_NUM_NC;
-  std::function<void()> interrupt_callback_;
-  QueueHandle_t interrupt_queue_ = nullptr;
-  TaskHandle_t interruptTask_handle_ = nullptr;
-
-  /**
-   * @brief Static interrupt handler (ISR context)
-   */
-  static void IRAM_ATTR interruptHandler(void* arg) {
-    auto* bus = static_cast<Esp32Pcal9555I2cBus*>(arg);
-    auto pin = static_cast<uint32_t>(bus->interrupt_pin_);
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xQueueSendFromISR(bus->interrupt_queue_, &pin, &xHigherPriorityTaskWoken);
-    if (xHigherPriorityTaskWoken) {
-      portYIELD_FROM_ISR();
-    }
-  }
-
-  /**
-   * @brief Interrupt processing task (task context)
-   */
-  static void interruptTask(void* arg) {
-    auto* bus = static_cast<Esp32Pcal9555I2cBus*>(arg);
-    uint32_t pin = 0;
-
-    while (true) {
-      if (xQueueReceive(bus->interrupt_queue_, &pin, portMAX_DELAY)) {
-        if (bus->interrupt_callback_) {
-          bus->interrupt_callback_();
-        }
-      }
-    }
-  }
+  uint8_t interrupt_priority_ = 0;
+  int interrupt_source_ = -1;
 
   /**
    * @brief Initialize address pins as outputs
@@ -0,0 +1,317 @@
+/**
+ * @file esp32_pcal95555_interrupt_dispatcher.hpp
+ * @brief One interrupt worker task shared by every PCAL9555 INT line
+ *
+ * Each INT GPIO registered here is a source with a priority. The GPIO ISR
+ * only sets the source's bit in one pending word and notifies the worker
+ * task; the worker takes the pending bits and runs the handlers, highest
+ * priority first. Edges raised while a handler runs are merged into the
+ * remaining bits, so a high-priority source raised during a low-priority
+ * service is handled next.
+ *
+ * Compared with one task and one queue per Esp32Pcal9555I2cBus, N expanders
+ * cost one task stack and no queues, and a burst of edges on several lines
+ * is drained in one wake-up instead of one context switch per line.
+ *
+ * @author Nebiyu Tadesse
+ * @date 2025
+ * @copyright HardFOC
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "driver/gpio.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#ifdef __cplusplus
+}
+#endif
+
+static constexpr const char* g_TAG_INT = "PCAL9555_INT";
+
+class Esp32Pcal9555InterruptDispatcher {
+public:
+  static constexpr size_t kMaxSources = 16;           ///< INT lines per program
+  static constexpr uint32_t kTaskStackBytes = 4096;   ///< Worker task stack
+  static constexpr UBaseType_t kTaskPriority = 5;     ///< Worker task priority
+
+  /// Counters since start-up.
+  struct Stats {
+    uint32_t edges = 0;     ///< ISR invocations
+    uint32_t services = 0;  ///< Handler calls
+    uint32_t wakeups = 0;   ///< Worker passes (at most one per edge; one drains a whole burst)
+  };
+
+  /**
+   * @brief The dispatcher shared by all bus instances.
+   */
+  static Esp32Pcal9555InterruptDispatcher& Instance() noexcept {
+    static Esp32Pcal9555InterruptDispatcher dispatcher;
+    return dispatcher;
+  }
+
+  Esp32Pcal9555InterruptDispatcher(const Esp32Pcal9555InterruptDispatcher&) = delete;
+  Esp32Pcal9555InterruptDispatcher& operator=(const Esp32Pcal9555InterruptDispatcher&) = delete;
+
+  /**
+   * @brief Route falling edges on @p pin to @p handler.
+   *
+   * Configures the GPIO as an input with pull-up and falling-edge interrupt,
+   * installs the GPIO ISR service and starts the worker task on first use.
+   * Registering a pin that is already a source replaces its handler and
+   * priority and returns the same id.
+   *
+   * @param pin      GPIO connected to the expander's INT output
+   * @param priority Higher values are serviced first when several lines are pending
+   * @param handler  Called from the worker task
+   * @return Source id for RemoveSource(), or -1 on error
+   *
+   * @note Handlers run on the worker task without the dispatcher lock, so a
+   *       handler may call AddSource() or RemoveSource() itself.
+   */
+  int AddSource(gpio_num_t pin, uint8_t priority, std::function<void()> handler) noexcept {
+    if (!handler || pin == GPIO_NUM_NC) {
+      ESP_LOGE(g_TAG_INT, "Invalid interrupt source (GPIO %d)", pin);
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < kMaxSources; ++i) {
+      if (sources_[i].pin == pin) {
+        sources_[i].handler = std::move(handler);
+        sources_[i].priority = priority;
+        sortSources();
+        return static_cast<int>(i);
+      }
+    }
+    size_t slot = kMaxSources;
+    for (size_t i = 0; i < kMaxSources; ++i) {
+      if (sources_[i].pin == GPIO_NUM_NC) {
+        slot = i;
+        break;
+      }
+    }
+    if (slot == kMaxSources) {
+      ESP_LOGE(g_TAG_INT, "No free interrupt source (max %u)", static_cast<unsigned>(kMaxSources));
+      return -1;
+    }
+    if (!ensureIsrService() || !ensureWorker()) {
+      return -1;
+    }
+
+    gpio_config_t io_conf = {};
+    io_conf.intr_type = GPIO_INTR_NEGEDGE; // Falling edge (active low)
+    io_conf.pin_bit_mask = (1ULL << pin);
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE; // Enable pull-up (INT is open-drain)
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+      ESP_LOGE(g_TAG_INT, "Failed to configure GPIO %d for interrupt: %s", pin, esp_err_to_name(ret));
+      return -1;
+    }
+
+    Source& source = sources_[slot];
+    source.owner = this;
+    source.bit = 1U << slot;
+    source.priority = priority;
+    source.handler = std::move(handler);
+    ret = gpio_isr_handler_add(pin, isrHandler, &source);
+    if (ret != ESP_OK) {
+      ESP_LOGE(g_TAG_INT, "Failed to add ISR handler for GPIO %d: %s", pin, esp_err_to_name(ret));
+      source.handler = nullptr;
+      return -1;
+    }
+    source.pin = pin;
+    active_ |= source.bit;
+    sortSources();
+    return static_cast<int>(slot);
+  }
+
+  /**
+   * @brief Stop routing edges of a source and forget its handler.
+   *
+   * Called from any task other than the worker, this also waits for a
+   * service of the source that is in progress, so whatever the handler
+   * captures may be destroyed once it returns. Called from a handler it does
+   * not wait (the calling handler keeps running to its end).
+   *
+   * @return false if @p id is not a registered source
+   */
+  bool RemoveSource(int id) noexcept {
+    if (id < 0 || static_cast<size_t>(id) >= kMaxSources) {
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    Source& source = sources_[static_cast<size_t>(id)];
+    if (source.pin == GPIO_NUM_NC) {
+      return false;
+    }
+    gpio_isr_handler_remove(source.pin);
+    active_ &= ~source.bit;
+    pending_.fetch_and(~source.bit, std::memory_order_relaxed);
+    source.pin = GPIO_NUM_NC;
+    source.handler = nullptr;
+    sortSources();
+    if (task_ != nullptr && xTaskGetCurrentTaskHandle() != task_) {
+      idle_.wait(lock, [this, id] { return in_flight_ != id; });
+    }
+    return true;
+  }
+
+  /// Number of registered sources.
+  [[nodiscard]] size_t SourceCount() const noexcept {
+    return count_;
+  }
+
+  /// Counters since start-up.
+  [[nodiscard]] Stats GetStats() const noexcept {
+    return {edges_.load(std::memory_order_relaxed), services_.load(std::memory_order_relaxed),
+            wakeups_.load(std::memory_order_relaxed)};
+  }
+
+private:
+  struct Source {
+    gpio_num_t pin = GPIO_NUM_NC;
+    uint8_t priority = 0;
+    uint32_t bit = 0;
+    Esp32Pcal9555InterruptDispatcher* owner = nullptr;
+    std::function<void()> handler;
+  };
+
+  Esp32Pcal9555InterruptDispatcher() = default;
+
+  /// Install the GPIO ISR service once for all sources.
+  bool ensureIsrService() noexcept {
+    if (isr_service_installed_) {
+      return true;
+    }
+    const esp_err_t ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) { // INVALID_STATE: installed by someone else
+      ESP_LOGE(g_TAG_INT, "Failed to install GPIO ISR service: %s", esp_err_to_name(ret));
+      return false;
+    }
+    isr_service_installed_ = true;
+    return true;
+  }
+
+  bool ensureWorker() noexcept {
+    if (task_ != nullptr) {
+      return true;
+    }
+    xTaskCreate(workerTask, "pcal9555_int", kTaskStackBytes, this, kTaskPriority, &task_);
+    if (task_ == nullptr) {
+      ESP_LOGE(g_TAG_INT, "Failed to create interrupt task");
+      return false;
+    }
+    return true;
+  }
+
+  /// Registered slots by descending priority; equal priorities keep slot order.
+  void sortSources() noexcept {
+    count_ = 0;
+    for (size_t i = 0; i < kMaxSources; ++i) {
+      if ((active_ & (1U << i)) == 0) {
+        continue;
+      }
+      size_t j = count_++;
+      while (j > 0 && sources_[order_[j - 1]].priority < sources_[i].priority) {
+        order_[j] = order_[j - 1];
+        --j;
+      }
+      order_[j] = static_cast<uint8_t>(i);
+    }
+  }
+
+  /**
+   * @brief GPIO ISR: mark the source pending and wake the worker.
+   */
+  static void IRAM_ATTR isrHandler(void* arg) {
+    auto* source = static_cast<Source*>(arg);
+    Esp32Pcal9555InterruptDispatcher* self = source->owner;
+    self->pending_.fetch_or(source->bit, std::memory_order_release);
+    self->edges_.fetch_add(1, std::memory_order_relaxed);
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->task_, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken) {
+      portYIELD_FROM_ISR();
+    }
+  }
+
+  /**
+   * @brief Worker task: one wake-up drains every pending source.
+   */
+  static void workerTask(void* arg) {
+    auto* self = static_cast<Esp32Pcal9555InterruptDispatcher*>(arg);
+    while (true) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      self->wakeups_.fetch_add(1, std::memory_order_relaxed);
+      self->drain();
+    }
+  }
+
+  /**
+   * @brief Run the pending handlers, highest priority first.
+   *
+   * The lock is only held to pick the next source and copy its handler; the
+   * handler itself runs unlocked so its I2C transfers do not block
+   * AddSource()/RemoveSource() callers. The source stays marked in flight
+   * until its handler returns, which is what RemoveSource() waits for.
+   */
+  void drain() noexcept {
+    uint32_t pending = 0;
+    while (true) {
+      std::function<void()> handler;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Edges raised meanwhile compete with the rest by priority.
+        pending = (pending | pending_.exchange(0, std::memory_order_acquire)) & active_;
+        for (size_t k = 0; k < count_; ++k) {
+          const Source& source = sources_[order_[k]];
+          if ((pending & source.bit) != 0) {
+            pending &= ~source.bit;
+            handler = source.handler;
+            in_flight_ = order_[k];
+            break;
+          }
+        }
+      }
+      if (!handler) {
+        return;
+      }
+      services_.fetch_add(1, std::memory_order_relaxed);
+      handler();
+      handler = nullptr; // release the captures before RemoveSource() returns
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_flight_ = -1;
+      }
+      idle_.notify_all();
+    }
+  }
+
+  std::mutex mutex_; // guards everything below except the atomics
+  std::condition_variable idle_; // signalled when the in-flight handler returns
+  int in_flight_ = -1;           // source whose handler the worker is running
+  std::array<Source, kMaxSources> sources_{};
+  std::array<uint8_t, kMaxSources> order_{};
+  size_t count_ = 0;
+  uint32_t active_ = 0;
+  bool isr_service_installed_ = false;
+  TaskHandle_t task_ = nullptr;
+  std::atomic<uint32_t> pending_{0};
+  std::atomic<uint32_t> edges_{0};
+  std::atomic<uint32_t> services_{0};
+  std::atomic<uint32_t> wakeups_{0};
+};
@@ -13,12 +13,12 @@
  * PCA9555 + PCAL9555A (standard registers):
  * - Initialization (I2C bus, driver, chip variant auto-detection)
  * - GPIO pin direction (SetPinDirection, SetMultipleDirections, SetDirections)
- * - Pin read/write (ReadPin, WritePin, TogglePin, WritePins, ReadPins)
+ * - Pin read/write (ReadPin, WritePin, TogglePin, WritePins, ReadPins, Unchecked fast path)
  * - Input polarity inversion (SetPinPolarity, SetMultiplePolarities, SetPolarities)
  * - Port-level operations (mixed port direction + read/write)
- * - Multi-pin API (initializer_list overloads for directions, polarities, R/W)
+ * - Multi-pin API (initializer_list, std::span and iterator overloads for directions, polarities, R/W)
  * - Address management (ChangeAddress, address-based constructor)
- * - Configuration (SetRetries, EnsureInitialized)
+ * - Configuration (SetRetries, EnsureInitialized, ScrubTick)
  * - Error handling (invalid pins, UnsupportedFeature, selective flag clearing)
  * - Stress tests (rapid pin toggling)
  *
@@ -43,7 +43,9 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "pcal95555.hpp"
+#include <array>
 #include <memory>
+#include <span>
 
 // Use fully qualified name for the class
 using PCAL95555Driver = pcal95555::PCAL95555<Esp32Pcal9555I2cBus>;
@@ -54,6 +56,7 @@ extern "C" {
 #include "driver/gpio.h"
 #include "driver/i2c_master.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #ifdef __cplusplus
 }
 #endif
@@ -411,6 +414,58 @@ static bool test_pin_toggle() noexcept {
   return true;
 }
 
+/**
+ * @brief Test the unchecked fast path against the safe API
+ */
+static bool test_unchecked_fast_path() noexcept {
+  ESP_LOGI(g_TAG, "Testing unchecked fast path...");
+
+  if (!g_driver) {
+    ESP_LOGE(g_TAG, "Driver not initialized");
+    return false;
+  }
+
+  // Validate once through the safe API
+  uint8_t test_pin = 2;
+  if (!g_driver->SetPinDirection(test_pin, GPIODir::Output) || !g_driver->WritePin(test_pin, false)) {
+    ESP_LOGE(g_TAG, "Failed to prepare pin %d", test_pin);
+    return false;
+  }
+
+  auto fast = g_driver->Unchecked();
+  if (!fast.WritePin(test_pin, true) || !g_driver->ReadPin(test_pin)) {
+    ESP_LOGE(g_TAG, "Unchecked WritePin did not drive pin %d HIGH", test_pin);
+    return false;
+  }
+  if (!fast.WritePin(test_pin, false) || fast.ReadPin(test_pin)) {
+    ESP_LOGE(g_TAG, "Unchecked WritePin did not drive pin %d LOW", test_pin);
+    return false;
+  }
+
+  constexpr int kIterations = 200;
+  uint64_t start = esp_timer_get_time();
+  for (int i = 0; i < kIterations; ++i) {
+    g_driver->TogglePin(test_pin);
+  }
+  uint64_t safe_us = esp_timer_get_time() - start;
+
+  start = esp_timer_get_time();
+  for (int i = 0; i < kIterations; ++i) {
+    if (!fast.TogglePin(test_pin)) {
+      ESP_LOGE(g_TAG, "Unchecked TogglePin failed at iteration %d", i);
+      return false;
+    }
+  }
+  uint64_t fast_us = esp_timer_get_time() - start;
+
+  ESP_LOGI(g_TAG, "TogglePin x%d: safe %llu us (%.2f us/op), unchecked %llu us (%.2f us/op)", kIterations,
+           static_cast<unsigned long long>(safe_us), static_cast<double>(safe_us) / kIterations,
+           static_cast<unsigned long long>(fast_us), static_cast<double>(fast_us) / kIterations);
+
+  ESP_LOGI(g_TAG, "[OK] Unchecked fast path tests passed");
+  return true;
+}
+
 //=============================================================================
 // PULL RESISTOR TESTS
 //=============================================================================
@@ -857,7 +912,7 @@ static bool test_interrupt_callback_unregistration() noexcept {
   }
 
   // Register a callback for pin 5
-  if (!g_driver->RegisterPinInterrupt(5, InterruptEdge::Both, [](uint8_t pin, bool state) {
+  if (!g_driver->RegisterPinInterrupt(5, InterruptEdge::Both, [](uint8_t /*pin*/, bool /*state*/) {
         ESP_LOGI(g_TAG, "This should not be called");
       })) {
     ESP_LOGE(g_TAG, "Failed to register callback");
@@ -1019,6 +1074,16 @@ static bool test_read_pins_multi() noexcept {
     return false;
   }
 
+  // Duplicates collapse, lookups are bit tests
+  auto dup = g_driver->ReadPins({11, 8, 11});
+  if (dup.size() != 2 || !dup.contains(8) || !dup.contains(11) || dup.contains(9)) {
+    ESP_LOGE(g_TAG, "ReadPins duplicate/lookup handling wrong (size=%d)", (int)dup.size());
+    return false;
+  }
+  if (dup.get(8) != results.get(8)) {
+    ESP_LOGW(g_TAG, "Pin 8 changed between reads (%d -> %d)", results.get(8), dup.get(8));
+  }
+
   ESP_LOGI(g_TAG, "[OK] ReadPins tests passed");
   return true;
 }
@@ -1089,6 +1154,94 @@ static bool test_set_polarities_multi() noexcept {
   return true;
 }
 
+/**
+ * @brief Test runtime-sized batches - std::span and iterator-pair overloads
+ */
+static bool test_runtime_batches() noexcept {
+  ESP_LOGI(g_TAG, "Testing runtime-sized batches (std::span / iterators)...");
+
+  if (!g_driver) {
+    ESP_LOGE(g_TAG, "Driver not initialized");
+    return false;
+  }
+
+  // Batch built at run time, as it would be from a configuration table
+  std::array<std::pair<uint8_t, GPIODir>, 4> dirs{};
+  std::array<std::pair<uint8_t, bool>, 4> levels{};
+  for (uint8_t i = 0; i < 4; ++i) {
+    dirs[i] = {i, GPIODir::Output};
+    levels[i] = {i, (i % 2) == 0};
+  }
+
+  if (!g_driver->SetDirections(std::span<const std::pair<uint8_t, GPIODir>>(dirs))) {
+    ESP_LOGE(g_TAG, "SetDirections(span) failed");
+    return false;
+  }
+  if (!g_driver->WritePins(levels.begin(), levels.end())) {
+    ESP_LOGE(g_TAG, "WritePins(first, last) failed");
+    return false;
+  }
+
+  std::array<uint8_t, 4> pins{0, 1, 2, 3};
+  auto results = g_driver->ReadPins(std::span<const uint8_t>(pins));
+  if (results.size() != pins.size()) {
+    ESP_LOGE(g_TAG, "ReadPins(span) returned %d results, expected %d", (int)results.size(), (int)pins.size());
+    return false;
+  }
+  for (const auto& [pin, value] : results) {
+    ESP_LOGI(g_TAG, "ReadPins(span): pin %d = %s", pin, value ? "HIGH" : "LOW");
+  }
+
+  ESP_LOGI(g_TAG, "[OK] Runtime-sized batch tests passed");
+  return true;
+}
+
+/**
+ * @brief Test compile-time pin lists - Pins/In/Out/High/Low templates
+ */
+static bool test_compile_time_pin_lists() noexcept {
+  ESP_LOGI(g_TAG, "Testing compile-time pin lists...");
+
+  if (!g_driver) {
+    ESP_LOGE(g_TAG, "Driver not initialized");
+    return false;
+  }
+
+  using pcal95555::High;
+  using pcal95555::In;
+  using pcal95555::Low;
+  using pcal95555::Out;
+  using pcal95555::Pins;
+
+  if (!g_driver->SetDirections<Out<0, 1, 2, 3>, In<8, 9>>()) {
+    ESP_LOGE(g_TAG, "SetDirections<Out, In>() failed");
+    return false;
+  }
+  if (!g_driver->WritePins<High<0, 2>, Low<1, 3>>()) {
+    ESP_LOGE(g_TAG, "WritePins<High, Low>() failed");
+    return false;
+  }
+
+  auto outputs = g_driver->ReadPins<Pins<0, 1, 2, 3>>();
+  if (outputs.size() != 4 || !outputs.get(0) || outputs.get(1) || !outputs.get(2) || outputs.get(3)) {
+    ESP_LOGE(g_TAG, "Output pins read back wrong: values=0x%04X", outputs.values);
+    return false;
+  }
+
+  // Runtime levels onto a compile-time pin set: pin 1 HIGH, pin 0 LOW
+  if (!g_driver->WritePins<Pins<0, 1>>(0x0002)) {
+    ESP_LOGE(g_TAG, "WritePins<Pins>(values) failed");
+    return false;
+  }
+  if (g_driver->ReadPin(0) || !g_driver->ReadPin(1)) {
+    ESP_LOGE(g_TAG, "WritePins<Pins>(values) did not apply levels");
+    return false;
+  }
+
+  ESP_LOGI(g_TAG, "[OK] Compile-time pin list tests passed");
+  return true;
+}
+
 //=============================================================================
 // ADDRESS MANAGEMENT TESTS
 //=============================================================================
@@ -1207,6 +1360,57 @@ static bool test_config_and_init() noexcept {
   return true;
 }
 
+/**
+ * @brief Test the background configuration scrubber against a simulated reset
+ */
+static bool test_config_scrubber() noexcept {
+  ESP_LOGI(g_TAG, "Testing configuration scrubber...");
+
+  if (!g_driver || !g_i2c_bus) {
+    ESP_LOGE(g_TAG, "Driver not initialized");
+    return false;
+  }
+
+  // Establish an expected image: pins 0-3 outputs, pattern 0b0101
+  if (!g_driver->SetMultipleDirections(0x000F, GPIODir::Output) ||
+      !g_driver->WritePins({{0, true}, {1, false}, {2, true}, {3, false}})) {
+    ESP_LOGE(g_TAG, "Failed to set up expected register image");
+    return false;
+  }
+
+  // Simulate a brownout: put OUTPUT/CONFIG port 0 back to power-on defaults
+  // behind the driver's back
+  const uint8_t por_defaults[2] = {0xFF, 0xFF};
+  const uint8_t addr = g_driver->GetAddress();
+  g_i2c_bus->Write(addr, static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0), por_defaults, 1);
+  g_i2c_bus->Write(addr, static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0), por_defaults, 1);
+
+  g_driver->ResetScrubStats();
+  g_driver->SetScrubRate(1000);
+  for (int tick = 0; tick < 20; ++tick) {
+    g_driver->ScrubTick(esp_timer_get_time());
+    vTaskDelay(pdMS_TO_TICKS(2));
+  }
+  g_driver->SetScrubRate(CONFIG_PCAL95555_SCRUB_MAX_READS_PER_SEC);
+
+  const pcal95555::ScrubStats stats = g_driver->GetScrubStats();
+  ESP_LOGI(g_TAG, "Scrub stats: checks=%lu mismatches=%lu repairs=%lu read_failures=%lu deferrals=%lu",
+           (unsigned long)stats.checks, (unsigned long)stats.mismatches, (unsigned long)stats.repairs,
+           (unsigned long)stats.read_failures, (unsigned long)stats.budget_deferrals);
+
+  if (stats.mismatches < 2 || stats.repairs != stats.mismatches) {
+    ESP_LOGE(g_TAG, "Scrubber did not detect and repair both reset registers");
+    return false;
+  }
+  if (!g_driver->ReadPin(0) || g_driver->ReadPin(1)) {
+    ESP_LOGE(g_TAG, "Output pattern not restored after scrub");
+    return false;
+  }
+
+  ESP_LOGI(g_TAG, "[OK] Configuration scrubber tests passed");
+  return true;
+}
+
 //=============================================================================
 // MULTI-PIN PCAL9555A-ONLY TESTS
 //=============================================================================
@@ -1541,6 +1745,8 @@ extern "C" void app_main(void) {
       RUN_TEST_IN_TASK("Pin Write", test_pin_write, 4096, 5);
       flip_test_progress_indicator(); RUN_TEST_IN_TASK("Pin Read", test_pin_read, 4096, 5);
       flip_test_progress_indicator(); RUN_TEST_IN_TASK("Pin Toggle", test_pin_toggle, 4096, 5);
+      flip_test_progress_indicator();
+      RUN_TEST_IN_TASK("Unchecked Fast Path", test_unchecked_fast_path, 4096, 5);
       flip_test_progress_indicator(););
 
   // Run pull resistor tests
@@ -1601,6 +1807,10 @@ extern "C" void app_main(void) {
       RUN_TEST_IN_TASK("SetDirections Multi", test_set_directions_multi, 4096, 5);
       flip_test_progress_indicator();
       RUN_TEST_IN_TASK("SetPolarities Multi", test_set_polarities_multi, 4096, 5);
+      flip_test_progress_indicator();
+      RUN_TEST_IN_TASK("Runtime-Sized Batches", test_runtime_batches, 4096, 5);
+      flip_test_progress_indicator();
+      RUN_TEST_IN_TASK("Compile-Time Pin Lists", test_compile_time_pin_lists, 4096, 5);
       flip_test_progress_indicator(););
 
   // Run address management tests
@@ -1611,6 +1821,8 @@ extern "C" void app_main(void) {
   // Run configuration and initialization tests
   RUN_TEST_SECTION_IF_ENABLED(ENABLE_CONFIG_TESTS, "CONFIGURATION TESTS",
                               RUN_TEST_IN_TASK("Config & Init", test_config_and_init, 4096, 5);
+                              flip_test_progress_indicator();
+                              RUN_TEST_IN_TASK("Config Scrubber", test_config_scrubber, 4096, 5);
                               flip_test_progress_indicator(););
 
   // Run multi-pin PCAL9555A-only API tests
@@ -1645,6 +1857,7 @@ extern "C" void app_main(void) {
   g_i2c_bus.reset();
 
   ESP_LOGI(g_TAG, "\nTest suite completed.");
+  TEST_FRAMEWORK_SUITE_COMPLETE_HOOK(g_test_results);
 
   while (true) {
     vTaskDelay(pdMS_TO_TICKS(10000));
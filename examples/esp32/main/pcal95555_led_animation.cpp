@@ -37,7 +37,6 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <cstdlib>
-#include <memory>
 
 #ifdef __cplusplus
 extern "C" {
@@ -77,11 +76,36 @@ static constexpr bool A0_LEVEL = false;
 static constexpr bool A1_LEVEL = false;
 static constexpr bool A2_LEVEL = false;
 
+/// Animation cycles to run before app_main() returns (0 = run forever).
+/// The host build (examples/host) sets this to bound the run.
+#ifndef LED_ANIMATION_MAX_CYCLES
+#define LED_ANIMATION_MAX_CYCLES 0
+#endif
+
+/// Called with the pattern name as each pattern starts. The host build uses
+/// it to split the per-animation transaction report; a no-op on target.
+#ifndef LED_ANIMATION_PATTERN_HOOK
+#define LED_ANIMATION_PATTERN_HOOK(name) ((void)0)
+#endif
+
 //=============================================================================
 // GLOBALS
 //=============================================================================
-static std::unique_ptr<Esp32Pcal9555I2cBus> g_bus;
-static std::unique_ptr<PCAL95555Driver> g_driver;
+// Bus and driver live in static storage and are constant-initialized:
+// no heap allocation and no constructor runs at boot. init_hardware() only
+// brings up the peripheral and the chip.
+static constexpr Esp32Pcal9555I2cBus::I2CConfig kBusConfig{
+    .port = I2C_NUM_0,
+    .sda_pin = GPIO_NUM_4,
+    .scl_pin = GPIO_NUM_5,
+    .frequency = 400000,
+    .pullup_enable = true,
+    .a0_pin = GPIO_NUM_45,
+    .a1_pin = GPIO_NUM_48,
+    .a2_pin = GPIO_NUM_47,
+};
+static constinit Esp32Pcal9555I2cBus g_bus{kBusConfig};
+static constinit PCAL95555Driver g_driver{&g_bus, A0_LEVEL, A1_LEVEL, A2_LEVEL};
 
 //=============================================================================
 // HELPERS
@@ -95,9 +119,9 @@ static inline void set_leds(uint16_t pattern) {
   uint8_t port0 = static_cast<uint8_t>(hw & 0xFF);
   uint8_t port1 = static_cast<uint8_t>((hw >> 8) & 0xFF);
   // Write OUTPUT_PORT_0 (0x02) and OUTPUT_PORT_1 (0x03) directly via bus
-  uint8_t addr = g_driver->GetAddress();
-  g_bus->Write(addr, 0x02, &port0, 1);
-  g_bus->Write(addr, 0x03, &port1, 1);
+  uint8_t addr = g_driver.GetAddress();
+  g_bus.Write(addr, 0x02, &port0, 1);
+  g_bus.Write(addr, 0x03, &port1, 1);
 }
 
 /// Turn all LEDs off
@@ -430,39 +454,23 @@ static void anim_alternating_flash(uint32_t speed_ms) {
 static bool init_hardware() {
   ESP_LOGI(g_TAG, "Initializing I2C bus...");
 
-  Esp32Pcal9555I2cBus::I2CConfig config;
-  config.port = I2C_NUM_0;
-  config.sda_pin = GPIO_NUM_4;
-  config.scl_pin = GPIO_NUM_5;
-  config.frequency = 400000;
-  config.pullup_enable = true;
-  config.a0_pin = GPIO_NUM_45;
-  config.a1_pin = GPIO_NUM_48;
-  config.a2_pin = GPIO_NUM_47;
-
-  g_bus = CreateEsp32Pcal9555I2cBus(config);
-  if (!g_bus || !g_bus->IsInitialized()) {
+  if (!g_bus.Init()) {
     ESP_LOGE(g_TAG, "Failed to initialize I2C bus");
     return false;
   }
   ESP_LOGI(g_TAG, "I2C bus initialized (SDA=GPIO%d, SCL=GPIO%d, %lu Hz)",
-           config.sda_pin, config.scl_pin, config.frequency);
+           kBusConfig.sda_pin, kBusConfig.scl_pin, kBusConfig.frequency);
 
   ESP_LOGI(g_TAG, "Initializing PCA9555/PCAL9555A driver...");
-  g_driver = std::make_unique<PCAL95555Driver>(g_bus.get(), A0_LEVEL, A1_LEVEL, A2_LEVEL);
-  if (!g_driver) {
-    ESP_LOGE(g_TAG, "Failed to create driver");
-    return false;
-  }
 
   // Force initialization
-  if (!g_driver->EnsureInitialized()) {
+  if (!g_driver.EnsureInitialized()) {
     ESP_LOGE(g_TAG, "Driver initialization failed");
     return false;
   }
 
   // Log detected chip variant
-  auto variant = g_driver->GetChipVariant();
+  auto variant = g_driver.GetChipVariant();
   const char* variant_name = "Unknown";
   if (variant == pcal95555::ChipVariant::PCA9555) {
     variant_name = "PCA9555 (standard)";
@@ -470,11 +478,11 @@ static bool init_hardware() {
     variant_name = "PCAL9555A (Agile I/O)";
   }
   ESP_LOGI(g_TAG, "Chip variant: %s", variant_name);
-  ESP_LOGI(g_TAG, "I2C address: 0x%02X", g_driver->GetAddress());
+  ESP_LOGI(g_TAG, "I2C address: 0x%02X", g_driver.GetAddress());
 
   // Configure all 16 pins as outputs
   for (uint8_t pin = 0; pin < NUM_PINS; ++pin) {
-    if (!g_driver->SetPinDirection(pin, GPIODir::Output)) {
+    if (!g_driver.SetPinDirection(pin, GPIODir::Output)) {
       ESP_LOGE(g_TAG, "Failed to set pin %d as output", pin);
       return false;
     }
@@ -485,7 +493,7 @@ static bool init_hardware() {
   all_off();
 
   // Clear any accumulated error flags from init
-  g_driver->ClearErrorFlags();
+  g_driver.ClearErrorFlags();
 
   return true;
 }
@@ -511,7 +519,8 @@ extern "C" void app_main(void) {
 
   if (!init_hardware()) {
     ESP_LOGE(g_TAG, "Hardware initialization failed. Halting.");
-    while (true) { delay_ms(1000); }
+    while (LED_ANIMATION_MAX_CYCLES == 0) { delay_ms(1000); }
+    return;
   }
 
   ESP_LOGI(g_TAG, "");
@@ -521,62 +530,73 @@ extern "C" void app_main(void) {
 
   int cycle = 0;
 
-  while (true) {
+  while (LED_ANIMATION_MAX_CYCLES == 0 || cycle < LED_ANIMATION_MAX_CYCLES) {
     cycle++;
     ESP_LOGI(g_TAG, "========== Animation Cycle %d ==========", cycle);
 
     // --- 1. Sequential Chase ---
     ESP_LOGI(g_TAG, "[1/10] Sequential Chase");
+    LED_ANIMATION_PATTERN_HOOK("Sequential Chase");
     anim_sequential_chase(60);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 2. Bounce ---
     ESP_LOGI(g_TAG, "[2/10] Bounce");
+    LED_ANIMATION_PATTERN_HOOK("Bounce");
     anim_bounce(40);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 3. Binary Counter ---
     ESP_LOGI(g_TAG, "[3/10] Binary Counter");
+    LED_ANIMATION_PATTERN_HOOK("Binary Counter");
     anim_binary_counter(5);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 4. Breathing (software PWM) ---
     ESP_LOGI(g_TAG, "[4/10] Breathing (software PWM)");
+    LED_ANIMATION_PATTERN_HOOK("Breathing (software PWM)");
     anim_breathing(40);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 5. Wave / Comet Tail ---
     ESP_LOGI(g_TAG, "[5/10] Wave / Comet Tail");
+    LED_ANIMATION_PATTERN_HOOK("Wave / Comet Tail");
     anim_wave(50);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 6. Random Sparkle ---
     ESP_LOGI(g_TAG, "[6/10] Random Sparkle");
+    LED_ANIMATION_PATTERN_HOOK("Random Sparkle");
     anim_sparkle(30, 3000);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 7. Build-up / Teardown ---
     ESP_LOGI(g_TAG, "[7/10] Build-up / Teardown");
+    LED_ANIMATION_PATTERN_HOOK("Build-up / Teardown");
     anim_buildup_teardown(80);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 8. Accelerating Scan ---
     ESP_LOGI(g_TAG, "[8/10] Accelerating Scan");
+    LED_ANIMATION_PATTERN_HOOK("Accelerating Scan");
     anim_accel_scan();
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 9. Center Expand / Contract ---
     ESP_LOGI(g_TAG, "[9/10] Center Expand / Contract");
+    LED_ANIMATION_PATTERN_HOOK("Center Expand / Contract");
     anim_center_expand(80);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- 10. Alternating Flash ---
     ESP_LOGI(g_TAG, "[10/10] Alternating Flash");
+    LED_ANIMATION_PATTERN_HOOK("Alternating Flash");
     anim_alternating_flash(100);
     delay_ms(INTER_PATTERN_DELAY_MS);
 
     // --- Finale: fast all-on / all-off strobe ---
     ESP_LOGI(g_TAG, "Finale: Strobe");
+    LED_ANIMATION_PATTERN_HOOK("Finale: Strobe");
     for (int i = 0; i < 10; ++i) {
       all_on();
       delay_ms(50);
@@ -585,10 +605,10 @@ extern "C" void app_main(void) {
     }
 
     // Check driver health
-    uint16_t errors = g_driver->GetErrorFlags();
+    uint16_t errors = g_driver.GetErrorFlags();
     if (errors != 0) {
       ESP_LOGW(g_TAG, "Driver error flags after cycle %d: 0x%04X", cycle, errors);
-      g_driver->ClearErrorFlags();
+      g_driver.ClearErrorFlags();
     } else {
       ESP_LOGI(g_TAG, "Cycle %d complete - no errors", cycle);
     }
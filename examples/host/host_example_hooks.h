@@ -0,0 +1,28 @@
+/**
+ * @file host_example_hooks.h
+ * @brief Hook definitions force-included into the ESP32 examples on the host
+ *
+ * The examples define these hooks as no-ops unless they are already defined;
+ * this header routes them to the host simulation so the bus report is split
+ * per animation pattern / per test and the run ends when the suite is done.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Start a new report section named @p name.
+void host_sim_begin_section(const char* name);
+/// Print the report and terminate the process with @p exit_code.
+void host_sim_finish(int exit_code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define LED_ANIMATION_PATTERN_HOOK(name) host_sim_begin_section(name)
+#define TEST_FRAMEWORK_TEST_HOOK(name) host_sim_begin_section(name)
+#define TEST_FRAMEWORK_SUITE_COMPLETE_HOOK(results) host_sim_finish((results).failed_tests == 0 ? 0 : 1)
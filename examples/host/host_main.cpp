@@ -0,0 +1,79 @@
+/**
+ * @file host_main.cpp
+ * @brief Host entry point: parse options, run the example's app_main(), report
+ *
+ * Usage:
+ *   pcal95555_host_<example> [--variant=pca9555|pcal9555a]
+ *                            [--log-level=none|error|warn|info|debug]
+ *                            [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "host_example_hooks.h"
+#include "host_sim.hpp"
+
+extern "C" void app_main(void);
+
+namespace {
+
+bool parseLogLevel(const char* text, int& level) {
+  static constexpr const char* kNames[] = {"none", "error", "warn", "info", "debug", "verbose"};
+  for (int i = 0; i < static_cast<int>(sizeof(kNames) / sizeof(kNames[0])); ++i) {
+    if (std::strcmp(text, kNames[i]) == 0) {
+      level = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+int usage(const char* prog) {
+  std::fprintf(stderr,
+               "usage: %s [--variant=pca9555|pcal9555a] [--log-level=none|error|warn|info|debug]"
+               " [--report-json=PATH]\n",
+               prog);
+  return 2;
+}
+
+} // namespace
+
+extern "C" void host_sim_begin_section(const char* name) {
+  pcal95555::sim::BeginSection(name);
+}
+
+extern "C" void host_sim_finish(int exit_code) {
+  pcal95555::sim::PrintReport();
+  std::fflush(stdout);
+  std::fflush(stderr);
+  // Example tasks (e.g. the INT service task) block forever; do not join them.
+  std::_Exit(exit_code);
+}
+
+int main(int argc, char** argv) {
+  pcal95555::sim::Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--variant=pca9555") {
+      options.variant = pcal95555::sim::SimVariant::PCA9555;
+    } else if (arg == "--variant=pcal9555a") {
+      options.variant = pcal95555::sim::SimVariant::PCAL9555A;
+    } else if (arg.rfind("--log-level=", 0) == 0) {
+      if (!parseLogLevel(arg.c_str() + std::strlen("--log-level="), options.log_level)) {
+        return usage(argv[0]);
+      }
+    } else if (arg.rfind("--report-json=", 0) == 0) {
+      options.report_json = arg.substr(std::strlen("--report-json="));
+    } else {
+      return usage(argv[0]);
+    }
+  }
+
+  pcal95555::sim::Configure(options);
+  app_main();
+  host_sim_finish(0);
+}
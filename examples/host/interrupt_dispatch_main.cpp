@@ -0,0 +1,287 @@
+/**
+ * @file interrupt_dispatch_main.cpp
+ * @brief Per-bus interrupt tasks vs the shared interrupt dispatcher
+ *
+ * Eight expanders, each with its own INT GPIO (GPIO 10-17, priority = line
+ * index), are serviced two ways:
+ *
+ *  - per-bus: what Esp32Pcal9555I2cBus did before the dispatcher, one
+ *    10-entry queue and one 4096-byte "pcal9555_int" task per INT line
+ *    (reproduced below as LegacyInterruptLine);
+ *  - shared:  Esp32Pcal9555I2cBus::RegisterInterruptHandler() on the shared
+ *    Esp32Pcal9555InterruptDispatcher.
+ *
+ * Each burst raises all eight lines, lowest priority first, while a transfer
+ * holds the bus, and waits until every handler ran. A handler holds the same
+ * lock for --service-us of busy time, standing in for the I2C transfers that
+ * serialize real services on one bus. Reported per scheme: kernel objects and their RAM (from the shim
+ * accounting), task wake-ups per burst, and the ISR-to-handler latency and
+ * service rank of the highest-priority line. Latencies are host wall time;
+ * the ratios, not the absolute values, carry over to the target.
+ *
+ * Usage: pcal95555_host_interrupt_dispatch [--bursts=N] [--service-us=N]
+ *                                          [--report-json=PATH]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "esp32_pcal95555_bus.hpp"
+#include "freertos/queue.h"
+#include "host_sim.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kLines = 8;
+constexpr int kFirstGpio = 10;
+
+struct Measurement {
+  const char* name = "";
+  pcal95555::sim::RtosUsage usage{};
+  double wakeups_per_burst = 0;
+  double top_latency_avg_us = 0;
+  double top_latency_max_us = 0;
+  double bottom_latency_avg_us = 0;
+  double top_rank_avg = 0;  // 0 = serviced first
+};
+
+/// Records what the handlers saw during one scheme's bursts.
+class Recorder {
+public:
+  explicit Recorder(uint32_t service_us) : service_us_(service_us) {}
+
+  void Raised(size_t line) {
+    raised_[line] = Clock::now();
+  }
+
+  void Service(size_t line) {
+    std::lock_guard<std::mutex> lock(bus_);
+    const double us = std::chrono::duration<double, std::micro>(Clock::now() - raised_[line]).count();
+    const uint32_t rank = rank_++;
+    if (line == kLines - 1) {
+      top_sum_us_ += us;
+      top_max_us_ = std::max(top_max_us_, us);
+      top_rank_sum_ += rank;
+    } else if (line == 0) {
+      bottom_sum_us_ += us;
+    }
+    const auto until = Clock::now() + std::chrono::microseconds(service_us_);
+    while (Clock::now() < until) {
+    }
+    done_.fetch_add(1, std::memory_order_release);
+  }
+
+  /// Raise every line through @p raise (lowest priority first) and wait for all services.
+  /// The lines are raised while the bus is held, as if a transfer were in
+  /// flight, so no service starts in the middle of the burst (an ISR is not
+  /// preempted by tasks; a host thread is).
+  template <typename Raise>
+  void Burst(Raise&& raise) {
+    const uint32_t target = done_.load() + kLines;
+    {
+      std::lock_guard<std::mutex> lock(bus_);
+      rank_ = 0;
+      for (size_t line = 0; line < kLines; ++line) {
+        Raised(line);
+        raise(line);
+      }
+    }
+    while (done_.load(std::memory_order_acquire) < target) {
+      std::this_thread::yield();
+    }
+    ++bursts_;
+  }
+
+  void Fill(Measurement& m) const {
+    m.top_latency_avg_us = top_sum_us_ / bursts_;
+    m.top_latency_max_us = top_max_us_;
+    m.bottom_latency_avg_us = bottom_sum_us_ / bursts_;
+    m.top_rank_avg = static_cast<double>(top_rank_sum_) / bursts_;
+  }
+
+private:
+  uint32_t service_us_;
+  std::mutex bus_;  // one I2C bus: services never overlap
+  std::array<Clock::time_point, kLines> raised_{};
+  uint32_t rank_ = 0;
+  std::atomic<uint32_t> done_{0};
+  double top_sum_us_ = 0;
+  double top_max_us_ = 0;
+  double bottom_sum_us_ = 0;
+  uint64_t top_rank_sum_ = 0;
+  uint32_t bursts_ = 0;
+};
+
+/// The per-bus scheme the dispatcher replaced: own queue, own task.
+struct LegacyInterruptLine {
+  QueueHandle_t queue = nullptr;
+  TaskHandle_t task = nullptr;
+  Recorder* recorder = nullptr;
+  size_t line = 0;
+
+  bool Start() {
+    queue = xQueueCreate(10, sizeof(uint32_t));
+    xTaskCreate(taskMain, "pcal9555_int", 4096, this, 5, &task);
+    return queue != nullptr && task != nullptr;
+  }
+
+  void Isr() {
+    const auto pin = static_cast<uint32_t>(kFirstGpio + line);
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(queue, &pin, &woken);
+  }
+
+  static void taskMain(void* arg) {
+    auto* self = static_cast<LegacyInterruptLine*>(arg);
+    uint32_t pin = 0;
+    while (true) {
+      if (xQueueReceive(self->queue, &pin, portMAX_DELAY)) {
+        self->recorder->Service(self->line);
+      }
+    }
+  }
+};
+
+pcal95555::sim::RtosUsage diff(const pcal95555::sim::RtosUsage& after, const pcal95555::sim::RtosUsage& before) {
+  return {after.tasks - before.tasks, after.stack_bytes - before.stack_bytes, after.queues - before.queues,
+          after.queue_bytes - before.queue_bytes, after.wakeups - before.wakeups};
+}
+
+Measurement runLegacy(uint32_t bursts, uint32_t service_us) {
+  Measurement m;
+  m.name = "per-bus";
+  Recorder recorder(service_us);
+  const auto base = pcal95555::sim::GetRtosUsage();
+  static std::array<LegacyInterruptLine, kLines> lines;
+  for (size_t i = 0; i < kLines; ++i) {
+    lines[i].recorder = &recorder;
+    lines[i].line = i;
+    lines[i].Start();
+  }
+  m.usage = diff(pcal95555::sim::GetRtosUsage(), base);
+  for (uint32_t b = 0; b < bursts; ++b) {
+    recorder.Burst([](size_t line) { lines[line].Isr(); });
+  }
+  m.wakeups_per_burst = static_cast<double>(diff(pcal95555::sim::GetRtosUsage(), base).wakeups) / bursts;
+  for (auto& line : lines) {
+    vTaskDelete(line.task);
+  }
+  while (pcal95555::sim::GetRtosUsage().tasks != base.tasks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));  // deleted tasks unwind at their next wait
+  }
+  for (auto& line : lines) {
+    vQueueDelete(line.queue);
+  }
+  recorder.Fill(m);
+  return m;
+}
+
+Measurement runShared(uint32_t bursts, uint32_t service_us) {
+  Measurement m;
+  m.name = "shared";
+  Recorder recorder(service_us);
+  const auto base = pcal95555::sim::GetRtosUsage();
+  std::vector<std::unique_ptr<Esp32Pcal9555I2cBus>> buses;
+  for (size_t i = 0; i < kLines; ++i) {
+    auto bus = std::make_unique<Esp32Pcal9555I2cBus>();
+    bus->SetupInterruptPin(static_cast<gpio_num_t>(kFirstGpio + i), static_cast<uint8_t>(i));
+    bus->RegisterInterruptHandler([&recorder, i] { recorder.Service(i); });
+    buses.push_back(std::move(bus));
+  }
+  m.usage = diff(pcal95555::sim::GetRtosUsage(), base);
+  for (uint32_t b = 0; b < bursts; ++b) {
+    recorder.Burst([](size_t line) { pcal95555::sim::RaiseGpioEdge(kFirstGpio + static_cast<int>(line)); });
+  }
+  m.wakeups_per_burst = static_cast<double>(diff(pcal95555::sim::GetRtosUsage(), base).wakeups) / bursts;
+  buses.clear();  // RemoveInterrupt(): sources go, the worker stays
+  recorder.Fill(m);
+  return m;
+}
+
+int usage(const char* argv0) {
+  std::fprintf(stderr, "usage: %s [--bursts=N] [--service-us=N] [--report-json=PATH]\n", argv0);
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t bursts = 500;
+  uint32_t service_us = 50;
+  std::string report_json;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.rfind("--bursts=", 0) == 0) {
+      bursts = static_cast<uint32_t>(std::strtoul(arg.c_str() + std::strlen("--bursts="), nullptr, 0));
+    } else if (arg.rfind("--service-us=", 0) == 0) {
+      service_us = static_cast<uint32_t>(std::strtoul(arg.c_str() + std::strlen("--service-us="), nullptr, 0));
+    } else if (arg.rfind("--report-json=", 0) == 0) {
+      report_json = arg.substr(std::strlen("--report-json="));
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (bursts == 0) {
+    return usage(argv[0]);
+  }
+
+  pcal95555::sim::Options options;
+  options.log_level = 1;  // errors only
+  pcal95555::sim::Configure(options);
+
+  const Measurement results[] = {runLegacy(bursts, service_us), runShared(bursts, service_us)};
+  const auto& shared_stats = Esp32Pcal9555InterruptDispatcher::Instance().GetStats();
+
+  std::printf("PCAL9555 interrupt dispatch, %zu INT lines, %u bursts, %u us per service\n\n", kLines, bursts,
+              service_us);
+  std::printf("%-8s %6s %12s %7s %12s %14s %14s %14s %14s\n", "scheme", "tasks", "stack_bytes", "queues",
+              "queue_bytes", "wakeups/burst", "top_lat_avg_us", "top_lat_max_us", "top_rank_avg");
+  for (const Measurement& m : results) {
+    std::printf("%-8s %6u %12llu %7u %12llu %14.2f %14.1f %14.1f %14.2f\n", m.name, m.usage.tasks,
+                static_cast<unsigned long long>(m.usage.stack_bytes), m.usage.queues,
+                static_cast<unsigned long long>(m.usage.queue_bytes), m.wakeups_per_burst, m.top_latency_avg_us,
+                m.top_latency_max_us, m.top_rank_avg);
+  }
+  std::printf("\nlowest-priority line, avg latency: per-bus %.1f us, shared %.1f us\n",
+              results[0].bottom_latency_avg_us, results[1].bottom_latency_avg_us);
+  std::printf("dispatcher: %u edges, %u services, %u wake-ups; sizeof %zu bytes (host ABI)\n", shared_stats.edges,
+              shared_stats.services, shared_stats.wakeups, sizeof(Esp32Pcal9555InterruptDispatcher));
+
+  if (!report_json.empty()) {
+    FILE* f = std::fopen(report_json.c_str(), "w");
+    if (f == nullptr) {
+      std::fprintf(stderr, "cannot write %s\n", report_json.c_str());
+      return 1;
+    }
+    std::fprintf(f, "{\n  \"lines\": %zu,\n  \"bursts\": %u,\n  \"service_us\": %u,\n  \"schemes\": [\n", kLines,
+                 bursts, service_us);
+    for (size_t i = 0; i < 2; ++i) {
+      const Measurement& m = results[i];
+      std::fprintf(f,
+                   "    {\"name\": \"%s\", \"tasks\": %u, \"stack_bytes\": %llu, \"queues\": %u, "
+                   "\"queue_bytes\": %llu, \"wakeups_per_burst\": %.3f, \"top_latency_avg_us\": %.2f, "
+                   "\"top_latency_max_us\": %.2f, \"bottom_latency_avg_us\": %.2f, \"top_rank_avg\": %.3f}%s\n",
+                   m.name, m.usage.tasks, static_cast<unsigned long long>(m.usage.stack_bytes), m.usage.queues,
+                   static_cast<unsigned long long>(m.usage.queue_bytes), m.wakeups_per_burst,
+                   m.top_latency_avg_us, m.top_latency_max_us, m.bottom_latency_avg_us, m.top_rank_avg,
+                   i == 0 ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+  }
+  std::fflush(stdout);
+  std::_Exit(0);  // the dispatcher task blocks forever; do not join it
+}
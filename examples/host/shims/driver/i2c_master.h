@@ -0,0 +1,68 @@
+/**
+ * @file i2c_master.h
+ * @brief Host shim: ESP-IDF I2C master API backed by simulated devices
+ *
+ * Transfers are delivered to the simulated expander(s) registered with the
+ * host simulation. Each transfer is counted and advances the simulation
+ * clock by its duration on the wire at the device's SCL speed.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+typedef int i2c_port_t;
+#define I2C_NUM_0 0
+#define I2C_NUM_1 1
+
+typedef enum { I2C_CLK_SRC_DEFAULT = 0 } i2c_clock_source_t;
+typedef enum { I2C_ADDR_BIT_LEN_7 = 0, I2C_ADDR_BIT_LEN_10 = 1 } i2c_addr_bit_len_t;
+
+typedef struct {
+  i2c_port_t i2c_port;
+  gpio_num_t sda_io_num;
+  gpio_num_t scl_io_num;
+  i2c_clock_source_t clk_source;
+  uint32_t glitch_ignore_cnt;
+  int intr_priority;
+  size_t trans_queue_depth;
+  struct {
+    uint32_t enable_internal_pullup : 1;
+  } flags;
+} i2c_master_bus_config_t;
+
+typedef struct {
+  i2c_addr_bit_len_t dev_addr_length;
+  uint16_t device_address;
+  uint32_t scl_speed_hz;
+  uint32_t scl_wait_us;
+  struct {
+    uint32_t disable_ack_check : 1;
+  } flags;
+} i2c_device_config_t;
+
+typedef struct HostI2cBus* i2c_master_bus_handle_t;
+typedef struct HostI2cDevice* i2c_master_dev_handle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t* config, i2c_master_bus_handle_t* ret_handle);
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t bus);
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus, const i2c_device_config_t* config,
+                                    i2c_master_dev_handle_t* ret_handle);
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t dev);
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t dev, const uint8_t* write_buffer, size_t write_size,
+                              int xfer_timeout_ms);
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t dev, const uint8_t* write_buffer,
+                                      size_t write_size, uint8_t* read_buffer, size_t read_size,
+                                      int xfer_timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
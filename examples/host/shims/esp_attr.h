@@ -0,0 +1,9 @@
+/**
+ * @file esp_attr.h
+ * @brief Host shim: ESP-IDF section attributes (no-ops on the host)
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
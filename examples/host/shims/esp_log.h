@@ -0,0 +1,35 @@
+/**
+ * @file esp_log.h
+ * @brief Host shim: ESP-IDF logging routed to stdout with simulated timestamps
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <stdint.h>
+
+typedef enum {
+  ESP_LOG_NONE = 0,
+  ESP_LOG_ERROR,
+  ESP_LOG_WARN,
+  ESP_LOG_INFO,
+  ESP_LOG_DEBUG,
+  ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// No printf format attribute: the examples print uint32_t with %lu, which is
+// correct on the 32-bit target but would warn on every 64-bit host.
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...);
+void esp_log_level_set(const char* tag, esp_log_level_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define ESP_LOGE(tag, format, ...) esp_log_write(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) esp_log_write(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) esp_log_write(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) esp_log_write(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) esp_log_write(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
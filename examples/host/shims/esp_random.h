@@ -0,0 +1,17 @@
+/**
+ * @file esp_random.h
+ * @brief Host shim: deterministic pseudo-random source (fixed seed per run)
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_random(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,18 @@
+/**
+ * @file esp_timer.h
+ * @brief Host shim: microsecond timer backed by the simulation clock
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Simulated time since start in microseconds (task delays + modelled bus time).
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
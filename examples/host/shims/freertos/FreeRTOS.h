@@ -0,0 +1,33 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host shim: FreeRTOS base types and tick conversion
+ *
+ * Tasks run on host threads. Task delays advance the simulation clock
+ * instead of sleeping, so timed examples finish in milliseconds of wall time
+ * while reporting the timing they would have on the target.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_attr.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;  // ESP-IDF ports size stacks in bytes
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define portTICK_PERIOD_MS ((TickType_t)(1000 / configTICK_RATE_HZ))
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+
+#define portYIELD_FROM_ISR(...) ((void)0)
@@ -0,0 +1,14 @@
+/**
+ * @file semphr.h
+ * @brief Host shim: FreeRTOS binary semaphores
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+#define xSemaphoreCreateBinary() xQueueCreate(1, 0)
+#define vSemaphoreDelete(sem) vQueueDelete(sem)
+#define xSemaphoreGive(sem) xQueueSend((sem), NULL, 0)
+#define xSemaphoreTake(sem, ticks) xQueueReceive((sem), NULL, (ticks))
@@ -0,0 +1,37 @@
+/**
+ * @file task.h
+ * @brief Host shim: FreeRTOS tasks on host threads, delays on the simulation clock
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "FreeRTOS.h"
+
+typedef struct HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+                       UBaseType_t priority, TaskHandle_t* out_handle);
+/// Delete a task; nullptr deletes the calling task (does not return).
+void vTaskDelete(TaskHandle_t task);
+/// Advance the simulation clock by `ticks` and yield.
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+/// Handle of the calling task; nullptr on threads that are not tasks (main).
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+/// Priorities are recorded but not enforced (host threads); nullptr is the calling task.
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+void vTaskPrioritySet(TaskHandle_t task, UBaseType_t priority);
+
+/// Direct-to-task notifications used as a counting semaphore.
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_prio_woken);
+/// Wait for a notification of the calling task; returns the count before clearing.
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
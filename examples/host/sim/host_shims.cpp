@@ -0,0 +1,595 @@
+/**
+ * @file host_shims.cpp
+ * @brief Host implementations of the ESP-IDF / FreeRTOS calls used by the examples
+ *
+ * - Tasks are std::threads; vTaskDelay() advances the simulation clock
+ *   instead of sleeping, so animations run as fast as the host allows while
+ *   esp_timer_get_time() still reports target time.
+ * - Queues, binary semaphores and task notifications block in real time
+ *   (bounded by their tick timeout) and advance the simulation clock on
+ *   timeout. Live tasks, stacks and queues are counted for GetRtosUsage().
+ * - I2C transfers go to the simulated expander and are accounted in the
+ *   current report section; the A0-A2 GPIOs drive its address straps and its
+ *   INT line raises the GPIO ISR registered on the board's INT pin.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "driver/gpio.h"
+#include "driver/i2c_master.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "host_sim.hpp"
+
+namespace sim = pcal95555::sim;
+
+struct HostTask {
+  std::string name;
+  std::atomic<bool> deleted{false};
+  uint32_t stack_bytes = 0;
+  std::atomic<UBaseType_t> priority{0};  // recorded only: host threads are not priority-scheduled
+  std::mutex mutex;  // guards notify_count
+  std::condition_variable cv;
+  uint32_t notify_count = 0;
+};
+
+struct HostQueue {
+  size_t length;
+  size_t item_size;
+  std::deque<std::vector<uint8_t>> items;
+  std::mutex mutex;
+  std::condition_variable cv;
+};
+
+struct HostI2cBus {
+  bool internal_pullup;
+};
+
+struct HostI2cDevice {
+  HostI2cBus* bus;
+  uint16_t address;
+  uint32_t scl_hz;
+};
+
+namespace {
+
+/// Thrown by vTaskDelete() to unwind the calling task's thread.
+struct TaskExit {};
+
+thread_local HostTask* t_self = nullptr;
+thread_local UBaseType_t t_priority = 0;  // threads that are not tasks (main)
+
+constexpr sim::BoardPins kBoard{};
+constexpr int kGpioCount = GPIO_NUM_MAX;
+
+std::mutex g_bus_mutex;  // serializes transfers, like the IDF bus lock
+std::mutex g_gpio_mutex;
+std::array<uint32_t, kGpioCount> g_gpio_levels{};
+std::array<gpio_isr_t, kGpioCount> g_isr_handlers{};
+std::array<void*, kGpioCount> g_isr_args{};
+bool g_isr_service_installed = false;
+std::atomic<bool> g_int_edge_pending{false};
+std::once_flag g_board_once;
+
+std::atomic<uint32_t> g_live_tasks{0};
+std::atomic<uint64_t> g_live_stack_bytes{0};
+std::atomic<uint32_t> g_live_queues{0};
+std::atomic<uint64_t> g_live_queue_bytes{0};
+std::atomic<uint64_t> g_wakeups{0};
+
+std::mutex g_log_mutex;
+std::atomic<int> g_log_level{-1};
+std::mutex g_random_mutex;
+uint32_t g_random_state = 0;
+
+void checkDeleted() {
+  if (t_self != nullptr && t_self->deleted.load()) {
+    throw TaskExit{};
+  }
+}
+
+/// Connect the expander's INT output to the board (once).
+void wireBoard() {
+  std::call_once(g_board_once, [] {
+    sim::Device().SetIntListener([](bool asserted) {
+      if (asserted) {
+        g_int_edge_pending = true;  // falling edge on the active-low line
+      }
+    });
+  });
+}
+
+/// Run the INT-pin ISR for an edge raised during the last transfer. Called
+/// without locks held, like a real ISR preempting the task.
+void dispatchIntEdge() {
+  if (!g_int_edge_pending.exchange(false)) {
+    return;
+  }
+  gpio_isr_t handler = nullptr;
+  void* arg = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(g_gpio_mutex);
+    if (g_isr_service_installed) {
+      handler = g_isr_handlers[kBoard.int_n];
+      arg = g_isr_args[kBoard.int_n];
+    }
+  }
+  if (handler != nullptr) {
+    handler(arg);
+  }
+}
+
+void updateStraps() {
+  const uint8_t bits = static_cast<uint8_t>((g_gpio_levels[kBoard.a0] != 0 ? 1 : 0) |
+                                            (g_gpio_levels[kBoard.a1] != 0 ? 2 : 0) |
+                                            (g_gpio_levels[kBoard.a2] != 0 ? 4 : 0));
+  std::lock_guard<std::mutex> lock(g_bus_mutex);
+  sim::Device().SetAddressStraps(bits);
+}
+
+esp_err_t transfer(HostI2cDevice* dev, const uint8_t* write_buffer, size_t write_size, uint8_t* read_buffer,
+                   size_t read_size) {
+  if (dev == nullptr || write_buffer == nullptr || write_size == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  const bool is_read = read_buffer != nullptr;
+  bool acked = false;
+  {
+    std::lock_guard<std::mutex> lock(g_bus_mutex);
+    sim::SimPcal95555Device& chip = sim::Device();
+    if (dev->address == chip.Address()) {
+      acked = chip.Write(write_buffer, is_read ? 1 : write_size);
+      if (acked && is_read) {
+        acked = chip.Read(write_buffer[0], read_buffer, read_size);
+      }
+    }
+    const bool touches_outputs = !is_read && (write_buffer[0] == 0x02 || write_buffer[0] == 0x03);
+    sim::RecordTransfer(is_read, write_size, read_size, dev->scl_hz, acked, touches_outputs);
+  }
+  dispatchIntEdge();
+  return acked ? ESP_OK : ESP_FAIL;
+}
+
+/// Wait on @p cv until @p ready(); portMAX_DELAY waits forever. On timeout
+/// the simulation clock advances by the full timeout, as the task slept it.
+template <typename Ready>
+bool blockUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, TickType_t ticks, Ready ready) {
+  if (ticks == portMAX_DELAY) {
+    while (!ready()) {
+      cv.wait_for(lock, std::chrono::milliseconds(20));
+      checkDeleted();
+    }
+    return true;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ticks);
+  while (!ready()) {
+    if (cv.wait_until(lock, deadline) == std::cv_status::timeout && !ready()) {
+      sim::AdvanceUs(static_cast<int64_t>(ticks) * 1000);
+      return false;
+    }
+    checkDeleted();
+  }
+  return true;
+}
+
+bool queueWait(HostQueue* queue, std::unique_lock<std::mutex>& lock, TickType_t ticks,
+               bool (*ready)(HostQueue*)) {
+  if (!ready(queue)) {
+    if (!blockUntil(lock, queue->cv, ticks, [queue, ready] { return ready(queue); })) {
+      return false;
+    }
+    ++g_wakeups;
+  }
+  return true;
+}
+
+BaseType_t queueSend(HostQueue* queue, const void* item, TickType_t ticks) {
+  if (queue == nullptr) {
+    return pdFAIL;
+  }
+  {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!queueWait(queue, lock, ticks, [](HostQueue* q) { return q->items.size() < q->length; })) {
+      return pdFAIL;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(item);
+    queue->items.emplace_back(bytes, bytes + (item != nullptr ? queue->item_size : 0));
+  }
+  queue->cv.notify_all();
+  return pdPASS;
+}
+
+} // namespace
+
+// ============================================================================
+// esp_err / esp_log / esp_timer / esp_random
+// ============================================================================
+
+extern "C" const char* esp_err_to_name(esp_err_t code) {
+  switch (code) {
+    case ESP_OK:
+      return "ESP_OK";
+    case ESP_FAIL:
+      return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+      return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+      return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+      return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_NOT_FOUND:
+      return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_TIMEOUT:
+      return "ESP_ERR_TIMEOUT";
+    default:
+      return "UNKNOWN ERROR";
+  }
+}
+
+extern "C" void esp_log_level_set(const char* tag, esp_log_level_t level) {
+  if (tag != nullptr && std::strcmp(tag, "*") == 0) {
+    g_log_level = level;
+  }
+}
+
+extern "C" void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...) {
+  const int threshold = g_log_level >= 0 ? g_log_level.load() : sim::GetOptions().log_level;
+  if (level == ESP_LOG_NONE || static_cast<int>(level) > threshold) {
+    return;
+  }
+  static constexpr char kLetters[] = {'N', 'E', 'W', 'I', 'D', 'V'};
+  std::lock_guard<std::mutex> lock(g_log_mutex);
+  std::printf("%c (%lld) %s: ", kLetters[level], static_cast<long long>(sim::NowUs() / 1000), tag);
+  va_list args;
+  va_start(args, format);
+  std::vprintf(format, args);
+  va_end(args);
+  std::putchar('\n');
+}
+
+extern "C" int64_t esp_timer_get_time(void) {
+  return sim::NowUs();
+}
+
+extern "C" uint32_t esp_random(void) {
+  std::lock_guard<std::mutex> lock(g_random_mutex);
+  if (g_random_state == 0) {
+    g_random_state = sim::GetOptions().random_seed != 0 ? sim::GetOptions().random_seed : 1U;
+  }
+  g_random_state ^= g_random_state << 13;
+  g_random_state ^= g_random_state >> 17;
+  g_random_state ^= g_random_state << 5;
+  return g_random_state;
+}
+
+// ============================================================================
+// FreeRTOS
+// ============================================================================
+
+extern "C" BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+                                  UBaseType_t priority, TaskHandle_t* out_handle) {
+  auto* task = new HostTask;
+  task->name = name != nullptr ? name : "";
+  task->priority = priority;
+  task->stack_bytes = stack_depth;
+  ++g_live_tasks;
+  g_live_stack_bytes += stack_depth;
+  if (out_handle != nullptr) {
+    *out_handle = task;
+  }
+  std::thread([fn, arg, task] {
+    t_self = task;
+    try {
+      fn(arg);
+    } catch (const TaskExit&) {
+      // vTaskDelete()
+    }
+    --g_live_tasks;
+    g_live_stack_bytes -= task->stack_bytes;
+  }).detach();
+  return pdPASS;
+}
+
+extern "C" void vTaskDelete(TaskHandle_t task) {
+  if (task == nullptr || task == t_self) {
+    throw TaskExit{};
+  }
+  task->deleted = true;
+}
+
+extern "C" void vTaskDelay(TickType_t ticks) {
+  sim::AdvanceUs(static_cast<int64_t>(ticks) * (1000000 / configTICK_RATE_HZ));
+  sim::MarkDelay();
+  std::this_thread::yield();
+  checkDeleted();
+}
+
+extern "C" UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+  task = task != nullptr ? task : t_self;
+  return task != nullptr ? task->priority.load() : t_priority;
+}
+
+extern "C" void vTaskPrioritySet(TaskHandle_t task, UBaseType_t priority) {
+  task = task != nullptr ? task : t_self;
+  if (task != nullptr) {
+    task->priority = priority;
+  } else {
+    t_priority = priority;
+  }
+}
+
+extern "C" TickType_t xTaskGetTickCount(void) {
+  return static_cast<TickType_t>(sim::NowUs() / (1000000 / configTICK_RATE_HZ));
+}
+
+extern "C" TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return t_self;
+}
+
+extern "C" BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  if (task == nullptr) {
+    return pdFAIL;
+  }
+  {
+    std::lock_guard<std::mutex> lock(task->mutex);
+    ++task->notify_count;
+  }
+  task->cv.notify_all();
+  return pdPASS;
+}
+
+extern "C" void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_prio_woken) {
+  if (higher_prio_woken != nullptr) {
+    *higher_prio_woken = pdFALSE;
+  }
+  xTaskNotifyGive(task);
+}
+
+extern "C" uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait) {
+  HostTask* self = t_self;
+  if (self == nullptr) {
+    return 0;  // not called from a task
+  }
+  std::unique_lock<std::mutex> lock(self->mutex);
+  if (self->notify_count == 0) {
+    if (!blockUntil(lock, self->cv, ticks_to_wait, [self] { return self->notify_count != 0; })) {
+      return 0;
+    }
+    ++g_wakeups;
+  }
+  const uint32_t count = self->notify_count;
+  self->notify_count = clear_count_on_exit != pdFALSE ? 0 : count - 1;
+  return count;
+}
+
+extern "C" QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  auto* queue = new HostQueue;
+  queue->length = length;
+  queue->item_size = item_size;
+  ++g_live_queues;
+  g_live_queue_bytes += static_cast<uint64_t>(length) * item_size;
+  return queue;
+}
+
+extern "C" void vQueueDelete(QueueHandle_t queue) {
+  if (queue != nullptr) {
+    --g_live_queues;
+    g_live_queue_bytes -= static_cast<uint64_t>(queue->length) * queue->item_size;
+  }
+  delete queue;
+}
+
+extern "C" BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks_to_wait) {
+  return queueSend(queue, item, ticks_to_wait);
+}
+
+extern "C" BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* higher_prio_woken) {
+  if (higher_prio_woken != nullptr) {
+    *higher_prio_woken = pdFALSE;
+  }
+  return queueSend(queue, item, 0);
+}
+
+extern "C" BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks_to_wait) {
+  if (queue == nullptr) {
+    return pdFAIL;
+  }
+  {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!queueWait(queue, lock, ticks_to_wait, [](HostQueue* q) { return !q->items.empty(); })) {
+      return pdFAIL;
+    }
+    if (item != nullptr && queue->item_size != 0) {
+      std::memcpy(item, queue->items.front().data(), queue->item_size);
+    }
+    queue->items.pop_front();
+  }
+  queue->cv.notify_all();
+  return pdPASS;
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+extern "C" esp_err_t gpio_config(const gpio_config_t* config) {
+  if (config == nullptr || (config->pin_bit_mask >> kGpioCount) != 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  wireBoard();
+  return ESP_OK;
+}
+
+extern "C" esp_err_t gpio_reset_pin(gpio_num_t gpio_num) {
+  if (gpio_num < 0 || gpio_num >= kGpioCount) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(g_gpio_mutex);
+  g_gpio_levels[gpio_num] = 0;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+  if (gpio_num < 0 || gpio_num >= kGpioCount) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(g_gpio_mutex);
+  g_gpio_levels[gpio_num] = level != 0 ? 1 : 0;
+  if (gpio_num == kBoard.a0 || gpio_num == kBoard.a1 || gpio_num == kBoard.a2) {
+    updateStraps();
+  }
+  return ESP_OK;
+}
+
+extern "C" int gpio_get_level(gpio_num_t gpio_num) {
+  if (gpio_num < 0 || gpio_num >= kGpioCount) {
+    return 0;
+  }
+  if (gpio_num == kBoard.int_n) {
+    std::lock_guard<std::mutex> lock(g_bus_mutex);
+    return sim::Device().IntAsserted() ? 0 : 1;
+  }
+  std::lock_guard<std::mutex> lock(g_gpio_mutex);
+  return static_cast<int>(g_gpio_levels[gpio_num]);
+}
+
+extern "C" esp_err_t gpio_install_isr_service(int intr_alloc_flags) {
+  (void)intr_alloc_flags;
+  std::lock_guard<std::mutex> lock(g_gpio_mutex);
+  if (g_isr_service_installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  g_isr_service_installed = true;
+  return ESP_OK;
+}
+
+extern "C" void gpio_uninstall_isr_service(void) {
+  std::lock_guard<std::mutex> lock(g_gpio_mutex);
+  g_isr_service_installed = false;
+  g_isr_handlers.fill(nullptr);
+}
+
+extern "C" esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void* args) {
+  if (gpio_num < 0 || gpio_num >= kGpioCount) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  wireBoard();
+  std::lock_guard<std::mutex> lock(g_gpio_mutex);
+  if (!g_isr_service_installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  g_isr_handlers[gpio_num] = isr_handler;
+  g_isr_args[gpio_num] = args;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num) {
+  if (gpio_num < 0 || gpio_num >= kGpioCount) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(g_gpio_mutex);
+  g_isr_handlers[gpio_num] = nullptr;
+  g_isr_args[gpio_num] = nullptr;
+  return ESP_OK;
+}
+
+// ============================================================================
+// Simulation hooks (host_sim.hpp)
+// ============================================================================
+
+namespace pcal95555::sim {
+
+RtosUsage GetRtosUsage() noexcept {
+  RtosUsage usage;
+  usage.tasks = g_live_tasks;
+  usage.stack_bytes = g_live_stack_bytes;
+  usage.queues = g_live_queues;
+  usage.queue_bytes = g_live_queue_bytes;
+  usage.wakeups = g_wakeups;
+  return usage;
+}
+
+bool RaiseGpioEdge(int gpio) {
+  if (gpio < 0 || gpio >= kGpioCount) {
+    return false;
+  }
+  gpio_isr_t handler = nullptr;
+  void* arg = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(g_gpio_mutex);
+    if (g_isr_service_installed) {
+      handler = g_isr_handlers[gpio];
+      arg = g_isr_args[gpio];
+    }
+  }
+  if (handler == nullptr) {
+    return false;
+  }
+  handler(arg);
+  return true;
+}
+
+} // namespace pcal95555::sim
+
+// ============================================================================
+// I2C master
+// ============================================================================
+
+extern "C" esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t* config,
+                                        i2c_master_bus_handle_t* ret_handle) {
+  if (config == nullptr || ret_handle == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  wireBoard();
+  *ret_handle = new HostI2cBus{config->flags.enable_internal_pullup != 0};
+  return ESP_OK;
+}
+
+extern "C" esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t bus) {
+  delete bus;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus, const i2c_device_config_t* config,
+                                               i2c_master_dev_handle_t* ret_handle) {
+  if (bus == nullptr || config == nullptr || ret_handle == nullptr || config->scl_speed_hz == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *ret_handle = new HostI2cDevice{bus, config->device_address, config->scl_speed_hz};
+  return ESP_OK;
+}
+
+extern "C" esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t dev) {
+  delete dev;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t i2c_master_transmit(i2c_master_dev_handle_t dev, const uint8_t* write_buffer,
+                                         size_t write_size, int xfer_timeout_ms) {
+  (void)xfer_timeout_ms;
+  return transfer(dev, write_buffer, write_size, nullptr, 0);
+}
+
+extern "C" esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t dev, const uint8_t* write_buffer,
+                                                 size_t write_size, uint8_t* read_buffer, size_t read_size,
+                                                 int xfer_timeout_ms) {
+  (void)xfer_timeout_ms;
+  return transfer(dev, write_buffer, write_size, read_buffer, read_size);
+}
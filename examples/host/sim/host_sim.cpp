@@ -0,0 +1,183 @@
+/**
+ * @file host_sim.cpp
+ * @brief Simulation clock, simulated expander and per-section bus report
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#include "host_sim.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+
+namespace pcal95555::sim {
+
+namespace {
+
+std::atomic<int64_t> g_now_us{0};
+std::mutex g_report_mutex;
+Options g_options;
+SimPcal95555Device g_device;
+std::vector<SectionStats> g_sections;
+bool g_frame_open = false;
+int64_t g_last_frame_start_us = -1;
+
+SectionStats& current() {
+  if (g_sections.empty()) {
+    g_sections.push_back(SectionStats{"startup", 0, 0, 0, 0, 0, NowUs(), NowUs(), 0, 0, 0, 0});
+  }
+  return g_sections.back();
+}
+
+/// Bits on the wire: START, address+R/W, each byte + ACK, repeated START, STOP.
+uint64_t transferBits(bool is_read, size_t write_len, size_t read_len) {
+  uint64_t bits = 1 + 9 + 9 * static_cast<uint64_t>(write_len) + 1;
+  if (is_read) {
+    bits += 1 + 9 + 9 * static_cast<uint64_t>(read_len);
+  }
+  return bits;
+}
+
+const char* variantName(SimVariant variant) {
+  return variant == SimVariant::PCA9555 ? "PCA9555" : "PCAL9555A";
+}
+
+double ms(uint64_t us) {
+  return static_cast<double>(us) / 1000.0;
+}
+
+} // namespace
+
+int64_t NowUs() noexcept {
+  return g_now_us.load(std::memory_order_relaxed);
+}
+
+void AdvanceUs(int64_t us) noexcept {
+  g_now_us.fetch_add(us, std::memory_order_relaxed);
+}
+
+void Configure(const Options& options) {
+  std::lock_guard<std::mutex> lock(g_report_mutex);
+  g_options = options;
+  g_now_us = 0;
+  g_device.SetVariant(options.variant);
+  g_sections.clear();
+  g_frame_open = false;
+  g_last_frame_start_us = -1;
+}
+
+const Options& GetOptions() noexcept {
+  return g_options;
+}
+
+SimPcal95555Device& Device() noexcept {
+  return g_device;
+}
+
+void BeginSection(const char* name) {
+  std::lock_guard<std::mutex> lock(g_report_mutex);
+  current().end_us = NowUs();
+  g_sections.push_back(SectionStats{name, 0, 0, 0, 0, 0, NowUs(), NowUs(), 0, 0, 0, 0});
+  g_frame_open = false;
+  g_last_frame_start_us = -1;
+}
+
+void MarkDelay() noexcept {
+  std::lock_guard<std::mutex> lock(g_report_mutex);
+  g_frame_open = false;
+}
+
+void RecordTransfer(bool is_read, size_t write_len, size_t read_len, uint32_t scl_hz, bool acked,
+                    bool touches_outputs) noexcept {
+  const uint64_t bits = transferBits(is_read, write_len, acked ? read_len : 0);
+  const uint64_t bus_us = (bits * 1000000U + scl_hz - 1) / (scl_hz != 0 ? scl_hz : 100000U);
+  std::lock_guard<std::mutex> lock(g_report_mutex);
+  SectionStats& s = current();
+  (is_read ? s.reads : s.writes) += 1;
+  s.bytes += 1 + write_len + (is_read ? 1 + read_len : 0);
+  s.nacks += acked ? 0 : 1;
+  s.bus_us += bus_us;
+  if (touches_outputs && acked) {
+    if (!g_frame_open) {
+      g_frame_open = true;
+      ++s.frames;
+      const int64_t now = NowUs();
+      if (g_last_frame_start_us >= 0) {
+        const auto gap = static_cast<uint64_t>(now - g_last_frame_start_us);
+        s.frame_gap_sum_us += gap;
+        s.frame_gap_max_us = std::max(s.frame_gap_max_us, gap);
+      }
+      g_last_frame_start_us = now;
+    }
+    s.frame_bus_sum_us += bus_us;
+  }
+  AdvanceUs(static_cast<int64_t>(bus_us));
+}
+
+std::vector<SectionStats> Sections() {
+  std::lock_guard<std::mutex> lock(g_report_mutex);
+  current().end_us = NowUs();
+  return g_sections;
+}
+
+void PrintReport() {
+  const std::vector<SectionStats> sections = Sections();
+  SectionStats total{"TOTAL", 0, 0, 0, 0, 0, 0, NowUs(), 0, 0, 0, 0};
+  for (const auto& s : sections) {
+    total.reads += s.reads;
+    total.writes += s.writes;
+    total.bytes += s.bytes;
+    total.nacks += s.nacks;
+    total.bus_us += s.bus_us;
+    total.frames += s.frames;
+  }
+
+  std::printf("\n=== Host simulation report: %s @ 0x%02X ===\n", variantName(g_options.variant),
+              g_device.Address());
+  std::printf("%-36s %8s %8s %9s %6s %10s %10s %8s %11s %11s %9s\n", "section", "reads", "writes",
+              "bytes", "nacks", "bus_ms", "sim_ms", "frames", "frame_avg", "frame_max", "txn/s");
+  auto row = [](const SectionStats& s) {
+    const double sim_ms = ms(static_cast<uint64_t>(s.end_us - s.start_us));
+    const double gaps = s.frames > 1 ? static_cast<double>(s.frames - 1) : 0.0;
+    const double frame_avg = gaps > 0 ? ms(s.frame_gap_sum_us) / gaps : 0.0;
+    const double txn_s = sim_ms > 0 ? static_cast<double>(s.reads + s.writes) * 1000.0 / sim_ms : 0.0;
+    std::printf("%-36.36s %8llu %8llu %9llu %6llu %10.2f %10.2f %8llu %11.3f %11.3f %9.0f\n",
+                s.name.c_str(), static_cast<unsigned long long>(s.reads),
+                static_cast<unsigned long long>(s.writes), static_cast<unsigned long long>(s.bytes),
+                static_cast<unsigned long long>(s.nacks), ms(s.bus_us), sim_ms,
+                static_cast<unsigned long long>(s.frames), frame_avg, ms(s.frame_gap_max_us), txn_s);
+  };
+  for (const auto& s : sections) {
+    row(s);
+  }
+  row(total);
+  std::fflush(stdout);
+
+  if (g_options.report_json.empty()) {
+    return;
+  }
+  std::FILE* f = std::fopen(g_options.report_json.c_str(), "w");
+  if (f == nullptr) {
+    std::fprintf(stderr, "host_sim: cannot write %s\n", g_options.report_json.c_str());
+    return;
+  }
+  std::fprintf(f, "{\n  \"variant\": \"%s\",\n  \"sections\": [\n", variantName(g_options.variant));
+  for (size_t i = 0; i < sections.size(); ++i) {
+    const SectionStats& s = sections[i];
+    std::fprintf(f,
+                 "    {\"name\": \"%s\", \"reads\": %llu, \"writes\": %llu, \"bytes\": %llu, "
+                 "\"nacks\": %llu, \"bus_us\": %llu, \"sim_us\": %lld, \"frames\": %llu, "
+                 "\"frame_gap_sum_us\": %llu, \"frame_gap_max_us\": %llu, \"frame_bus_us\": %llu}%s\n",
+                 s.name.c_str(), static_cast<unsigned long long>(s.reads),
+                 static_cast<unsigned long long>(s.writes), static_cast<unsigned long long>(s.bytes),
+                 static_cast<unsigned long long>(s.nacks), static_cast<unsigned long long>(s.bus_us),
+                 static_cast<long long>(s.end_us - s.start_us), static_cast<unsigned long long>(s.frames),
+                 static_cast<unsigned long long>(s.frame_gap_sum_us),
+                 static_cast<unsigned long long>(s.frame_gap_max_us),
+                 static_cast<unsigned long long>(s.frame_bus_sum_us), i + 1 < sections.size() ? "," : "");
+  }
+  std::fprintf(f, "  ]\n}\n");
+  std::fclose(f);
+}
+
+} // namespace pcal95555::sim
@@ -0,0 +1,94 @@
+/**
+ * @file host_sim.hpp
+ * @brief Host simulation of the ESP32-S3 example board
+ *
+ * Owns the simulation clock, the simulated expander wired to the ESP-IDF
+ * shims, and the per-section bus report. Examples mark sections through the
+ * hooks in host_example_hooks.h; everything else is driven through the
+ * unmodified ESP-IDF calls the examples already make.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sim_pcal95555_device.hpp"
+
+namespace pcal95555::sim {
+
+/// Board wiring of the ESP32-S3 examples (see examples/esp32/README.md).
+struct BoardPins {
+  int a0 = 45;
+  int a1 = 48;
+  int a2 = 47;
+  int int_n = 7;
+};
+
+/// Run options, set from the command line before app_main() starts.
+struct Options {
+  SimVariant variant = SimVariant::PCAL9555A;
+  int log_level = 3;          ///< esp_log_level_t threshold (3 = INFO)
+  std::string report_json;    ///< Write the report here as JSON (empty = off)
+  uint32_t random_seed = 0x2545F491U;
+};
+
+/// Bus and timing counters for one report section.
+struct SectionStats {
+  std::string name;
+  uint64_t reads = 0;          ///< write-pointer + read transfers
+  uint64_t writes = 0;         ///< write transfers
+  uint64_t bytes = 0;          ///< bytes on the wire, address bytes included
+  uint64_t nacks = 0;
+  uint64_t bus_us = 0;         ///< modelled SCL time
+  int64_t start_us = 0;
+  int64_t end_us = 0;
+  uint64_t frames = 0;         ///< bursts of output writes between task delays
+  uint64_t frame_gap_sum_us = 0;
+  uint64_t frame_gap_max_us = 0;
+  uint64_t frame_bus_sum_us = 0;
+};
+
+/// Simulation clock in microseconds.
+int64_t NowUs() noexcept;
+void AdvanceUs(int64_t us) noexcept;
+
+/// Configure and reset the simulation. Call once before app_main().
+void Configure(const Options& options);
+const Options& GetOptions() noexcept;
+
+/// The simulated expander (for host-side stimulus, e.g. DriveInputs()).
+SimPcal95555Device& Device() noexcept;
+
+/// Close the current report section and open a new one.
+void BeginSection(const char* name);
+
+/// Task delay boundary: ends the current output frame.
+void MarkDelay() noexcept;
+
+/// Record one I2C transfer (called by the I2C shim).
+void RecordTransfer(bool is_read, size_t write_len, size_t read_len, uint32_t scl_hz, bool acked,
+                    bool touches_outputs) noexcept;
+
+/// Snapshot of all sections recorded so far (current one included).
+std::vector<SectionStats> Sections();
+
+/// Kernel objects alive in the shims, and how often tasks woke from a wait.
+struct RtosUsage {
+  uint32_t tasks = 0;
+  uint64_t stack_bytes = 0;   ///< Sum of xTaskCreate() stack depths (bytes on ESP-IDF)
+  uint32_t queues = 0;        ///< Queues and semaphores
+  uint64_t queue_bytes = 0;   ///< Item storage of those queues
+  uint64_t wakeups = 0;       ///< Blocking waits that ended with an item or notification
+};
+RtosUsage GetRtosUsage() noexcept;
+
+/// Run the ISR registered on @p gpio, as a falling edge on that pin would.
+/// @return false if no handler is registered there.
+bool RaiseGpioEdge(int gpio);
+
+/// Print the report table to stdout and write the JSON file if requested.
+void PrintReport();
+
+} // namespace pcal95555::sim
@@ -0,0 +1,237 @@
+/**
+ * @file sim_pcal95555_device.hpp
+ * @brief Register-level model of a PCA9555 / PCAL9555A for host builds
+ *
+ * Models what the driver and the examples can observe over I2C:
+ * - Register file with power-on defaults, pair-wise auto-increment
+ *   (the pointer toggles between the two registers of a pair)
+ * - NACK on Agile I/O registers (0x40-0x4F) when modelling a PCA9555
+ * - Pad levels: outputs drive their pins, inputs read an external driver,
+ *   the PCAL9555A pull resistors, or float high
+ * - Polarity inversion, input latch, interrupt mask/status and the INT line
+ *
+ * Not modelled: drive strength (stored only), electrical contention, bus
+ * timing (accounted by the host I2C shim).
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace pcal95555::sim {
+
+/// Chip variant modelled by SimPcal95555Device.
+enum class SimVariant : uint8_t { PCA9555, PCAL9555A };
+
+class SimPcal95555Device {
+public:
+  static constexpr uint8_t kBaseAddress = 0x20;
+
+  explicit SimPcal95555Device(SimVariant variant = SimVariant::PCAL9555A) noexcept : variant_(variant) {
+    Reset();
+  }
+
+  /// Restore power-on register defaults (as after a POR or RESET pulse).
+  void Reset() noexcept {
+    regs_.fill(0);
+    regs_[0x02] = regs_[0x03] = 0xFF;  // OUTPUT
+    regs_[0x06] = regs_[0x07] = 0xFF;  // CONFIG: all inputs
+    for (uint8_t r = 0x40; r <= 0x43; ++r) {
+      regs_[r] = 0xFF;                 // DRIVE_STRENGTH: full drive
+    }
+    regs_[0x48] = regs_[0x49] = 0xFF;  // PULL_SELECT: pull-up
+    regs_[0x4A] = regs_[0x4B] = 0xFF;  // INT_MASK: all masked
+    status_ = 0;
+    latched_ = 0;
+    last_read_ = inputRegister();
+    updateInt();
+  }
+
+  [[nodiscard]] SimVariant Variant() const noexcept { return variant_; }
+  void SetVariant(SimVariant variant) noexcept {
+    variant_ = variant;
+    Reset();
+  }
+
+  /// 7-bit address selected by the A2-A0 straps.
+  [[nodiscard]] uint8_t Address() const noexcept { return kBaseAddress | straps_; }
+  void SetAddressStraps(uint8_t bits) noexcept { straps_ = bits & 0x07; }
+
+  /**
+   * @brief Bus write: data[0] is the register pointer, the rest are payload.
+   * @return false if the pointer addresses a register the chip NACKs.
+   */
+  bool Write(const uint8_t* data, size_t len) noexcept {
+    if (len == 0) {
+      return true;
+    }
+    uint8_t reg = data[0];
+    if (!exists(reg)) {
+      return false;
+    }
+    pointer_ = reg;
+    for (size_t i = 1; i < len; ++i) {
+      writeReg(reg, data[i]);
+      reg = next(reg);
+    }
+    pointer_ = reg;
+    refresh();
+    return true;
+  }
+
+  /**
+   * @brief Bus read starting at the register pointer set by the write phase.
+   * @return false if the register is NACKed.
+   */
+  bool Read(uint8_t reg, uint8_t* out, size_t len) noexcept {
+    if (!exists(reg)) {
+      return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+      out[i] = readReg(reg);
+      reg = next(reg);
+    }
+    pointer_ = reg;
+    updateInt();
+    return true;
+  }
+
+  /// Drive input pins from outside the chip (bit N of @p levels for pin N).
+  void DriveInputs(uint16_t mask, uint16_t levels) noexcept {
+    ext_mask_ |= mask;
+    ext_levels_ = static_cast<uint16_t>((ext_levels_ & ~mask) | (levels & mask));
+    refresh();
+  }
+
+  /// Stop driving the pins in @p mask (they fall back to pull / float).
+  void ReleaseInputs(uint16_t mask) noexcept {
+    ext_mask_ &= static_cast<uint16_t>(~mask);
+    refresh();
+  }
+
+  /// Actual pad levels, bit N = pin N.
+  [[nodiscard]] uint16_t PinLevels() const noexcept {
+    const uint16_t config = pair(0x06);
+    const uint16_t output = pair(0x02);
+    uint16_t released = config;  // inputs do not drive the pad
+    if (agile()) {
+      // Open-drain ports release the pad for a HIGH output.
+      if ((regs_[0x4F] & 0x01) != 0) {
+        released |= static_cast<uint16_t>(output & 0x00FF);
+      }
+      if ((regs_[0x4F] & 0x02) != 0) {
+        released |= static_cast<uint16_t>(output & 0xFF00);
+      }
+    }
+    uint16_t idle = 0xFFFF;  // floating pins read HIGH (board pull-ups)
+    if (agile()) {
+      const uint16_t pull_en = pair(0x46);
+      idle = static_cast<uint16_t>((idle & ~pull_en) | (pair(0x48) & pull_en));
+    }
+    const uint16_t external = static_cast<uint16_t>((ext_levels_ & ext_mask_) | (idle & ~ext_mask_));
+    return static_cast<uint16_t>((output & ~released) | (external & released));
+  }
+
+  /// Output registers as written by the host (bit N = pin N).
+  [[nodiscard]] uint16_t OutputRegister() const noexcept { return pair(0x02); }
+
+  /// INT output (active-low open drain): true while asserted.
+  [[nodiscard]] bool IntAsserted() const noexcept { return int_asserted_; }
+
+  /// Called on every INT transition with the new asserted state.
+  void SetIntListener(std::function<void(bool asserted)> listener) { int_listener_ = std::move(listener); }
+
+private:
+  SimVariant variant_;
+  std::array<uint8_t, 256> regs_{};
+  uint8_t straps_{0};
+  uint8_t pointer_{0};
+  uint16_t ext_mask_{0};
+  uint16_t ext_levels_{0};
+  uint16_t last_read_{0};  // input register value as last seen by the host
+  uint16_t status_{0};     // pending interrupt sources
+  uint16_t latched_{0};    // values captured by the input latch
+  bool int_asserted_{false};
+  std::function<void(bool)> int_listener_;
+
+  [[nodiscard]] bool agile() const noexcept { return variant_ == SimVariant::PCAL9555A; }
+
+  [[nodiscard]] bool exists(uint8_t reg) const noexcept {
+    if (reg <= 0x07) {
+      return true;
+    }
+    return agile() && ((reg >= 0x40 && reg <= 0x4D) || reg == 0x4F);
+  }
+
+  /// Register pairs auto-increment within the pair; OUTPUT_CONF stays put.
+  [[nodiscard]] static uint8_t next(uint8_t reg) noexcept {
+    return reg == 0x4F ? reg : static_cast<uint8_t>(reg ^ 0x01);
+  }
+
+  [[nodiscard]] uint16_t pair(uint8_t reg0) const noexcept {
+    return static_cast<uint16_t>(regs_[reg0] | (regs_[reg0 + 1] << 8));
+  }
+
+  [[nodiscard]] uint16_t inputRegister() const noexcept {
+    return static_cast<uint16_t>(PinLevels() ^ pair(0x04));
+  }
+
+  [[nodiscard]] uint16_t latchEnabled() const noexcept { return agile() ? pair(0x44) : 0; }
+
+  void writeReg(uint8_t reg, uint8_t value) noexcept {
+    if (reg <= 0x01 || reg == 0x4C || reg == 0x4D) {
+      return;  // read-only
+    }
+    regs_[reg] = value;
+  }
+
+  uint8_t readReg(uint8_t reg) noexcept {
+    if (reg <= 0x01) {
+      const uint16_t port_mask = reg == 0 ? 0x00FF : 0xFF00;
+      const uint16_t live = inputRegister();
+      const uint16_t latch = static_cast<uint16_t>(latchEnabled() & status_ & port_mask);
+      const uint16_t value = static_cast<uint16_t>((live & ~latch) | (latched_ & latch));
+      // Reading the input port acknowledges the port's interrupt sources.
+      last_read_ = static_cast<uint16_t>((last_read_ & ~port_mask) | (live & port_mask));
+      status_ &= static_cast<uint16_t>(~port_mask);
+      return static_cast<uint8_t>(reg == 0 ? value : value >> 8);
+    }
+    if (reg == 0x4C || reg == 0x4D) {
+      const auto status = static_cast<uint16_t>(status_ & ~pair(0x4A));
+      return static_cast<uint8_t>(reg == 0x4C ? status : status >> 8);
+    }
+    return regs_[reg];
+  }
+
+  /// Re-evaluate interrupt sources after pad levels may have changed.
+  void refresh() noexcept {
+    const uint16_t inputs = pair(0x06);
+    const uint16_t enabled = agile() ? static_cast<uint16_t>(~pair(0x4A)) : 0xFFFF;
+    const uint16_t live = inputRegister();
+    const auto changed = static_cast<uint16_t>((live ^ last_read_) & inputs & enabled);
+    const auto fresh = static_cast<uint16_t>(changed & ~status_);
+    latched_ = static_cast<uint16_t>((latched_ & ~fresh) | (live & fresh));
+    status_ |= changed;
+    if (latchEnabled() == 0) {
+      // Without the latch a pin that returns to its last-read level clears its source.
+      status_ &= static_cast<uint16_t>(~(~changed & inputs));
+    }
+    updateInt();
+  }
+
+  void updateInt() noexcept {
+    const uint16_t enabled = agile() ? static_cast<uint16_t>(~pair(0x4A)) : 0xFFFF;
+    const bool asserted = (status_ & enabled) != 0;
+    if (asserted != int_asserted_) {
+      int_asserted_ = asserted;
+      if (int_listener_) {
+        int_listener_(asserted);
+      }
+    }
+  }
+};
+
+} // namespace pcal95555::sim
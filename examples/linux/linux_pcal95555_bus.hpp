@@ -0,0 +1,107 @@
+/**
+ * @file linux_pcal95555_bus.hpp
+ * @brief Linux i2c-dev implementation of the pcal95555::I2cInterface
+ *
+ * Talks to `/dev/i2c-N` through the `I2C_RDWR` ioctl, so each driver call is
+ * one combined transfer (register write + repeated-start read for reads) and
+ * one bus object can serve every expander on the adapter: the target address
+ * travels with each message instead of being bound with `I2C_SLAVE`.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "pcal95555.hpp"
+
+/**
+ * @brief I2C bus on a Linux i2c-dev adapter.
+ *
+ * The device node is opened lazily by EnsureInitialized() (called by the
+ * driver on first use), so constructing the bus never fails.
+ */
+class LinuxPcal95555I2cBus : public pcal95555::I2cInterface<LinuxPcal95555I2cBus> {
+public:
+  /**
+   * @param device Adapter node, e.g. "/dev/i2c-1".
+   */
+  explicit LinuxPcal95555I2cBus(std::string device) noexcept : device_(std::move(device)) {}
+
+  ~LinuxPcal95555I2cBus() { Close(); }
+
+  LinuxPcal95555I2cBus(const LinuxPcal95555I2cBus&) = delete;
+  LinuxPcal95555I2cBus& operator=(const LinuxPcal95555I2cBus&) = delete;
+
+  /**
+   * @brief Open the adapter node if it is not open yet.
+   * @return true if the node is open.
+   */
+  bool EnsureInitialized() noexcept {
+    if (fd_ >= 0) {
+      return true;
+    }
+    fd_ = ::open(device_.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd_ < 0) {
+      std::fprintf(stderr, "pcal95555: cannot open %s: %s\n", device_.c_str(), std::strerror(errno));
+      return false;
+    }
+    return true;
+  }
+
+  /// Close the adapter node (reopened on the next EnsureInitialized()).
+  void Close() noexcept {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    std::array<uint8_t, 32> buffer{};  // register + payload; the driver writes at most a pair
+    if (len + 1 > buffer.size() || !EnsureInitialized()) {
+      return false;
+    }
+    buffer[0] = reg;
+    if (len > 0) {
+      std::memcpy(&buffer[1], data, len);
+    }
+    i2c_msg msg{addr, 0, static_cast<uint16_t>(len + 1), buffer.data()};
+    return transfer(&msg, 1);
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    if (data == nullptr || len == 0 || !EnsureInitialized()) {
+      return false;
+    }
+    std::array<i2c_msg, 2> msgs{{
+        {addr, 0, 1, &reg},
+        {addr, I2C_M_RD, static_cast<uint16_t>(len), data},
+    }};
+    return transfer(msgs.data(), msgs.size());
+  }
+
+  /// Adapter node this bus was created for.
+  [[nodiscard]] const std::string& Device() const noexcept { return device_; }
+
+private:
+  bool transfer(i2c_msg* msgs, size_t count) noexcept {
+    i2c_rdwr_ioctl_data xfer{msgs, static_cast<uint32_t>(count)};
+    // A NACK surfaces as EREMOTEIO/ENXIO; the driver's retry policy handles it.
+    return ::ioctl(fd_, I2C_RDWR, &xfer) == static_cast<int>(count);
+  }
+
+  std::string device_;
+  int fd_{-1};
+};
@@ -0,0 +1,522 @@
+/**
+ * @file pcal95555_daemon.hpp
+ * @brief Multi-process expander daemon: request coalescing + shared-memory mirror
+ *
+ * ExpanderDaemon owns one PCAL95555 driver per configured expander on a
+ * single I2C bus and serves local clients over a Unix SOCK_SEQPACKET socket
+ * (see pcal95555_daemon_protocol.hpp). Each loop iteration:
+ *
+ * 1. Waits in poll() for client requests or the next input refresh.
+ * 2. Drains every request that is waiting and merges their set/clear masks
+ *    per expander, in arrival order.
+ * 3. Issues at most one output update per expander (one paired
+ *    WriteAllOutputs() of the kept output image, no read-back; none if
+ *    nothing changes).
+ * 4. Reads the inputs of expanders a client asked about, or of all of them
+ *    once the poll interval has elapsed.
+ * 5. Publishes changed state into the seqlock mirror
+ *    (pcal95555_shm_state.hpp) and answers the requests.
+ *
+ * Clients that only need state read the mirror and never talk to the daemon.
+ *
+ * The daemon is templated on the bus type so it can run against the Linux
+ * i2c-dev bus (pcal95555d.cpp) or any other I2cInterface implementation.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "pcal95555.hpp"
+#include "pcal95555_daemon_protocol.hpp"
+#include "pcal95555_shm_state.hpp"
+
+namespace pcal95555::daemon {
+
+/// One expander owned by the daemon.
+struct ExpanderConfig {
+  uint8_t address = 0x20;          ///< 7-bit I2C address (0x20-0x27)
+  uint16_t output_mask = 0x0000;   ///< Pins configured as outputs; the rest are inputs
+  uint16_t initial_outputs = 0;    ///< Output levels driven at startup
+  ChipVariant variant = ChipVariant::Unknown;
+};
+
+struct DaemonOptions {
+  std::string socket_path = kDefaultSocketPath;
+  std::string shm_name = kDefaultShmName;
+  uint32_t poll_interval_ms = 10;  ///< Input refresh period (0 = only on Read requests)
+  std::vector<ExpanderConfig> expanders;
+};
+
+/// Counters for tuning the coalescing (printed by pcal95555d on exit).
+struct DaemonStats {
+  uint64_t requests = 0;       ///< Requests received
+  uint64_t ops = 0;            ///< Pin operations received
+  uint64_t output_writes = 0;  ///< Output updates issued on the bus
+  uint64_t skipped_writes = 0; ///< Merged updates that changed nothing (no bus access)
+  uint64_t input_reads = 0;    ///< Input refreshes issued on the bus
+  uint64_t rounds = 0;         ///< Loop iterations that handled at least one request
+};
+
+template <typename I2cType>
+class ExpanderDaemon {
+public:
+  using Driver = PCAL95555<I2cType>;
+
+  ExpanderDaemon(I2cType& bus, DaemonOptions options) noexcept : bus_(bus), options_(std::move(options)) {}
+
+  ~ExpanderDaemon() { Stop(); }
+
+  ExpanderDaemon(const ExpanderDaemon&) = delete;
+  ExpanderDaemon& operator=(const ExpanderDaemon&) = delete;
+
+  /**
+   * @brief Configure the expanders, create the mirror and start listening.
+   * @return false if an expander does not respond or a resource cannot be created.
+   */
+  bool Start() noexcept;
+
+  /**
+   * @brief Close clients, remove the socket and unlink the mirror.
+   */
+  void Stop() noexcept;
+
+  /**
+   * @brief Run one loop iteration (wait, drain, flush, publish, reply).
+   * @param max_wait_ms Upper bound on the poll() wait (-1 = until the next refresh).
+   * @return false on a fatal socket error.
+   */
+  bool RunOnce(int max_wait_ms = -1) noexcept;
+
+  /**
+   * @brief Loop until @p stop becomes true.
+   */
+  template <typename StopFlag>
+  void Run(const StopFlag& stop) noexcept {
+    while (!stop) {
+      if (!RunOnce(100)) {
+        return;
+      }
+    }
+  }
+
+  [[nodiscard]] const DaemonStats& Stats() const noexcept { return stats_; }
+
+private:
+  struct Expander {
+    ExpanderConfig config;
+    std::unique_ptr<Driver> driver;
+    ExpanderState state;
+    uint16_t pending_set = 0;
+    uint16_t pending_clear = 0;
+    bool dirty = false;          // pending output change
+    bool refresh_inputs = false; // a client asked for fresh inputs
+    bool failed = false;         // a bus access failed this round
+    bool publish = false;
+  };
+
+  struct PendingReply {
+    int fd;
+    Request request;
+  };
+
+  I2cType& bus_;
+  DaemonOptions options_;
+  std::vector<Expander> expanders_;
+  std::vector<int> clients_;
+  std::vector<PendingReply> replies_;
+  int listen_fd_{-1};
+  ShmSegment* shm_{nullptr};
+  bool started_{false};
+  uint64_t next_refresh_ns_{0};
+  DaemonStats stats_{};
+
+  static uint64_t nowNs() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+  }
+
+  bool configureExpander(Expander& e) noexcept;
+  bool createMirror() noexcept;
+  bool createSocket() noexcept;
+  void acceptClients() noexcept;
+  void drainClient(int fd) noexcept;
+  void closeClient(int fd) noexcept;
+  bool queueRequest(const Request& request) noexcept;
+  void flushOutputs() noexcept;
+  void refreshInputs(bool all) noexcept;
+  void publish() noexcept;
+  void sendReplies() noexcept;
+  void sendResponse(int fd, const Response& response) noexcept;
+};
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+template <typename I2cType>
+bool ExpanderDaemon<I2cType>::Start() noexcept {
+  if (started_) {
+    return true;
+  }
+  if (options_.expanders.empty() || options_.expanders.size() > kMaxExpanders) {
+    std::fprintf(stderr, "pcal95555d: need 1-%zu expanders\n", kMaxExpanders);
+    return false;
+  }
+  expanders_.clear();
+  expanders_.reserve(options_.expanders.size());
+  for (const ExpanderConfig& config : options_.expanders) {
+    Expander& e = expanders_.emplace_back();
+    e.config = config;
+    e.driver = std::make_unique<Driver>(&bus_, config.address, config.variant);
+    if (!configureExpander(e)) {
+      std::fprintf(stderr, "pcal95555d: expander 0x%02X not responding\n", config.address);
+      return false;
+    }
+  }
+  if (!createMirror() || !createSocket()) {
+    Stop();
+    return false;
+  }
+  started_ = true;
+  return true;
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::Stop() noexcept {
+  for (int fd : clients_) {
+    ::close(fd);
+  }
+  clients_.clear();
+  replies_.clear();
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    ::unlink(options_.socket_path.c_str());
+  }
+  if (shm_ != nullptr) {
+    shm_->ready.store(0, std::memory_order_release);
+    ::munmap(shm_, sizeof(ShmSegment));
+    shm_ = nullptr;
+    ::shm_unlink(options_.shm_name.c_str());
+  }
+  started_ = false;
+}
+
+template <typename I2cType>
+bool ExpanderDaemon<I2cType>::configureExpander(Expander& e) noexcept {
+  Driver& drv = *e.driver;
+  const uint16_t outputs = e.config.output_mask;
+  // Drive the initial levels before turning pins into outputs so they never glitch.
+  // From here on state.outputs is the OUTPUT register image (input pins' latches 0).
+  const auto initial = static_cast<uint16_t>(e.config.initial_outputs & outputs);
+  bool ok = drv.EnsureInitialized() && drv.WriteAllOutputs(initial);
+  if (ok && outputs != 0) {
+    ok = drv.SetMultipleDirections(outputs, GPIODir::Output);
+  }
+  if (ok && outputs != 0xFFFF) {
+    ok = drv.SetMultipleDirections(static_cast<uint16_t>(~outputs), GPIODir::Input);
+  }
+  if (!ok) {
+    return false;
+  }
+  e.state.address = drv.GetAddress();
+  e.state.variant = static_cast<uint8_t>(drv.GetChipVariant());
+  e.state.directions = static_cast<uint16_t>(~outputs);
+  e.state.outputs = initial;
+  e.state.inputs = drv.ReadAllInputs();
+  e.state.error_flags = drv.GetErrorFlags();
+  e.state.updated_ns = nowNs();
+  e.publish = true;
+  return true;
+}
+
+template <typename I2cType>
+bool ExpanderDaemon<I2cType>::createMirror() noexcept {
+  const int fd = ::shm_open(options_.shm_name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    std::fprintf(stderr, "pcal95555d: shm_open(%s): %s\n", options_.shm_name.c_str(), std::strerror(errno));
+    return false;
+  }
+  void* mem = MAP_FAILED;
+  if (::ftruncate(fd, sizeof(ShmSegment)) == 0) {
+    mem = ::mmap(nullptr, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  ::close(fd);
+  if (mem == MAP_FAILED) {
+    std::fprintf(stderr, "pcal95555d: cannot map %s: %s\n", options_.shm_name.c_str(), std::strerror(errno));
+    ::shm_unlink(options_.shm_name.c_str());
+    return false;
+  }
+  shm_ = ::new (mem) ShmSegment{};
+  shm_->magic = kShmMagic;
+  shm_->version = kShmVersion;
+  shm_->slot_count = static_cast<uint16_t>(expanders_.size());
+  shm_->daemon_pid.store(static_cast<uint32_t>(::getpid()), std::memory_order_relaxed);
+  publish();
+  shm_->ready.store(1, std::memory_order_release);
+  return true;
+}
+
+template <typename I2cType>
+bool ExpanderDaemon<I2cType>::createSocket() noexcept {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (options_.socket_path.size() >= sizeof(addr.sun_path)) {
+    std::fprintf(stderr, "pcal95555d: socket path too long\n");
+    return false;
+  }
+  std::memcpy(addr.sun_path, options_.socket_path.c_str(), options_.socket_path.size() + 1);
+  listen_fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0) {
+    std::fprintf(stderr, "pcal95555d: socket: %s\n", std::strerror(errno));
+    return false;
+  }
+  ::unlink(options_.socket_path.c_str());  // stale socket from a previous run
+  if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(listen_fd_, 16) != 0) {
+    std::fprintf(stderr, "pcal95555d: bind %s: %s\n", options_.socket_path.c_str(), std::strerror(errno));
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+  return true;
+}
+
+template <typename I2cType>
+bool ExpanderDaemon<I2cType>::RunOnce(int max_wait_ms) noexcept {
+  if (!started_) {
+    return false;
+  }
+  std::vector<pollfd> fds;
+  fds.reserve(clients_.size() + 1);
+  fds.push_back({listen_fd_, POLLIN, 0});
+  for (int fd : clients_) {
+    fds.push_back({fd, POLLIN, 0});
+  }
+
+  int timeout = max_wait_ms;
+  if (options_.poll_interval_ms != 0) {
+    const uint64_t now = nowNs();
+    const int until_refresh =
+        next_refresh_ns_ > now ? static_cast<int>((next_refresh_ns_ - now + 999999) / 1000000) : 0;
+    timeout = timeout < 0 ? until_refresh : std::min(timeout, until_refresh);
+  }
+  const int ready = ::poll(fds.data(), fds.size(), timeout);
+  if (ready < 0) {
+    return errno == EINTR;
+  }
+
+  if ((fds[0].revents & POLLIN) != 0) {
+    acceptClients();
+  }
+  for (size_t i = 1; i < fds.size(); ++i) {
+    if ((fds[i].revents & POLLIN) != 0) {
+      drainClient(fds[i].fd);
+    } else if ((fds[i].revents & (POLLHUP | POLLERR | POLLNVAL)) != 0) {
+      closeClient(fds[i].fd);
+    }
+  }
+
+  const uint64_t now = nowNs();
+  const bool refresh_all = options_.poll_interval_ms != 0 && now >= next_refresh_ns_;
+  if (refresh_all) {
+    next_refresh_ns_ = now + static_cast<uint64_t>(options_.poll_interval_ms) * 1000000ULL;
+  }
+  if (!replies_.empty()) {
+    ++stats_.rounds;
+  }
+  flushOutputs();
+  refreshInputs(refresh_all);
+  publish();
+  sendReplies();
+  return true;
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::acceptClients() noexcept {
+  for (;;) {
+    const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      return;
+    }
+    clients_.push_back(fd);
+  }
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::drainClient(int fd) noexcept {
+  // Take everything this client has queued so it coalesces into this round.
+  for (;;) {
+    Request request{};
+    const ssize_t n = ::recv(fd, &request, sizeof(request), MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (n <= 0) {
+      closeClient(fd);
+      return;
+    }
+    ++stats_.requests;
+    if (static_cast<size_t>(n) != sizeof(request) || !queueRequest(request)) {
+      Response response{};
+      response.sequence = request.sequence;
+      response.status = Status::BadRequest;
+      sendResponse(fd, response);
+      continue;
+    }
+    replies_.push_back({fd, request});
+  }
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::closeClient(int fd) noexcept {
+  std::erase(clients_, fd);
+  std::erase_if(replies_, [fd](const PendingReply& r) { return r.fd == fd; });
+  ::close(fd);
+}
+
+template <typename I2cType>
+bool ExpanderDaemon<I2cType>::queueRequest(const Request& request) noexcept {
+  if (request.magic != kRequestMagic || request.count > kMaxOpsPerRequest ||
+      (request.command != Command::Apply && request.command != Command::Read)) {
+    return false;
+  }
+  for (uint8_t i = 0; i < request.count; ++i) {
+    if (request.ops[i].expander >= expanders_.size()) {
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < request.count; ++i) {
+    const PinOp& op = request.ops[i];
+    Expander& e = expanders_[op.expander];
+    if (request.command == Command::Read) {
+      e.refresh_inputs = true;
+      continue;
+    }
+    // Sequential composition of (out & ~c) | s steps keeps arrival order.
+    e.pending_clear = static_cast<uint16_t>(e.pending_clear | op.clear_mask);
+    e.pending_set = static_cast<uint16_t>((e.pending_set & ~op.clear_mask) | op.set_mask);
+    e.dirty = true;
+    ++stats_.ops;
+  }
+  return true;
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::flushOutputs() noexcept {
+  for (Expander& e : expanders_) {
+    e.failed = false;
+    if (!e.dirty) {
+      continue;
+    }
+    const uint16_t mask = e.config.output_mask;
+    const uint16_t current = e.state.outputs;
+    const auto merged = static_cast<uint16_t>((current & ~e.pending_clear) | e.pending_set);
+    const auto desired = static_cast<uint16_t>((current & ~mask) | (merged & mask));
+    const auto changed = static_cast<uint16_t>(desired ^ current);
+    e.pending_set = 0;
+    e.pending_clear = 0;
+    e.dirty = false;
+    if (changed == 0) {
+      ++stats_.skipped_writes;
+      continue;
+    }
+    // The daemon owns the OUTPUT register, so the whole image goes out in one
+    // paired write; a read-modify-write would add a read per flush.
+    ++stats_.output_writes;
+    if (e.driver->WriteAllOutputs(desired)) {
+      e.state.outputs = desired;
+    } else {
+      e.failed = true;
+    }
+    e.state.error_flags = e.driver->GetErrorFlags();
+    e.state.updated_ns = nowNs();
+    e.publish = true;
+  }
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::refreshInputs(bool all) noexcept {
+  for (Expander& e : expanders_) {
+    if (!all && !e.refresh_inputs) {
+      continue;
+    }
+    e.refresh_inputs = false;
+    e.driver->ClearError(Error::I2CReadFail);
+    const uint16_t inputs = e.driver->ReadAllInputs();
+    ++stats_.input_reads;
+    const uint16_t flags = e.driver->GetErrorFlags();
+    if ((flags & static_cast<uint16_t>(Error::I2CReadFail)) != 0) {
+      e.failed = true;
+    } else if (inputs != e.state.inputs) {
+      e.state.inputs = inputs;
+      e.publish = true;
+    }
+    if (flags != e.state.error_flags) {
+      e.state.error_flags = flags;
+      e.publish = true;
+    }
+    if (e.publish) {
+      e.state.updated_ns = nowNs();
+    }
+  }
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::publish() noexcept {
+  if (shm_ == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < expanders_.size(); ++i) {
+    if (expanders_[i].publish) {
+      shm_->slots[i].Store(expanders_[i].state);
+      expanders_[i].publish = false;
+    }
+  }
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::sendReplies() noexcept {
+  for (const PendingReply& reply : replies_) {
+    Response response{};
+    response.sequence = reply.request.sequence;
+    response.count = reply.request.count;
+    for (uint8_t i = 0; i < reply.request.count; ++i) {
+      const Expander& e = expanders_[reply.request.ops[i].expander];
+      response.states[i] = e.state;
+      if (e.failed) {
+        response.status = Status::BusError;
+      }
+    }
+    sendResponse(reply.fd, response);
+  }
+  replies_.clear();
+}
+
+template <typename I2cType>
+void ExpanderDaemon<I2cType>::sendResponse(int fd, const Response& response) noexcept {
+  // A client that stopped reading loses its reply rather than stalling everyone.
+  (void)::send(fd, &response, sizeof(response), MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+} // namespace pcal95555::daemon
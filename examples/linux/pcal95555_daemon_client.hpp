@@ -0,0 +1,216 @@
+/**
+ * @file pcal95555_daemon_client.hpp
+ * @brief Client side of pcal95555d: request socket + shared-memory reader
+ *
+ * - DaemonClient sends batched set/clear requests (and input refresh
+ *   requests) over the control socket and waits for the daemon's reply.
+ * - StateMirror maps the daemon's shared-memory segment read-only; Load()
+ *   returns a consistent snapshot of one expander without any syscall.
+ *
+ * @code
+ * pcal95555::daemon::DaemonClient client;
+ * client.Connect();
+ * client.Apply({{0, 0, 0x0001, 0x0000}, {1, 0, 0x0000, 0x8000}});  // one round trip
+ *
+ * pcal95555::daemon::StateMirror mirror;
+ * mirror.Open();
+ * pcal95555::daemon::ExpanderState st;
+ * mirror.Load(0, st);  // no syscall, no bus access
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "pcal95555_daemon_protocol.hpp"
+#include "pcal95555_shm_state.hpp"
+
+namespace pcal95555::daemon {
+
+/**
+ * @brief Connection to pcal95555d's control socket.
+ *
+ * Each call is one request and one blocking reply. Not thread-safe: use one
+ * client per thread.
+ */
+class DaemonClient {
+public:
+  DaemonClient() = default;
+  ~DaemonClient() { Close(); }
+  DaemonClient(const DaemonClient&) = delete;
+  DaemonClient& operator=(const DaemonClient&) = delete;
+
+  /**
+   * @brief Connect to the daemon.
+   * @return false if the daemon is not running or the path is invalid.
+   */
+  bool Connect(const char* socket_path = kDefaultSocketPath) noexcept {
+    Close();
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    const size_t len = std::strlen(socket_path);
+    if (len >= sizeof(addr.sun_path)) {
+      return false;
+    }
+    std::memcpy(addr.sun_path, socket_path, len + 1);
+    fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+      return false;
+    }
+    if (::connect(fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() noexcept {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  [[nodiscard]] bool IsConnected() const noexcept { return fd_ >= 0; }
+
+  /**
+   * @brief Apply a batch of pin operations, in order, in one round trip.
+   * @param ops At most kMaxOpsPerRequest operations.
+   * @param response Optional: receives the resulting state per operation.
+   * @return true if the daemon applied the batch (Status::Ok).
+   */
+  bool Apply(std::span<const PinOp> ops, Response* response = nullptr) noexcept {
+    return transact(Command::Apply, ops, response);
+  }
+
+  bool Apply(std::initializer_list<PinOp> ops, Response* response = nullptr) noexcept {
+    return Apply(std::span<const PinOp>(ops.begin(), ops.size()), response);
+  }
+
+  /**
+   * @brief Ask the daemon to read the inputs of @p expanders now.
+   *
+   * Only needed when the mirror's poll-interval freshness is not enough.
+   */
+  bool Read(std::span<const uint8_t> expanders, Response& response) noexcept {
+    PinOp ops[kMaxOpsPerRequest]{};
+    if (expanders.size() > kMaxOpsPerRequest) {
+      return false;
+    }
+    for (size_t i = 0; i < expanders.size(); ++i) {
+      ops[i].expander = expanders[i];
+    }
+    return transact(Command::Read, std::span<const PinOp>(ops, expanders.size()), &response);
+  }
+
+private:
+  int fd_{-1};
+  uint32_t sequence_{0};
+
+  bool transact(Command command, std::span<const PinOp> ops, Response* response) noexcept {
+    if (fd_ < 0 || ops.size() > kMaxOpsPerRequest) {
+      return false;
+    }
+    Request request{};
+    request.sequence = ++sequence_;
+    request.command = command;
+    request.count = static_cast<uint8_t>(ops.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+      request.ops[i] = ops[i];
+    }
+    if (::send(fd_, &request, sizeof(request), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(request))) {
+      return false;
+    }
+    Response reply{};
+    ssize_t n = 0;
+    do {
+      n = ::recv(fd_, &reply, sizeof(reply), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n != static_cast<ssize_t>(sizeof(reply)) || reply.magic != kResponseMagic ||
+        reply.sequence != request.sequence) {
+      return false;
+    }
+    if (response != nullptr) {
+      *response = reply;
+    }
+    return reply.status == Status::Ok;
+  }
+};
+
+/**
+ * @brief Read-only view of the daemon's shared-memory mirror.
+ */
+class StateMirror {
+public:
+  StateMirror() = default;
+  ~StateMirror() { Close(); }
+  StateMirror(const StateMirror&) = delete;
+  StateMirror& operator=(const StateMirror&) = delete;
+
+  /**
+   * @brief Map the segment published by the daemon.
+   * @return false if the daemon has not created (or finished creating) it.
+   */
+  bool Open(const char* shm_name = kDefaultShmName) noexcept {
+    Close();
+    const int fd = ::shm_open(shm_name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+      return false;
+    }
+    void* mem = ::mmap(nullptr, sizeof(ShmSegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+      return false;
+    }
+    seg_ = static_cast<const ShmSegment*>(mem);
+    if (seg_->ready.load(std::memory_order_acquire) == 0 || seg_->magic != kShmMagic ||
+        seg_->version != kShmVersion) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() noexcept {
+    if (seg_ != nullptr) {
+      ::munmap(const_cast<ShmSegment*>(seg_), sizeof(ShmSegment));
+      seg_ = nullptr;
+    }
+  }
+
+  /// Expanders published by the daemon (0 if not open).
+  [[nodiscard]] size_t Count() const noexcept { return seg_ != nullptr ? seg_->slot_count : 0; }
+
+  /// false once the daemon has shut down (re-Open() after it restarts).
+  [[nodiscard]] bool Alive() const noexcept {
+    return seg_ != nullptr && seg_->ready.load(std::memory_order_acquire) != 0;
+  }
+
+  /**
+   * @brief Copy a consistent snapshot of expander @p index.
+   * @return Snapshot sequence number (changes whenever the state is
+   *         republished), or 0 if @p index is out of range.
+   */
+  uint32_t Load(size_t index, ExpanderState& out) const noexcept {
+    if (index >= Count()) {
+      return 0;
+    }
+    return seg_->slots[index].Load(out);
+  }
+
+private:
+  const ShmSegment* seg_{nullptr};
+};
+
+} // namespace pcal95555::daemon
@@ -0,0 +1,74 @@
+/**
+ * @file pcal95555_daemon_protocol.hpp
+ * @brief Control-socket messages between pcal95555d and its clients
+ *
+ * The socket is a Unix SOCK_SEQPACKET socket: one send() is one Request and
+ * one Response, with message boundaries kept by the kernel. A request is a
+ * batch of per-expander set/clear masks applied in order; the daemon merges
+ * every batch that is waiting when it wakes into one output write per
+ * expander, then answers each request with the resulting state.
+ *
+ * Messages are fixed-size, host-endian structs: both ends run on the same
+ * machine.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pcal95555_shm_state.hpp"
+
+namespace pcal95555::daemon {
+
+inline constexpr uint32_t kRequestMagic = 0x50435251;   // "PCRQ"
+inline constexpr uint32_t kResponseMagic = 0x50435250;  // "PCRP"
+
+/// Pin operations one request can carry.
+inline constexpr size_t kMaxOpsPerRequest = 16;
+
+/// Request kind.
+enum class Command : uint8_t {
+  Apply = 1,  ///< Apply the ops, reply once they are on the bus
+  Read = 2,   ///< Refresh the inputs of the listed expanders and reply
+};
+
+/// Reply status.
+enum class Status : uint8_t {
+  Ok = 0,
+  BadRequest = 1,  ///< Malformed message or unknown expander index
+  BusError = 2,    ///< An I2C transfer for this request failed
+};
+
+/**
+ * @brief One pin operation: `outputs = (outputs & ~clear_mask) | set_mask`.
+ *
+ * Pins that are not configured as outputs are ignored by the daemon.
+ */
+struct PinOp {
+  uint8_t expander = 0;  ///< Index in the daemon's expander list (= shm slot)
+  uint8_t reserved = 0;
+  uint16_t set_mask = 0;
+  uint16_t clear_mask = 0;
+};
+
+struct Request {
+  uint32_t magic = kRequestMagic;
+  uint32_t sequence = 0;  ///< Echoed in the response
+  Command command = Command::Apply;
+  uint8_t count = 0;      ///< Valid entries in ops
+  uint16_t reserved = 0;
+  PinOp ops[kMaxOpsPerRequest]{};
+};
+
+struct Response {
+  uint32_t magic = kResponseMagic;
+  uint32_t sequence = 0;
+  Status status = Status::Ok;
+  uint8_t count = 0;  ///< Valid entries in states (one per op, same order)
+  uint16_t reserved = 0;
+  ExpanderState states[kMaxOpsPerRequest]{};
+};
+
+} // namespace pcal95555::daemon
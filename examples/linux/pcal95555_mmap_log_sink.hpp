@@ -0,0 +1,164 @@
+/**
+ * @file pcal95555_mmap_log_sink.hpp
+ * @brief pcal95555::EventLogSink backed by a memory-mapped file
+ *
+ * The log file is the block ring itself (BlockCount() * BlockSize() bytes,
+ * MAP_SHARED), so every appended event is in the page cache immediately and
+ * survives a crash of the logging process; Sync() forces it to disk. A new
+ * file is created fully erased (0xFF). An existing file is reused as is, so
+ * EventLogWriter::Open() continues its history, and can be opened read-only
+ * for decoding (pcal95555logdump).
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "pcal95555_event_log.hpp"
+
+class MmapLogSink : public pcal95555::EventLogSink<MmapLogSink> {
+public:
+  MmapLogSink() = default;
+  MmapLogSink(const MmapLogSink&) = delete;
+  MmapLogSink& operator=(const MmapLogSink&) = delete;
+  ~MmapLogSink() { Close(); }
+
+  /**
+   * @brief Open or create @p path as a ring of @p blocks blocks of @p block_size bytes.
+   *
+   * An existing file must have exactly that size.
+   * @return false on any system error or size mismatch (see errno).
+   */
+  bool Create(const std::string& path, size_t block_size, uint32_t blocks) noexcept {
+    Close();
+    const size_t size = block_size * blocks;
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st {};
+    const bool fresh = ::fstat(fd, &st) == 0 && st.st_size == 0;
+    if ((fresh && ::ftruncate(fd, static_cast<off_t>(size)) != 0) ||
+        (!fresh && static_cast<size_t>(st.st_size) != size)) {
+      ::close(fd);
+      errno = EINVAL;
+      return false;
+    }
+    if (!map(fd, size, PROT_READ | PROT_WRITE)) {
+      return false;
+    }
+    if (fresh) {
+      std::memset(data_, pcal95555::kEventLogErased, size);
+    }
+    block_size_ = block_size;
+    blocks_ = blocks;
+    writable_ = true;
+    return true;
+  }
+
+  /**
+   * @brief Open an existing log read-only; the geometry comes from its first valid block.
+   * @return false if the file cannot be mapped or holds no valid block.
+   */
+  bool OpenReadOnly(const std::string& path) noexcept {
+    Close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(pcal95555::kEventLogHeaderBytes)) {
+      ::close(fd);
+      errno = EINVAL;
+      return false;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    if (!map(fd, size, PROT_READ)) {
+      return false;
+    }
+    // Blocks start at multiples of 64 bytes (the smallest block size).
+    for (size_t offset = 0; offset + pcal95555::kEventLogHeaderBytes <= size; offset += 64) {
+      uint32_t magic = 0;
+      std::memcpy(&magic, data_ + offset, sizeof(magic));
+      const uint8_t shift = data_[offset + 16];
+      if (magic == pcal95555::kEventLogMagic && shift >= 6 && shift <= 15 && size % (size_t{1} << shift) == 0 &&
+          offset % (size_t{1} << shift) == 0) {
+        block_size_ = size_t{1} << shift;
+        blocks_ = static_cast<uint32_t>(size / block_size_);
+        return true;
+      }
+    }
+    Close();
+    errno = EINVAL;
+    return false;
+  }
+
+  void Close() noexcept {
+    if (data_ != nullptr) {
+      ::munmap(data_, mapped_);
+    }
+    data_ = nullptr;
+    mapped_ = 0;
+    block_size_ = 0;
+    blocks_ = 0;
+    writable_ = false;
+  }
+
+  /// Flush the mapping to disk (msync).
+  bool Sync() noexcept { return data_ != nullptr && ::msync(data_, mapped_, MS_SYNC) == 0; }
+
+  uint32_t BlockCount() const noexcept { return blocks_; }
+  size_t BlockSize() const noexcept { return block_size_; }
+
+  bool Erase(uint32_t block) noexcept {
+    if (!writable_ || block >= blocks_) {
+      return false;
+    }
+    std::memset(data_ + block * block_size_, pcal95555::kEventLogErased, block_size_);
+    return true;
+  }
+
+  bool Program(uint32_t block, size_t offset, const uint8_t* data, size_t len) noexcept {
+    if (!writable_ || block >= blocks_ || offset + len > block_size_) {
+      return false;
+    }
+    std::memcpy(data_ + block * block_size_ + offset, data, len);
+    return true;
+  }
+
+  bool Read(uint32_t block, size_t offset, uint8_t* data, size_t len) noexcept {
+    if (block >= blocks_ || offset + len > block_size_) {
+      return false;
+    }
+    std::memcpy(data, data_ + block * block_size_ + offset, len);
+    return true;
+  }
+
+private:
+  bool map(int fd, size_t size, int prot) noexcept {
+    void* p = ::mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file open
+    if (p == MAP_FAILED) {
+      return false;
+    }
+    data_ = static_cast<uint8_t*>(p);
+    mapped_ = size;
+    return true;
+  }
+
+  uint8_t* data_{nullptr};
+  size_t mapped_{0};
+  size_t block_size_{0};
+  uint32_t blocks_{0};
+  bool writable_{false};
+};
@@ -0,0 +1,128 @@
+/**
+ * @file pcal95555_shm_state.hpp
+ * @brief Shared-memory state mirror published by pcal95555d
+ *
+ * The daemon owns the expanders and publishes each one's input, output and
+ * direction registers into a POSIX shared-memory segment. Every slot is
+ * guarded by a sequence lock: the daemon (single writer) makes the sequence
+ * odd while it updates a slot and even again when done, and readers retry
+ * until they see the same even sequence before and after copying the slot.
+ * Reading state therefore costs no syscall, no bus access and never blocks
+ * the daemon.
+ *
+ * All shared fields are lock-free std::atomic, so the layout is valid across
+ * processes (no process-local locks) and free of data races.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pcal95555::daemon {
+
+/// Default segment name (shm_open).
+inline constexpr const char* kDefaultShmName = "/pcal95555";
+/// Default control socket path.
+inline constexpr const char* kDefaultSocketPath = "/run/pcal95555.sock";
+
+/// Expanders one daemon can own (one per address 0x20-0x27).
+inline constexpr size_t kMaxExpanders = 8;
+
+inline constexpr uint32_t kShmMagic = 0x50434D53;  // "PCMS"
+inline constexpr uint16_t kShmVersion = 1;
+
+/**
+ * @brief One expander's state as published by the daemon.
+ */
+struct ExpanderState {
+  uint8_t address = 0;       ///< 7-bit I2C address
+  uint8_t variant = 0;       ///< pcal95555::ChipVariant as integer
+  uint16_t error_flags = 0;  ///< Driver error flags after the last bus access
+  uint16_t inputs = 0;       ///< Input port registers (bit N = pin N)
+  uint16_t outputs = 0;      ///< Levels driven on the output pins (input pins read 0)
+  uint16_t directions = 0;   ///< Configuration registers (1 = input)
+  uint64_t updated_ns = 0;   ///< CLOCK_MONOTONIC time of the last publish
+};
+
+/**
+ * @brief Seqlock-protected slot for one expander.
+ *
+ * Each slot sits on its own cache line so updates to one expander do not
+ * disturb readers polling another.
+ */
+struct alignas(64) ShmSlot {
+  std::atomic<uint32_t> seq{0};  ///< Odd while the daemon is writing
+  std::atomic<uint8_t> address{0};
+  std::atomic<uint8_t> variant{0};
+  std::atomic<uint16_t> error_flags{0};
+  std::atomic<uint16_t> inputs{0};
+  std::atomic<uint16_t> outputs{0};
+  std::atomic<uint16_t> directions{0};
+  std::atomic<uint64_t> updated_ns{0};
+
+  /**
+   * @brief Publish a new state (daemon only; single writer).
+   */
+  void Store(const ExpanderState& state) noexcept {
+    const uint32_t start = seq.load(std::memory_order_relaxed);
+    seq.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    address.store(state.address, std::memory_order_relaxed);
+    variant.store(state.variant, std::memory_order_relaxed);
+    error_flags.store(state.error_flags, std::memory_order_relaxed);
+    inputs.store(state.inputs, std::memory_order_relaxed);
+    outputs.store(state.outputs, std::memory_order_relaxed);
+    directions.store(state.directions, std::memory_order_relaxed);
+    updated_ns.store(state.updated_ns, std::memory_order_relaxed);
+    seq.store(start + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief Copy a consistent snapshot of the slot (any process, wait-free
+   *        for the writer, retries while a publish is in progress).
+   * @return Sequence number of the snapshot (changes on every publish).
+   */
+  uint32_t Load(ExpanderState& out) const noexcept {
+    for (;;) {
+      const uint32_t before = seq.load(std::memory_order_acquire);
+      if ((before & 1U) != 0) {
+        continue;
+      }
+      out.address = address.load(std::memory_order_relaxed);
+      out.variant = variant.load(std::memory_order_relaxed);
+      out.error_flags = error_flags.load(std::memory_order_relaxed);
+      out.inputs = inputs.load(std::memory_order_relaxed);
+      out.outputs = outputs.load(std::memory_order_relaxed);
+      out.directions = directions.load(std::memory_order_relaxed);
+      out.updated_ns = updated_ns.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) == before) {
+        return before;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Layout of the whole segment.
+ *
+ * The header is written once before the daemon starts serving; `ready`
+ * flips to 1 last, so readers that see it can trust the rest of the header.
+ */
+struct ShmSegment {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t slot_count;  ///< Slots in use (expanders owned by the daemon)
+  std::atomic<uint32_t> ready;
+  std::atomic<uint32_t> daemon_pid;
+  ShmSlot slots[kMaxExpanders];
+};
+
+static_assert(std::atomic<uint16_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory mirror needs address-free (lock-free) atomics");
+
+} // namespace pcal95555::daemon
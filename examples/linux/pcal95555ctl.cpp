@@ -0,0 +1,103 @@
+/**
+ * @file pcal95555ctl.cpp
+ * @brief pcal95555ctl: command-line client for pcal95555d
+ *
+ * Usage:
+ *   pcal95555ctl [--socket=PATH] [--shm=NAME] set   INDEX MASK   # drive pins HIGH
+ *   pcal95555ctl [--socket=PATH] [--shm=NAME] clear INDEX MASK   # drive pins LOW
+ *   pcal95555ctl [--socket=PATH] [--shm=NAME] read  INDEX        # refresh inputs now
+ *   pcal95555ctl [--socket=PATH] [--shm=NAME] show               # print the mirror (no daemon round trip)
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "pcal95555_daemon_client.hpp"
+
+namespace {
+
+using pcal95555::daemon::ExpanderState;
+
+void printState(unsigned index, const ExpanderState& st) {
+  std::printf("[%u] addr=0x%02X variant=%u inputs=0x%04X outputs=0x%04X directions=0x%04X errors=0x%04X\n",
+              index, st.address, st.variant, st.inputs, st.outputs, st.directions, st.error_flags);
+}
+
+int usage(const char* prog) {
+  std::fprintf(stderr,
+               "usage: %s [--socket=PATH] [--shm=NAME] set|clear INDEX MASK\n"
+               "       %s [--socket=PATH] [--shm=NAME] read INDEX\n"
+               "       %s [--socket=PATH] [--shm=NAME] show\n",
+               prog, prog, prog);
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string socket_path = pcal95555::daemon::kDefaultSocketPath;
+  std::string shm_name = pcal95555::daemon::kDefaultShmName;
+  int i = 1;
+  for (; i < argc && std::strncmp(argv[i], "--", 2) == 0; ++i) {
+    if (std::strncmp(argv[i], "--socket=", 9) == 0) {
+      socket_path = argv[i] + 9;
+    } else if (std::strncmp(argv[i], "--shm=", 6) == 0) {
+      shm_name = argv[i] + 6;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (i >= argc) {
+    return usage(argv[0]);
+  }
+  const std::string command = argv[i];
+
+  if (command == "show") {
+    pcal95555::daemon::StateMirror mirror;
+    if (!mirror.Open(shm_name.c_str())) {
+      std::fprintf(stderr, "cannot open mirror %s (is pcal95555d running?)\n", shm_name.c_str());
+      return 1;
+    }
+    for (size_t n = 0; n < mirror.Count(); ++n) {
+      ExpanderState st;
+      mirror.Load(n, st);
+      printState(static_cast<unsigned>(n), st);
+    }
+    return 0;
+  }
+
+  const bool is_write = command == "set" || command == "clear";
+  if (!(is_write || command == "read") || argc - i != (is_write ? 3 : 2)) {
+    return usage(argv[0]);
+  }
+  const auto index = static_cast<uint8_t>(std::strtoul(argv[i + 1], nullptr, 0));
+
+  pcal95555::daemon::DaemonClient client;
+  if (!client.Connect(socket_path.c_str())) {
+    std::fprintf(stderr, "cannot connect to %s (is pcal95555d running?)\n", socket_path.c_str());
+    return 1;
+  }
+  pcal95555::daemon::Response response;
+  bool ok = false;
+  if (is_write) {
+    const auto mask = static_cast<uint16_t>(std::strtoul(argv[i + 2], nullptr, 0));
+    pcal95555::daemon::PinOp op{};
+    op.expander = index;
+    (command == "set" ? op.set_mask : op.clear_mask) = mask;
+    ok = client.Apply({op}, &response);
+  } else {
+    const uint8_t expanders[] = {index};
+    ok = client.Read(expanders, response);
+  }
+  if (response.count > 0) {
+    printState(index, response.states[0]);
+  }
+  if (!ok) {
+    std::fprintf(stderr, "request failed (status %u)\n", static_cast<unsigned>(response.status));
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file pcal95555d.cpp
+ * @brief pcal95555d: owns the expanders on one Linux I2C adapter for all local processes
+ *
+ * Usage:
+ *   pcal95555d --bus=/dev/i2c-1 --expander=ADDR:OUTPUT_MASK[:INITIAL] [--expander=...]
+ *              [--variant=auto|pca9555|pcal9555a] [--socket=PATH] [--shm=NAME]
+ *              [--poll-ms=N]
+ *
+ * Example: two expanders, the first with its low byte as outputs (all off),
+ * the second all inputs:
+ *   pcal95555d --bus=/dev/i2c-1 --expander=0x20:0x00FF:0x0000 --expander=0x21:0x0000
+ *
+ * Expanders are numbered in command-line order; that index is used in client
+ * requests and as the shared-memory slot.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "linux_pcal95555_bus.hpp"
+#include "pcal95555_daemon.hpp"
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void onSignal(int /*signo*/) {
+  g_stop = 1;
+}
+
+bool parseNumber(const std::string& text, unsigned long max, unsigned long& out) {
+  char* end = nullptr;
+  errno = 0;
+  out = std::strtoul(text.c_str(), &end, 0);
+  return errno == 0 && end != text.c_str() && *end == '\0' && out <= max;
+}
+
+/// ADDR:OUTPUT_MASK[:INITIAL]
+bool parseExpander(const std::string& spec, pcal95555::daemon::ExpanderConfig& config) {
+  const size_t first = spec.find(':');
+  if (first == std::string::npos) {
+    return false;
+  }
+  const size_t second = spec.find(':', first + 1);
+  unsigned long address = 0;
+  unsigned long mask = 0;
+  unsigned long initial = 0;
+  if (!parseNumber(spec.substr(0, first), 0x7F, address) ||
+      !parseNumber(spec.substr(first + 1, second - first - 1), 0xFFFF, mask) ||
+      (second != std::string::npos && !parseNumber(spec.substr(second + 1), 0xFFFF, initial))) {
+    return false;
+  }
+  if (address < 0x20 || address > 0x27) {
+    return false;
+  }
+  config.address = static_cast<uint8_t>(address);
+  config.output_mask = static_cast<uint16_t>(mask);
+  config.initial_outputs = static_cast<uint16_t>(initial);
+  return true;
+}
+
+int usage(const char* prog) {
+  std::fprintf(stderr,
+               "usage: %s --bus=/dev/i2c-N --expander=ADDR:OUTPUT_MASK[:INITIAL] [--expander=...]\n"
+               "          [--variant=auto|pca9555|pcal9555a] [--socket=PATH] [--shm=NAME] [--poll-ms=N]\n",
+               prog);
+  return 2;
+}
+
+bool startsWith(const std::string& s, const char* prefix, std::string& value) {
+  const size_t n = std::strlen(prefix);
+  if (s.compare(0, n, prefix) != 0) {
+    return false;
+  }
+  value = s.substr(n);
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  pcal95555::daemon::DaemonOptions options;
+  std::string bus_path;
+  pcal95555::ChipVariant variant = pcal95555::ChipVariant::Unknown;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    std::string value;
+    unsigned long number = 0;
+    if (startsWith(arg, "--bus=", value)) {
+      bus_path = value;
+    } else if (startsWith(arg, "--expander=", value)) {
+      pcal95555::daemon::ExpanderConfig config;
+      if (!parseExpander(value, config)) {
+        std::fprintf(stderr, "bad --expander '%s'\n", value.c_str());
+        return usage(argv[0]);
+      }
+      options.expanders.push_back(config);
+    } else if (startsWith(arg, "--variant=", value)) {
+      if (value == "pca9555") {
+        variant = pcal95555::ChipVariant::PCA9555;
+      } else if (value == "pcal9555a") {
+        variant = pcal95555::ChipVariant::PCAL9555A;
+      } else if (value != "auto") {
+        return usage(argv[0]);
+      }
+    } else if (startsWith(arg, "--socket=", value)) {
+      options.socket_path = value;
+    } else if (startsWith(arg, "--shm=", value)) {
+      options.shm_name = value;
+    } else if (startsWith(arg, "--poll-ms=", value) && parseNumber(value, 60000, number)) {
+      options.poll_interval_ms = static_cast<uint32_t>(number);
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (bus_path.empty() || options.expanders.empty()) {
+    return usage(argv[0]);
+  }
+  for (auto& config : options.expanders) {
+    config.variant = variant;
+  }
+
+  struct sigaction sa {};
+  sa.sa_handler = onSignal;
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+
+  LinuxPcal95555I2cBus bus(bus_path);
+  pcal95555::daemon::ExpanderDaemon<LinuxPcal95555I2cBus> daemon(bus, options);
+  if (!daemon.Start()) {
+    return 1;
+  }
+  std::fprintf(stderr, "pcal95555d: serving %zu expander(s) on %s (socket %s, shm %s)\n",
+               options.expanders.size(), bus_path.c_str(), options.socket_path.c_str(),
+               options.shm_name.c_str());
+
+  daemon.Run(g_stop);
+
+  const auto& stats = daemon.Stats();
+  std::fprintf(stderr,
+               "pcal95555d: %llu requests, %llu ops -> %llu output writes (%llu skipped), "
+               "%llu input reads\n",
+               static_cast<unsigned long long>(stats.requests), static_cast<unsigned long long>(stats.ops),
+               static_cast<unsigned long long>(stats.output_writes),
+               static_cast<unsigned long long>(stats.skipped_writes),
+               static_cast<unsigned long long>(stats.input_reads));
+  daemon.Stop();
+  return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file pcal95555logdump.cpp
+ * @brief pcal95555logdump: decode a pcal95555::EventLogWriter log on the host
+ *
+ * Usage:
+ *   pcal95555logdump [--stats] [--device=N] FILE
+ *
+ * FILE is the raw block ring: a log written through MmapLogSink, or a RAM /
+ * flash ring copied off the target (RamRingSink::Data(), a flash partition
+ * dump). The block size is read from the block headers. Events are printed
+ * oldest first, one per line:
+ *
+ *   <time_us> dev<N> <inputs> <changed>
+ *
+ * --stats prints only the totals: time span, events, blocks and the average
+ * encoded size per event (block headers included).
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "pcal95555_mmap_log_sink.hpp"
+
+namespace {
+
+int usage(const char* prog) {
+  std::fprintf(stderr, "usage: %s [--stats] [--device=N] FILE\n", prog);
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bool stats_only = false;
+  int device = -1;
+  std::string path;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--stats") {
+      stats_only = true;
+    } else if (arg.rfind("--device=", 0) == 0) {
+      device = std::atoi(arg.c_str() + std::strlen("--device="));
+      if (device < 0 || device >= static_cast<int>(pcal95555::kEventLogMaxDevices)) {
+        return usage(argv[0]);
+      }
+    } else if (path.empty() && arg.rfind("--", 0) != 0) {
+      path = arg;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (path.empty()) {
+    return usage(argv[0]);
+  }
+
+  MmapLogSink sink;
+  if (!sink.OpenReadOnly(path)) {
+    std::fprintf(stderr, "%s: not an event log (%s)\n", path.c_str(), std::strerror(errno));
+    return 1;
+  }
+  std::vector<uint8_t> scratch(sink.BlockSize());
+  pcal95555::EventLogReader<MmapLogSink> reader(&sink, scratch);
+
+  pcal95555::EventLogEvent ev;
+  uint64_t events = 0;
+  uint64_t first_us = 0;
+  uint64_t last_us = 0;
+  uint64_t used_bytes = 0;
+  while (reader.Next(ev)) {
+    if (events == 0) {
+      first_us = ev.time_us;
+    }
+    last_us = ev.time_us;
+    ++events;
+    if (!stats_only && (device < 0 || ev.device == device)) {
+      std::printf("%llu dev%u %04X %04X\n", static_cast<unsigned long long>(ev.time_us), ev.device, ev.inputs,
+                  ev.changed);
+    }
+  }
+  // Storage used: every block before the last one in full, plus the used part of the last.
+  if (reader.BlocksRead() != 0) {
+    used_bytes = static_cast<uint64_t>(reader.BlocksRead() - 1) * sink.BlockSize() + reader.CurrentBlock().Offset();
+  }
+
+  if (stats_only) {
+    const double span_s = static_cast<double>(last_us - first_us) / 1e6;
+    std::printf("blocks:      %u of %u (%zu bytes each)\n", reader.BlocksRead(), sink.BlockCount(),
+                sink.BlockSize());
+    std::printf("events:      %llu over %.3f s", static_cast<unsigned long long>(events), span_s);
+    if (span_s > 0) {
+      std::printf(" (%.1f events/s)", static_cast<double>(events) / span_s);
+    }
+    std::printf("\nbytes:       %llu", static_cast<unsigned long long>(used_bytes));
+    if (events != 0) {
+      std::printf(" (%.2f bytes/event)", static_cast<double>(used_bytes) / static_cast<double>(events));
+    }
+    std::printf("\n");
+  }
+  return 0;
+}
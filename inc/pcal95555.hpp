@@ -5,17 +5,24 @@
  */
 #pragma once
 #include <array>
+#include <bit>
 #include <cstddef>
+#include <concepts>
 #include <cstdint>
-#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <span>
 #include <utility>
 #include <stdio.h> // NOLINT(modernize-deprecated-headers) - For FILE* used by ESP-IDF headers
 #include <string.h> // NOLINT(modernize-deprecated-headers) - For C string functions (must be before namespace)
 
+#include "pcal95555_capture.hpp"
 #include "pcal95555_i2c_interface.hpp"
+#include "pcal95555_inline_callback.hpp"
+#include "pcal95555_interrupt_moderation.hpp"
 
 #include "pcal95555_kconfig.hpp"
+#include "pcal95555_output_compositor.hpp"
 #include "pcal95555_version.h"
 
 /** PCAL95555 register map (all control registers). */
@@ -105,7 +112,8 @@ enum class Error : uint16_t {
   I2CReadFail = 1 << 2,         ///< An I2C read operation failed
   I2CWriteFail = 1 << 3,        ///< An I2C write operation failed
   UnsupportedFeature = 1 << 4,  ///< Feature requires PCAL9555A but chip is PCA9555
-  InvalidAddress = 1 << 5       ///< Provided I2C address is out of valid range (0x20-0x27)
+  InvalidAddress = 1 << 5,      ///< Provided I2C address is out of valid range (0x20-0x27)
+  InterruptBindFail = 1 << 6    ///< The bus refused to move the interrupt handler to a moved driver
 };
 
 /** @brief Combine two Error flags. */
@@ -124,10 +132,15 @@ inline constexpr Error operator~(Error e) noexcept {
 namespace pcal95555 {
 
 /**
- * @brief Fixed-capacity result container for multi-pin read operations.
+ * @brief Bitmask-backed result of a multi-pin read.
  *
- * Stores up to 16 pin/value pairs on the stack, avoiding heap allocation.
- * The PCAL95555 has exactly 16 GPIO pins, so 16 is the hard upper bound.
+ * Holds two 16-bit masks instead of a list of pairs: `requested` marks the
+ * pins that were asked for, `values` holds their levels. Lookup is a single
+ * bit test, size() is a popcount and iteration walks the set bits with
+ * count-trailing-zeros, so cost is independent of how many pins were read.
+ *
+ * Entries are visited in ascending pin order, regardless of the order the
+ * pins were requested in; duplicate requests collapse to one entry.
  *
  * Supports range-based for loops and structured bindings:
  * @code
@@ -135,63 +148,229 @@ namespace pcal95555 {
  *   for (const auto& [pin, value] : results) {
  *       printf("Pin %d: %s\n", pin, value ? "HIGH" : "LOW");
  *   }
+ *   if (results.contains(5) && results.get(5)) { ... }
  * @endcode
  */
 struct PinReadResult {
   /// Maximum number of entries (constrained by hardware: 16 GPIO pins).
   static constexpr uint8_t kMaxPins = 16;
 
-  /// Pin number / value pairs.
-  std::array<std::pair<uint8_t, bool>, kMaxPins> data{};
+  /// Bit N set when pin N is part of the result.
+  uint16_t requested = 0;
+
+  /// Bit N is the level of pin N (only meaningful where `requested` is set).
+  uint16_t values = 0;
+
+  /**
+   * @brief Forward iterator over the set bits of `requested`.
+   *
+   * Dereferencing yields a `std::pair<uint8_t, bool>` {pin, value} by value.
+   */
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<uint8_t, bool>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+
+    /// Proxy so `it->first` / `it->second` work on a by-value element.
+    struct pointer {
+      value_type entry;
+      constexpr const value_type* operator->() const noexcept { return &entry; }
+    };
 
-  /// Number of valid entries in data[].
-  uint8_t count = 0;
+    constexpr iterator() noexcept = default;
+    constexpr iterator(uint16_t remaining, uint16_t values) noexcept : remaining_(remaining), values_(values) {}
+
+    [[nodiscard]] constexpr value_type operator*() const noexcept {
+      const auto pin = static_cast<uint8_t>(std::countr_zero(remaining_));
+      return {pin, ((values_ >> pin) & 1U) != 0U};
+    }
+    [[nodiscard]] constexpr pointer operator->() const noexcept { return pointer{**this}; }
+
+    constexpr iterator& operator++() noexcept {
+      remaining_ = static_cast<uint16_t>(remaining_ & (remaining_ - 1U));  // clear lowest set bit
+      return *this;
+    }
+    constexpr iterator operator++(int) noexcept {
+      iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    [[nodiscard]] constexpr bool operator==(const iterator& other) const noexcept {
+      return remaining_ == other.remaining_;
+    }
+
+  private:
+    uint16_t remaining_ = 0;
+    uint16_t values_ = 0;
+  };
 
   // -- Container-like API --------------------------------------------------
 
   /// Number of populated entries.
-  [[nodiscard]] uint8_t size() const noexcept { return count; }
+  [[nodiscard]] constexpr uint8_t size() const noexcept { return static_cast<uint8_t>(std::popcount(requested)); }
 
   /// True when no entries have been added.
-  [[nodiscard]] bool empty() const noexcept { return count == 0; }
+  [[nodiscard]] constexpr bool empty() const noexcept { return requested == 0; }
 
-  /// Access entry by index (no bounds check).
-  [[nodiscard]] const std::pair<uint8_t, bool>& operator[](uint8_t i) const noexcept {
-    return data[i];
+  /// i-th entry in ascending pin order (no bounds check).
+  [[nodiscard]] constexpr std::pair<uint8_t, bool> operator[](uint8_t i) const noexcept {
+    uint16_t remaining = requested;
+    for (; i > 0; --i) {
+      remaining = static_cast<uint16_t>(remaining & (remaining - 1U));
+    }
+    return *iterator(remaining, values);
   }
 
-  /// Append a pin/value pair.  Silently drops entries beyond kMaxPins.
-  void push_back(uint8_t pin, bool value) noexcept {
-    if (count < kMaxPins) {
-      data[count++] = {pin, value};
+  /// Add a pin/value pair.  Pins outside 0-15 are ignored.
+  constexpr void push_back(uint8_t pin, bool value) noexcept {
+    if (pin < kMaxPins) {
+      const auto bit = static_cast<uint16_t>(1U << pin);
+      requested = static_cast<uint16_t>(requested | bit);
+      values = value ? static_cast<uint16_t>(values | bit) : static_cast<uint16_t>(values & ~bit);
     }
   }
 
   // -- Lookup API ----------------------------------------------------------
 
-  /// Check whether a pin number is already stored in the result set.
-  [[nodiscard]] bool contains(uint8_t pin) const noexcept {
-    for (uint8_t i = 0; i < count; ++i) {
-      if (data[i].first == pin) return true;
-    }
-    return false;
+  /// Check whether a pin number is part of the result set.
+  [[nodiscard]] constexpr bool contains(uint8_t pin) const noexcept {
+    return pin < kMaxPins && ((requested >> pin) & 1U) != 0U;
+  }
+
+  /// Level of a pin; false when the pin is not part of the result set.
+  [[nodiscard]] constexpr bool get(uint8_t pin) const noexcept {
+    return contains(pin) && ((values >> pin) & 1U) != 0U;
   }
 
   /// Look up a pin's read result by pin number.
-  /// @return Pointer to the {pin, value} pair, or nullptr if not found.
-  [[nodiscard]] const std::pair<uint8_t, bool>* find(uint8_t pin) const noexcept {
-    for (uint8_t i = 0; i < count; ++i) {
-      if (data[i].first == pin) return &data[i];
+  /// @return Iterator to the {pin, value} entry, or end() if not found.
+  [[nodiscard]] constexpr iterator find(uint8_t pin) const noexcept {
+    if (!contains(pin)) {
+      return end();
     }
-    return nullptr;
+    return iterator(static_cast<uint16_t>(requested & ~((1U << pin) - 1U)), values);
   }
 
   // -- Iterator support for range-based for --------------------------------
-  using iterator       = typename std::array<std::pair<uint8_t, bool>, kMaxPins>::const_iterator;
-  [[nodiscard]] iterator begin() const noexcept { return data.begin(); }
-  [[nodiscard]] iterator end()   const noexcept { return data.begin() + count; }
+  [[nodiscard]] constexpr iterator begin() const noexcept { return iterator(requested, values); }
+  [[nodiscard]] constexpr iterator end()   const noexcept { return iterator(0, values); }
 };
 
+/**
+ * @brief Counters maintained by the background configuration scrubber.
+ *
+ * @see PCAL95555::ScrubTick()
+ */
+struct ScrubStats {
+  uint32_t checks = 0;            ///< Register pairs read back and compared
+  uint32_t mismatches = 0;        ///< Checks where the chip differed from the expected image
+  uint32_t repairs = 0;           ///< Mismatches successfully re-written
+  uint32_t repair_failures = 0;   ///< Mismatches whose re-write failed on the bus
+  uint32_t read_failures = 0;     ///< Read-backs that failed on the bus
+  uint32_t budget_deferrals = 0;  ///< Ticks skipped because the bus budget was spent
+};
+
+/**
+ * @brief Safe state written by PCAL95555::EmergencyStop().
+ *
+ * Armed once with ArmEmergencyStop(); the register bytes are computed at
+ * arming time so the stop itself only issues the writes.
+ */
+struct SafeState {
+  uint16_t outputs = 0;           ///< Safe output levels (bit N = pin N)
+  uint16_t directions = 0xFFFF;   ///< CONFIG image (1 = input), written if write_directions is set
+  bool write_directions = false;  ///< Also write CONFIG_PORT_0/1 (one more paired write)
+};
+
+/**
+ * @brief Pull resistor configuration of all 16 pins (PULL_ENABLE + PULL_SELECT).
+ *
+ * @see PCAL95555::SetPullImage(), PCAL95555::GetPullImage()
+ */
+struct PullImage {
+  uint16_t enable = 0;    ///< Bit N set = pull resistor enabled on pin N
+  uint16_t pull_up = 0;   ///< Bit N set = pull-up, clear = pull-down (meaningful where enabled)
+};
+
+/**
+ * @brief Edges delivered to an interrupt subscriber, already filtered by its masks.
+ *
+ * @see PCAL95555::Subscribe()
+ */
+struct PinEvents {
+  uint16_t rising = 0;   ///< Subscribed pins that went LOW->HIGH
+  uint16_t falling = 0;  ///< Subscribed pins that went HIGH->LOW
+  uint16_t states = 0;   ///< Levels of all 16 inputs after the interrupt
+};
+
+/**
+ * @brief Compile-time pin groups for the templated batch APIs.
+ *
+ * A group names a fixed set of pins and a role. Its 16-bit mask is computed
+ * at compile time and out-of-range pins are rejected with a static_assert,
+ * so the templated SetDirections<>(), WritePins<>() and ReadPins<>() reduce
+ * to constant set/clear masks plus the bus transaction.
+ *
+ * @code
+ *   driver.SetDirections<In<1, 2>, Out<8, 9>>();
+ *   driver.WritePins<High<8>, Low<9>>();
+ *   driver.WritePins<Pins<0, 5>>(0x0001);   // pin 0 HIGH, pin 5 LOW
+ *   auto r = driver.ReadPins<Pins<1, 2>>();
+ * @endcode
+ */
+enum class PinRole : uint8_t {
+  Any = 0,     ///< Plain pin set (Pins<...>)
+  Input = 1,   ///< Configure as input (In<...>)
+  Output = 2,  ///< Configure as output (Out<...>)
+  High = 3,    ///< Drive HIGH (High<...>)
+  Low = 4      ///< Drive LOW (Low<...>)
+};
+
+/** @brief A compile-time pin set with a role; use the Pins/In/Out/High/Low aliases. */
+template <PinRole Role, uint8_t... PinNums>
+struct PinGroup {
+  static_assert(sizeof...(PinNums) > 0, "Pin group must name at least one pin");
+  static_assert(((PinNums < 16) && ...), "PCAL95555 pin index out of range (0-15)");
+
+  /// Role of every pin in the group.
+  static constexpr PinRole role = Role;
+  /// Bit N set for each pin N in the group.
+  static constexpr uint16_t mask = static_cast<uint16_t>((0U | ... | (1U << (PinNums & 0x0FU))));
+  /// Number of pins named (duplicates included).
+  static constexpr uint8_t count = sizeof...(PinNums);
+};
+
+/// Plain pin set, e.g. `Pins<0, 5>`.
+template <uint8_t... PinNums>
+using Pins = PinGroup<PinRole::Any, PinNums...>;
+/// Pins to configure as inputs, e.g. `In<1, 2>`.
+template <uint8_t... PinNums>
+using In = PinGroup<PinRole::Input, PinNums...>;
+/// Pins to configure as outputs, e.g. `Out<8, 9>`.
+template <uint8_t... PinNums>
+using Out = PinGroup<PinRole::Output, PinNums...>;
+/// Pins to drive HIGH, e.g. `High<3>`.
+template <uint8_t... PinNums>
+using High = PinGroup<PinRole::High, PinNums...>;
+/// Pins to drive LOW, e.g. `Low<4, 7>`.
+template <uint8_t... PinNums>
+using Low = PinGroup<PinRole::Low, PinNums...>;
+
+/// Satisfied by any PinGroup instantiation.
+template <typename T>
+concept PinGroupType = requires {
+  { T::role } -> std::convertible_to<PinRole>;
+  { T::mask } -> std::convertible_to<uint16_t>;
+};
+
+/// OR of the masks of every group in Groups with role R.
+template <PinRole R, typename... Groups>
+inline constexpr uint16_t kPinGroupMask =
+    static_cast<uint16_t>((0U | ... | (Groups::role == R ? Groups::mask : 0U)));
+
 /**
  * @enum ChipVariant
  * @brief Identifies the detected or user-specified chip variant.
@@ -206,6 +385,17 @@ enum class ChipVariant : uint8_t {
   PCAL9555A = 2   ///< NXP PCAL9555A with Agile I/O (registers 0x00-0x07 + 0x40-0x4F)
 };
 
+/**
+ * @brief How HandleInterrupt() finds the pins that fired.
+ *
+ * Selected once when the chip variant is known (or fixed at compile time
+ * with CONFIG_PCAL95555_SERVICE_ENGINE); see PCAL95555::GetInterruptEngine().
+ */
+enum class InterruptEngine : uint8_t {
+  InputDiff = 1,   ///< One paired input read, diffed against the previous one (PCA9555)
+  StatusLatch = 2  ///< INT_STATUS read, then input read; never misses a toggle (PCAL9555A)
+};
+
 /**
  * @class PCAL95555
  * @brief Driver for the PCA9555 / PCAL9555A / PCAL95555AHF I²C GPIO expander.
@@ -237,10 +427,32 @@ enum class ChipVariant : uint8_t {
  *       Initialization includes setting address pins, verifying I2C communication, and
  *       auto-detecting the chip variant.
  * @note Use HasAgileIO() or GetChipVariant() to query which features are available.
+ * @note Both constructors are constexpr and allocate nothing (callbacks are
+ *       stored inline), so a driver can be declared `constinit` in static
+ *       storage: it is then part of .data/.bss, with no constructor run at boot.
+ *       @code
+ *       constinit MyI2cBus g_bus;
+ *       constinit pcal95555::PCAL95555<MyI2cBus> g_expander(&g_bus, uint8_t{0x20});
+ *       @endcode
  */
 template <typename I2cType>
 class PCAL95555 {
 public:
+  /// Per-pin interrupt callback (stored inline, no heap allocation).
+  using PinCallback = InlineCallback<void(uint8_t pin, bool state)>;
+  /// Global interrupt callback receiving the 16-bit status mask.
+  using IrqCallback = InlineCallback<void(uint16_t status)>;
+  /// Interrupt subscriber callback receiving its filtered edges.
+  using SubscriberCallback = InlineCallback<void(const PinEvents& events)>;
+
+  /// Capacity of the subscriber table (CONFIG_PCAL95555_MAX_SUBSCRIBERS).
+  static constexpr size_t kMaxSubscribers = CONFIG_PCAL95555_MAX_SUBSCRIBERS;
+  static_assert(kMaxSubscribers <= 32, "CONFIG_PCAL95555_MAX_SUBSCRIBERS must be 0-32");
+  static_assert(CONFIG_PCAL95555_SERVICE_ENGINE >= 0 && CONFIG_PCAL95555_SERVICE_ENGINE <= 2,
+                "CONFIG_PCAL95555_SERVICE_ENGINE must be 0 (auto), 1 (InputDiff) or 2 (StatusLatch)");
+  static_assert(CONFIG_PCAL95555_CALLBACK_BUDGET >= 0 && CONFIG_PCAL95555_CALLBACK_BUDGET <= 255,
+                "CONFIG_PCAL95555_CALLBACK_BUDGET must be 0-255");
+
   /**
    * @brief Construct a new PCAL95555 driver instance using address pin levels.
    *
@@ -272,7 +484,7 @@ public:
    *   // Force PCAL9555A mode
    *   PCAL95555 driver(bus, true, false, false, ChipVariant::PCAL9555A);
    */
-  PCAL95555(I2cType* bus, bool a0_level, bool a1_level, bool a2_level,
+  constexpr PCAL95555(I2cType* bus, bool a0_level, bool a1_level, bool a2_level,
             ChipVariant variant = ChipVariant::Unknown);
 
   /**
@@ -305,9 +517,36 @@ public:
    *   // Address 0x21, force PCA9555 mode
    *   PCAL95555 driver(bus, 0x21, ChipVariant::PCA9555);
    */
-  explicit PCAL95555(I2cType* bus, uint8_t address,
+  explicit constexpr PCAL95555(I2cType* bus, uint8_t address,
                      ChipVariant variant = ChipVariant::Unknown);
 
+  /**
+   * @brief Move a driver, including its register shadow and callbacks.
+   *
+   * If the source had registered its interrupt handler with the bus, the
+   * handler is registered again for the new instance, so the bus never calls
+   * into the moved-from object. Move assignment first replaces the target's
+   * own registration with a no-op handler. The source is then left as if
+   * freshly constructed for the same bus and address: uninitialized, with no
+   * shadow, armed safe state, callbacks or subscribers. If the bus refuses
+   * either registration, Error::InterruptBindFail is set on the target and
+   * the bus keeps calling the (reset) source until it is destroyed or the
+   * target registers again. Drivers cannot be copied: two copies would drive
+   * one device with separate shadows.
+   */
+  PCAL95555(PCAL95555&& other) noexcept;
+  /// @copydoc PCAL95555(PCAL95555&&)
+  PCAL95555& operator=(PCAL95555&& other) noexcept;
+
+  /**
+   * @brief Replace the bus's interrupt registration, if any, with a no-op handler.
+   *
+   * The bus must outlive the driver. A bus that refuses the replacement
+   * keeps calling the destroyed driver; buses that accept
+   * RegisterInterruptHandler() once should accept it again.
+   */
+  constexpr ~PCAL95555() noexcept;
+
   // ---- Version Information (compile-time, static) ----
 
   /**
@@ -357,14 +596,14 @@ public:
    *                Note: setting N will result in N+1 total attempts per
    * transfer.
    */
-  void SetRetries(int retries) noexcept;
+  constexpr void SetRetries(int retries) noexcept;
 
   /**
    * @brief Retrieve currently latched error flags.
    *
    * @return Bitmask composed of @ref Error values.
    */
-  [[nodiscard]] uint16_t GetErrorFlags() const noexcept;
+  [[nodiscard]] constexpr uint16_t GetErrorFlags() const noexcept;
 
   /**
    * @brief Check if a specific error flag is set.
@@ -376,28 +615,28 @@ public:
    *   if (driver.HasError(Error::I2CReadFail)) { ... }
    * @endcode
    */
-  [[nodiscard]] bool HasError(Error e) const noexcept;
+  [[nodiscard]] constexpr bool HasError(Error e) const noexcept;
 
   /**
    * @brief Check if any error flag is set.
    *
    * @return true if error_flags_ != 0.
    */
-  [[nodiscard]] bool HasAnyError() const noexcept;
+  [[nodiscard]] constexpr bool HasAnyError() const noexcept;
 
   /**
    * @brief Clear a single error flag.
    *
    * @param e The error flag to clear.
    */
-  void ClearError(Error e) noexcept;
+  constexpr void ClearError(Error e) noexcept;
 
   /**
    * @brief Clear specific error flags by raw bitmask.
    *
    * @param mask Bitmask of errors to clear (default: all).
    */
-  void ClearErrorFlags(uint16_t mask = 0xFFFF) noexcept;
+  constexpr void ClearErrorFlags(uint16_t mask = 0xFFFF) noexcept;
 
   /**
    * @brief Reset all registers to their power-on default state.
@@ -406,7 +645,7 @@ public:
    * interrupts masked, drive strength set to full, and output mode
    * configured as push-pull as specified by the datasheet.
    */
-  void ResetToDefault() noexcept;
+  constexpr void ResetToDefault() noexcept;
 
   /**
    * @brief Initialize the device using values from Kconfig.
@@ -414,7 +653,7 @@ public:
    * @details This writes the configuration registers using the
    * CONFIG_PCAL95555_INIT_* options defined at compile time.
    */
-  void InitFromConfig() noexcept;
+  constexpr void InitFromConfig() noexcept;
 
   /**
    * @brief Set the direction of a single GPIO pin.
@@ -423,7 +662,7 @@ public:
    * @param dir Direction enum: Input or Output.
    * @return true on success; false on I2C failure.
    */
-  bool SetPinDirection(uint8_t pin, GPIODir dir) noexcept;
+  constexpr bool SetPinDirection(uint8_t pin, GPIODir dir) noexcept;
 
   /**
    * @brief Set the direction for multiple GPIO pins at once using a bitmask.
@@ -435,13 +674,14 @@ public:
    * @note This is a low-level method. For easier use with individual pin directions,
    *       prefer SetDirections() which works with pin numbers directly.
    */
-  bool SetMultipleDirections(uint16_t mask, GPIODir dir) noexcept;
+  constexpr bool SetMultipleDirections(uint16_t mask, GPIODir dir) noexcept;
 
   /**
    * @brief Configure direction for multiple pins at once with individual settings.
    *
-   * @param configs Initializer list of pin/direction pairs: {{pin1, dir1}, {pin2, dir2}, ...}
-   * @return true if all pins configured successfully; false on any failure.
+   * @param configs Pin/direction pairs: {{pin1, dir1}, {pin2, dir2}, ...}
+   * @return true once both CONFIG registers are written; false on a pin outside 0-15
+   *         (Error::InvalidPin, before any bus transaction) or an I2C failure.
    *
    * @example
    *   // Set pin 0 as output, pin 5 as input, pin 10 as output
@@ -451,7 +691,37 @@ public:
    *       {10, GPIODir::Output}
    *   });
    */
-  bool SetDirections(std::initializer_list<std::pair<uint8_t, GPIODir>> configs) noexcept;
+  constexpr bool SetDirections(std::initializer_list<std::pair<uint8_t, GPIODir>> configs) noexcept;
+
+  /// @copydoc SetDirections(std::initializer_list<std::pair<uint8_t, GPIODir>>)
+  constexpr bool SetDirections(std::span<const std::pair<uint8_t, GPIODir>> configs) noexcept;
+
+  /**
+   * @brief Iterator-range overload of SetDirections().
+   *
+   * @tparam PairIt Input iterator whose value has `.first` (pin) and
+   *                `.second` (GPIODir) members.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return As SetDirections(std::initializer_list<std::pair<uint8_t, GPIODir>>).
+   */
+  template <typename PairIt>
+    requires std::input_iterator<PairIt>
+  constexpr bool SetDirections(PairIt first, PairIt last) noexcept;
+
+  /**
+   * @brief Compile-time direction batch: `SetDirections<In<1, 2>, Out<8, 9>>()`.
+   *
+   * Input and output masks are folded at compile time; the call is one read
+   * of both CONFIG registers, `(cfg | in) & ~out`, and one write back. A pin
+   * listed both as input and output, or a group that is not In/Out, is a
+   * compile error.
+   *
+   * @tparam Groups One or more In<...> / Out<...> groups.
+   * @return true on success; false on I2C failure.
+   */
+  template <PinGroupType... Groups>
+  constexpr bool SetDirections() noexcept;
 
   /**
    * @brief Read the current logical level of a GPIO pin.
@@ -459,7 +729,7 @@ public:
    * @param pin Zero-based pin index (0-15).
    * @return true if pin is high; false if pin is low or on read error.
    */
-  bool ReadPin(uint8_t pin) noexcept;
+  constexpr bool ReadPin(uint8_t pin) noexcept;
 
   /**
    * @brief Write a logical level to a GPIO output pin.
@@ -468,7 +738,7 @@ public:
    * @param value true to drive high, false to drive low.
    * @return true if write succeeded; false on I2C failure.
    */
-  bool WritePin(uint8_t pin, bool value) noexcept;
+  constexpr bool WritePin(uint8_t pin, bool value) noexcept;
 
   /**
    * @brief Set the output level for multiple GPIO pins at once using a bitmask.
@@ -489,7 +759,48 @@ public:
    *   // Clear pins 8-15
    *   driver.SetMultipleOutputs(0xFF00, false);
    */
-  bool SetMultipleOutputs(uint16_t mask, bool value) noexcept;
+  constexpr bool SetMultipleOutputs(uint16_t mask, bool value) noexcept;
+
+  /**
+   * @brief Write all 16 output levels in one paired transfer.
+   *
+   * Writes OUTPUT_PORT_0 and OUTPUT_PORT_1 with a single auto-increment
+   * write and no read-back, so every output pin is driven to @p outputs.
+   * Use it when the caller holds the complete output image.
+   *
+   * @param outputs 16-bit output image (bit N = level of pin N).
+   * @return true on success; false on I2C failure.
+   */
+  constexpr bool WriteAllOutputs(uint16_t outputs) noexcept;
+
+  /**
+   * @brief Write the image composed from @p compositor if it changed.
+   *
+   * Composes the compositor's layers and, when the result differs from the
+   * last image written, writes it with WriteAllOutputs(): one paired write,
+   * no read-modify-write per client. Safe to call from every client task
+   * after it updated its layer; overlapping calls are combined and the last
+   * update is always written.
+   *
+   * @param compositor Layers owning the output pins of this expander.
+   * @return true if the outputs match the composed image (or another call
+   *         is writing it); false on I2C failure.
+   *
+   * @note The compositor assumes it owns OUTPUT_PORT_0/1. After writing the
+   *       outputs another way, call OutputCompositor::Invalidate().
+   *
+   * @example
+   *   static pcal95555::OutputCompositor<3> outputs;
+   *   enum : size_t { kStatus = 0, kFault = 1 };
+   *   // Status task: heartbeat on pins 0-3
+   *   outputs.SetLayer(kStatus, pattern, 0x000F, 1);
+   *   driver.ComposeOutputs(outputs);
+   *   // Fault task: force pin 0 high over the status pattern
+   *   outputs.SetLayer(kFault, 0x0001, 0x0001, 10);
+   *   driver.ComposeOutputs(outputs);
+   */
+  template <size_t Layers>
+  bool ComposeOutputs(OutputCompositor<Layers>& compositor) noexcept;
 
   /**
    * @brief Toggle the output state of a GPIO pin.
@@ -497,13 +808,15 @@ public:
    * @param pin Zero-based pin index (0-15).
    * @return true on success; false on I2C failure.
    */
-  bool TogglePin(uint8_t pin) noexcept;
+  constexpr bool TogglePin(uint8_t pin) noexcept;
 
   /**
    * @brief Write values to multiple GPIO output pins at once.
    *
-   * @param configs Initializer list of pin/value pairs: {{pin1, value1}, {pin2, value2}, ...}
-   * @return true if all pins written successfully; false on any failure.
+   * @param configs Pin/value pairs: {{pin1, value1}, {pin2, value2}, ...}
+   * @return true once both OUTPUT registers are written (a pin still set as input
+   *         drives the value once it becomes an output); false on a pin outside 0-15
+   *         (Error::InvalidPin, before any bus transaction) or an I2C failure.
    *
    * @example
    *   // Set pin 0 HIGH, pin 5 LOW, pin 10 HIGH
@@ -513,18 +826,62 @@ public:
    *       {10, true}
    *   });
    */
-  bool WritePins(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept;
+  constexpr bool WritePins(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept;
+
+  /// @copydoc WritePins(std::initializer_list<std::pair<uint8_t, bool>>)
+  constexpr bool WritePins(std::span<const std::pair<uint8_t, bool>> configs) noexcept;
+
+  /**
+   * @brief Iterator-range overload of WritePins().
+   *
+   * @tparam PairIt Input iterator whose value has `.first` (pin) and
+   *                `.second` (bool) members.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return As WritePins(std::initializer_list<std::pair<uint8_t, bool>>).
+   */
+  template <typename PairIt>
+    requires std::input_iterator<PairIt>
+  constexpr bool WritePins(PairIt first, PairIt last) noexcept;
+
+  /**
+   * @brief Compile-time output batch: `WritePins<High<0, 3>, Low<5>>()`.
+   *
+   * Set and clear masks are folded at compile time; the call is one read of
+   * both OUTPUT registers, `(out | high) & ~low`, and one write back. A pin
+   * listed both HIGH and LOW, or a group that is not High/Low, is a compile
+   * error.
+   *
+   * @tparam Groups One or more High<...> / Low<...> groups.
+   * @return true on success; false on I2C failure.
+   */
+  template <PinGroupType... Groups>
+  constexpr bool WritePins() noexcept;
+
+  /**
+   * @brief Write runtime levels to a compile-time pin set: `WritePins<Pins<0, 5>>(values)`.
+   *
+   * Only the pins in PinSet are touched: `(out & ~PinSet::mask) | (values & PinSet::mask)`.
+   *
+   * @tparam PinSet A Pins<...> group.
+   * @param values 16-bit level image; bit N is the level for pin N. Bits
+   *               outside PinSet are ignored.
+   * @return true on success; false on I2C failure.
+   */
+  template <PinGroupType PinSet>
+  constexpr bool WritePins(uint16_t values) noexcept;
 
   /**
    * @brief Read values from multiple GPIO input pins at once.
    *
-   * Reads both input port registers in a single I2C burst, then extracts
-   * the requested pin values.  The result is a stack-allocated
-   * @ref PinReadResult (max 16 entries) — no heap allocation occurs.
+   * Reads both input port registers in a single I2C burst, then masks out
+   * the requested pin values.  The result is a 4-byte bitmask-backed
+   * @ref PinReadResult — no heap allocation occurs.
    *
    * @param pins Initializer list of pin numbers to read: {pin1, pin2, pin3, ...}
-   * @return PinReadResult containing pin/value pairs.  Empty on I2C failure.
-   *         Pins outside 0-15 are included with value=false.
+   * @return PinReadResult with one entry per distinct valid pin, iterated in
+   *         ascending pin order.  Empty on I2C failure.  Pins outside 0-15 are
+   *         skipped and set Error::InvalidPin.
    *
    * @example
    *   // Read pins 0, 5, and 10
@@ -533,13 +890,45 @@ public:
    *       printf("Pin %d: %s\n", pin, value ? "HIGH" : "LOW");
    *   }
    */
-  PinReadResult ReadPins(std::initializer_list<uint8_t> pins) noexcept;
+  constexpr PinReadResult ReadPins(std::initializer_list<uint8_t> pins) noexcept;
+
+  /**
+   * @brief Runtime-sized overload of ReadPins().
+   *
+   * @param pins Contiguous pin numbers, e.g. a std::vector or std::array.
+   * @return PinReadResult containing pin/value pairs.  Empty on I2C failure.
+   */
+  constexpr PinReadResult ReadPins(std::span<const uint8_t> pins) noexcept;
+
+  /**
+   * @brief Iterator-range overload of ReadPins().
+   *
+   * @tparam PinIt Input iterator over pin numbers.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return PinReadResult containing pin/value pairs.  Empty on I2C failure.
+   */
+  template <typename PinIt>
+    requires std::input_iterator<PinIt>
+  constexpr PinReadResult ReadPins(PinIt first, PinIt last) noexcept;
+
+  /**
+   * @brief Compile-time read batch: `ReadPins<Pins<1, 2, 9>>()`.
+   *
+   * The requested mask is a constant; the call is the input-port read plus
+   * one AND.
+   *
+   * @tparam PinSet A Pins<...> group.
+   * @return PinReadResult for exactly the pins in PinSet.  Empty on I2C failure.
+   */
+  template <PinGroupType PinSet>
+  constexpr PinReadResult ReadPins() noexcept;
 
   /**
    * @brief Read all 16 pin input states in a single operation.
    *
-   * Reads both INPUT_PORT_0 and INPUT_PORT_1 registers in two I2C transactions
-   * and returns a 16-bit mask where bit N represents the state of pin N.
+   * Reads INPUT_PORT_0 and INPUT_PORT_1 in one paired (auto-increment) I2C
+   * read and returns a 16-bit mask where bit N represents the state of pin N.
    *
    * @return 16-bit mask with current input states (bit N = pin N level).
    *         Returns 0 on I2C failure (check GetErrorFlags() to distinguish
@@ -549,7 +938,42 @@ public:
    *   uint16_t all_states = driver.ReadAllInputs();
    *   bool pin5_high = (all_states >> 5) & 1;
    */
-  uint16_t ReadAllInputs() noexcept;
+  constexpr uint16_t ReadAllInputs() noexcept;
+
+  /**
+   * @brief Read all 16 pin input states, reporting I2C failure.
+   *
+   * Same single paired read as ReadAllInputs(), but an all-low sample and a
+   * failed read are told apart by the return value. @p inputs is left
+   * unchanged on failure.
+   *
+   * @param[out] inputs 16-bit mask with current input states (bit N = pin N level).
+   * @return true if the inputs were read; false on I2C failure.
+   */
+  constexpr bool ReadAllInputs(uint16_t& inputs) noexcept;
+
+  /**
+   * @brief Read all 16 inputs once and feed the sample to a triggered capture.
+   *
+   * One paired input read, like ReadAllInputs(). Failed reads are not fed
+   * to the capture, so a bus error never shows up as a spurious edge.
+   *
+   * @param capture Capture armed with InputCapture::Arm().
+   * @param now_us  Monotonic timestamp in microseconds (e.g. esp_timer_get_time()).
+   * @return true if the inputs were read and sampled; false on I2C failure
+   *         or if the capture is not recording (Idle / Done).
+   *
+   * @example
+   *   static pcal95555::InputCapture<2048> capture;
+   *   capture.Arm({.trigger = {.falling_mask = 1U << 3}, .post_trigger_changes = 200});
+   *   // Periodic task
+   *   driver.SampleInputs(capture, esp_timer_get_time());
+   *   if (capture.State() == pcal95555::CaptureState::Done) {
+   *       size_t n = capture.Export(out_buffer);  // decode with CaptureReader
+   *   }
+   */
+  template <size_t Bytes>
+  constexpr bool SampleInputs(InputCapture<Bytes>& capture, uint64_t now_us) noexcept;
 
   /**
    * @brief Enable or disable the pull-up/pull-down resistor on a pin.
@@ -559,13 +983,15 @@ public:
    * @return true on success; false on I2C failure.
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool SetPullEnable(uint8_t pin, bool enable) noexcept;
+  constexpr bool SetPullEnable(uint8_t pin, bool enable) noexcept;
 
   /**
    * @brief Configure pull resistor enable/disable for multiple pins at once.
    *
-   * @param configs Initializer list of pin/enable pairs: {{pin1, enable1}, {pin2, enable2}, ...}
-   * @return true if all pins configured successfully; false on any failure.
+   * @param configs Pin/enable pairs: {{pin1, enable1}, {pin2, enable2}, ...}
+   * @return true if the pull-enable registers hold the batch (no write when they
+   *         already did); false on a PCA9555 (Error::UnsupportedFeature), a pin outside
+   *         0-15 (Error::InvalidPin, before any bus transaction) or an I2C failure.
    *
    * @example
    *   // Enable pull on pins 0 and 5, disable on pin 3
@@ -576,7 +1002,23 @@ public:
    *   });
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool SetPullEnables(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept;
+  constexpr bool SetPullEnables(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept;
+
+  /// @copydoc SetPullEnables(std::initializer_list<std::pair<uint8_t, bool>>)
+  constexpr bool SetPullEnables(std::span<const std::pair<uint8_t, bool>> configs) noexcept;
+
+  /**
+   * @brief Iterator-range overload of SetPullEnables().
+   *
+   * @tparam PairIt Input iterator whose value has `.first` (pin) and
+   *                `.second` (bool) members.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return As SetPullEnables(std::initializer_list<std::pair<uint8_t, bool>>).
+   */
+  template <typename PairIt>
+    requires std::input_iterator<PairIt>
+  constexpr bool SetPullEnables(PairIt first, PairIt last) noexcept;
 
   /**
    * @brief Select internal pull-up or pull-down resistor direction.
@@ -586,13 +1028,15 @@ public:
    * @return true on success; false on I2C failure.
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool SetPullDirection(uint8_t pin, bool pull_up) noexcept;
+  constexpr bool SetPullDirection(uint8_t pin, bool pull_up) noexcept;
 
   /**
    * @brief Configure pull resistor direction for multiple pins at once.
    *
-   * @param configs Initializer list of pin/pull_up pairs: {{pin1, pull_up1}, {pin2, pull_up2}, ...}
-   * @return true if all pins configured successfully; false on any failure.
+   * @param configs Pin/pull_up pairs: {{pin1, pull_up1}, {pin2, pull_up2}, ...}
+   * @return true if the pull-select registers hold the batch (no write when they
+   *         already did); false on a PCA9555 (Error::UnsupportedFeature), a pin outside
+   *         0-15 (Error::InvalidPin, before any bus transaction) or an I2C failure.
    *
    * @example
    *   // Set pin 0 to pull-up, pin 5 to pull-down, pin 10 to pull-up
@@ -603,7 +1047,23 @@ public:
    *   });
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool SetPullDirections(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept;
+  constexpr bool SetPullDirections(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept;
+
+  /// @copydoc SetPullDirections(std::initializer_list<std::pair<uint8_t, bool>>)
+  constexpr bool SetPullDirections(std::span<const std::pair<uint8_t, bool>> configs) noexcept;
+
+  /**
+   * @brief Iterator-range overload of SetPullDirections().
+   *
+   * @tparam PairIt Input iterator whose value has `.first` (pin) and
+   *                `.second` (bool) members.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return As SetPullDirections(std::initializer_list<std::pair<uint8_t, bool>>).
+   */
+  template <typename PairIt>
+    requires std::input_iterator<PairIt>
+  constexpr bool SetPullDirections(PairIt first, PairIt last) noexcept;
 
   /**
    * @brief Read the current pull resistor configuration from hardware registers.
@@ -618,7 +1078,56 @@ public:
    * @return true on success; false on I2C failure.
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool GetPullConfiguration(uint16_t& enable_mask, uint16_t& direction_mask) noexcept;
+  constexpr bool GetPullConfiguration(uint16_t& enable_mask, uint16_t& direction_mask) noexcept;
+
+  /**
+   * @brief Configure the pull resistors of every pin in @p mask at once.
+   *
+   * The pull setters work on an image of PULL_ENABLE and PULL_SELECT kept in
+   * the driver (the register shadow). The first pull call after construction
+   * or an address change loads each register pair it needs with one paired
+   * read; after that, updates are computed in memory and cost at most one
+   * paired write per register pair whose value changes. Pairs left unchanged
+   * are not written.
+   *
+   * @param mask Pins to configure (bit N = pin N).
+   * @param enable true to enable the resistors; false to disable them (the
+   *               pull direction is then left as it is).
+   * @param pull_up With @p enable: true for pull-up, false for pull-down.
+   * @return true on success; false on I2C failure.
+   * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
+   *
+   * @example
+   *   // Pull-ups on the button inputs 0-3, pull-downs on 8-9
+   *   driver.SetPulls(0x000F, true, true);
+   *   driver.SetPulls(0x0300, true, false);
+   */
+  constexpr bool SetPulls(uint16_t mask, bool enable, bool pull_up = true) noexcept;
+
+  /**
+   * @brief Write the pull configuration of all 16 pins.
+   *
+   * Needs no read-back: each register pair is written once, or not at all
+   * if the driver's image shows the chip already holds that value.
+   *
+   * @param image Pull enable and pull-up masks.
+   * @return true on success; false on I2C failure.
+   * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
+   */
+  constexpr bool SetPullImage(const PullImage& image) noexcept;
+
+  /**
+   * @brief Get the pull configuration from the driver's image.
+   *
+   * Served from memory once the image is loaded (by any pull setter or a
+   * previous call); otherwise loads it with one paired read per register
+   * pair. Use GetPullConfiguration() to read the chip itself.
+   *
+   * @param[out] image Pull enable and pull-up masks.
+   * @return true on success; false on I2C failure.
+   * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
+   */
+  constexpr bool GetPullImage(PullImage& image) noexcept;
 
   /**
    * @brief Configure the output drive strength for a GPIO pin.
@@ -628,13 +1137,15 @@ public:
    * @return true on success; false on I2C failure.
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool SetDriveStrength(uint8_t pin, DriveStrength level) noexcept;
+  constexpr bool SetDriveStrength(uint8_t pin, DriveStrength level) noexcept;
 
   /**
    * @brief Configure drive strength for multiple pins at once.
    *
-   * @param configs Initializer list of pin/level pairs: {{pin1, level1}, {pin2, level2}, ...}
-   * @return true if all pins configured successfully; false on any failure.
+   * @param configs Pin/level pairs: {{pin1, level1}, {pin2, level2}, ...}
+   * @return true if the drive-strength registers hold the batch (no write when
+   *         they already did); false on a PCA9555 (Error::UnsupportedFeature), a pin outside
+   *         0-15 (Error::InvalidPin, before any bus transaction) or an I2C failure.
    *
    * @example
    *   // Set pin 0 to Level3 (full), pin 5 to Level1 (50%), pin 10 to Level2 (75%)
@@ -645,7 +1156,63 @@ public:
    *   });
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool SetDriveStrengths(std::initializer_list<std::pair<uint8_t, DriveStrength>> configs) noexcept;
+  constexpr bool SetDriveStrengths(std::initializer_list<std::pair<uint8_t, DriveStrength>> configs) noexcept;
+
+  /// @copydoc SetDriveStrengths(std::initializer_list<std::pair<uint8_t, DriveStrength>>)
+  constexpr bool SetDriveStrengths(std::span<const std::pair<uint8_t, DriveStrength>> configs) noexcept;
+
+  /**
+   * @brief Iterator-range overload of SetDriveStrengths().
+   *
+   * @tparam PairIt Input iterator whose value has `.first` (pin) and
+   *                `.second` (DriveStrength) members.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return As SetDriveStrengths(std::initializer_list<std::pair<uint8_t, DriveStrength>>).
+   */
+  template <typename PairIt>
+    requires std::input_iterator<PairIt>
+  constexpr bool SetDriveStrengths(PairIt first, PairIt last) noexcept;
+
+  /**
+   * @brief Set the same drive strength on every pin in @p mask.
+   *
+   * Like the other drive strength setters, this works on a packed 32-bit
+   * image of DRIVE_STRENGTH_0..3 kept in the driver (pin N = bits 2N+1:2N).
+   * The image of a register pair (pins 0-7 or 8-15) is loaded with one paired
+   * read the first time it is needed; after that an update costs one paired
+   * write per pair whose value changes, and nothing is read back.
+   *
+   * @param mask Pins to configure (bit N = pin N).
+   * @param level Drive strength level (Level0..Level3).
+   * @return true on success; false on I2C failure.
+   * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
+   */
+  constexpr bool SetMultipleDriveStrengths(uint16_t mask, DriveStrength level) noexcept;
+
+  /**
+   * @brief Write the packed drive strength image of all 16 pins.
+   *
+   * Needs no read-back: each register pair is written once, or not at all
+   * if the driver's image shows the chip already holds that value.
+   *
+   * @param image Packed levels: pin N in bits 2N+1:2N (0xFFFFFFFF = all Level3).
+   * @return true on success; false on I2C failure.
+   * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
+   */
+  constexpr bool SetDriveImage(uint32_t image) noexcept;
+
+  /**
+   * @brief Get the packed drive strength image from the driver's state.
+   *
+   * Served from memory once the image is loaded; otherwise loads it with
+   * one paired read per register pair.
+   *
+   * @param[out] image Packed levels: pin N in bits 2N+1:2N.
+   * @return true on success; false on I2C failure.
+   * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
+   */
+  constexpr bool GetDriveImage(uint32_t& image) noexcept;
 
   /**
    * @brief Enable or disable interrupt on a single pin.
@@ -662,13 +1229,14 @@ public:
    *   driver.ConfigureInterrupt(3, InterruptState::Disabled);
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool ConfigureInterrupt(uint8_t pin, InterruptState state) noexcept;
+  constexpr bool ConfigureInterrupt(uint8_t pin, InterruptState state) noexcept;
 
   /**
    * @brief Configure interrupts for multiple pins at once.
    *
-   * @param configs Initializer list of pin/state pairs: {{pin1, state1}, {pin2, state2}, ...}
-   * @return true if all pins configured successfully; false on any failure.
+   * @param configs Pin/state pairs: {{pin1, state1}, {pin2, state2}, ...}
+   * @return true once both interrupt mask registers are written; false on
+   *         a PCA9555 (Error::UnsupportedFeature), a pin outside 0-15 (Error::InvalidPin, before any bus transaction) or an I2C failure.
    *
    * @example
    *   // Enable interrupts on pins 0, 5, and 10
@@ -686,7 +1254,23 @@ public:
    *   });
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool ConfigureInterrupts(std::initializer_list<std::pair<uint8_t, InterruptState>> configs) noexcept;
+  constexpr bool ConfigureInterrupts(std::initializer_list<std::pair<uint8_t, InterruptState>> configs) noexcept;
+
+  /// @copydoc ConfigureInterrupts(std::initializer_list<std::pair<uint8_t, InterruptState>>)
+  constexpr bool ConfigureInterrupts(std::span<const std::pair<uint8_t, InterruptState>> configs) noexcept;
+
+  /**
+   * @brief Iterator-range overload of ConfigureInterrupts().
+   *
+   * @tparam PairIt Input iterator whose value has `.first` (pin) and
+   *                `.second` (InterruptState) members.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return As ConfigureInterrupts(std::initializer_list<std::pair<uint8_t, InterruptState>>).
+   */
+  template <typename PairIt>
+    requires std::input_iterator<PairIt>
+  constexpr bool ConfigureInterrupts(PairIt first, PairIt last) noexcept;
 
   /**
    * @brief Enable or disable interrupts on multiple pins using a bitmask.
@@ -704,7 +1288,7 @@ public:
    *   driver.ConfigureInterruptMask(0xFFD9);
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool ConfigureInterruptMask(uint16_t mask) noexcept;
+  constexpr bool ConfigureInterruptMask(uint16_t mask) noexcept;
   /**
    * @brief Retrieve and clear the interrupt status.
    *
@@ -712,7 +1296,7 @@ public:
    *         Returns 0 on PCA9555 (interrupt status registers not available).
    * @note Requires PCAL9555A. Returns 0 with Error::UnsupportedFeature on PCA9555.
    */
-  uint16_t GetInterruptStatus() noexcept;
+  constexpr uint16_t GetInterruptStatus() noexcept;
 
   /**
    * @brief Configure per-port output mode (push-pull or open-drain).
@@ -722,7 +1306,7 @@ public:
    * @return true on success; false on I2C failure.
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool SetOutputMode(bool port_0_open_drain, bool port_1_open_drain) noexcept;
+  constexpr bool SetOutputMode(bool port_0_open_drain, bool port_1_open_drain) noexcept;
 
   /**
    * @brief Configure input polarity inversion for a single pin.
@@ -731,7 +1315,7 @@ public:
    * @param polarity Polarity::Normal or Polarity::Inverted.
    * @return true on success; false on I2C failure.
    */
-  bool SetPinPolarity(uint8_t pin, Polarity polarity) noexcept;
+  constexpr bool SetPinPolarity(uint8_t pin, Polarity polarity) noexcept;
 
   /**
    * @brief Configure input polarity for multiple pins using a bitmask.
@@ -743,13 +1327,14 @@ public:
    * @note This is a low-level method. For easier use with individual pin polarities,
    *       prefer SetPolarities() which works with pin numbers directly.
    */
-  bool SetMultiplePolarities(uint16_t mask, Polarity polarity) noexcept;
+  constexpr bool SetMultiplePolarities(uint16_t mask, Polarity polarity) noexcept;
 
   /**
    * @brief Configure polarity for multiple pins at once with individual settings.
    *
-   * @param configs Initializer list of pin/polarity pairs: {{pin1, pol1}, {pin2, pol2}, ...}
-   * @return true if all pins configured successfully; false on any failure.
+   * @param configs Pin/polarity pairs: {{pin1, pol1}, {pin2, pol2}, ...}
+   * @return true once both polarity inversion registers are written; false on
+   *         a pin outside 0-15 (Error::InvalidPin, before any bus transaction) or an I2C failure.
    *
    * @example
    *   // Set pin 0 to normal, pin 5 to inverted, pin 10 to normal
@@ -759,7 +1344,23 @@ public:
    *       {10, Polarity::Normal}
    *   });
    */
-  bool SetPolarities(std::initializer_list<std::pair<uint8_t, Polarity>> configs) noexcept;
+  constexpr bool SetPolarities(std::initializer_list<std::pair<uint8_t, Polarity>> configs) noexcept;
+
+  /// @copydoc SetPolarities(std::initializer_list<std::pair<uint8_t, Polarity>>)
+  constexpr bool SetPolarities(std::span<const std::pair<uint8_t, Polarity>> configs) noexcept;
+
+  /**
+   * @brief Iterator-range overload of SetPolarities().
+   *
+   * @tparam PairIt Input iterator whose value has `.first` (pin) and
+   *                `.second` (Polarity) members.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return As SetPolarities(std::initializer_list<std::pair<uint8_t, Polarity>>).
+   */
+  template <typename PairIt>
+    requires std::input_iterator<PairIt>
+  constexpr bool SetPolarities(PairIt first, PairIt last) noexcept;
 
   /**
    * @brief Enable or disable the input latch for a single pin.
@@ -769,7 +1370,7 @@ public:
    * @return true on success; false on I2C failure.
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool EnableInputLatch(uint8_t pin, bool enable) noexcept;
+  constexpr bool EnableInputLatch(uint8_t pin, bool enable) noexcept;
 
   /**
    * @brief Enable or disable input latch for multiple pins using a bitmask.
@@ -782,13 +1383,14 @@ public:
    *       prefer EnableInputLatches() which works with pin numbers directly.
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool EnableMultipleInputLatches(uint16_t mask, bool enable) noexcept;
+  constexpr bool EnableMultipleInputLatches(uint16_t mask, bool enable) noexcept;
 
   /**
    * @brief Configure input latch for multiple pins at once with individual settings.
    *
-   * @param configs Initializer list of pin/enable pairs: {{pin1, enable1}, {pin2, enable2}, ...}
-   * @return true if all pins configured successfully; false on any failure.
+   * @param configs Pin/enable pairs: {{pin1, enable1}, {pin2, enable2}, ...}
+   * @return true once both input latch registers are written; false on
+   *         a PCA9555 (Error::UnsupportedFeature), a pin outside 0-15 (Error::InvalidPin, before any bus transaction) or an I2C failure.
    *
    * @example
    *   // Enable latch on pins 0 and 5, disable on pin 3
@@ -799,7 +1401,23 @@ public:
    *   });
    * @note Requires PCAL9555A. Returns false with Error::UnsupportedFeature on PCA9555.
    */
-  bool EnableInputLatches(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept;
+  constexpr bool EnableInputLatches(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept;
+
+  /// @copydoc EnableInputLatches(std::initializer_list<std::pair<uint8_t, bool>>)
+  constexpr bool EnableInputLatches(std::span<const std::pair<uint8_t, bool>> configs) noexcept;
+
+  /**
+   * @brief Iterator-range overload of EnableInputLatches().
+   *
+   * @tparam PairIt Input iterator whose value has `.first` (pin) and
+   *                `.second` (bool) members.
+   * @param first Beginning of the range.
+   * @param last End of the range.
+   * @return As EnableInputLatches(std::initializer_list<std::pair<uint8_t, bool>>).
+   */
+  template <typename PairIt>
+    requires std::input_iterator<PairIt>
+  constexpr bool EnableInputLatches(PairIt first, PairIt last) noexcept;
 
   /**
    * @brief Register a callback for a specific pin interrupt.
@@ -816,6 +1434,9 @@ public:
    * @note The pin must be configured as an input for interrupts to work.
    * @note Interrupts must be enabled for the pin via ConfigureInterrupt() or ConfigureInterruptMask().
    * @note Only one callback per pin is supported. Registering a new callback replaces the old one.
+   *       Called from that pin's own callback, the replacement is installed once the callback
+   *       returns; it fails if another running pin callback already has one pending.
+   * @note Captures are limited to CONFIG_PCAL95555_CALLBACK_STORAGE_BYTES; larger ones fail to compile.
    *
    * @example
    *   // Register callback for pin 5 on rising edge
@@ -829,11 +1450,14 @@ public:
    *   });
    */
   bool RegisterPinInterrupt(uint8_t pin, InterruptEdge edge,
-                            std::function<void(uint8_t pin, bool state)> callback);
+                            PinCallback callback);
 
   /**
    * @brief Unregister callback for a specific pin interrupt.
    *
+   * May be called from any callback, including the pin's own: it is not
+   * called again, and a running callback is destroyed once it returns.
+   *
    * @param pin Pin number (0-15) to unregister callback for.
    * @return true if callback was unregistered; false if pin was invalid or had no callback.
    */
@@ -849,14 +1473,62 @@ public:
    *                 Bit N set indicates pin N triggered an interrupt.
    *
    * @note This works alongside per-pin callbacks. Both will be called.
-   * @note Only one global callback is supported. Registering a new one replaces the old.
+   * @note Only one global callback is supported. Registering a new one replaces the old;
+   *       called from the global callback itself, the new one is installed once it returns.
    *
    * @example
    *   driver.SetInterruptCallback([](uint16_t status) {
    *       ESP_LOGI("APP", "Interrupt! Pins: 0x%04X", status);
    *   });
    */
-  void SetInterruptCallback(const std::function<void(uint16_t)>& callback) noexcept;
+  void SetInterruptCallback(const IrqCallback& callback) noexcept;
+
+  /**
+   * @brief Add an interrupt subscriber listening to a set of pins.
+   *
+   * Any number of subscribers (up to kMaxSubscribers) may listen to the same
+   * pins, independently of RegisterPinInterrupt() and SetInterruptCallback().
+   * On each interrupt every subscriber costs one AND against its masks; only
+   * subscribers with a matching edge are called, once, with all of their
+   * matching pins in the PinEvents masks. Slots live inline in the driver,
+   * so subscribing never allocates.
+   *
+   * @param pin_mask Pins to listen to (bit N = pin N); must not be 0.
+   * @param edge     Edges to deliver (Rising, Falling or Both).
+   * @param callback Function receiving the filtered PinEvents.
+   * @return Subscriber handle (>= 0) for Unsubscribe(), or -1 if the mask is
+   *         empty, the callback is empty or the table is full.
+   *
+   * @note Like the other callbacks, do not subscribe or unsubscribe while
+   *       HandleInterrupt() may run on another task. From inside an interrupt
+   *       callback (same task) both are allowed; see Unsubscribe().
+   *
+   * @example
+   *   // Two subsystems listening to the same pin
+   *   int logger = driver.Subscribe(0x0003, InterruptEdge::Both, [](const PinEvents& ev) {
+   *       ESP_LOGI("LOG", "up 0x%04X down 0x%04X", ev.rising, ev.falling);
+   *   });
+   *   int estop = driver.Subscribe(0x0001, InterruptEdge::Falling, [&](const PinEvents&) { StopMotors(); });
+   */
+  int Subscribe(uint16_t pin_mask, InterruptEdge edge, SubscriberCallback callback) noexcept;
+
+  /**
+   * @brief Remove an interrupt subscriber.
+   *
+   * May be called from any interrupt callback, including the subscriber's
+   * own: the subscriber is not called again (in this pass or later), but its
+   * callable is only destroyed when the delivery returns, so a callback can
+   * unsubscribe itself. Until then its slot is not reused by Subscribe().
+   *
+   * @param handle Value returned by Subscribe().
+   * @return true if the subscriber was removed; false if @p handle is not in use.
+   */
+  bool Unsubscribe(int handle) noexcept;
+
+  /**
+   * @brief Number of active interrupt subscribers.
+   */
+  [[nodiscard]] constexpr size_t GetSubscriberCount() const noexcept;
 
   /**
    * @brief Register this driver's interrupt handler with the I2C interface.
@@ -889,26 +1561,100 @@ public:
    * @brief Internal handler to process an interrupt event.
    *
    * @details This method is called by the I2C interface when the INT pin fires.
-   * It reads the interrupt status registers, determines which pins triggered
-   * interrupts, checks edge conditions, and invokes registered callbacks.
+   * It runs the interrupt engine selected at initialization (see
+   * GetInterruptEngine()), determines which pins triggered and their edges,
+   * and invokes registered callbacks.
    *
-   * Reading the interrupt status registers clears the interrupt condition.
+   * Reading the input port registers clears the interrupt condition.
+   * With SetCallbackBudget(), each call is one bounded pass.
    */
   void HandleInterrupt() noexcept;
 
+  /**
+   * @brief Adaptive interrupt service: per-edge, moderated or polled.
+   *
+   * Asks @p moderator whether a service is due and, if so, runs the same
+   * service as HandleInterrupt() and reports what it found. The moderator
+   * switches between servicing every edge, one service per moderation
+   * delay, and fixed-rate polling as the event rate changes.
+   *
+   * Call it from the interrupt task on every INT edge (@p edge = true) and
+   * whenever moderator.NextWakeUs() elapses (@p edge = false).
+   *
+   * @param moderator Service policy and statistics.
+   * @param now_us    Monotonic timestamp in microseconds.
+   * @param edge      true if called because INT fired.
+   * @return true if the expander was serviced.
+   */
+  bool ServiceInterrupts(InterruptModerator& moderator, uint64_t now_us, bool edge) noexcept;
+
+  /**
+   * @brief Bound the work of each interrupt service pass.
+   *
+   * With a nonzero budget, one HandleInterrupt() (or ServiceInterrupts())
+   * pass has hard limits:
+   *  - at most @p max_callbacks invocations of the global, per-pin and
+   *    subscriber callbacks. Events left over are kept, in order, and
+   *    delivered by the next passes. Every pass still reads the inputs
+   *    (with StatusLatch also when the INT_STATUS read failed), which
+   *    releases INT so the next change raises a new edge; what it
+   *    finds is queued behind the backlog (services read while a backlog
+   *    and a queued service are pending merge into the queued one, so a
+   *    pin reports at most one edge each way there);
+   *  - at most GetServiceTransactionBound() bus transactions;
+   *  - no lazy initialization (an uninitialized driver returns at once, so
+   *    call EnsureInitialized() at startup) and no heap allocation.
+   *
+   * The pass that leaves events deferred has already released INT, so no
+   * edge will ask for them: the caller must run another pass while
+   * HasDeferredEvents() is true.
+   *
+   * @param max_callbacks Callbacks per pass, 1-255; 0 = unbounded (every
+   *                      event is delivered in the pass that read it).
+   *                      The default is CONFIG_PCAL95555_CALLBACK_BUDGET.
+   *
+   * @example
+   *   driver.EnsureInitialized();
+   *   driver.SetCallbackBudget(8);
+   *   // In the interrupt task
+   *   do {
+   *       driver.HandleInterrupt();
+   *   } while (driver.HasDeferredEvents() && TimeLeftInSlot());
+   */
+  constexpr void SetCallbackBudget(uint8_t max_callbacks) noexcept { callback_budget_ = max_callbacks; }
+
+  /// Callback budget per service pass (0 = unbounded).
+  [[nodiscard]] constexpr uint8_t GetCallbackBudget() const noexcept { return callback_budget_; }
+
+  /// true while events read by a bounded pass still wait for their callbacks.
+  [[nodiscard]] constexpr bool HasDeferredEvents() const noexcept { return deferred_.Pending() || queued_.Pending(); }
+
+  /**
+   * @brief Upper bound on the bus transactions of one bounded service pass.
+   *
+   * (paired reads of the engine) x (1 + retries): 1 + retries with
+   * InputDiff, 2 x (1 + retries) with StatusLatch. Only meaningful with a
+   * nonzero callback budget; unbounded passes may initialize the driver.
+   */
+  [[nodiscard]] constexpr uint32_t GetServiceTransactionBound() const noexcept {
+    const bool status_latch = CONFIG_PCAL95555_SERVICE_ENGINE == 2 ||
+                              (CONFIG_PCAL95555_SERVICE_ENGINE == 0 && interrupt_engine_ == InterruptEngine::StatusLatch);
+    return (status_latch ? 2U : 1U) * static_cast<uint32_t>(retries_ + 1);
+  }
+
   /**
    * @brief Get the current I2C address of the device.
    *
    * @return 7-bit I2C address (0x20 to 0x27).
    */
-  [[nodiscard]] uint8_t GetAddress() const noexcept;
+  [[nodiscard]] constexpr uint8_t GetAddress() const noexcept;
 
   /**
    * @brief Get the current A2-A0 address bits.
    *
    * @return 3-bit value (0-7) representing A2, A1, A0 pin configuration.
    */
-  [[nodiscard]] uint8_t GetAddressBits() const noexcept;
+  [[nodiscard]] constexpr uint8_t GetAddressBits() const noexcept;
 
   /**
    * @brief Check if the detected chip supports Agile I/O (PCAL9555A features).
@@ -924,7 +1670,7 @@ public:
    *       driver.SetPullEnable(5, true);
    *   }
    */
-  [[nodiscard]] bool HasAgileIO() const noexcept;
+  [[nodiscard]] constexpr bool HasAgileIO() const noexcept;
 
   /**
    * @brief Get the detected chip variant.
@@ -934,7 +1680,23 @@ public:
    *
    * @note Call after EnsureInitialized() for accurate results.
    */
-  [[nodiscard]] ChipVariant GetChipVariant() const noexcept;
+  [[nodiscard]] constexpr ChipVariant GetChipVariant() const noexcept;
+
+  /**
+   * @brief Get the interrupt service engine used by HandleInterrupt().
+   *
+   * InputDiff costs one paired read per interrupt and sees a pin only if its
+   * level differs from the previous service. StatusLatch (PCAL9555A) reads
+   * INT_STATUS and then the inputs: two paired reads, but a pin that toggled
+   * and came back before the service is still reported (as both edges), a
+   * pin that changed without being flagged (after the INT_STATUS read, or
+   * masked) is reported like InputDiff would, and with EnableInputLatch() the input read returns the level that raised the
+   * interrupt.
+   *
+   * @return The engine selected for the detected variant (InputDiff until
+   *         initialized), or the one fixed by CONFIG_PCAL95555_SERVICE_ENGINE.
+   */
+  [[nodiscard]] constexpr InterruptEngine GetInterruptEngine() const noexcept;
 
   /**
    * @brief Change the I2C address by setting A2-A0 pins.
@@ -961,7 +1723,7 @@ public:
    *       ESP_LOGI("APP", "Address changed to 0x%02X", driver.GetAddress());
    *   }
    */
-  bool ChangeAddress(bool a0_level, bool a1_level, bool a2_level) noexcept;
+  constexpr bool ChangeAddress(bool a0_level, bool a1_level, bool a2_level) noexcept;
 
   /**
    * @brief Change the I2C address using address value directly.
@@ -993,7 +1755,57 @@ public:
    *       ESP_LOGI("APP", "Address changed to 0x%02X", driver.GetAddress());
    *   }
    */
-  bool ChangeAddress(uint8_t address) noexcept;
+  constexpr bool ChangeAddress(uint8_t address) noexcept;
+
+  /**
+   * @brief Point the driver at another address, trusting verified identities.
+   *
+   * The driver remembers, per address (0x20-0x27), the chip variant it
+   * verified there: by initialization, ChangeAddress() or a previous
+   * RetargetAddress(). For such an address, this sets the address pins
+   * (as ChangeAddress() does) and switches over without any bus traffic:
+   * no verification read and no variant detection, and the driver counts as
+   * initialized at once. For any other address it behaves exactly like
+   * ChangeAddress().
+   *
+   * Both keep the emergency stop armed per address (see ArmEmergencyStop()),
+   * drop the events still pending from the previous address (bounded service) and
+   * re-seed the edge baseline at the first interrupt service
+   * there: the InputDiff engine reports no edges from that service, the
+   * StatusLatch engine reports each flagged pin once, towards its current
+   * level.
+   *
+   * A transaction that fails at an address (after retries) makes the driver
+   * forget that address, so the next retarget to it verifies again.
+   * Calls through Unchecked() do not track failures.
+   *
+   * @param address 7-bit I2C address (0x20 to 0x27).
+   * @return true if the address is known or was verified; false as for
+   *         ChangeAddress().
+   *
+   * @example
+   *   // One driver object serving three expanders on the same bus
+   *   for (uint8_t addr : {0x20, 0x21, 0x22}) {
+   *       driver.RetargetAddress(addr);  // verified once, then free
+   *       driver.WriteAllOutputs(images[addr - 0x20]);
+   *   }
+   */
+  constexpr bool RetargetAddress(uint8_t address) noexcept;
+
+  /**
+   * @brief Chip variant remembered for @p address.
+   *
+   * @param address 7-bit I2C address (0x20 to 0x27).
+   * @return The verified variant; ChipVariant::Unknown if the address has not
+   *         been verified, was forgotten after a failure, or is out of range.
+   */
+  [[nodiscard]] constexpr ChipVariant GetCachedVariant(uint8_t address) const noexcept;
+
+  /**
+   * @brief Forget every remembered address (e.g. after a board power cycle
+   *        that may have swapped parts).
+   */
+  constexpr void ClearIdentityCache() noexcept;
 
   /**
    * @brief Ensure the driver is initialized before use.
@@ -1017,7 +1829,211 @@ public:
    *   }
    *   // Driver is now ready to use
    */
-  bool EnsureInitialized() noexcept;
+  constexpr bool EnsureInitialized() noexcept;
+
+  // ---- Configuration scrubber ----
+
+  /**
+   * @brief Run one step of the background configuration scrubber.
+   *
+   * The driver keeps a write-through shadow of every configuration register
+   * it has written (OUTPUT, POLARITY, CONFIG and, on PCAL9555A, the Agile I/O
+   * registers). Each call reads back at most one register pair, round-robin,
+   * and compares it with the shadow. Registers that differ (e.g. because a
+   * brownout reset the expander to power-on defaults) are re-written, only
+   * the differing ones, and the event is counted in GetScrubStats().
+   *
+   * Bus usage is capped at CONFIG_PCAL95555_SCRUB_MAX_READS_PER_SEC
+   * read-backs per second (see SetScrubRate()); calls arriving sooner are
+   * cheap no-ops. Registers the driver has neither written nor loaded
+   * into a drive/pull image are not checked.
+   *
+   * @param now_us Monotonic timestamp in microseconds (e.g. esp_timer_get_time()).
+   * @return true if a register pair was read back this tick; false if the
+   *         tick was skipped (budget, nothing to check, scrubbing disabled)
+   *         or the read-back failed.
+   *
+   * @example
+   *   // In a periodic task or main loop
+   *   driver.ScrubTick(esp_timer_get_time());
+   *   if (driver.GetScrubStats().mismatches != 0) {
+   *       ESP_LOGW("APP", "Expander lost its configuration and was repaired");
+   *   }
+   */
+  constexpr bool ScrubTick(uint64_t now_us) noexcept;
+
+  /**
+   * @brief Change the scrubber bus budget.
+   *
+   * @param max_reads_per_sec Maximum register-pair read-backs per second;
+   *                          0 disables scrubbing.
+   */
+  constexpr void SetScrubRate(uint32_t max_reads_per_sec) noexcept;
+
+  /**
+   * @brief Get the scrubber counters.
+   * @return Snapshot of the counters since construction or ResetScrubStats().
+   */
+  [[nodiscard]] constexpr ScrubStats GetScrubStats() const noexcept;
+
+  /**
+   * @brief Reset the scrubber counters to zero.
+   */
+  constexpr void ResetScrubStats() noexcept;
+
+  // ---- Emergency stop ----
+
+  /**
+   * @brief Store the safe state written by EmergencyStop().
+   *
+   * Also completes the lazy initialization, so the stop itself never
+   * probes the device or reads a register. The state belongs to the device
+   * at the current address: the driver keeps one armed state per address
+   * (0x20-0x27), so after ChangeAddress() or RetargetAddress() EmergencyStop()
+   * drives the state armed for the new address, if any, and a retarget back
+   * finds the old one still armed.
+   *
+   * @param state Output levels and, optionally, pin directions to force.
+   * @return true if armed; false if the device could not be initialized
+   *         (the state is stored anyway).
+   */
+  constexpr bool ArmEmergencyStop(const SafeState& state) noexcept;
+
+  /// @return true if ArmEmergencyStop() was called at the current address.
+  [[nodiscard]] constexpr bool IsEmergencyStopArmed() const noexcept;
+
+  /**
+   * @brief Drive the armed safe state: one paired OUTPUT_PORT_0/1 write.
+   *
+   * No read-back, no read-modify-write and no lazy initialization; with
+   * SafeState::write_directions a second paired write of CONFIG_PORT_0/1
+   * follows (outputs first, so pins turned into outputs start at their safe
+   * level). The writes are bracketed by the bus's SetUrgent() hook, which
+   * lets bus implementations with their own queue, arbitration or quotas
+   * (e.g. AccountingBus) put them ahead of other work.
+   *
+   * Worst-case completion at 400 kHz SCL, per device: 95 us of wire time
+   * (190 us with directions) plus the host's per-transfer overhead. On a
+   * shared bus add the transfer already on the wire, at most 120 us for a
+   * paired read of this driver. Retries (SetRetries()) add 95 us each.
+   *
+   * @return true if the safe state was written; false if nothing is armed
+   *         at the current address or on I2C failure.
+   *
+   * @example
+   *   driver.ArmEmergencyStop({.outputs = 0x0000, .directions = 0xFF00, .write_directions = true});
+   *   // Fault path
+   *   driver.EmergencyStop();
+   */
+  constexpr bool EmergencyStop() noexcept;
+
+  // ---- Unchecked fast path ----
+
+  /**
+   * @class UncheckedView
+   * @brief Lightweight handle exposing the hot-path GPIO operations without
+   *        safety checks.
+   *
+   * Every call goes straight to the bus: there is no EnsureInitialized(), no
+   * pin validation, no retry loop and no error_flags_ bookkeeping. Pin
+   * indices are masked with `& 0x0F`, so an out-of-range pin aliases onto
+   * 0-15 instead of being rejected. The return value only reports whether
+   * the bus transfer(s) succeeded.
+   *
+   * Intended for tight loops whose arguments were validated once up front.
+   * The safe API on PCAL95555 remains the default and should be preferred
+   * everywhere else.
+   *
+   * @pre The owning driver has been initialized successfully
+   *      (EnsureInitialized() returned true).
+   * @note The view stores a reference to the driver and must not outlive it.
+   */
+  class UncheckedView {
+  public:
+    /**
+     * @brief Set the direction of a single pin (read-modify-write of CONFIG).
+     * @param pin Pin index; masked to 0-15.
+     * @param dir GPIODir::Input or GPIODir::Output.
+     * @return true if the bus transfers succeeded.
+     */
+    constexpr bool SetPinDirection(uint8_t pin, GPIODir dir) noexcept;
+
+    /**
+     * @brief Set the direction of every pin in a mask.
+     * @param mask Bitmask of pins to modify.
+     * @param dir GPIODir::Input or GPIODir::Output.
+     * @return true if the bus transfers succeeded.
+     */
+    constexpr bool SetMultipleDirections(uint16_t mask, GPIODir dir) noexcept;
+
+    /**
+     * @brief Drive a single output pin (read-modify-write of OUTPUT).
+     * @param pin Pin index; masked to 0-15.
+     * @param value true = HIGH, false = LOW.
+     * @return true if the bus transfers succeeded.
+     */
+    constexpr bool WritePin(uint8_t pin, bool value) noexcept;
+
+    /**
+     * @brief Invert a single output pin (read-modify-write of OUTPUT).
+     * @param pin Pin index; masked to 0-15.
+     * @return true if the bus transfers succeeded.
+     */
+    constexpr bool TogglePin(uint8_t pin) noexcept;
+
+    /**
+     * @brief Drive every pin in a mask to the same level.
+     * @param mask Bitmask of pins to modify.
+     * @param value true = HIGH, false = LOW.
+     * @return true if the bus transfers succeeded.
+     */
+    constexpr bool SetMultipleOutputs(uint16_t mask, bool value) noexcept;
+
+    /**
+     * @brief Read the input level of a single pin.
+     * @param pin Pin index; masked to 0-15.
+     * @return Pin level; false if the read failed.
+     */
+    constexpr bool ReadPin(uint8_t pin) noexcept;
+
+    /**
+     * @brief Read both input ports.
+     * @return 16-bit input state (bit N = pin N); 0 if the read failed.
+     */
+    constexpr uint16_t ReadAllInputs() noexcept;
+
+  private:
+    friend class PCAL95555;
+    constexpr explicit UncheckedView(PCAL95555& driver) noexcept : drv_(driver) {}
+
+    constexpr bool read(uint8_t reg, uint8_t& value) noexcept;
+    constexpr bool write(uint8_t reg, uint8_t value) noexcept;
+    constexpr bool readPair(uint8_t reg0, uint8_t& val0, uint8_t& val1) noexcept;
+    constexpr bool writePair(uint8_t reg0, uint8_t val0, uint8_t val1) noexcept;
+    constexpr bool modifyBit(uint8_t reg0, uint8_t reg1, uint8_t pin, bool bit_value) noexcept;
+    constexpr bool modifyMask(uint8_t reg0, uint16_t mask, bool bit_value) noexcept;
+
+    PCAL95555& drv_;
+  };
+
+  /**
+   * @brief Get the unchecked fast-path view of this driver.
+   *
+   * @return An UncheckedView bound to this driver.
+   *
+   * @warning See UncheckedView: no initialization check, no pin validation,
+   *          no retries and no error flags. Validate once, then loop.
+   *
+   * @example
+   *   if (!driver.EnsureInitialized() || !driver.SetPinDirection(5, GPIODir::Output)) {
+   *       return;
+   *   }
+   *   auto fast = driver.Unchecked();
+   *   for (;;) {
+   *       fast.TogglePin(5);
+   *   }
+   */
+  [[nodiscard]] constexpr UncheckedView Unchecked() noexcept;
 
 protected:
   /**
@@ -1027,7 +2043,7 @@ protected:
    * @param value Reference to store the read byte.
    * @return true if read succeeds; false on failure.
    */
-  bool readRegister(uint8_t reg, uint8_t& value) noexcept;
+  constexpr bool readRegister(uint8_t reg, uint8_t& value) noexcept;
   /**
    * @brief Write a single byte to a device register with retry logic.
    *
@@ -1035,35 +2051,140 @@ protected:
    * @param value Byte value to write.
    * @return true if write succeeds; false on failure.
    */
-  bool writeRegister(uint8_t reg, uint8_t value) noexcept;
+  constexpr bool writeRegister(uint8_t reg, uint8_t value) noexcept;
+  /**
+   * @brief Read a register pair (reg0, reg0 + 1) in one auto-increment transfer.
+   *
+   * @param reg0 Even register address of the pair.
+   * @param val0 Receives the value of reg0.
+   * @param val1 Receives the value of reg0 + 1.
+   * @return true if read succeeds; false on failure.
+   */
+  constexpr bool readRegisterPair(uint8_t reg0, uint8_t& val0, uint8_t& val1) noexcept;
+  /**
+   * @brief Write a register pair (reg0, reg0 + 1) in one auto-increment transfer.
+   *
+   * @param reg0 Even register address of the pair.
+   * @param val0 Value for reg0.
+   * @param val1 Value for reg0 + 1.
+   * @return true if write succeeds; false on failure.
+   */
+  constexpr bool writeRegisterPair(uint8_t reg0, uint8_t val0, uint8_t val1) noexcept;
 
 private:
+  // Member-wise copy; only the move operations use it (they rebind the handler).
+  PCAL95555(const PCAL95555&) = default;
+  PCAL95555& operator=(const PCAL95555&) = default;
+
+  /**
+   * @brief Register HandleInterrupt() of this instance with the bus.
+   */
+  bool bindInterruptHandler() noexcept;
+
+  /**
+   * @brief Take over the bus registration of @p other (move operations).
+   */
+  void takeInterruptHandler(PCAL95555& other) noexcept;
+
+  /**
+   * @brief Replace this instance's registration with a no-op handler.
+   * @return false if the bus refused it (the old handler is still registered).
+   */
+  bool releaseInterruptHandler() noexcept;
+
+  /**
+   * @brief Leave a moved-from instance as freshly constructed (keeps the bus, address and binding).
+   */
+  void resetMovedFrom() noexcept;
+
   /**
    * @brief Structure to store pin interrupt callback information.
    */
   struct PinInterruptCallback {
-    std::function<void(uint8_t pin, bool state)> callback;
-    InterruptEdge edge;
-    bool registered;
+    PinCallback callback;
+    InterruptEdge edge{InterruptEdge::Both};
+    bool registered{false};
+  };
 
-    PinInterruptCallback() : edge(InterruptEdge::Both), registered(false) {}
+  /**
+   * @brief Interrupt subscriber slot (see Subscribe()).
+   */
+  struct Subscriber {
+    SubscriberCallback callback;
+    uint16_t rising_mask{0};
+    uint16_t falling_mask{0};
   };
 
-  I2cType* i2c_;
-  uint8_t dev_addr_;
-  uint8_t address_bits_;  // A2-A0 bits (0-7)
+  I2cType* i2c_{nullptr};
+  uint8_t dev_addr_{0x20};
+  uint8_t address_bits_{0};  // A2-A0 bits (0-7)
   int retries_{1};
   uint16_t error_flags_{0};
-  std::function<void(uint16_t)> irq_callback_;  // Global callback for all interrupts
+  IrqCallback irq_callback_;                    // Global callback for all interrupts
   PinInterruptCallback pin_callbacks_[16];      // Per-pin callbacks
+  std::array<Subscriber, kMaxSubscribers> subscribers_{};  // Interrupt subscriber table
+  uint32_t subscriber_slots_{0};               // Bit N set = subscribers_[N] in use
+  uint32_t retired_slots_{0};                  // Unsubscribed during delivery, callable not yet destroyed
+  uint8_t delivery_depth_{0};                  // Nesting of deliverDeferred() (callbacks may run a pass)
+  uint16_t running_pins_{0};                   // Pin callbacks running now (callPin())
+  uint16_t retired_pins_{0};                   // Unregistered while running, callable not yet destroyed
+  int8_t pending_pin_{-1};                     // Pin whose running callback pending_pin_callback_ replaces
+  bool running_irq_{false};                    // irq_callback_ running now (callIrq())
+  bool irq_pending_{false};                    // pending_irq_ replaces irq_callback_ once it returns
+  PinInterruptCallback pending_pin_callback_{};  // Registered from its own pin's callback
+  IrqCallback pending_irq_;                    // Set from inside the global callback
   uint16_t previous_pin_states_{0};            // Previous pin states for edge detection
+  bool baseline_stale_{false};                 // Address changed: next service re-seeds previous_pin_states_
   bool initialized_{false};                    // Lazy initialization flag
-  bool a0_level_;                              // Stored pin levels for lazy init
-  bool a1_level_;
-  bool a2_level_;
+  bool interrupt_bound_{false};                // RegisterInterruptHandler() succeeded
+  InterruptEngine interrupt_engine_{InterruptEngine::InputDiff};  // Selected at init
+  uint16_t identity_cache_{0};                 // 2 bits per address (A2-A0): verified ChipVariant, 0 = unknown
+  std::array<std::array<uint8_t, 4>, 8> estop_images_{};  // Per address: OUTPUT_PORT_0/1, CONFIG_PORT_0/1
+  uint8_t estop_armed_{0};                     // Bit N set = estop_images_[N] armed
+  uint8_t estop_directions_{0};                // Bit N set = EmergencyStop() at N also writes CONFIG_PORT_0/1
+  uint8_t callback_budget_{CONFIG_PCAL95555_CALLBACK_BUDGET};  // Callbacks per service pass (0 = unbounded)
+  /// Events of one service (or, in queued_, several merged ones) not yet delivered.
+  struct DeferredEvents {
+    uint16_t status{0};
+    uint16_t rising{0};
+    uint16_t falling{0};
+    uint16_t states{0};
+    uint16_t previous{0};  // Levels before the service (edge order of pulses)
+    uint16_t pins{0};      // Pins whose callback is still due
+    uint16_t back{0};      // Of those: the away edge was delivered, the edge back is due
+    uint32_t slots{0};     // Subscriber slots still due
+    bool irq{false};       // Global callback still due
+
+    [[nodiscard]] constexpr bool Pending() const noexcept { return irq || pins != 0 || slots != 0; }
+  };
+  DeferredEvents deferred_{};                  // Being delivered (bounded passes may stop part-way)
+  DeferredEvents queued_{};                    // Read while deferred_ was pending; delivered after it
+  bool a0_level_{false};                       // Stored pin levels for lazy init
+  bool a1_level_{false};
+  bool a2_level_{false};
   ChipVariant chip_variant_{ChipVariant::Unknown};  // Detected or user-specified chip variant
   ChipVariant user_variant_{ChipVariant::Unknown};  // User-requested variant (for skipping detection)
 
+  // Write-through shadow of the register file: 0x00-0x07 -> [0..7], 0x40-0x4F -> [8..23]
+  static constexpr uint8_t kShadowSize = 24;
+  std::array<uint8_t, kShadowSize> shadow_{};
+  uint32_t shadow_valid_{0};                   // Bit i set once shadow_[i] holds a written or loaded value
+  uint8_t scrub_cursor_{0};                    // Next scrub table entry
+  bool scrub_started_{false};                  // scrub_last_us_ holds a real timestamp
+  uint64_t scrub_last_us_{0};                  // Time of the last scrub read-back
+  uint32_t scrub_interval_us_{                 // Minimum spacing between read-backs (0 = off)
+      CONFIG_PCAL95555_SCRUB_MAX_READS_PER_SEC > 0 ? 1000000U / CONFIG_PCAL95555_SCRUB_MAX_READS_PER_SEC : 0U};
+  ScrubStats scrub_stats_{};
+
+  // Writable configuration registers, checked one pair per ScrubTick(). OUTPUT_CONF
+  // (0x4F) has no partner register and is checked on its own.
+  static constexpr std::array<uint8_t, 10> kScrubTable{
+      static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0),    static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0),
+      static_cast<uint8_t>(Pcal95555Reg::POLARITY_INV_0),   static_cast<uint8_t>(Pcal95555Reg::INT_MASK_0),
+      static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0),    static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0),
+      static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_0), static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_2),
+      static_cast<uint8_t>(Pcal95555Reg::INPUT_LATCH_0),    static_cast<uint8_t>(Pcal95555Reg::OUTPUT_CONF)};
+
   /**
    * @brief Calculate I2C address from A2-A0 bits.
    *
@@ -1081,7 +2202,66 @@ private:
    *
    * @return 16-bit mask with current pin states (bit N = pin N state).
    */
-  uint16_t readPinStates() noexcept;
+  constexpr uint16_t readPinStates() noexcept;
+
+  /**
+   * @brief Interrupt service behind HandleInterrupt(): run the selected engine.
+   * @return Pins that triggered (interrupt status, or changed pins on PCA9555).
+   */
+  uint16_t serviceInterrupt() noexcept;
+
+  /// InterruptEngine::InputDiff: one paired input read, diffed against the last one.
+  uint16_t serviceByDiff() noexcept;
+
+  /// InterruptEngine::StatusLatch: INT_STATUS, then inputs; status pins whose level is unchanged
+  /// pulsed, changed pins single edges whether flagged or not. The input read runs even if the
+  /// INT_STATUS read failed (it releases INT); that service then sees only level changes.
+  uint16_t serviceByStatus() noexcept;
+
+  /**
+   * @brief Queue the events of one service for delivery, then store @p states.
+   *
+   * A pin set in both @p rising and @p falling pulsed: it left its previous
+   * level and came back, and per-pin callbacks see both edges in that order.
+   * The events go to deferred_ when nothing is pending, else to queued_;
+   * further services while both are pending are merged into queued_ (a
+   * pin then reports at most one edge each way, ending at its current level).
+   */
+  void queueEvents(uint16_t status, uint16_t rising, uint16_t falling, uint16_t states) noexcept;
+
+  /**
+   * @brief Deliver deferred_, then queued_, within the callback budget.
+   *
+   * Order: global callback, per-pin callbacks by pin (edge away, then back),
+   * subscribers by slot. Entries that call nothing cost no budget. When the
+   * outermost delivery returns, subscribers unsubscribed from a callback
+   * (retired_slots_) are destroyed.
+   */
+  void deliverDeferred() noexcept;
+
+  /// The calls of deliverDeferred(), without the retired-slot cleanup.
+  void deliverCallbacks() noexcept;
+
+  /**
+   * @brief Deliver deferred_ with @p left callbacks to spend.
+   * @return Callbacks left; deferred_ is still pending if it ran out.
+   */
+  uint32_t deliverRecord(uint32_t left) noexcept;
+
+  /**
+   * @brief Call the callback of @p pin.
+   *
+   * While it runs, UnregisterPinInterrupt() and RegisterPinInterrupt() on
+   * that pin only mark the change; the running callable is destroyed or
+   * replaced here, once the outermost call of it returns.
+   */
+  void callPin(uint8_t pin, bool state) noexcept;
+
+  /// Call the global callback; a SetInterruptCallback() from inside it is applied once it returns.
+  void callIrq(uint16_t status) noexcept;
+
+  /// Pick the engine for the current chip_variant_ (no-op when fixed at compile time).
+  constexpr void selectInterruptEngine() noexcept;
 
   /**
    * @brief Perform actual initialization of the driver.
@@ -1094,22 +2274,22 @@ private:
    *
    * @return true if initialization succeeded; false on failure.
    */
-  bool initialize() noexcept;
+  constexpr bool initialize() noexcept;
 
-  void setError(Error error_code) noexcept;
-  void clearError(Error error_code) noexcept;
+  constexpr void setError(Error error_code) noexcept;
+  constexpr void clearError(Error error_code) noexcept;
 
   // ---- Internal R-M-W helpers (reduce code duplication) ----
 
   /**
    * @brief Read both port registers (port0 and port1) in one call.
    */
-  bool readDualPort(uint8_t reg0, uint8_t reg1, uint8_t& val0, uint8_t& val1) noexcept;
+  constexpr bool readDualPort(uint8_t reg0, uint8_t reg1, uint8_t& val0, uint8_t& val1) noexcept;
 
   /**
    * @brief Write both port registers (port0 and port1) in one call.
    */
-  bool writeDualPort(uint8_t reg0, uint8_t reg1, uint8_t val0, uint8_t val1) noexcept;
+  constexpr bool writeDualPort(uint8_t reg0, uint8_t reg1, uint8_t val0, uint8_t val1) noexcept;
 
   /**
    * @brief Single-pin read-modify-write on a dual-port register pair.
@@ -1117,7 +2297,7 @@ private:
    * Selects the correct port register based on pin number, reads, modifies the bit,
    * and writes back. Does NOT validate pin or call EnsureInitialized().
    */
-  bool modifySinglePinRegister(uint8_t reg0, uint8_t reg1, uint8_t pin, bool bit_value) noexcept;
+  constexpr bool modifySinglePinRegister(uint8_t reg0, uint8_t reg1, uint8_t pin, bool bit_value) noexcept;
 
   /**
    * @brief Batch mask read-modify-write on a dual-port register pair.
@@ -1125,25 +2305,129 @@ private:
    * For each bit set in mask (0-15), sets or clears the corresponding bit in the
    * appropriate port register. Does NOT call EnsureInitialized().
    */
-  bool modifyDualPortByMask(uint8_t reg0, uint8_t reg1, uint16_t mask, bool bit_value) noexcept;
+  constexpr bool modifyDualPortByMask(uint8_t reg0, uint8_t reg1, uint16_t mask, bool bit_value) noexcept;
+
+  /**
+   * @brief Set and clear bit masks on a dual-port register pair in one RMW.
+   *
+   * Computes `(value | set_mask) & ~clear_mask` across both ports. Does NOT
+   * call EnsureInitialized().
+   */
+  constexpr bool updateDualPortMasks(uint8_t reg0, uint8_t reg1, uint16_t set_mask, uint16_t clear_mask) noexcept;
+
+  /**
+   * @brief Apply a batch of pin/setting pairs to a dual-port register pair.
+   *
+   * Checks and folds every pair first, so a pin outside 0-15 fails with no
+   * bus transaction; then one read and one write of both ports.
+   * `to_bit` maps a setting (pair.second) to the register bit value.
+   */
+  template <typename PairIt, typename ToBit>
+  constexpr bool applyPinBatch(uint8_t reg0, uint8_t reg1, PairIt first, PairIt last, ToBit to_bit) noexcept;
+
+  /**
+   * @brief Get a register pair from the shadow, loading it on first use.
+   *
+   * A pair not yet in the shadow is read once and stored there, so later
+   * updates need no read-back. Does NOT call EnsureInitialized().
+   */
+  constexpr bool loadImagePair(uint8_t reg0, uint8_t& val0, uint8_t& val1) noexcept;
+
+  /**
+   * @brief Replace the @p mask bits of a shadowed register pair with @p bits.
+   *
+   * Writes the pair once if its value changes, not at all otherwise. A
+   * full mask needs no load. Does NOT call EnsureInitialized().
+   */
+  constexpr bool updateImagePair(uint8_t reg0, uint16_t mask, uint16_t bits) noexcept;
+
+  /**
+   * @brief Apply @p mask / @p bits of the packed 32-bit drive image.
+   *
+   * Touches only the register pairs (pins 0-7, 8-15) covered by @p mask.
+   */
+  constexpr bool updateDriveImage(uint32_t mask, uint32_t bits) noexcept;
+
+  /**
+   * @brief Apply a batch of pin/setting pairs to a shadowed register pair.
+   *
+   * Same contract as applyPinBatch(), through updateImagePair().
+   */
+  template <typename PairIt, typename ToBit>
+  constexpr bool applyImageBatch(uint8_t reg0, PairIt first, PairIt last, ToBit to_bit) noexcept;
+
+  /// True if @p pin (any integer type, checked before narrowing) is 0-15.
+  template <typename Pin>
+  static constexpr bool isValidPin(Pin pin) noexcept {
+    return std::cmp_greater_equal(pin, 0) && std::cmp_less(pin, 16);
+  }
+
+  /// Drive image mask with `0b11` in the field of every pin in @p pins.
+  static constexpr uint32_t driveFieldMask(uint16_t pins) noexcept {
+    uint32_t mask = 0;
+    for (uint8_t pin = 0; pin < 16; ++pin) {
+      if ((pins & (1U << pin)) != 0) {
+        mask |= 0x3UL << (pin * 2);
+      }
+    }
+    return mask;
+  }
 
   /**
    * @brief Check that the chip supports Agile I/O, setting error if not.
    *
    * @return true if chip is PCAL9555A; false if PCA9555 (sets Error::UnsupportedFeature).
    */
-  bool requireAgileIO() noexcept;
+  constexpr bool requireAgileIO() noexcept;
 
   /**
-   * @brief Shared implementation for ChangeAddress overloads.
+   * @brief Map a register address to its shadow slot.
+   * @return Slot index, or -1 for registers that are not shadowed.
+   */
+  static constexpr int shadowIndex(uint8_t reg) noexcept {
+    if (reg <= 0x07) {
+      return reg;
+    }
+    if (reg >= 0x40 && reg <= 0x4F) {
+      return 8 + (reg - 0x40);
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Record a value that was successfully written to the chip.
+   */
+  constexpr void shadowStore(uint8_t reg, uint8_t value) noexcept;
+
+  /**
+   * @brief Forget every shadowed value (e.g. after an address change).
+   */
+  constexpr void shadowInvalidate() noexcept;
+
+  /**
+   * @brief Shared implementation for ChangeAddress overloads and RetargetAddress().
    *
    * Sets GPIO address pins, updates internal state, verifies communication,
    * and re-detects chip variant at the new address.
    *
    * @param new_bits  Address bits (0-7) to set.
+   * @param use_cache Skip verification and detection if the identity cache
+   *                  knows the address.
    * @return true if communication at the new address succeeded.
    */
-  bool changeAddressImpl(uint8_t new_bits) noexcept;
+  constexpr bool changeAddressImpl(uint8_t new_bits, bool use_cache = false) noexcept;
+
+  /**
+   * @brief Record chip_variant_ as verified at the current address (Unknown is not recorded).
+   */
+  constexpr void rememberIdentity() noexcept;
+
+  /**
+   * @brief Forget the current address after a failed transaction.
+   */
+  constexpr void forgetIdentity() noexcept {
+    identity_cache_ = static_cast<uint16_t>(identity_cache_ & ~(0x3U << (address_bits_ * 2)));
+  }
 
   /**
    * @brief Detect the chip variant by probing an Agile I/O register.
@@ -1158,9 +2442,27 @@ private:
    * If step 2 NACKs but step 3 succeeds the chip is a standard PCA9555.
    * If step 3 also fails the detection is inconclusive (bus error).
    */
-  void detectChipVariant() noexcept;
+  constexpr void detectChipVariant() noexcept;
 };
 
+/**
+ * @brief EmergencyStop() every device, in argument order.
+ *
+ * Each device gets its write even if an earlier one failed. List the
+ * devices whose outputs are most critical first.
+ *
+ * @return true if every device was stopped.
+ *
+ * @example
+ *   pcal95555::EmergencyStopAll(motors, heaters, leds);
+ */
+template <typename... Drivers>
+constexpr bool EmergencyStopAll(Drivers&... drivers) noexcept {
+  bool ok = true;
+  ((ok = drivers.EmergencyStop() && ok), ...);
+  return ok;
+}
+
 // Include template implementation
 #define PCAL95555_HEADER_INCLUDED
 // NOLINTNEXTLINE(bugprone-suspicious-include) - Intentional: template implementation file
@@ -0,0 +1,470 @@
+/**
+ * @file pcal95555_bus_accounting.hpp
+ * @brief Per-client I2C bus utilization accounting and bandwidth quotas
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * AccountingBus is an I2cInterface decorator. Drivers talk to it instead of
+ * the real bus; it forwards every transaction and charges its wire time to
+ * the client (subsystem) that issued it: LED animation, input scanning,
+ * interrupt service, configuration scrubbing, ... Wire time is either
+ * modelled from the transfer length and SCL rate, or measured around the
+ * inner bus call.
+ *
+ * Time is split into fixed windows (e.g. 100 ms). A client can have a quota
+ * of wire time per window; once it is used up, further transactions of that
+ * client either wait for the next window or are dropped (the driver call
+ * fails, like a NACK), so background work cannot starve interrupt service.
+ * Clients without a quota are never held back. At the end of every window
+ * the per-client totals are published as a BusWindowReport through a
+ * callback (and FormatBusReport() renders it as text).
+ *
+ * Clients are small integers (0 .. Clients-1). A transaction is charged to
+ * the bus's current client (SetClient() / ClientScope), or to the fixed
+ * client of a Port, a per-client view for drivers that always work for one
+ * subsystem.
+ *
+ * Locking: with BusAccountingConfig::lock/unlock set, AccountingBus holds
+ * that lock around every transaction (and the bookkeeping of SetClientUrgent()
+ * and Tick()), and a waiting client sleeps with it released, so interrupt
+ * service keeps the bus while a throttled client waits. Callers must then not
+ * hold a lock of their own around driver calls of a client that can wait.
+ * Without lock/unlock, serialize calls with the lock that already serializes
+ * the bus; QuotaAction::Wait then drops instead, as a sleep under the
+ * caller's lock would hold up every other client for up to a window.
+ * SetClient() / ClientScope select a bus-wide client, so several tasks
+ * should each use their own Port.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <span>
+#include <utility>
+
+#include "pcal95555_i2c_interface.hpp"
+#include "pcal95555_inline_callback.hpp"
+#include "pcal95555_kconfig.hpp"
+
+namespace pcal95555 {
+
+/// What happens to a transaction of a client that used up its quota.
+enum class QuotaAction : uint8_t {
+  Wait = 0,  ///< Sleep until the next window, then proceed (needs sleep_us and lock/unlock, else drops)
+  Drop = 1   ///< Fail the transaction without touching the bus
+};
+
+/**
+ * @brief Clock, window and timing model of an AccountingBus.
+ */
+struct BusAccountingConfig {
+  uint64_t (*now_us)() noexcept = nullptr;         ///< Monotonic microseconds; required for windows and quotas
+  void (*sleep_us)(uint32_t us) noexcept = nullptr;  ///< Needed by QuotaAction::Wait (else Wait drops)
+  void (*lock)() noexcept = nullptr;    ///< Serializes the bus; released while a client waits (needs unlock)
+  void (*unlock)() noexcept = nullptr;  ///< Releases lock
+  uint32_t window_us = 100000;  ///< Accounting window
+  uint32_t scl_hz = 400000;     ///< Bus clock for modelled wire time
+  uint32_t overhead_us = 0;     ///< Fixed modelled cost added per transaction (driver / ISR latency)
+  bool measure = false;         ///< Charge measured call durations instead of modelled wire time
+};
+
+/// Per-client settings.
+struct BusClientConfig {
+  const char* name = nullptr;  ///< Label used in reports
+  uint32_t quota_us = 0;       ///< Wire time per window (0 = unlimited)
+  QuotaAction action = QuotaAction::Wait;
+};
+
+/// One client's usage in one window.
+struct BusClientStats {
+  const char* name = nullptr;
+  uint32_t quota_us = 0;
+  uint32_t wire_us = 0;       ///< Wire time charged in the window
+  uint32_t transactions = 0;  ///< Transactions forwarded to the bus
+  uint32_t bytes = 0;         ///< Data bytes transferred (register address excluded)
+  uint32_t dropped = 0;       ///< Transactions refused by the quota
+  uint32_t waits = 0;         ///< Transactions delayed to a later window
+  uint64_t total_wire_us = 0; ///< Wire time since construction
+};
+
+/// Usage of every client over one completed window.
+struct BusWindowReport {
+  uint64_t start_us = 0;   ///< Window start (now_us() time base)
+  uint32_t length_us = 0;  ///< Window length
+  uint32_t busy_us = 0;    ///< Wire time of all clients
+  std::span<const BusClientStats> clients;
+};
+
+/**
+ * @brief Modelled wire time of one register transaction.
+ *
+ * Counts START, address + R/W, register byte and data bytes (9 bits each
+ * with ACK), the repeated START and address of a read, and STOP.
+ */
+[[nodiscard]] constexpr uint32_t ModelledWireUs(bool is_read, size_t len, uint32_t scl_hz) noexcept {
+  uint64_t bits = 1 + 9 + 9 + 9 * static_cast<uint64_t>(len) + 1;
+  if (is_read) {
+    bits += 1 + 9;
+  }
+  const uint64_t hz = scl_hz != 0 ? scl_hz : 100000;
+  return static_cast<uint32_t>((bits * 1000000ULL + hz - 1) / hz);
+}
+
+/**
+ * @brief Render @p report as text, one line per client that used the bus.
+ *
+ * @code
+ * window 1200000 us +100000 us: busy 41.3%
+ *   irq          wire  2210 us   2.2%  txn   52  bytes  104
+ *   leds         wire 38900 us  38.9%  txn  950  bytes 1900  quota 40000  dropped 12
+ * @endcode
+ * @return Characters written (excluding the terminator), truncated to fit.
+ */
+inline size_t FormatBusReport(const BusWindowReport& report, std::span<char> out) noexcept {
+  if (out.empty()) {
+    return 0;
+  }
+  size_t pos = 0;
+  const auto append = [&](int n) {
+    if (n > 0) {
+      pos += static_cast<size_t>(n);
+      if (pos >= out.size()) {
+        pos = out.size() - 1;
+      }
+    }
+  };
+  const double length = report.length_us != 0 ? static_cast<double>(report.length_us) : 1.0;
+  append(std::snprintf(out.data(), out.size(), "window %llu us +%u us: busy %.1f%%\n",
+                       static_cast<unsigned long long>(report.start_us), report.length_us,
+                       100.0 * report.busy_us / length));
+  for (size_t i = 0; i < report.clients.size(); ++i) {
+    const BusClientStats& c = report.clients[i];
+    if (c.transactions == 0 && c.dropped == 0 && c.waits == 0) {
+      continue;
+    }
+    char label[24];
+    if (c.name != nullptr) {
+      std::snprintf(label, sizeof(label), "%s", c.name);
+    } else {
+      std::snprintf(label, sizeof(label), "client%u", static_cast<unsigned>(i));
+    }
+    append(std::snprintf(out.data() + pos, out.size() - pos,
+                         "  %-12s wire %5u us %5.1f%%  txn %4u  bytes %4u", label, c.wire_us,
+                         100.0 * c.wire_us / length, c.transactions, c.bytes));
+    if (c.quota_us != 0) {
+      append(std::snprintf(out.data() + pos, out.size() - pos, "  quota %u", c.quota_us));
+    }
+    if (c.dropped != 0) {
+      append(std::snprintf(out.data() + pos, out.size() - pos, "  dropped %u", c.dropped));
+    }
+    if (c.waits != 0) {
+      append(std::snprintf(out.data() + pos, out.size() - pos, "  waits %u", c.waits));
+    }
+    append(std::snprintf(out.data() + pos, out.size() - pos, "\n"));
+  }
+  return pos;
+}
+
+/**
+ * @brief I2cInterface decorator that accounts wire time per client.
+ *
+ * @code
+ * enum : uint8_t { kIrq, kLeds, kScan, kScrub };
+ * static pcal95555::AccountingBus<MyI2c> bus(&raw_bus, {.now_us = NowUs, .sleep_us = SleepUs,
+ *                                                      .lock = LockBus, .unlock = UnlockBus});
+ * bus.ConfigureClient(kIrq, {"irq"});
+ * bus.ConfigureClient(kLeds, {"leds", 40000, pcal95555::QuotaAction::Drop});  // 40 % of 100 ms
+ * bus.ConfigureClient(kScrub, {"scrub", 2000, pcal95555::QuotaAction::Wait});
+ * bus.SetReportCallback([](const pcal95555::BusWindowReport& r) { ... });
+ *
+ * pcal95555::PCAL95555<decltype(bus)> driver(&bus, 0x20);
+ * {
+ *   decltype(bus)::ClientScope scope(bus, kLeds);
+ *   driver.WritePins(frame);  // charged to "leds", may be dropped
+ * }
+ * @endcode
+ *
+ * @tparam Inner The wrapped I2cInterface implementation.
+ * @tparam Clients Number of client slots (default `CONFIG_PCAL95555_BUS_CLIENTS`).
+ */
+template <typename Inner, size_t Clients = CONFIG_PCAL95555_BUS_CLIENTS>
+class AccountingBus : public I2cInterface<AccountingBus<Inner, Clients>> {
+  static_assert(Clients >= 1 && Clients <= 255, "AccountingBus supports 1-255 clients");
+
+public:
+  /// Invoked at the end of every window, with the bus lock held.
+  using ReportCallback = InlineCallback<void(const BusWindowReport&)>;
+
+  AccountingBus(Inner* inner, const BusAccountingConfig& config) noexcept : inner_(inner), config_(config) {
+    if (config_.window_us == 0) {
+      config_.window_us = 100000;
+    }
+    if (config_.lock == nullptr || config_.unlock == nullptr) {
+      config_.lock = nullptr;
+      config_.unlock = nullptr;
+    }
+    if (config_.now_us != nullptr) {
+      window_start_us_ = config_.now_us();
+    }
+  }
+
+  /**
+   * @brief Name a client and set its quota.
+   * @return false if @p client is out of range.
+   */
+  bool ConfigureClient(uint8_t client, const BusClientConfig& config) noexcept {
+    if (client >= Clients) {
+      return false;
+    }
+    clients_[client] = config;
+    current_[client].name = config.name;
+    current_[client].quota_us = config.quota_us;
+    return true;
+  }
+
+  /// Client charged for transactions made through this object (not through a Port).
+  void SetClient(uint8_t client) noexcept { client_ = client < Clients ? client : 0; }
+  [[nodiscard]] uint8_t GetClient() const noexcept { return client_; }
+
+  /**
+   * @brief Sets the current client for its lifetime, then restores the previous one.
+   */
+  class ClientScope {
+  public:
+    ClientScope(AccountingBus& bus, uint8_t client) noexcept : bus_(bus), previous_(bus.GetClient()) {
+      bus_.SetClient(client);
+    }
+    ~ClientScope() { bus_.SetClient(previous_); }
+    ClientScope(const ClientScope&) = delete;
+    ClientScope& operator=(const ClientScope&) = delete;
+
+  private:
+    AccountingBus& bus_;
+    uint8_t previous_;
+  };
+
+  /**
+   * @brief Bus view that charges everything to one client.
+   *
+   * Give a Port to a driver that always works for the same subsystem:
+   * `PCAL95555<AccountingBus<MyI2c>::Port> leds(&leds_port, 0x21);`
+   */
+  class Port : public I2cInterface<Port> {
+  public:
+    Port(AccountingBus* owner, uint8_t client) noexcept : owner_(owner), client_(client) {}
+
+    bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+      return owner_->Transfer(client_, false, addr, reg, const_cast<uint8_t*>(data), len);
+    }
+    bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+      return owner_->Transfer(client_, true, addr, reg, data, len);
+    }
+    bool EnsureInitialized() noexcept { return owner_->EnsureInitialized(); }
+    bool SetAddressPins(bool a0_level, bool a1_level, bool a2_level) noexcept {
+      return owner_->SetAddressPins(a0_level, a1_level, a2_level);
+    }
+    bool RegisterInterruptHandler(std::function<void()> handler) noexcept {
+      return owner_->RegisterInterruptHandler(std::move(handler));
+    }
+    void GpioSet(CtrlPin pin, GpioSignal signal) noexcept { owner_->GpioSet(pin, signal); }
+    bool GpioRead(CtrlPin pin, GpioSignal& signal) noexcept { return owner_->GpioRead(pin, signal); }
+    void SetUrgent(bool urgent) noexcept { owner_->SetClientUrgent(client_, urgent); }
+
+  private:
+    AccountingBus* owner_;
+    uint8_t client_;
+  };
+
+  /// A Port charging @p client (out-of-range clients are charged to client 0).
+  [[nodiscard]] Port MakePort(uint8_t client) noexcept { return Port(this, client < Clients ? client : 0); }
+
+  void SetReportCallback(ReportCallback callback) noexcept { report_callback_ = std::move(callback); }
+
+  /**
+   * @brief Close the window if it has elapsed; call periodically so reports
+   *        keep coming while the bus is idle.
+   * @return true if a window was closed (and reported).
+   */
+  bool Tick() noexcept {
+    const Guard guard(config_);
+    return config_.now_us != nullptr && rollIfDue(config_.now_us());
+  }
+
+  /// Report of the last completed window (empty before the first one closes).
+  [[nodiscard]] BusWindowReport LastReport() const noexcept { return last_report_; }
+
+  /// Usage of @p client in the window in progress.
+  [[nodiscard]] BusClientStats CurrentStats(uint8_t client) const noexcept {
+    return client < Clients ? current_[client] : BusClientStats{};
+  }
+
+  // ---- I2cInterface ----
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    return Transfer(client_, false, addr, reg, const_cast<uint8_t*>(data), len);
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    return Transfer(client_, true, addr, reg, data, len);
+  }
+
+  bool EnsureInitialized() noexcept { return inner_->EnsureInitialized(); }
+
+  bool SetAddressPins(bool a0_level, bool a1_level, bool a2_level) noexcept {
+    return inner_->SetAddressPins(a0_level, a1_level, a2_level);
+  }
+
+  bool RegisterInterruptHandler(std::function<void()> handler) noexcept {
+    return inner_->RegisterInterruptHandler(std::move(handler));
+  }
+
+  void GpioSet(CtrlPin pin, GpioSignal signal) noexcept { inner_->GpioSet(pin, signal); }
+
+  bool GpioRead(CtrlPin pin, GpioSignal& signal) noexcept { return inner_->GpioRead(pin, signal); }
+
+  /// Urgent transfers (PCAL95555::EmergencyStop()) of the current client skip its quota; they are still charged.
+  void SetUrgent(bool urgent) noexcept { SetClientUrgent(client_, urgent); }
+
+  /**
+   * @brief Start or end an urgent section for @p client only.
+   *
+   * Other clients keep their quotas while @p client is urgent. Every
+   * client's section is forwarded to the inner bus as its own
+   * SetUrgent(true)/SetUrgent(false) pair, from the task that runs it, so an
+   * inner bus that scopes urgency to the calling task (Esp32Pcal9555I2cBus)
+   * sees both ends of each task's section.
+   */
+  void SetClientUrgent(uint8_t client, bool urgent) noexcept {
+    if (client >= Clients) {
+      client = 0;
+    }
+    const Guard guard(config_);
+    if (urgent_[client] == urgent) {
+      return;
+    }
+    urgent_[client] = urgent;
+    inner_->SetUrgent(urgent);
+  }
+
+  /**
+   * @brief Account, admit and forward one transaction for @p client.
+   *
+   * @p data is only written for reads. A transaction is always admitted
+   * when the client has not used the bus yet in the window, so a single
+   * transaction larger than the quota still gets through once per window.
+   * Transactions of a client inside its urgent section (SetClientUrgent())
+   * are always admitted. A waiting client sleeps with the bus lock released.
+   */
+  bool Transfer(uint8_t client, bool is_read, uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    if (client >= Clients) {
+      client = 0;
+    }
+    const uint32_t modelled = ModelledWireUs(is_read, len, config_.scl_hz) + config_.overhead_us;
+    Guard guard(config_);
+    uint64_t now = 0;
+    if (config_.now_us != nullptr) {
+      now = config_.now_us();
+      rollIfDue(now);
+      bool waited = false;
+      while (overQuota(client, modelled)) {
+        BusClientStats& stats = current_[client];
+        if (clients_[client].action == QuotaAction::Drop || config_.sleep_us == nullptr || config_.lock == nullptr) {
+          ++stats.dropped;
+          return false;
+        }
+        if (!waited) {
+          ++stats.waits;  // reported with the window that refused it
+          waited = true;
+        }
+        // Other clients (interrupt service) keep the bus until the next window
+        const uint64_t end = window_start_us_ + config_.window_us;
+        guard.Unlock();
+        config_.sleep_us(static_cast<uint32_t>(end > now ? end - now : 1));
+        guard.Lock();
+        now = config_.now_us();
+        rollIfDue(now);
+      }
+    }
+    const bool ok = is_read ? inner_->Read(addr, reg, data, len) : inner_->Write(addr, reg, data, len);
+    uint32_t charged = modelled;
+    if (config_.measure && config_.now_us != nullptr) {
+      charged = static_cast<uint32_t>(config_.now_us() - now);
+    }
+    BusClientStats& stats = current_[client];
+    stats.wire_us += charged;
+    stats.total_wire_us += charged;
+    ++stats.transactions;
+    stats.bytes += static_cast<uint32_t>(len);
+    return ok;
+  }
+
+private:
+  /// Holds BusAccountingConfig::lock for its scope (nothing without one).
+  class Guard {
+  public:
+    explicit Guard(const BusAccountingConfig& config) noexcept : config_(config) { Lock(); }
+    ~Guard() { Unlock(); }
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+    void Lock() noexcept {
+      if (config_.lock != nullptr && !held_) {
+        config_.lock();
+        held_ = true;
+      }
+    }
+    void Unlock() noexcept {
+      if (held_) {
+        config_.unlock();
+        held_ = false;
+      }
+    }
+
+  private:
+    const BusAccountingConfig& config_;
+    bool held_ = false;
+  };
+
+  /// @p client has a quota, is not urgent, and @p modelled more would exceed it.
+  [[nodiscard]] bool overQuota(uint8_t client, uint32_t modelled) const noexcept {
+    const uint32_t quota = clients_[client].quota_us;
+    const uint32_t used = current_[client].wire_us;
+    return !urgent_[client] && quota != 0 && used != 0 && used + modelled > quota;
+  }
+
+  bool rollIfDue(uint64_t now) noexcept {
+    if (now < window_start_us_ + config_.window_us) {
+      return false;
+    }
+    uint32_t busy = 0;
+    for (size_t i = 0; i < Clients; ++i) {
+      last_stats_[i] = current_[i];
+      busy += current_[i].wire_us;
+      const uint64_t total = current_[i].total_wire_us;
+      current_[i] = BusClientStats{};
+      current_[i].name = clients_[i].name;
+      current_[i].quota_us = clients_[i].quota_us;
+      current_[i].total_wire_us = total;
+    }
+    last_report_ = {window_start_us_, config_.window_us, busy, std::span<const BusClientStats>(last_stats_)};
+    // Skip idle windows so the next one contains now.
+    window_start_us_ += (now - window_start_us_) / config_.window_us * config_.window_us;
+    if (report_callback_) {
+      report_callback_(last_report_);
+    }
+    return true;
+  }
+
+  Inner* inner_;
+  BusAccountingConfig config_;
+  uint64_t window_start_us_{0};
+  BusClientConfig clients_[Clients]{};
+  BusClientStats current_[Clients]{};
+  BusClientStats last_stats_[Clients]{};
+  BusWindowReport last_report_{};
+  ReportCallback report_callback_{};
+  uint8_t client_{0};
+  bool urgent_[Clients]{};
+};
+
+} // namespace pcal95555
@@ -0,0 +1,425 @@
+/**
+ * @file pcal95555_capture.hpp
+ * @brief Triggered, run-length encoded input capture for the PCAL95555 driver
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Logic-analyzer-style capture on top of input sampling. InputCapture keeps
+ * only the samples where the input image changed, each stored as a
+ * variable-length time delta plus the 16-bit mask of pins that changed, in a
+ * fixed byte ring inside the object (no heap). Idle inputs cost nothing, so
+ * hours of mostly static pins fit in a few hundred bytes.
+ *
+ * Capture flow:
+ *  - Arm() with a trigger (level pattern and/or edges on selected pins).
+ *    While armed, changes are kept in a circular pre-trigger history of at
+ *    most CaptureConfig::pre_trigger_bytes; older changes are folded into the
+ *    base state.
+ *  - When the trigger condition is met, the capture continues until
+ *    CaptureConfig::post_trigger_changes further changes were recorded or the
+ *    buffer is full.
+ *  - Export() writes the capture to a self-describing byte stream;
+ *    CaptureReader decodes it (on the target or the host).
+ *
+ * Samples come from PCAL95555::SampleInputs() (one paired input read) or any
+ * other source via InputCapture::Sample().
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pcal95555_kconfig.hpp"
+
+namespace pcal95555 {
+
+/**
+ * @brief Trigger condition evaluated on every change of the input image.
+ *
+ * The trigger fires when both parts hold:
+ *  - level: `(inputs & level_mask) == (level_value & level_mask)`
+ *    (always true when level_mask is 0);
+ *  - edge: any pin in rising_mask rose or any pin in falling_mask fell
+ *    (always true when both masks are 0).
+ *
+ * With every mask at 0 the capture triggers on the first sample.
+ */
+struct CaptureTrigger {
+  uint16_t level_mask = 0;    ///< Pins whose level is compared
+  uint16_t level_value = 0;   ///< Required levels of the level_mask pins
+  uint16_t rising_mask = 0;   ///< Pins whose LOW->HIGH edge fires the trigger
+  uint16_t falling_mask = 0;  ///< Pins whose HIGH->LOW edge fires the trigger
+};
+
+/**
+ * @brief Capture settings passed to InputCapture::Arm().
+ */
+struct CaptureConfig {
+  CaptureTrigger trigger{};
+  uint32_t pre_trigger_bytes = 0;     ///< History kept before the trigger (0 = half the buffer)
+  uint32_t post_trigger_changes = 0;  ///< Changes recorded after the trigger (0 = until full)
+};
+
+/// Capture life cycle.
+enum class CaptureState : uint8_t {
+  Idle = 0,       ///< Not armed; samples are ignored
+  Armed = 1,      ///< Recording pre-trigger history, waiting for the trigger
+  Triggered = 2,  ///< Recording post-trigger changes
+  Done = 3        ///< Post-trigger depth reached or buffer full; ready to export
+};
+
+/// Export stream identification ("PCP1", little-endian).
+inline constexpr uint32_t kCaptureMagic = 0x31504350;
+inline constexpr uint8_t kCaptureVersion = 1;
+/// Size of the export header preceding the records.
+inline constexpr size_t kCaptureHeaderBytes = 36;
+/// trigger_index value of a capture that never triggered.
+inline constexpr uint32_t kCaptureNoTrigger = 0xFFFFFFFF;
+
+/**
+ * @brief Fixed-capacity triggered capture of the 16-bit input image.
+ *
+ * Record format: LEB128 varint of the microseconds since the previous
+ * change, then the changed-pin mask (2 bytes, little-endian). A change costs
+ * 3 bytes when changes are less than 128 us apart and 7 bytes for gaps of up
+ * to ~9 hours.
+ *
+ * Not thread-safe: sample and export from the same task, or stop sampling
+ * (state Done / Disarm()) before exporting from another.
+ *
+ * @tparam Bytes Record buffer size (default `CONFIG_PCAL95555_CAPTURE_BYTES`).
+ */
+template <size_t Bytes = CONFIG_PCAL95555_CAPTURE_BYTES>
+class InputCapture {
+  static_assert(Bytes >= 64 && Bytes <= 0x7FFFFFFF, "Capture buffer must be 64 bytes .. 2 GiB");
+
+public:
+  constexpr InputCapture() noexcept = default;
+
+  /**
+   * @brief Clear the buffer and start waiting for the trigger.
+   *
+   * The first sample after Arm() becomes the base state.
+   */
+  constexpr void Arm(const CaptureConfig& config) noexcept {
+    config_ = config;
+    if (config_.pre_trigger_bytes == 0 || config_.pre_trigger_bytes > Bytes) {
+      config_.pre_trigger_bytes = Bytes / 2;
+    }
+    head_ = 0;
+    used_ = 0;
+    records_ = 0;
+    trigger_index_ = kCaptureNoTrigger;
+    post_changes_ = 0;
+    has_base_ = false;
+    state_ = CaptureState::Armed;
+  }
+
+  /// Stop capturing; the data recorded so far stays exportable.
+  constexpr void Disarm() noexcept {
+    if (state_ == CaptureState::Armed || state_ == CaptureState::Triggered) {
+      state_ = CaptureState::Done;
+    }
+  }
+
+  /**
+   * @brief Fire the trigger now, at the current state (manual trigger).
+   * @return false if the capture is not armed or has no sample yet.
+   */
+  constexpr bool ForceTrigger() noexcept {
+    if (state_ != CaptureState::Armed || !has_base_) {
+      return false;
+    }
+    fire();
+    return true;
+  }
+
+  /**
+   * @brief Feed one sample of the input image.
+   *
+   * Unchanged samples only advance the end time. Ignored unless the capture
+   * is Armed or Triggered.
+   *
+   * @param inputs Input port image (bit N = pin N).
+   * @param now_us Monotonic timestamp in microseconds; must not go backwards.
+   */
+  constexpr void Sample(uint16_t inputs, uint64_t now_us) noexcept {
+    if (state_ != CaptureState::Armed && state_ != CaptureState::Triggered) {
+      return;
+    }
+    if (!has_base_) {
+      has_base_ = true;
+      base_value_ = last_value_ = inputs;
+      base_time_us_ = last_change_us_ = end_time_us_ = now_us;
+      if (matches(inputs, 0, 0)) {
+        fire();
+      }
+      return;
+    }
+    if (now_us > end_time_us_) {
+      end_time_us_ = now_us;
+    }
+    const uint16_t changed = static_cast<uint16_t>(inputs ^ last_value_);
+    if (changed == 0) {
+      return;
+    }
+    const auto rising = static_cast<uint16_t>(changed & inputs);
+    const auto falling = static_cast<uint16_t>(changed & last_value_);
+    if (!append(end_time_us_ - last_change_us_, changed)) {
+      state_ = CaptureState::Done;  // full: keep what we have
+      return;
+    }
+    last_value_ = inputs;
+    last_change_us_ = end_time_us_;
+
+    if (state_ == CaptureState::Armed) {
+      if (matches(inputs, rising, falling)) {
+        fire();
+      }
+    } else if (config_.post_trigger_changes != 0 && ++post_changes_ >= config_.post_trigger_changes) {
+      state_ = CaptureState::Done;
+    }
+  }
+
+  [[nodiscard]] constexpr CaptureState State() const noexcept { return state_; }
+
+  /// Changes currently stored.
+  [[nodiscard]] constexpr uint32_t RecordCount() const noexcept { return records_; }
+
+  /// Record bytes currently stored.
+  [[nodiscard]] constexpr size_t UsedBytes() const noexcept { return used_; }
+
+  /// Buffer capacity in bytes.
+  [[nodiscard]] static constexpr size_t Capacity() noexcept { return Bytes; }
+
+  /// Bytes Export() needs for the current contents.
+  [[nodiscard]] constexpr size_t ExportSize() const noexcept { return kCaptureHeaderBytes + used_; }
+
+  /**
+   * @brief Write the capture to @p out (header + records, little-endian).
+   *
+   * Can be called in any state; decode with CaptureReader.
+   * @return Bytes written, or 0 if @p out is smaller than ExportSize().
+   */
+  constexpr size_t Export(std::span<uint8_t> out) const noexcept {
+    if (out.size() < ExportSize()) {
+      return 0;
+    }
+    size_t pos = 0;
+    put(out, pos, kCaptureMagic, 4);
+    put(out, pos, kCaptureVersion, 1);
+    put(out, pos, static_cast<uint8_t>(state_), 1);
+    put(out, pos, has_base_ ? base_value_ : 0, 2);
+    put(out, pos, has_base_ ? base_time_us_ : 0, 8);
+    put(out, pos, has_base_ ? end_time_us_ : 0, 8);
+    put(out, pos, records_, 4);
+    put(out, pos, trigger_index_, 4);
+    put(out, pos, static_cast<uint32_t>(used_), 4);
+    for (size_t i = 0; i < used_; ++i) {
+      out[pos++] = buf_[(head_ + i) % Bytes];
+    }
+    return pos;
+  }
+
+private:
+  constexpr bool matches(uint16_t inputs, uint16_t rising, uint16_t falling) const noexcept {
+    const CaptureTrigger& t = config_.trigger;
+    const bool level_ok = (inputs & t.level_mask) == (t.level_value & t.level_mask);
+    const bool edge_ok = (t.rising_mask == 0 && t.falling_mask == 0) || (rising & t.rising_mask) != 0 ||
+                         (falling & t.falling_mask) != 0;
+    return level_ok && edge_ok;
+  }
+
+  constexpr void fire() noexcept {
+    trigger_index_ = records_;  // trigger state = base + records_ changes
+    state_ = CaptureState::Triggered;
+  }
+
+  /// Append one record, evicting pre-trigger history while armed.
+  constexpr bool append(uint64_t delta_us, uint16_t changed) noexcept {
+    const uint64_t delta_total = delta_us;
+    uint8_t rec[12]{};
+    size_t len = 0;
+    do {
+      const auto low = static_cast<uint8_t>(delta_us & 0x7F);
+      delta_us >>= 7;
+      rec[len++] = static_cast<uint8_t>(delta_us != 0 ? (low | 0x80) : low);
+    } while (delta_us != 0);
+    rec[len++] = static_cast<uint8_t>(changed & 0xFF);
+    rec[len++] = static_cast<uint8_t>(changed >> 8);
+
+    if (state_ == CaptureState::Armed) {
+      while (used_ + len > config_.pre_trigger_bytes && records_ != 0) {
+        evictOldest();
+      }
+      if (used_ + len > config_.pre_trigger_bytes) {
+        // History window smaller than one record: the change moves the base.
+        base_time_us_ += delta_total;
+        base_value_ = static_cast<uint16_t>(base_value_ ^ changed);
+        return true;
+      }
+    } else if (used_ + len > Bytes) {
+      return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+      buf_[(head_ + used_ + i) % Bytes] = rec[i];
+    }
+    used_ += len;
+    ++records_;
+    return true;
+  }
+
+  /// Fold the oldest record into the base state.
+  constexpr void evictOldest() noexcept {
+    uint64_t delta = 0;
+    unsigned shift = 0;
+    uint8_t byte = 0;
+    do {
+      byte = pop();
+      delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      shift += 7;
+    } while ((byte & 0x80) != 0);
+    const uint8_t lo = pop();
+    const uint8_t hi = pop();
+    base_time_us_ += delta;
+    base_value_ = static_cast<uint16_t>(base_value_ ^ (lo | (hi << 8)));
+    --records_;
+  }
+
+  constexpr uint8_t pop() noexcept {
+    const uint8_t b = buf_[head_];
+    head_ = (head_ + 1) % Bytes;
+    --used_;
+    return b;
+  }
+
+  static constexpr void put(std::span<uint8_t> out, size_t& pos, uint64_t value, size_t len) noexcept {
+    for (size_t i = 0; i < len; ++i) {
+      out[pos++] = static_cast<uint8_t>(value >> (8 * i));
+    }
+  }
+
+  uint8_t buf_[Bytes]{};
+  size_t head_{0};  ///< Oldest record byte
+  size_t used_{0};
+  uint32_t records_{0};
+  uint32_t trigger_index_{kCaptureNoTrigger};
+  uint32_t post_changes_{0};
+  CaptureConfig config_{};
+  uint16_t base_value_{0};  ///< State before the oldest stored record
+  uint16_t last_value_{0};
+  uint64_t base_time_us_{0};
+  uint64_t last_change_us_{0};
+  uint64_t end_time_us_{0};  ///< Time of the latest sample
+  bool has_base_{false};
+  CaptureState state_{CaptureState::Idle};
+};
+
+/// One decoded state of a capture.
+struct CaptureEvent {
+  uint64_t time_us = 0;  ///< When the state was first sampled
+  uint16_t value = 0;    ///< Input image from this point on
+  uint16_t changed = 0;  ///< Pins that changed (0 for the base state)
+  bool trigger = false;  ///< This is the state the trigger fired on
+};
+
+/**
+ * @brief Decoder for InputCapture::Export() streams.
+ *
+ * @code
+ * pcal95555::CaptureReader reader(bytes);
+ * pcal95555::CaptureEvent ev;
+ * while (reader.Next(ev)) {
+ *   printf("%llu us: %04X%s\n", ev.time_us, ev.value, ev.trigger ? " <- trigger" : "");
+ * }
+ * @endcode
+ */
+class CaptureReader {
+public:
+  constexpr explicit CaptureReader(std::span<const uint8_t> data) noexcept : data_(data) {
+    if (data.size() < kCaptureHeaderBytes || get(0, 4) != kCaptureMagic || get(4, 1) != kCaptureVersion) {
+      return;
+    }
+    const auto record_bytes = static_cast<size_t>(get(32, 4));
+    if (data.size() < kCaptureHeaderBytes + record_bytes) {
+      return;
+    }
+    state_ = static_cast<CaptureState>(get(5, 1));
+    value_ = static_cast<uint16_t>(get(6, 2));
+    time_us_ = get(8, 8);
+    end_time_us_ = get(16, 8);
+    records_ = static_cast<uint32_t>(get(24, 4));
+    trigger_index_ = static_cast<uint32_t>(get(28, 4));
+    end_ = kCaptureHeaderBytes + record_bytes;
+    pos_ = kCaptureHeaderBytes;
+    valid_ = true;
+  }
+
+  /// false if the stream is truncated or not a capture.
+  [[nodiscard]] constexpr bool Valid() const noexcept { return valid_; }
+  [[nodiscard]] constexpr CaptureState State() const noexcept { return state_; }
+  /// Changes in the stream (Next() yields RecordCount() + 1 events).
+  [[nodiscard]] constexpr uint32_t RecordCount() const noexcept { return records_; }
+  /// Index of the trigger event, or kCaptureNoTrigger.
+  [[nodiscard]] constexpr uint32_t TriggerIndex() const noexcept { return trigger_index_; }
+  /// Time of the last sample (the capture covers [first event, EndTimeUs()]).
+  [[nodiscard]] constexpr uint64_t EndTimeUs() const noexcept { return end_time_us_; }
+
+  /**
+   * @brief Decode the next event: the base state first, then one per change.
+   * @return false at the end of the stream (or on a corrupt record).
+   */
+  constexpr bool Next(CaptureEvent& event) noexcept {
+    if (!valid_ || index_ > records_) {
+      return false;
+    }
+    uint16_t changed = 0;
+    if (index_ > 0) {
+      uint64_t delta = 0;
+      unsigned shift = 0;
+      uint8_t byte = 0;
+      do {
+        if (pos_ >= end_ || shift > 63) {
+          valid_ = false;
+          return false;
+        }
+        byte = data_[pos_++];
+        delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        shift += 7;
+      } while ((byte & 0x80) != 0);
+      if (pos_ + 2 > end_) {
+        valid_ = false;
+        return false;
+      }
+      changed = static_cast<uint16_t>(data_[pos_] | (data_[pos_ + 1] << 8));
+      pos_ += 2;
+      time_us_ += delta;
+      value_ = static_cast<uint16_t>(value_ ^ changed);
+    }
+    event = {time_us_, value_, changed, index_ == trigger_index_};
+    ++index_;
+    return true;
+  }
+
+private:
+  [[nodiscard]] constexpr uint64_t get(size_t offset, size_t len) const noexcept {
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; ++i) {
+      v |= static_cast<uint64_t>(data_[offset + i]) << (8 * i);
+    }
+    return v;
+  }
+
+  std::span<const uint8_t> data_;
+  size_t pos_{0};
+  size_t end_{0};
+  uint32_t index_{0};
+  uint32_t records_{0};
+  uint32_t trigger_index_{kCaptureNoTrigger};
+  uint64_t time_us_{0};
+  uint64_t end_time_us_{0};
+  uint16_t value_{0};
+  CaptureState state_{CaptureState::Idle};
+  bool valid_{false};
+};
+
+} // namespace pcal95555
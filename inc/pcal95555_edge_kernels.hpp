@@ -0,0 +1,500 @@
+/**
+ * @file pcal95555_edge_kernels.hpp
+ * @brief Edge extraction over captured 16-bit input samples (SIMD + portable)
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Post-processing helpers for long captures of the input port image (one
+ * uint16_t per sample, bit N = pin N), e.g. from repeated ReadAllInputs()
+ * calls. Every kernel takes the sample that preceded the buffer as
+ * `previous`, so a capture can be processed in chunks.
+ *
+ * Edge index convention: an edge reported at index `i` happened between
+ * `samples[i - 1]` (or `previous` for `i == 0`) and `samples[i]`. Map
+ * indices to time with the capture's sample period or timestamp array.
+ *
+ * The kernels in pcal95555::edges use AVX2, SSE2 or AArch64 NEON when the
+ * translation unit is compiled for them (e.g. `-mavx2`, `-march=native`) and
+ * portable code otherwise; pcal95555::edges::scalar holds the plain per-sample
+ * loops with identical results. Define HF_PCAL95555_EDGE_KERNELS_SCALAR to
+ * force the portable path.
+ *
+ * This header is standalone (it does not include the driver) and is meant
+ * for host-side analysis, not for the target.
+ */
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#if !defined(HF_PCAL95555_EDGE_KERNELS_SCALAR)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HF_PCAL95555_EDGE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HF_PCAL95555_EDGE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define HF_PCAL95555_EDGE_NEON 1
+#endif
+#endif
+
+namespace pcal95555::edges {
+
+/// Instruction set the pcal95555::edges kernels were compiled for.
+#if defined(HF_PCAL95555_EDGE_AVX2)
+inline constexpr const char* kBackend = "avx2";
+#elif defined(HF_PCAL95555_EDGE_SSE2)
+inline constexpr const char* kBackend = "sse2";
+#elif defined(HF_PCAL95555_EDGE_NEON)
+inline constexpr const char* kBackend = "neon";
+#else
+inline constexpr const char* kBackend = "scalar";
+#endif
+
+/// Per-pin edge totals (index N = pin N).
+struct EdgeCounts {
+  std::array<uint64_t, 16> rising{};
+  std::array<uint64_t, 16> falling{};
+};
+
+/// One edge of a single pin.
+struct EdgeEvent {
+  uint32_t index;  ///< Sample index (see edge index convention)
+  bool rising;     ///< true = LOW to HIGH
+};
+
+/// Interval between two consecutive edges of a single pin.
+struct Pulse {
+  uint32_t start;  ///< Index of the edge that began the pulse
+  uint32_t width;  ///< Length in samples
+  bool level;      ///< Pin level during the pulse (true = HIGH)
+};
+
+//==============================================================================
+// Reference kernels
+//==============================================================================
+
+namespace scalar {
+
+/**
+ * @brief rising[i] = pins that went LOW->HIGH at i; falling[i] = HIGH->LOW.
+ * @param rising,falling Output arrays of samples.size() entries each.
+ */
+inline void EdgeMasks(std::span<const uint16_t> samples, uint16_t previous, uint16_t* rising,
+                      uint16_t* falling) noexcept {
+  uint16_t prev = previous;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const uint16_t cur = samples[i];
+    rising[i] = static_cast<uint16_t>(cur & ~prev);
+    falling[i] = static_cast<uint16_t>(prev & ~cur);
+    prev = cur;
+  }
+}
+
+/**
+ * @brief Add the number of level changes of every pin to @p toggles.
+ */
+inline void CountToggles(std::span<const uint16_t> samples, uint16_t previous,
+                         std::array<uint64_t, 16>& toggles) noexcept {
+  uint16_t prev = previous;
+  for (const uint16_t cur : samples) {
+    for (unsigned t = static_cast<uint16_t>(prev ^ cur); t != 0; t &= t - 1) {
+      ++toggles[static_cast<size_t>(std::countr_zero(t))];
+    }
+    prev = cur;
+  }
+}
+
+/**
+ * @brief Call fn(index) for every sample where a pin in @p pin_mask changed.
+ *
+ * Stops at the first call that returns false.
+ * @return Number of calls that returned true.
+ */
+template <typename Fn>
+size_t ForEachChange(std::span<const uint16_t> samples, uint16_t previous, uint16_t pin_mask, Fn&& fn) {
+  size_t calls = 0;
+  uint16_t prev = previous;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    if (((prev ^ samples[i]) & pin_mask) != 0) {
+      if (!fn(i)) {
+        return calls;
+      }
+      ++calls;
+    }
+    prev = samples[i];
+  }
+  return calls;
+}
+
+} // namespace scalar
+
+//==============================================================================
+// SIMD primitives
+//==============================================================================
+
+namespace detail {
+
+#if defined(HF_PCAL95555_EDGE_AVX2)
+#define HF_PCAL95555_EDGE_SIMD 1
+using Vec = __m256i;
+inline constexpr size_t kLanes = 16;
+inline constexpr unsigned kLaneBits = 2;  // changedLanes() bits per lane
+inline Vec load(const uint16_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const Vec*>(p)); }
+inline void store(uint16_t* p, Vec v) noexcept { _mm256_storeu_si256(reinterpret_cast<Vec*>(p), v); }
+inline Vec vxor(Vec a, Vec b) noexcept { return _mm256_xor_si256(a, b); }
+inline Vec vand(Vec a, Vec b) noexcept { return _mm256_and_si256(a, b); }
+inline Vec andNot(Vec a, Vec b) noexcept { return _mm256_andnot_si256(b, a); }  // a & ~b
+inline Vec splat(uint16_t v) noexcept { return _mm256_set1_epi16(static_cast<short>(v)); }
+inline Vec zero() noexcept { return _mm256_setzero_si256(); }
+inline Vec addBytes(Vec a, Vec b) noexcept { return _mm256_add_epi8(a, b); }
+template <int Shift>
+inline Vec shiftRight(Vec v) noexcept { return _mm256_srli_epi16(v, Shift); }
+inline uint32_t changedLanes(Vec v) noexcept {
+  const auto eq = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, zero())));
+  return ~eq & 0x55555555U;
+}
+#elif defined(HF_PCAL95555_EDGE_SSE2)
+#define HF_PCAL95555_EDGE_SIMD 1
+using Vec = __m128i;
+inline constexpr size_t kLanes = 8;
+inline constexpr unsigned kLaneBits = 2;
+inline Vec load(const uint16_t* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const Vec*>(p)); }
+inline void store(uint16_t* p, Vec v) noexcept { _mm_storeu_si128(reinterpret_cast<Vec*>(p), v); }
+inline Vec vxor(Vec a, Vec b) noexcept { return _mm_xor_si128(a, b); }
+inline Vec vand(Vec a, Vec b) noexcept { return _mm_and_si128(a, b); }
+inline Vec andNot(Vec a, Vec b) noexcept { return _mm_andnot_si128(b, a); }  // a & ~b
+inline Vec splat(uint16_t v) noexcept { return _mm_set1_epi16(static_cast<short>(v)); }
+inline Vec zero() noexcept { return _mm_setzero_si128(); }
+inline Vec addBytes(Vec a, Vec b) noexcept { return _mm_add_epi8(a, b); }
+template <int Shift>
+inline Vec shiftRight(Vec v) noexcept { return _mm_srli_epi16(v, Shift); }
+inline uint32_t changedLanes(Vec v) noexcept {
+  const auto eq = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero())));
+  return ~eq & 0x5555U;
+}
+#elif defined(HF_PCAL95555_EDGE_NEON)
+#define HF_PCAL95555_EDGE_SIMD 1
+using Vec = uint16x8_t;
+inline constexpr size_t kLanes = 8;
+inline constexpr unsigned kLaneBits = 1;
+inline Vec load(const uint16_t* p) noexcept { return vld1q_u16(p); }
+inline void store(uint16_t* p, Vec v) noexcept { vst1q_u16(p, v); }
+inline Vec vxor(Vec a, Vec b) noexcept { return veorq_u16(a, b); }
+inline Vec vand(Vec a, Vec b) noexcept { return vandq_u16(a, b); }
+inline Vec andNot(Vec a, Vec b) noexcept { return vbicq_u16(a, b); }  // a & ~b
+inline Vec splat(uint16_t v) noexcept { return vdupq_n_u16(v); }
+inline Vec zero() noexcept { return vdupq_n_u16(0); }
+inline Vec addBytes(Vec a, Vec b) noexcept {
+  return vreinterpretq_u16_u8(vaddq_u8(vreinterpretq_u8_u16(a), vreinterpretq_u8_u16(b)));
+}
+template <int Shift>
+inline Vec shiftRight(Vec v) noexcept {
+  if constexpr (Shift == 0) {
+    return v;
+  } else {
+    return vshrq_n_u16(v, Shift);
+  }
+}
+inline uint32_t changedLanes(Vec v) noexcept {
+  if (vmaxvq_u16(v) == 0) {
+    return 0;  // common case for sparse edges
+  }
+  static constexpr uint16_t kWeights[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+  return vaddvq_u16(vandq_u16(vtstq_u16(v, v), vld1q_u16(kWeights)));
+}
+#endif
+
+#if defined(HF_PCAL95555_EDGE_SIMD)
+/**
+ * Vertical toggle count: byte lanes of acc[B] count bit B (even bytes) and
+ * bit B + 8 (odd bytes) of each 16-bit lane, so eight byte adders cover all
+ * sixteen pins. Byte counters wrap after 255 vectors; see kFlushEvery.
+ */
+template <int... B>
+inline void accumulateBits(Vec t, Vec (&acc)[8], Vec ones, std::integer_sequence<int, B...> /*unused*/) noexcept {
+  ((acc[B] = addBytes(acc[B], vand(shiftRight<B>(t), ones))), ...);
+}
+
+inline constexpr size_t kFlushEvery = 255;
+
+inline void flushBits(const Vec (&acc)[8], std::array<uint64_t, 16>& toggles) noexcept {
+  for (size_t b = 0; b < 8; ++b) {
+    uint16_t words[kLanes];
+    store(words, acc[b]);
+    for (const uint16_t w : words) {
+      toggles[b] += w & 0xFFU;
+      toggles[b + 8] += w >> 8;
+    }
+  }
+}
+#endif
+
+} // namespace detail
+
+//==============================================================================
+// Dispatched kernels
+//==============================================================================
+
+/**
+ * @brief rising[i] = pins that went LOW->HIGH at i; falling[i] = HIGH->LOW.
+ * @param rising,falling Output arrays of samples.size() entries each.
+ */
+inline void EdgeMasks(std::span<const uint16_t> samples, uint16_t previous, uint16_t* rising,
+                      uint16_t* falling) noexcept {
+  if (samples.empty()) {
+    return;
+  }
+  const uint16_t* p = samples.data();
+  rising[0] = static_cast<uint16_t>(p[0] & ~previous);
+  falling[0] = static_cast<uint16_t>(previous & ~p[0]);
+  size_t i = 1;
+#if defined(HF_PCAL95555_EDGE_SIMD)
+  const size_t n = samples.size();
+  // Overlapping loads at i and i - 1 give each lane its predecessor.
+  for (; i + detail::kLanes <= n; i += detail::kLanes) {
+    const detail::Vec cur = detail::load(p + i);
+    const detail::Vec prv = detail::load(p + i - 1);
+    detail::store(rising + i, detail::andNot(cur, prv));
+    detail::store(falling + i, detail::andNot(prv, cur));
+  }
+#endif
+  scalar::EdgeMasks(samples.subspan(i), p[i - 1], rising + i, falling + i);
+}
+
+/**
+ * @brief Add the number of level changes of every pin to @p toggles.
+ */
+inline void CountToggles(std::span<const uint16_t> samples, uint16_t previous,
+                         std::array<uint64_t, 16>& toggles) noexcept {
+  if (samples.empty()) {
+    return;
+  }
+  const uint16_t* p = samples.data();
+  scalar::CountToggles(samples.first(1), previous, toggles);
+  size_t i = 1;
+#if defined(HF_PCAL95555_EDGE_SIMD)
+  const size_t n = samples.size();
+  const detail::Vec ones = detail::splat(0x0101);
+  while (i + detail::kLanes <= n) {
+    detail::Vec acc[8];
+    for (auto& a : acc) {
+      a = detail::zero();
+    }
+    for (size_t k = 0; k < detail::kFlushEvery && i + detail::kLanes <= n; ++k, i += detail::kLanes) {
+      const detail::Vec t = detail::vxor(detail::load(p + i), detail::load(p + i - 1));
+      detail::accumulateBits(t, acc, ones, std::make_integer_sequence<int, 8>{});
+    }
+    detail::flushBits(acc, toggles);
+  }
+#endif
+  scalar::CountToggles(samples.subspan(i), p[i - 1], toggles);
+}
+
+/**
+ * @brief Call fn(index) for every sample where a pin in @p pin_mask changed.
+ *
+ * Samples without a change in the mask are skipped a vector at a time, so
+ * the cost is dominated by memory bandwidth when edges are sparse. Stops at
+ * the first call that returns false.
+ * @return Number of calls that returned true.
+ */
+template <typename Fn>
+size_t ForEachChange(std::span<const uint16_t> samples, uint16_t previous, uint16_t pin_mask, Fn&& fn) {
+  if (samples.empty()) {
+    return 0;
+  }
+  const uint16_t* p = samples.data();
+  size_t calls = 0;
+  if (((previous ^ p[0]) & pin_mask) != 0) {
+    if (!fn(size_t{0})) {
+      return 0;
+    }
+    ++calls;
+  }
+  size_t i = 1;
+#if defined(HF_PCAL95555_EDGE_SIMD)
+  const size_t n = samples.size();
+  const detail::Vec mask = detail::splat(pin_mask);
+  for (; i + detail::kLanes <= n; i += detail::kLanes) {
+    const detail::Vec t = detail::vand(detail::vxor(detail::load(p + i), detail::load(p + i - 1)), mask);
+    for (uint32_t lanes = detail::changedLanes(t); lanes != 0; lanes &= lanes - 1) {
+      const size_t index = i + static_cast<size_t>(std::countr_zero(lanes)) / detail::kLaneBits;
+      if (!fn(index)) {
+        return calls;
+      }
+      ++calls;
+    }
+  }
+#endif
+  const size_t base = i;
+  return calls + scalar::ForEachChange(samples.subspan(base), p[base - 1], pin_mask,
+                                       [&](size_t k) { return fn(base + k); });
+}
+
+//==============================================================================
+// Per-pin analysis (built on ForEachChange)
+//==============================================================================
+
+namespace detail {
+
+template <typename Scan>
+size_t findChanges(Scan&& scan, std::span<uint32_t> out) {
+  size_t count = 0;
+  scan([&](size_t i) {
+    if (count == out.size()) {
+      return false;
+    }
+    out[count++] = static_cast<uint32_t>(i);
+    return true;
+  });
+  return count;
+}
+
+template <typename Scan>
+size_t pinEdges(Scan&& scan, std::span<const uint16_t> samples, uint8_t pin, std::span<EdgeEvent> out) {
+  size_t count = 0;
+  scan([&](size_t i) {
+    if (count == out.size()) {
+      return false;
+    }
+    out[count++] = {static_cast<uint32_t>(i), ((samples[i] >> pin) & 1U) != 0};
+    return true;
+  });
+  return count;
+}
+
+template <typename Scan>
+size_t pulseWidths(Scan&& scan, std::span<const uint16_t> samples, uint8_t pin, std::span<Pulse> out) {
+  size_t count = 0;
+  bool have_start = false;
+  size_t start = 0;
+  scan([&](size_t i) {
+    if (have_start) {
+      if (count == out.size()) {
+        return false;
+      }
+      out[count++] = {static_cast<uint32_t>(start), static_cast<uint32_t>(i - start),
+                      ((samples[start] >> pin) & 1U) != 0};
+    }
+    have_start = true;
+    start = i;
+    return true;
+  });
+  return count;
+}
+
+inline void splitToggles(const std::array<uint64_t, 16>& toggles, uint16_t previous, EdgeCounts& counts) noexcept {
+  // Edges of one pin alternate, so the starting level decides which kind
+  // gets the odd one.
+  for (size_t b = 0; b < 16; ++b) {
+    const uint64_t starts_low = ((previous >> b) & 1U) == 0 ? 1 : 0;
+    const uint64_t rising = (toggles[b] + starts_low) / 2;
+    counts.rising[b] += rising;
+    counts.falling[b] += toggles[b] - rising;
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Indices of the samples where any pin in @p pin_mask changed.
+ *
+ * Stops when @p out is full; resume with the samples after the last index
+ * and that sample as `previous`.
+ * @return Number of indices written.
+ */
+inline size_t FindChanges(std::span<const uint16_t> samples, uint16_t previous, uint16_t pin_mask,
+                          std::span<uint32_t> out) noexcept {
+  return detail::findChanges(
+      [&](auto&& fn) { return ForEachChange(samples, previous, pin_mask, fn); }, out);
+}
+
+/**
+ * @brief Edge timestamps (sample indices) and directions of one pin.
+ * @param pin Pin number (0-15).
+ * @return Number of events written (stops when @p out is full).
+ */
+inline size_t PinEdges(std::span<const uint16_t> samples, uint16_t previous, uint8_t pin,
+                       std::span<EdgeEvent> out) noexcept {
+  if (pin >= 16) {
+    return 0;
+  }
+  return detail::pinEdges(
+      [&](auto&& fn) { return ForEachChange(samples, previous, static_cast<uint16_t>(1U << pin), fn); },
+      samples, pin, out);
+}
+
+/**
+ * @brief Widths of the complete pulses of one pin (edge to next edge).
+ *
+ * The level before the first edge and after the last edge of the buffer is
+ * not reported; when processing in chunks, use PinEdges() to stitch pulses
+ * across chunk boundaries.
+ * @param pin Pin number (0-15).
+ * @return Number of pulses written (stops when @p out is full).
+ */
+inline size_t PulseWidths(std::span<const uint16_t> samples, uint16_t previous, uint8_t pin,
+                          std::span<Pulse> out) noexcept {
+  if (pin >= 16) {
+    return 0;
+  }
+  return detail::pulseWidths(
+      [&](auto&& fn) { return ForEachChange(samples, previous, static_cast<uint16_t>(1U << pin), fn); },
+      samples, pin, out);
+}
+
+/**
+ * @brief Add the rising and falling edge counts of every pin to @p counts.
+ */
+inline void CountEdges(std::span<const uint16_t> samples, uint16_t previous, EdgeCounts& counts) noexcept {
+  std::array<uint64_t, 16> toggles{};
+  CountToggles(samples, previous, toggles);
+  detail::splitToggles(toggles, previous, counts);
+}
+
+namespace scalar {
+
+/// Reference version of edges::FindChanges().
+inline size_t FindChanges(std::span<const uint16_t> samples, uint16_t previous, uint16_t pin_mask,
+                          std::span<uint32_t> out) noexcept {
+  return detail::findChanges(
+      [&](auto&& fn) { return ForEachChange(samples, previous, pin_mask, fn); }, out);
+}
+
+/// Reference version of edges::PinEdges().
+inline size_t PinEdges(std::span<const uint16_t> samples, uint16_t previous, uint8_t pin,
+                       std::span<EdgeEvent> out) noexcept {
+  if (pin >= 16) {
+    return 0;
+  }
+  return detail::pinEdges(
+      [&](auto&& fn) { return ForEachChange(samples, previous, static_cast<uint16_t>(1U << pin), fn); },
+      samples, pin, out);
+}
+
+/// Reference version of edges::PulseWidths().
+inline size_t PulseWidths(std::span<const uint16_t> samples, uint16_t previous, uint8_t pin,
+                          std::span<Pulse> out) noexcept {
+  if (pin >= 16) {
+    return 0;
+  }
+  return detail::pulseWidths(
+      [&](auto&& fn) { return ForEachChange(samples, previous, static_cast<uint16_t>(1U << pin), fn); },
+      samples, pin, out);
+}
+
+/// Reference version of edges::CountEdges().
+inline void CountEdges(std::span<const uint16_t> samples, uint16_t previous, EdgeCounts& counts) noexcept {
+  std::array<uint64_t, 16> toggles{};
+  CountToggles(samples, previous, toggles);
+  detail::splitToggles(toggles, previous, counts);
+}
+
+} // namespace scalar
+
+} // namespace pcal95555::edges
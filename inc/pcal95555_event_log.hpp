@@ -0,0 +1,574 @@
+/**
+ * @file pcal95555_event_log.hpp
+ * @brief Append-only binary pin-change log for post-mortem analysis
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * EventLogWriter records input changes of up to eight expanders (device
+ * index 0-7, e.g. the address pins A2-A0) as compact binary events instead
+ * of text, so hours of history fit in a small RAM ring, a flash partition or
+ * a memory-mapped file. The storage is an EventLogSink: a ring of equally
+ * sized blocks that are erased as a whole and then only appended to, which
+ * is what NOR flash requires and what the RAM / file sinks emulate.
+ *
+ * Block layout (little-endian):
+ *  - header: magic "PEL1" (4), sequence number (4), base time in us (8),
+ *    log2 of the block size (1), device-present mask (1), then the input
+ *    image of every present device in index order (2 each). The header makes
+ *    each block decodable on its own, so overwriting the oldest block never
+ *    breaks the rest of the log.
+ *  - events, back to back, until the first erased (0xFF) byte.
+ *
+ * Event layout: a tag byte `0 S DDD LLL` (bit 7 is always clear, so a tag
+ * can never be mistaken for erased space) with D = device index and L =
+ * number of time-delta bytes, followed by
+ *  - S = 1 (exactly one pin changed): one byte `tttt pppp` holding the pin
+ *    number and the low 4 bits of the delta, then L bytes of `delta >> 4`;
+ *  - S = 0 (zero or several pins changed): the 16-bit XOR mask of changed
+ *    pins, then L bytes of the delta.
+ * The delta is the time since the previous event of the block (any device)
+ * in microseconds, as a length-prefixed varint. A single-pin change costs
+ * 2 bytes when events are less than 16 us apart, 3 bytes up to 4 ms
+ * (sustained kHz rates) and 4 bytes up to 1 s.
+ *
+ * EventLogReader walks the blocks oldest first and yields absolute
+ * timestamps and input images; it runs on the target or on a host that has
+ * a copy of the storage (see examples/linux/pcal95555logdump.cpp).
+ */
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace pcal95555 {
+
+/// Block identification ("PEL1", little-endian).
+inline constexpr uint32_t kEventLogMagic = 0x314C4550;
+/// Fixed part of a block header (the device images follow).
+inline constexpr size_t kEventLogHeaderBytes = 18;
+/// Devices one log can hold (3-bit index).
+inline constexpr size_t kEventLogMaxDevices = 8;
+/// Value of erased storage; never a valid event tag.
+inline constexpr uint8_t kEventLogErased = 0xFF;
+/// Largest encoded event (tag + 2-byte mask + 7 delta bytes).
+inline constexpr size_t kEventLogMaxEventBytes = 10;
+
+/**
+ * @brief CRTP-based storage interface for the event log.
+ *
+ * The storage is BlockCount() blocks of BlockSize() bytes (a power of two,
+ * 64 .. 32768). Erase() sets a whole block to kEventLogErased; Program()
+ * only ever writes erased bytes, at increasing offsets within a block.
+ *
+ * @code
+ * class FlashSink : public pcal95555::EventLogSink<FlashSink> {
+ * public:
+ *   uint32_t BlockCount() const noexcept { return 16; }
+ *   size_t BlockSize() const noexcept { return 4096; }
+ *   bool Erase(uint32_t block) noexcept { ... }
+ *   bool Program(uint32_t block, size_t offset, const uint8_t* data, size_t len) noexcept { ... }
+ *   bool Read(uint32_t block, size_t offset, uint8_t* data, size_t len) noexcept { ... }
+ * };
+ * @endcode
+ *
+ * @tparam Derived The derived class type (CRTP pattern)
+ */
+template <typename Derived>
+class EventLogSink {
+public:
+  /// Number of blocks in the ring (at least 2).
+  constexpr uint32_t BlockCount() const noexcept {
+    return static_cast<const Derived*>(this)->BlockCount();
+  }
+
+  /// Bytes per block.
+  constexpr size_t BlockSize() const noexcept { return static_cast<const Derived*>(this)->BlockSize(); }
+
+  /// Set every byte of @p block to kEventLogErased.
+  constexpr bool Erase(uint32_t block) noexcept { return static_cast<Derived*>(this)->Erase(block); }
+
+  /// Write @p len bytes at @p offset of @p block (previously erased bytes only).
+  constexpr bool Program(uint32_t block, size_t offset, const uint8_t* data, size_t len) noexcept {
+    return static_cast<Derived*>(this)->Program(block, offset, data, len);
+  }
+
+  /// Read @p len bytes at @p offset of @p block.
+  constexpr bool Read(uint32_t block, size_t offset, uint8_t* data, size_t len) noexcept {
+    return static_cast<Derived*>(this)->Read(block, offset, data, len);
+  }
+
+protected:
+  EventLogSink() = default;
+  EventLogSink(const EventLogSink&) = default;
+  EventLogSink& operator=(const EventLogSink&) = default;
+  ~EventLogSink() = default;
+};
+
+/**
+ * @brief Event log storage in a static RAM array.
+ *
+ * Starts fully erased. Data() exposes the raw ring so it can be dumped
+ * over a debug link and decoded on the host.
+ *
+ * @tparam BlockBytes Bytes per block (power of two, 64 .. 32768).
+ * @tparam Blocks Number of blocks (at least 2).
+ */
+template <size_t BlockBytes = 512, uint32_t Blocks = 8>
+class RamRingSink : public EventLogSink<RamRingSink<BlockBytes, Blocks>> {
+  static_assert(BlockBytes >= 64 && BlockBytes <= 32768 && std::has_single_bit(BlockBytes),
+                "Block size must be a power of two, 64 .. 32768");
+  static_assert(Blocks >= 2, "The ring needs at least 2 blocks");
+
+public:
+  constexpr RamRingSink() noexcept {
+    for (auto& b : data_) {
+      b = kEventLogErased;
+    }
+  }
+
+  constexpr uint32_t BlockCount() const noexcept { return Blocks; }
+  constexpr size_t BlockSize() const noexcept { return BlockBytes; }
+
+  constexpr bool Erase(uint32_t block) noexcept {
+    if (block >= Blocks) {
+      return false;
+    }
+    for (size_t i = 0; i < BlockBytes; ++i) {
+      data_[block * BlockBytes + i] = kEventLogErased;
+    }
+    return true;
+  }
+
+  constexpr bool Program(uint32_t block, size_t offset, const uint8_t* data, size_t len) noexcept {
+    if (block >= Blocks || offset + len > BlockBytes) {
+      return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+      data_[block * BlockBytes + offset + i] = data[i];
+    }
+    return true;
+  }
+
+  constexpr bool Read(uint32_t block, size_t offset, uint8_t* data, size_t len) noexcept {
+    if (block >= Blocks || offset + len > BlockBytes) {
+      return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = data_[block * BlockBytes + offset + i];
+    }
+    return true;
+  }
+
+  /// The whole ring (BlockCount() * BlockSize() bytes).
+  [[nodiscard]] constexpr std::span<const uint8_t> Data() const noexcept { return data_; }
+
+private:
+  uint8_t data_[BlockBytes * Blocks];
+};
+
+/**
+ * @brief Appends pin-change events to an EventLogSink.
+ *
+ * Call Open() once, then Append() the new input image of a device whenever
+ * it may have changed, typically from an interrupt subscriber:
+ * @code
+ * static pcal95555::RamRingSink<512, 16> g_sink;
+ * static pcal95555::EventLogWriter<decltype(g_sink)> g_log(&g_sink);
+ *
+ * g_log.Open();
+ * driver.Subscribe(0xFFFF, InterruptEdge::Both, [](const pcal95555::PinEvents& ev) {
+ *   g_log.Append(0, ev.states, esp_timer_get_time());
+ * });
+ * @endcode
+ *
+ * Appending an unchanged image records nothing. Not thread-safe: append
+ * from one task (or guard the writer with a lock).
+ *
+ * @tparam Sink An EventLogSink implementation.
+ */
+template <typename Sink>
+class EventLogWriter {
+public:
+  constexpr explicit EventLogWriter(Sink* sink) noexcept : sink_(sink) {}
+
+  /**
+   * @brief Validate the sink geometry and find where to continue.
+   *
+   * Scans the block headers and resumes in the block after the newest valid
+   * one, so a reboot appends to the existing history instead of
+   * overwriting it. A partly filled block is never reused.
+   *
+   * @return false if the sink is missing or its geometry is unsupported.
+   */
+  constexpr bool Open() noexcept {
+    open_ = false;
+    block_open_ = false;
+    if (sink_ == nullptr) {
+      return false;
+    }
+    const size_t size = sink_->BlockSize();
+    blocks_ = sink_->BlockCount();
+    if (size < 64 || size > 32768 || !std::has_single_bit(size) || blocks_ < 2) {
+      return false;
+    }
+    block_shift_ = static_cast<uint8_t>(std::countr_zero(size));
+    next_block_ = 0;
+    next_seq_ = 0;
+    bool found = false;
+    for (uint32_t b = 0; b < blocks_; ++b) {
+      uint8_t hdr[kEventLogHeaderBytes]{};
+      if (!sink_->Read(b, 0, hdr, sizeof(hdr)) || get(hdr, 0, 4) != kEventLogMagic || hdr[16] != block_shift_) {
+        continue;
+      }
+      const auto seq = static_cast<uint32_t>(get(hdr, 4, 4));
+      if (!found || seq >= next_seq_) {
+        next_seq_ = seq + 1;
+        next_block_ = (b + 1) % blocks_;
+        found = true;
+      }
+    }
+    open_ = true;
+    return true;
+  }
+
+  /**
+   * @brief Record the input image of one device.
+   *
+   * @param device Device index, 0-7.
+   * @param inputs Input image (bit N = pin N).
+   * @param now_us Monotonic timestamp in microseconds (earlier timestamps
+   *        than the previous event are treated as equal to it).
+   * @return false if the log is not open, @p device is out of range or the
+   *         sink failed.
+   */
+  constexpr bool Append(uint8_t device, uint16_t inputs, uint64_t now_us) noexcept {
+    if (!open_ || device >= kEventLogMaxDevices) {
+      return false;
+    }
+    const uint8_t bit = static_cast<uint8_t>(1U << device);
+    const uint16_t previous = (present_ & bit) != 0 ? states_[device] : 0;
+    const auto changed = static_cast<uint16_t>(inputs ^ previous);
+    if (changed == 0 && (present_ & bit) != 0) {
+      return true;
+    }
+    if (now_us < last_us_) {
+      now_us = last_us_;
+    }
+    uint8_t rec[kEventLogMaxEventBytes]{};
+    size_t len = Encode(device, changed, block_open_ ? now_us - last_us_ : 0, rec);
+    if (!block_open_ || offset_ + len > (size_t{1} << block_shift_)) {
+      if (!startBlock(now_us)) {
+        return false;
+      }
+      len = Encode(device, changed, 0, rec);
+    }
+    if (!sink_->Program(current_block_, offset_, rec, len)) {
+      return false;
+    }
+    offset_ += len;
+    last_us_ = now_us;
+    states_[device] = inputs;
+    present_ = static_cast<uint8_t>(present_ | bit);
+    ++events_;
+    bytes_ += len;
+    return true;
+  }
+
+  /// Events appended since construction.
+  [[nodiscard]] constexpr uint64_t EventCount() const noexcept { return events_; }
+
+  /// Bytes programmed since construction, block headers included.
+  [[nodiscard]] constexpr uint64_t BytesWritten() const noexcept { return bytes_; }
+
+  /// Blocks started since construction.
+  [[nodiscard]] constexpr uint32_t BlocksStarted() const noexcept { return blocks_started_; }
+
+  /**
+   * @brief Encode one event into @p out (at least kEventLogMaxEventBytes).
+   * @return Encoded length in bytes.
+   */
+  static constexpr size_t Encode(uint8_t device, uint16_t changed, uint64_t delta_us, uint8_t* out) noexcept {
+    const bool single = std::has_single_bit(changed);
+    size_t pos = 1;
+    uint64_t rest = delta_us;
+    if (single) {
+      out[pos++] = static_cast<uint8_t>(std::countr_zero(changed) | ((delta_us & 0x0F) << 4));
+      rest >>= 4;
+    } else {
+      out[pos++] = static_cast<uint8_t>(changed & 0xFF);
+      out[pos++] = static_cast<uint8_t>(changed >> 8);
+    }
+    if (rest > 0x00FFFFFFFFFFFFFFULL) {
+      rest = 0x00FFFFFFFFFFFFFFULL;  // 7 bytes: over 2000 years
+    }
+    uint8_t n = 0;
+    while (rest != 0) {
+      out[pos++] = static_cast<uint8_t>(rest & 0xFF);
+      rest >>= 8;
+      ++n;
+    }
+    out[0] = static_cast<uint8_t>((single ? 0x40 : 0x00) | ((device & 0x07) << 3) | n);
+    return pos;
+  }
+
+private:
+  constexpr bool startBlock(uint64_t now_us) noexcept {
+    if (!sink_->Erase(next_block_)) {
+      return false;
+    }
+    uint8_t hdr[kEventLogHeaderBytes + 2 * kEventLogMaxDevices]{};
+    put(hdr, 0, kEventLogMagic, 4);
+    put(hdr, 4, next_seq_, 4);
+    put(hdr, 8, now_us, 8);
+    hdr[16] = block_shift_;
+    hdr[17] = present_;
+    size_t len = kEventLogHeaderBytes;
+    for (size_t d = 0; d < kEventLogMaxDevices; ++d) {
+      if ((present_ & (1U << d)) != 0) {
+        put(hdr, len, states_[d], 2);
+        len += 2;
+      }
+    }
+    if (!sink_->Program(next_block_, 0, hdr, len)) {
+      return false;
+    }
+    current_block_ = next_block_;
+    next_block_ = (next_block_ + 1) % blocks_;
+    ++next_seq_;
+    ++blocks_started_;
+    offset_ = len;
+    last_us_ = now_us;
+    block_open_ = true;
+    bytes_ += len;
+    return true;
+  }
+
+  static constexpr void put(uint8_t* out, size_t pos, uint64_t value, size_t len) noexcept {
+    for (size_t i = 0; i < len; ++i) {
+      out[pos + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+  }
+
+  static constexpr uint64_t get(const uint8_t* in, size_t pos, size_t len) noexcept {
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; ++i) {
+      v |= static_cast<uint64_t>(in[pos + i]) << (8 * i);
+    }
+    return v;
+  }
+
+  Sink* sink_;
+  uint64_t last_us_{0};  ///< Time of the latest event (or block start)
+  uint64_t events_{0};
+  uint64_t bytes_{0};
+  size_t offset_{0};  ///< Next free byte in current_block_
+  uint32_t blocks_{0};
+  uint32_t current_block_{0};
+  uint32_t next_block_{0};
+  uint32_t next_seq_{0};
+  uint32_t blocks_started_{0};
+  uint16_t states_[kEventLogMaxDevices]{};
+  uint8_t present_{0};  ///< Devices with a known image
+  uint8_t block_shift_{0};
+  bool open_{false};
+  bool block_open_{false};
+};
+
+/// One decoded event.
+struct EventLogEvent {
+  uint64_t time_us = 0;  ///< When the change was appended
+  uint16_t inputs = 0;   ///< Input image of the device from this point on
+  uint16_t changed = 0;  ///< Pins that changed (all set pins for a device's first event)
+  uint8_t device = 0;    ///< Device index, 0-7
+};
+
+/**
+ * @brief Decoder for one block of an event log.
+ */
+class EventLogBlockReader {
+public:
+  constexpr EventLogBlockReader() noexcept = default;
+
+  /// Parse the header of @p block (the full block contents).
+  constexpr explicit EventLogBlockReader(std::span<const uint8_t> block) noexcept : data_(block) {
+    if (block.size() < kEventLogHeaderBytes || get(0, 4) != kEventLogMagic ||
+        block.size() != (size_t{1} << (data_[16] & 0x1F))) {
+      return;
+    }
+    seq_ = static_cast<uint32_t>(get(4, 4));
+    time_us_ = get(8, 8);
+    present_ = data_[17];
+    pos_ = kEventLogHeaderBytes;
+    for (size_t d = 0; d < kEventLogMaxDevices; ++d) {
+      if ((present_ & (1U << d)) != 0) {
+        if (pos_ + 2 > data_.size()) {
+          return;
+        }
+        states_[d] = static_cast<uint16_t>(get(pos_, 2));
+        pos_ += 2;
+      }
+    }
+    valid_ = true;
+  }
+
+  /// false if the block is erased, torn or not part of a log.
+  [[nodiscard]] constexpr bool Valid() const noexcept { return valid_; }
+  [[nodiscard]] constexpr uint32_t Sequence() const noexcept { return seq_; }
+  /// Device-present mask and images at the start of the block.
+  [[nodiscard]] constexpr uint8_t PresentMask() const noexcept { return present_; }
+  /// Bytes decoded so far, header included (the used size once Next() returned false).
+  [[nodiscard]] constexpr size_t Offset() const noexcept { return pos_; }
+
+  /**
+   * @brief Decode the next event of the block.
+   * @return false at the end of the block (or on a truncated event).
+   */
+  constexpr bool Next(EventLogEvent& event) noexcept {
+    if (!valid_ || pos_ >= data_.size() || (data_[pos_] & 0x80) != 0) {
+      return false;
+    }
+    const uint8_t tag = data_[pos_];
+    const bool single = (tag & 0x40) != 0;
+    const auto device = static_cast<uint8_t>((tag >> 3) & 0x07);
+    const size_t n = tag & 0x07;
+    const size_t len = 1 + (single ? 1 : 2) + n;
+    if (pos_ + len > data_.size()) {
+      valid_ = false;
+      return false;
+    }
+    uint16_t changed = 0;
+    uint64_t delta = 0;
+    if (single) {
+      const uint8_t b = data_[pos_ + 1];
+      changed = static_cast<uint16_t>(1U << (b & 0x0F));
+      delta = (get(pos_ + 2, n) << 4) | (b >> 4);
+    } else {
+      changed = static_cast<uint16_t>(get(pos_ + 1, 2));
+      delta = get(pos_ + 3, n);
+    }
+    pos_ += len;
+    time_us_ += delta;
+    states_[device] = static_cast<uint16_t>(states_[device] ^ changed);
+    present_ = static_cast<uint8_t>(present_ | (1U << device));
+    event = {time_us_, states_[device], changed, device};
+    return true;
+  }
+
+private:
+  [[nodiscard]] constexpr uint64_t get(size_t offset, size_t len) const noexcept {
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; ++i) {
+      v |= static_cast<uint64_t>(data_[offset + i]) << (8 * i);
+    }
+    return v;
+  }
+
+  std::span<const uint8_t> data_;
+  size_t pos_{0};
+  uint64_t time_us_{0};
+  uint32_t seq_{0};
+  uint16_t states_[kEventLogMaxDevices]{};
+  uint8_t present_{0};
+  bool valid_{false};
+};
+
+/**
+ * @brief Decoder for a whole event log, oldest block first.
+ *
+ * @code
+ * uint8_t scratch[512];  // one block
+ * pcal95555::EventLogReader<decltype(g_sink)> reader(&g_sink, scratch);
+ * pcal95555::EventLogEvent ev;
+ * while (reader.Next(ev)) {
+ *   printf("%llu us dev %u: %04X\n", ev.time_us, ev.device, ev.inputs);
+ * }
+ * @endcode
+ *
+ * @tparam Sink An EventLogSink implementation.
+ */
+template <typename Sink>
+class EventLogReader {
+public:
+  /**
+   * @param sink Storage to decode.
+   * @param scratch Buffer of at least sink->BlockSize() bytes.
+   */
+  constexpr EventLogReader(Sink* sink, std::span<uint8_t> scratch) noexcept : sink_(sink), scratch_(scratch) {
+    if (sink_ == nullptr || scratch.size() < sink_->BlockSize()) {
+      return;
+    }
+    blocks_ = sink_->BlockCount();
+    bool found = false;
+    for (uint32_t b = 0; b < blocks_; ++b) {
+      uint8_t hdr[kEventLogHeaderBytes]{};
+      if (!sink_->Read(b, 0, hdr, sizeof(hdr)) || headerSeq(hdr) < 0) {
+        continue;
+      }
+      const auto seq = static_cast<uint32_t>(headerSeq(hdr));
+      if (!found || seq < seq_) {
+        seq_ = seq;
+        block_ = b;
+        found = true;
+      }
+    }
+    pending_ = found;
+  }
+
+  /// Blocks decoded so far.
+  [[nodiscard]] constexpr uint32_t BlocksRead() const noexcept { return blocks_read_; }
+
+  /// Block currently being decoded.
+  [[nodiscard]] constexpr const EventLogBlockReader& CurrentBlock() const noexcept { return current_; }
+
+  /**
+   * @brief Decode the next event.
+   *
+   * Stops at the first block that is missing, torn or out of sequence.
+   * @return false at the end of the log.
+   */
+  constexpr bool Next(EventLogEvent& event) noexcept {
+    while (true) {
+      if (current_.Next(event)) {
+        return true;
+      }
+      if (!pending_ || blocks_read_ >= blocks_) {
+        return false;
+      }
+      const size_t size = sink_->BlockSize();
+      if (!sink_->Read(block_, 0, scratch_.data(), size)) {
+        pending_ = false;
+        return false;
+      }
+      current_ = EventLogBlockReader(scratch_.first(size));
+      if (!current_.Valid() || current_.Sequence() != seq_) {
+        pending_ = false;
+        return false;
+      }
+      ++blocks_read_;
+      block_ = (block_ + 1) % blocks_;
+      ++seq_;
+    }
+  }
+
+private:
+  static constexpr int64_t headerSeq(const uint8_t* hdr) noexcept {
+    uint32_t magic = 0;
+    uint32_t seq = 0;
+    for (size_t i = 0; i < 4; ++i) {
+      magic |= static_cast<uint32_t>(hdr[i]) << (8 * i);
+      seq |= static_cast<uint32_t>(hdr[4 + i]) << (8 * i);
+    }
+    return magic == kEventLogMagic ? static_cast<int64_t>(seq) : -1;
+  }
+
+  Sink* sink_;
+  std::span<uint8_t> scratch_;
+  EventLogBlockReader current_{};
+  uint32_t blocks_{0};
+  uint32_t block_{0};  ///< Next block to load
+  uint32_t seq_{0};    ///< Sequence number expected there
+  uint32_t blocks_read_{0};
+  bool pending_{false};
+};
+
+} // namespace pcal95555
@@ -0,0 +1,259 @@
+/**
+ * @file pcal95555_fault_injection.hpp
+ * @brief I2C fault injection for measuring degraded-mode behaviour
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * FaultInjectionBus is an I2cInterface decorator. Drivers talk to it instead
+ * of the real bus; it forwards every transaction and, with configurable
+ * probabilities, makes it go wrong the way a marginal bus does:
+ *
+ *  - NACK: the transaction fails without reaching the device. A NACK can
+ *    start a storm, in which the next transactions fail as well;
+ *  - timeout: the call waits `timeout_us`, then fails (clock stretching
+ *    held too long, arbitration never won);
+ *  - delay: the call completes, but only after `delay_us`;
+ *  - corruption: a read completes, with one random data bit flipped;
+ *  - stuck read: a register frozen with SetStuck() reads back the same
+ *    value whatever is written to it (stuck data line, latched-up
+ *    register);
+ *  - disappearance: an address marked absent (SetPresent()) NACKs every
+ *    transaction until it is marked present again (unplugged cable, device
+ *    in reset).
+ *
+ * Faults are drawn from a seeded xorshift generator, so a run is
+ * reproducible. Only transactions to `target_addr` are affected (0xFF: any
+ * address), stuck registers included. Waits go through `sleep_us`; on the
+ * host, point it at the simulated clock to measure the cost without waiting.
+ *
+ * Not thread-safe: serialize calls with the lock that already serializes
+ * the bus.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "pcal95555_i2c_interface.hpp"
+
+namespace pcal95555 {
+
+/**
+ * @brief Fault probabilities and timing of a FaultInjectionBus.
+ *
+ * Probabilities are in parts per million of transactions (10000 = 1 %).
+ * Faults are tried in the order NACK, timeout, delay, corruption; at most
+ * one fault hits a transaction.
+ */
+struct FaultInjectionConfig {
+  uint32_t nack_ppm = 0;       ///< Transactions that NACK
+  uint16_t nack_burst = 1;     ///< Consecutive transactions failed by one NACK event (storm length)
+  uint32_t timeout_ppm = 0;    ///< Transactions that time out
+  uint32_t timeout_us = 1000;  ///< Wait before a timed-out transaction fails
+  uint32_t delay_ppm = 0;      ///< Transactions that complete late
+  uint32_t delay_us = 100;     ///< Extra completion time of a delayed transaction
+  uint32_t corrupt_ppm = 0;    ///< Reads that return one flipped bit
+  uint8_t target_addr = 0xFF;  ///< Address affected by faults (0xFF: every address)
+  uint32_t seed = 1;           ///< Generator seed (0 is replaced by 1)
+  void (*sleep_us)(uint32_t us) noexcept = nullptr;  ///< Waits for timeouts and delays (nullptr: no wait)
+};
+
+/// Transactions seen and faults injected since construction or ResetStats().
+struct FaultInjectionStats {
+  uint32_t transactions = 0;  ///< Calls to Write() / Read()
+  uint32_t nacks = 0;         ///< Failed by NACK (storm members included)
+  uint32_t storms = 0;        ///< NACK events (a storm counts once)
+  uint32_t timeouts = 0;      ///< Failed after timeout_us
+  uint32_t delays = 0;        ///< Completed after delay_us
+  uint32_t corrupted = 0;     ///< Reads with a flipped bit
+  uint32_t stuck = 0;         ///< Reads that returned at least one frozen register
+  uint32_t absent = 0;        ///< Failed because the address is marked absent
+};
+
+/**
+ * @brief I2cInterface decorator that injects faults around @p Inner.
+ *
+ * @code
+ * pcal95555::FaultInjectionBus<MyI2c> faulty(&i2c, {.nack_ppm = 10000, .nack_burst = 4});
+ * pcal95555::PCAL95555<pcal95555::FaultInjectionBus<MyI2c>> driver(&faulty, 0x20);
+ * // ... run the workload, then look at faulty.Stats() and driver.GetErrorFlags()
+ * @endcode
+ */
+template <typename Inner>
+class FaultInjectionBus : public I2cInterface<FaultInjectionBus<Inner>> {
+public:
+  FaultInjectionBus(Inner* inner, const FaultInjectionConfig& config = {}) noexcept : inner_(inner) {
+    SetConfig(config);
+  }
+
+  /// Replace the fault model; restarts the generator from the new seed and ends a storm.
+  void SetConfig(const FaultInjectionConfig& config) noexcept {
+    config_ = config;
+    rng_ = config.seed != 0 ? config.seed : 1;
+    storm_left_ = 0;
+  }
+  [[nodiscard]] const FaultInjectionConfig& Config() const noexcept { return config_; }
+
+  /**
+   * @brief Mark @p addr present or absent (0x00-0x7F).
+   *
+   * Absent addresses NACK every transaction, regardless of the
+   * probabilities and of `target_addr`.
+   */
+  void SetPresent(uint8_t addr, bool present) noexcept {
+    const uint8_t a = addr & 0x7F;
+    const uint32_t bit = 1U << (a & 31);
+    if (present) {
+      absent_[a >> 5] &= ~bit;
+    } else {
+      absent_[a >> 5] |= bit;
+    }
+  }
+  [[nodiscard]] bool IsPresent(uint8_t addr) const noexcept {
+    const uint8_t a = addr & 0x7F;
+    return (absent_[a >> 5] & (1U << (a & 31))) == 0;
+  }
+
+  /**
+   * @brief Freeze register @p reg (0x00-0x7F): reads return @p value until ClearStuck().
+   *
+   * Writes still reach the device; only what reads report is frozen. Reads
+   * covering several registers (paired reads) freeze just this byte.
+   */
+  void SetStuck(uint8_t reg, uint8_t value) noexcept {
+    const uint8_t r = reg & 0x7F;
+    stuck_[r >> 5] |= 1U << (r & 31);
+    stuck_value_[r] = value;
+  }
+  void ClearStuck(uint8_t reg) noexcept {
+    const uint8_t r = reg & 0x7F;
+    stuck_[r >> 5] &= ~(1U << (r & 31));
+  }
+  [[nodiscard]] bool IsStuck(uint8_t reg) const noexcept {
+    const uint8_t r = reg & 0x7F;
+    return (stuck_[r >> 5] & (1U << (r & 31))) != 0;
+  }
+
+  [[nodiscard]] const FaultInjectionStats& Stats() const noexcept { return stats_; }
+  void ResetStats() noexcept { stats_ = FaultInjectionStats{}; }
+
+  // ---- I2cInterface ----
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    if (!admit(addr, false)) {
+      return false;
+    }
+    return inner_->Write(addr, reg, data, len);
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    if (!admit(addr, true)) {
+      return false;
+    }
+    if (!inner_->Read(addr, reg, data, len)) {
+      return false;
+    }
+    if (corrupt_pending_ && len != 0) {
+      const uint32_t bit = next() % static_cast<uint32_t>(len * 8);
+      data[bit / 8] = static_cast<uint8_t>(data[bit / 8] ^ (1U << (bit % 8)));
+      ++stats_.corrupted;
+    }
+    if ((stuck_[0] | stuck_[1] | stuck_[2] | stuck_[3]) != 0 && targeted(addr)) {
+      bool frozen = false;
+      for (size_t i = 0; i < len; ++i) {
+        const auto r = static_cast<uint8_t>((reg + i) & 0x7F);
+        if (IsStuck(r)) {
+          data[i] = stuck_value_[r];
+          frozen = true;
+        }
+      }
+      stats_.stuck += frozen ? 1 : 0;
+    }
+    return true;
+  }
+
+  bool EnsureInitialized() noexcept { return inner_->EnsureInitialized(); }
+
+  bool SetAddressPins(bool a0_level, bool a1_level, bool a2_level) noexcept {
+    return inner_->SetAddressPins(a0_level, a1_level, a2_level);
+  }
+
+  bool RegisterInterruptHandler(std::function<void()> handler) noexcept {
+    return inner_->RegisterInterruptHandler(std::move(handler));
+  }
+
+  void GpioSet(CtrlPin pin, GpioSignal signal) noexcept { inner_->GpioSet(pin, signal); }
+
+  bool GpioRead(CtrlPin pin, GpioSignal& signal) noexcept { return inner_->GpioRead(pin, signal); }
+
+  void SetUrgent(bool urgent) noexcept { inner_->SetUrgent(urgent); }
+
+private:
+  /// Decide the fate of one transaction; false = fail it without forwarding.
+  bool admit(uint8_t addr, bool is_read) noexcept {
+    ++stats_.transactions;
+    corrupt_pending_ = false;
+    if (!IsPresent(addr)) {
+      ++stats_.absent;
+      return false;
+    }
+    if (!targeted(addr)) {
+      return true;
+    }
+    if (storm_left_ != 0) {
+      --storm_left_;
+      ++stats_.nacks;
+      return false;
+    }
+    if (hit(config_.nack_ppm)) {
+      storm_left_ = config_.nack_burst > 1 ? static_cast<uint16_t>(config_.nack_burst - 1) : 0;
+      ++stats_.storms;
+      ++stats_.nacks;
+      return false;
+    }
+    if (hit(config_.timeout_ppm)) {
+      wait(config_.timeout_us);
+      ++stats_.timeouts;
+      return false;
+    }
+    if (hit(config_.delay_ppm)) {
+      wait(config_.delay_us);
+      ++stats_.delays;
+    } else if (is_read && hit(config_.corrupt_ppm)) {
+      corrupt_pending_ = true;
+    }
+    return true;
+  }
+
+  [[nodiscard]] bool targeted(uint8_t addr) const noexcept {
+    return config_.target_addr == 0xFF || (addr & 0x7F) == (config_.target_addr & 0x7F);
+  }
+
+  /// True with probability @p ppm / 1e6; draws nothing when @p ppm is 0.
+  bool hit(uint32_t ppm) noexcept { return ppm != 0 && next() % 1000000U < ppm; }
+
+  uint32_t next() noexcept {
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return rng_;
+  }
+
+  void wait(uint32_t us) const noexcept {
+    if (config_.sleep_us != nullptr && us != 0) {
+      config_.sleep_us(us);
+    }
+  }
+
+  Inner* inner_;
+  FaultInjectionConfig config_{};
+  FaultInjectionStats stats_{};
+  uint32_t absent_[4]{};
+  uint32_t stuck_[4]{};          // Bit per register 0x00-0x7F
+  uint8_t stuck_value_[0x80]{};  // What a stuck register reads back
+  uint32_t rng_{1};
+  uint16_t storm_left_{0};
+  bool corrupt_pending_{false};
+};
+
+} // namespace pcal95555
@@ -76,7 +76,7 @@ public:
    * @return true if the device acknowledges the transfer; false on NACK or
    * error.
    */
-  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+  constexpr bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
     return static_cast<Derived*>(this)->Write(addr, reg, data, len);
   }
 
@@ -89,7 +89,7 @@ public:
    * @param len Number of bytes to read into the buffer.
    * @return true if the read succeeds; false on NACK or error.
    */
-  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+  constexpr bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
     return static_cast<Derived*>(this)->Read(addr, reg, data, len);
   }
 
@@ -116,7 +116,7 @@ public:
    *   // Set A2=HIGH, A1=LOW, A0=HIGH (address bits = 0b101 = 5)
    *   bool success = i2c->SetAddressPins(true, false, true);
    */
-  bool SetAddressPins(bool a0_level, bool a1_level, bool a2_level) noexcept {
+  constexpr bool SetAddressPins(bool a0_level, bool a1_level, bool a2_level) noexcept {
     // Default implementation: not supported
     (void)a0_level;  // Suppress unused parameter warning
     (void)a1_level;
@@ -148,7 +148,7 @@ public:
    *       return true;
    *   }
    */
-  bool EnsureInitialized() noexcept {
+  constexpr bool EnsureInitialized() noexcept {
     return static_cast<Derived*>(this)->EnsureInitialized();
   }
 
@@ -202,7 +202,7 @@ public:
    * @note Default implementation is a no-op. Override in derived class if
    *       the reset pin is wired and controllable.
    */
-  void GpioSet(CtrlPin pin, GpioSignal signal) noexcept {
+  constexpr void GpioSet(CtrlPin pin, GpioSignal signal) noexcept {
     (void)pin;
     (void)signal;
   }
@@ -219,23 +219,37 @@ public:
    * @note Default implementation returns false (unsupported). Override in
    *       derived class if interrupt pin monitoring is needed.
    */
-  bool GpioRead(CtrlPin pin, GpioSignal &signal) noexcept {
+  constexpr bool GpioRead(CtrlPin pin, GpioSignal &signal) noexcept {
     (void)pin;
     (void)signal;
     return false;
   }
 
+  /**
+   * @brief Mark the following transfers as urgent (or end the urgent section).
+   *
+   * PCAL95555::EmergencyStop() calls SetUrgent(true) before its writes and
+   * SetUrgent(false) after them. Implementations that queue, arbitrate or
+   * throttle transfers can use it to put those writes ahead of other work
+   * (skip a software queue, take a priority lock, ignore quotas).
+   *
+   * @param[in] urgent true at the start of the urgent section, false at its end.
+   *
+   * @note Default implementation is a no-op: transfers are issued directly.
+   */
+  constexpr void SetUrgent(bool urgent) noexcept { (void)urgent; }
+
   /**
    * @brief Assert a control pin (set to ACTIVE).
    * @param[in] pin  Which control pin to assert.
    */
-  void GpioSetActive(CtrlPin pin) noexcept { GpioSet(pin, GpioSignal::ACTIVE); }
+  constexpr void GpioSetActive(CtrlPin pin) noexcept { GpioSet(pin, GpioSignal::ACTIVE); }
 
   /**
    * @brief Deassert a control pin (set to INACTIVE).
    * @param[in] pin  Which control pin to deassert.
    */
-  void GpioSetInactive(CtrlPin pin) noexcept { GpioSet(pin, GpioSignal::INACTIVE); }
+  constexpr void GpioSetInactive(CtrlPin pin) noexcept { GpioSet(pin, GpioSignal::INACTIVE); }
 
   /// @}
 
@@ -0,0 +1,132 @@
+/**
+ * @file pcal95555_inline_callback.hpp
+ * @brief Heap-free, fixed-capacity callable wrapper for PCAL95555 interrupt callbacks
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pcal95555_kconfig.hpp"
+
+namespace pcal95555 {
+
+/**
+ * @brief Type-erased callable stored inline in the owning object.
+ *
+ * Replaces `std::function` in the driver's callback slots: it accepts any
+ * nothrow-copyable callable whose size fits in @p Capacity bytes and never
+ * touches the heap. Oversized or throwing-copy captures are rejected at
+ * compile time, so the `noexcept` copy operations below cannot terminate.
+ *
+ * An empty InlineCallback is a literal type, so drivers that own callback
+ * slots remain usable in constant evaluation (see
+ * pcal95555_transaction_budget.hpp).
+ *
+ * @tparam Signature Function signature, e.g. `void(uint16_t)`.
+ * @tparam Capacity  Inline storage size in bytes
+ *                   (default `CONFIG_PCAL95555_CALLBACK_STORAGE_BYTES`).
+ */
+template <typename Signature, std::size_t Capacity = CONFIG_PCAL95555_CALLBACK_STORAGE_BYTES>
+class InlineCallback;
+
+template <typename R, typename... Args, std::size_t Capacity>
+class InlineCallback<R(Args...), Capacity> {
+public:
+  constexpr InlineCallback() noexcept = default;
+  constexpr InlineCallback(std::nullptr_t) noexcept {}  // NOLINT(google-explicit-constructor)
+
+  /**
+   * @brief Store a callable (lambda, function pointer, functor).
+   * @note Fails to compile if the callable does not fit in @p Capacity bytes.
+   */
+  template <typename F>
+    requires(!std::is_same_v<std::remove_cvref_t<F>, InlineCallback> &&
+             std::is_invocable_r_v<R, std::remove_cvref_t<F>&, Args...>)
+  InlineCallback(F&& fn) noexcept {  // NOLINT(google-explicit-constructor)
+    emplace(std::forward<F>(fn));
+  }
+
+  InlineCallback(const InlineCallback& other) noexcept {
+    if (other.ops_ != nullptr) {
+      other.ops_->copy(storage_, other.storage_);
+      ops_ = other.ops_;
+    }
+  }
+
+  InlineCallback& operator=(const InlineCallback& other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.ops_ != nullptr) {
+        other.ops_->copy(storage_, other.storage_);
+        ops_ = other.ops_;
+      }
+    }
+    return *this;
+  }
+
+  constexpr InlineCallback& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  constexpr ~InlineCallback() { reset(); }
+
+  /**
+   * @brief Destroy the stored callable, leaving the wrapper empty.
+   */
+  constexpr void reset() noexcept {
+    if (ops_ != nullptr) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  /// @return true if a callable is stored.
+  constexpr explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+  /**
+   * @brief Invoke the stored callable. Must not be empty.
+   */
+  R operator()(Args... args) const {
+    return ops_->invoke(storage_, std::forward<Args>(args)...);
+  }
+
+private:
+  struct Ops {
+    R (*invoke)(void* obj, Args... args);
+    void (*copy)(void* dst, const void* src);
+    void (*destroy)(void* obj);
+  };
+
+  template <typename Fn>
+  static constexpr Ops kOpsFor{
+      [](void* obj, Args... args) -> R {
+        return (*std::launder(static_cast<Fn*>(obj)))(std::forward<Args>(args)...);
+      },
+      [](void* dst, const void* src) { ::new (dst) Fn(*std::launder(static_cast<const Fn*>(src))); },
+      [](void* obj) { std::launder(static_cast<Fn*>(obj))->~Fn(); }};
+
+  template <typename F>
+  void emplace(F&& fn) noexcept {
+    using Fn = std::remove_cvref_t<F>;
+    static_assert(sizeof(Fn) <= Capacity,
+                  "Callback capture too large: raise CONFIG_PCAL95555_CALLBACK_STORAGE_BYTES");
+    static_assert(alignof(Fn) <= kAlign, "Callback capture over-aligned");
+    static_assert(std::is_nothrow_copy_constructible_v<Fn>, "Callback must be copyable without throwing");
+    static_assert(std::is_nothrow_constructible_v<Fn, F>, "Callback must be constructible without throwing");
+    ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(fn));
+    ops_ = &kOpsFor<Fn>;
+  }
+
+  // Pointer/double alignment covers lambda captures without padding every slot to max_align_t.
+  static constexpr std::size_t kAlign = alignof(void*) > alignof(double) ? alignof(void*) : alignof(double);
+
+  alignas(kAlign) mutable unsigned char storage_[Capacity]{};
+  const Ops* ops_{nullptr};
+};
+
+} // namespace pcal95555
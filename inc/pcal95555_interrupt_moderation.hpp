@@ -0,0 +1,265 @@
+/**
+ * @file pcal95555_interrupt_moderation.hpp
+ * @brief Adaptive interrupt service: per-edge, moderated or polled
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Servicing an interrupt costs two paired reads on PCAL9555A (status +
+ * inputs) and one on PCA9555 (inputs). At low event rates the cheapest
+ * policy is to service every INT edge; at high rates that costs more bus
+ * time than polling at a fixed rate. In between,
+ * moderation (as in NIC interrupt moderation) waits a short time after the
+ * first edge so that the edges arriving meanwhile are handled in one pass.
+ *
+ * InterruptModerator measures the event rate over fixed windows: the input
+ * pins the services found changed or the INT edges reported, whichever is
+ * higher in the window. A pin that toggles an even number of times between
+ * two services reads as unchanged, and one service reports at most 16
+ * changes, so the change count alone under-reads a busy input while it is
+ * being polled; the edges still show the load. The moderator moves
+ * between the three modes with separate enter/exit thresholds, so a rate
+ * near a threshold does not flap. Every transition is reported through a
+ * callback and counted in ModerationStats, together with an estimate of the
+ * bus time saved against one service per input change (what per-edge
+ * service costs when every change raises its own INT edge).
+ *
+ * Used through PCAL95555::ServiceInterrupts(), called from the interrupt
+ * task on every INT edge and whenever NextWakeUs() elapses.
+ */
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pcal95555_inline_callback.hpp"
+
+namespace pcal95555 {
+
+/// How INT edges are turned into interrupt services.
+enum class ServiceMode : uint8_t {
+  PerEdge = 0,    ///< Service every edge immediately
+  Moderated = 1,  ///< Service once per moderation delay after the first edge
+  Polling = 2     ///< Service at a fixed period; edges are only counted
+};
+
+/**
+ * @brief Thresholds and timing of InterruptModerator.
+ *
+ * Rates are events per second (input changes or INT edges, whichever is
+ * higher over the window). Each enter threshold must be above
+ * its exit threshold; the gap is the hysteresis.
+ */
+struct ModerationConfig {
+  uint32_t moderate_enter_hz = 200;  ///< PerEdge -> Moderated at or above this rate
+  uint32_t moderate_exit_hz = 100;   ///< Moderated -> PerEdge below this rate
+  uint32_t poll_enter_hz = 2000;     ///< -> Polling at or above this rate
+  uint32_t poll_exit_hz = 1000;      ///< Polling -> Moderated below this rate
+  uint32_t moderation_us = 500;      ///< Delay after the first edge in Moderated mode
+  uint32_t poll_period_us = 1000;    ///< Service period in Polling mode
+  uint32_t window_us = 100000;       ///< Rate measurement window
+  uint32_t service_wire_us = 240;    ///< Bus time of one service (two paired reads at 400 kHz; 120 on PCA9555)
+  ServiceMode initial_mode = ServiceMode::PerEdge;
+  bool adaptive = true;              ///< false: stay in initial_mode
+};
+
+/// Counters since construction or ResetStats().
+struct ModerationStats {
+  uint32_t edges = 0;              ///< INT edges reported
+  uint32_t services = 0;           ///< Interrupt services performed
+  uint32_t empty_services = 0;     ///< Services that found no change (mostly idle polls)
+  uint32_t events = 0;             ///< Input changes found by the services
+  uint32_t transitions = 0;        ///< Mode changes
+  uint32_t last_rate_hz = 0;       ///< Rate measured in the last window
+  int64_t bus_us_saved = 0;        ///< (events - services) x service_wire_us; negative = cost
+  uint32_t services_by_mode[3]{};  ///< Services per ServiceMode
+};
+
+/// Reported on every mode change.
+struct ModeTransition {
+  ServiceMode from;
+  ServiceMode to;
+  uint32_t rate_hz;  ///< Rate that caused the change
+  uint64_t time_us;  ///< When the change happened
+};
+
+/**
+ * @brief Decides when the interrupt task services the expander.
+ *
+ * Not thread-safe: call from the one task that services the expander.
+ *
+ * @code
+ * pcal95555::InterruptModerator moderator;
+ * moderator.SetTransitionCallback([](const pcal95555::ModeTransition& t) {
+ *   ESP_LOGI("IRQ", "mode %u -> %u at %u Hz", unsigned(t.from), unsigned(t.to), unsigned(t.rate_hz));
+ * });
+ * for (;;) {
+ *   const uint64_t now = esp_timer_get_time();
+ *   const uint32_t wait_us = moderator.NextWakeUs(now);
+ *   const TickType_t ticks = wait_us == pcal95555::InterruptModerator::kNoWake
+ *                                ? portMAX_DELAY : pdMS_TO_TICKS(wait_us / 1000 + 1);
+ *   const bool edge = xSemaphoreTake(int_sem, ticks) == pdTRUE;
+ *   driver.ServiceInterrupts(moderator, esp_timer_get_time(), edge);
+ * }
+ * @endcode
+ */
+class InterruptModerator {
+public:
+  using TransitionCallback = InlineCallback<void(const ModeTransition&)>;
+
+  explicit InterruptModerator(const ModerationConfig& config = {}) noexcept
+      : config_(config), mode_(config.initial_mode) {
+    if (config_.window_us == 0) {
+      config_.window_us = 100000;
+    }
+  }
+
+  /**
+   * @brief Whether to service now.
+   *
+   * @param now_us Monotonic time in microseconds.
+   * @param edge   true when called because of an INT edge.
+   */
+  [[nodiscard]] bool ShouldService(uint64_t now_us, bool edge) noexcept {
+    if (!started_) {
+      started_ = true;
+      window_start_us_ = now_us;
+      next_poll_us_ = now_us;
+    }
+    if (edge) {
+      ++stats_.edges;
+      ++window_edges_;
+      if (!pending_) {
+        pending_ = true;
+        deadline_us_ = now_us + config_.moderation_us;
+      }
+    }
+    rollIfDue(now_us);
+    switch (mode_) {
+      case ServiceMode::PerEdge:
+        return pending_;
+      case ServiceMode::Moderated:
+        return pending_ && now_us >= deadline_us_;
+      case ServiceMode::Polling:
+        return now_us >= next_poll_us_;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Record a completed service.
+   * @param changed Pins the service found changed (interrupt status).
+   */
+  void Serviced(uint64_t now_us, uint16_t changed) noexcept {
+    pending_ = false;
+    const auto found = static_cast<uint32_t>(std::popcount(changed));
+    window_events_ += found;
+    stats_.events += found;
+    if (found == 0) {
+      ++stats_.empty_services;
+    }
+    ++stats_.services;
+    ++stats_.services_by_mode[static_cast<size_t>(mode_)];
+    if (mode_ == ServiceMode::Polling) {
+      next_poll_us_ += config_.poll_period_us;
+      if (next_poll_us_ <= now_us) {
+        next_poll_us_ = now_us + config_.poll_period_us;  // fell behind: do not burst
+      }
+    }
+    stats_.bus_us_saved = (static_cast<int64_t>(stats_.events) - stats_.services) * config_.service_wire_us;
+  }
+
+  /**
+   * @brief Microseconds until the task must call ShouldService() without an edge.
+   * @return 0 if due now; kNoWake if only an edge can make a service due.
+   */
+  [[nodiscard]] uint32_t NextWakeUs(uint64_t now_us) const noexcept {
+    uint64_t due = UINT64_MAX;
+    switch (mode_) {
+      case ServiceMode::PerEdge:
+        due = pending_ ? now_us : due;
+        break;
+      case ServiceMode::Moderated:
+        due = pending_ ? deadline_us_ : due;
+        break;
+      case ServiceMode::Polling:
+        due = next_poll_us_;  // edges wait for the next poll
+        break;
+    }
+    if (mode_ != ServiceMode::PerEdge && config_.adaptive) {
+      due = std::min(due, window_start_us_ + config_.window_us);  // rate check while idle
+    }
+    if (due == UINT64_MAX) {
+      return kNoWake;
+    }
+    return due <= now_us ? 0 : static_cast<uint32_t>(std::min<uint64_t>(due - now_us, kNoWake - 1));
+  }
+
+  static constexpr uint32_t kNoWake = UINT32_MAX;
+
+  [[nodiscard]] ServiceMode Mode() const noexcept { return mode_; }
+  [[nodiscard]] const ModerationStats& Stats() const noexcept { return stats_; }
+  void ResetStats() noexcept { stats_ = ModerationStats{}; }
+  void SetTransitionCallback(TransitionCallback callback) noexcept { on_transition_ = std::move(callback); }
+
+private:
+  void rollIfDue(uint64_t now_us) noexcept {
+    const uint64_t elapsed = now_us - window_start_us_;
+    if (elapsed < config_.window_us) {
+      return;
+    }
+    const uint64_t events = std::max(window_events_, window_edges_);
+    const auto rate = static_cast<uint32_t>(events * 1000000ULL / elapsed);
+    stats_.last_rate_hz = rate;
+    window_events_ = 0;
+    window_edges_ = 0;
+    window_start_us_ = now_us;
+    if (!config_.adaptive) {
+      return;
+    }
+    ServiceMode next = mode_;
+    switch (mode_) {
+      case ServiceMode::PerEdge:
+        next = rate >= config_.poll_enter_hz       ? ServiceMode::Polling
+               : rate >= config_.moderate_enter_hz ? ServiceMode::Moderated
+                                                   : mode_;
+        break;
+      case ServiceMode::Moderated:
+        next = rate >= config_.poll_enter_hz    ? ServiceMode::Polling
+               : rate < config_.moderate_exit_hz ? ServiceMode::PerEdge
+                                                 : mode_;
+        break;
+      case ServiceMode::Polling:
+        next = rate >= config_.poll_exit_hz     ? mode_
+               : rate < config_.moderate_exit_hz ? ServiceMode::PerEdge
+                                                 : ServiceMode::Moderated;
+        break;
+    }
+    if (next == mode_) {
+      return;
+    }
+    const ModeTransition transition{mode_, next, rate, now_us};
+    mode_ = next;
+    ++stats_.transitions;
+    if (next == ServiceMode::Polling) {
+      next_poll_us_ = now_us;
+    }
+    if (on_transition_) {
+      on_transition_(transition);
+    }
+  }
+
+  ModerationConfig config_;
+  ServiceMode mode_;
+  bool started_{false};
+  bool pending_{false};          // edge seen, not yet serviced
+  uint64_t deadline_us_{0};      // Moderated: service due at
+  uint64_t next_poll_us_{0};     // Polling: next service due at
+  uint64_t window_start_us_{0};
+  uint32_t window_events_{0};   // changes found by services in this window
+  uint32_t window_edges_{0};    // INT edges reported in this window
+  ModerationStats stats_{};
+  TransitionCallback on_transition_{};
+};
+
+} // namespace pcal95555
@@ -9,6 +9,30 @@
 #ifndef CONFIG_PCAL95555_INIT_FROM_KCONFIG
 #define CONFIG_PCAL95555_INIT_FROM_KCONFIG 1
 #endif
+#ifndef CONFIG_PCAL95555_SCRUB_MAX_READS_PER_SEC
+#define CONFIG_PCAL95555_SCRUB_MAX_READS_PER_SEC 10
+#endif
+#ifndef CONFIG_PCAL95555_MAX_SUBSCRIBERS
+#define CONFIG_PCAL95555_MAX_SUBSCRIBERS 4
+#endif
+#ifndef CONFIG_PCAL95555_SERVICE_ENGINE
+#define CONFIG_PCAL95555_SERVICE_ENGINE 0
+#endif
+#ifndef CONFIG_PCAL95555_CALLBACK_BUDGET
+#define CONFIG_PCAL95555_CALLBACK_BUDGET 0
+#endif
+#ifndef CONFIG_PCAL95555_CAPTURE_BYTES
+#define CONFIG_PCAL95555_CAPTURE_BYTES 1024
+#endif
+#ifndef CONFIG_PCAL95555_BUS_CLIENTS
+#define CONFIG_PCAL95555_BUS_CLIENTS 4
+#endif
+#ifndef CONFIG_PCAL95555_OUTPUT_LAYERS
+#define CONFIG_PCAL95555_OUTPUT_LAYERS 4
+#endif
+#ifndef CONFIG_PCAL95555_CALLBACK_STORAGE_BYTES
+#define CONFIG_PCAL95555_CALLBACK_STORAGE_BYTES 16
+#endif
 #ifndef CONFIG_PCAL95555_PORT0_OD
 #define CONFIG_PCAL95555_PORT0_OD 0
 #endif
@@ -0,0 +1,222 @@
+/**
+ * @file pcal95555_output_compositor.hpp
+ * @brief Layered output image shared by several clients of one expander
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Several subsystems often drive different pins of the same expander, and
+ * some of them temporarily override others (a fault indicator on top of a
+ * status pattern). Instead of one read-modify-write per client, each client
+ * owns a layer: an ownership mask, the levels of the owned pins, and a
+ * priority. The compositor merges the layers into one 16-bit output image:
+ *
+ *  - pins owned by no layer take the base image (SetBase());
+ *  - a pin owned by several layers takes the level of the highest-priority
+ *    owner; on equal priority the higher layer index wins.
+ *
+ * PCAL95555::ComposeOutputs() writes the composed image as one paired
+ * OUTPUT_PORT_0/1 write, and only when it differs from the last image
+ * written. No read-back is needed: the compositor owns every output pin.
+ *
+ * Clients update their layers from any task without locks. Each layer is one
+ * atomic word, and every update bumps a generation counter. Concurrent
+ * ComposeOutputs() calls are combined: if another call is already writing,
+ * the new one returns at once and the writer composes again before it
+ * leaves, so the last update always reaches the expander.
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pcal95555_kconfig.hpp"
+
+namespace pcal95555 {
+
+/// Snapshot of one compositor layer.
+struct OutputLayer {
+  uint16_t value = 0;    ///< Levels of the owned pins (bit N = pin N)
+  uint16_t mask = 0;     ///< Pins owned by this layer; 0 = layer inactive
+  uint8_t priority = 0;  ///< Higher priority overrides lower on shared pins
+};
+
+/**
+ * @brief Priority-ordered output layers composed into one output image.
+ *
+ * @tparam Layers Number of layers (one per client), 1-32.
+ *
+ * @note Layers are addressed by index; assign one index per client. The
+ *       object must outlive every ComposeOutputs() call that uses it.
+ */
+template <size_t Layers = CONFIG_PCAL95555_OUTPUT_LAYERS>
+class OutputCompositor {
+  static_assert(Layers >= 1 && Layers <= 32, "OutputCompositor supports 1-32 layers");
+
+public:
+  static constexpr size_t kLayers = Layers;
+
+  /// @param base Levels of the pins no layer owns.
+  explicit OutputCompositor(uint16_t base = 0) noexcept : base_(base) {}
+
+  OutputCompositor(const OutputCompositor&) = delete;
+  OutputCompositor& operator=(const OutputCompositor&) = delete;
+
+  /**
+   * @brief Replace a layer: owned pins, their levels and the priority.
+   *
+   * @param layer    Layer index (0 .. kLayers-1).
+   * @param value    Levels of the owned pins; bits outside @p mask are ignored.
+   * @param mask     Pins the layer owns; 0 releases all of them.
+   * @param priority Higher values override lower ones on shared pins.
+   * @return false if @p layer is out of range.
+   */
+  bool SetLayer(size_t layer, uint16_t value, uint16_t mask, uint8_t priority) noexcept {
+    if (layer >= Layers) {
+      return false;
+    }
+    priorities_[layer].store(priority, std::memory_order_relaxed);
+    layers_[layer].store(pack(value, mask), std::memory_order_relaxed);
+    generation_.fetch_add(1);
+    return true;
+  }
+
+  /**
+   * @brief Change the levels of a layer's pins; ownership and priority stay.
+   * @return false if @p layer is out of range.
+   */
+  bool SetLayerValue(size_t layer, uint16_t value) noexcept {
+    if (layer >= Layers) {
+      return false;
+    }
+    uint32_t word = layers_[layer].load(std::memory_order_relaxed);
+    while (!layers_[layer].compare_exchange_weak(word, pack(value, static_cast<uint16_t>(word >> 16)),
+                                                 std::memory_order_relaxed)) {
+    }
+    generation_.fetch_add(1);
+    return true;
+  }
+
+  /// Release every pin of @p layer (the layer stops contributing).
+  bool ClearLayer(size_t layer) noexcept {
+    return SetLayer(layer, 0, 0, 0);
+  }
+
+  /// Levels of the pins no layer owns.
+  void SetBase(uint16_t base) noexcept {
+    base_.store(base, std::memory_order_relaxed);
+    generation_.fetch_add(1);
+  }
+
+  /// Current content of @p layer (an empty layer when out of range).
+  [[nodiscard]] OutputLayer GetLayer(size_t layer) const noexcept {
+    if (layer >= Layers) {
+      return {};
+    }
+    const uint32_t word = layers_[layer].load(std::memory_order_relaxed);
+    return {static_cast<uint16_t>(word & 0xFFFF), static_cast<uint16_t>(word >> 16),
+            priorities_[layer].load(std::memory_order_relaxed)};
+  }
+
+  /**
+   * @brief Compose the current layers into one output image.
+   *
+   * Layers are visited from the highest priority down; each contributes the
+   * pins no higher layer has claimed.
+   */
+  [[nodiscard]] uint16_t Compose() const noexcept {
+    uint32_t words[Layers];
+    uint8_t order[Layers];
+    uint8_t prio[Layers];
+    for (size_t i = 0; i < Layers; ++i) {
+      words[i] = layers_[i].load(std::memory_order_relaxed);
+      prio[i] = priorities_[i].load(std::memory_order_relaxed);
+      // Insertion sort, highest priority (then highest index) first.
+      size_t j = i;
+      while (j > 0 && prio[order[j - 1]] <= prio[i]) {
+        order[j] = order[j - 1];
+        --j;
+      }
+      order[j] = static_cast<uint8_t>(i);
+    }
+    uint16_t image = 0;
+    uint16_t claimed = 0;
+    for (size_t k = 0; k < Layers; ++k) {
+      const uint32_t word = words[order[k]];
+      const auto mask = static_cast<uint16_t>((word >> 16) & ~claimed);
+      image = static_cast<uint16_t>(image | (word & mask));
+      claimed = static_cast<uint16_t>(claimed | mask);
+    }
+    return static_cast<uint16_t>(image | (base_.load(std::memory_order_relaxed) & ~claimed));
+  }
+
+  /**
+   * @brief Compose and hand the image to @p write if it changed.
+   *
+   * Used by PCAL95555::ComposeOutputs(); @p write is `bool(uint16_t image)`
+   * and performs the bus write. Only one caller writes at a time: a call
+   * that finds another one writing returns true immediately, and the writer
+   * repeats until no update arrived while it was writing.
+   *
+   * @return false if @p write failed (the next call retries the image).
+   */
+  template <typename WriteFn>
+  bool Flush(WriteFn&& write) noexcept {
+    while (!flushing_.exchange(true)) {
+      const uint32_t generation = generation_.load();
+      if (invalidate_.exchange(false)) {
+        written_valid_ = false;
+      }
+      const uint16_t image = Compose();
+      bool ok = true;
+      if (!written_valid_ || image != written_image_) {
+        ok = write(image);
+        if (ok) {
+          written_image_ = image;
+          written_valid_ = true;
+          writes_.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      flushing_.store(false);
+      if (!ok) {
+        return false;
+      }
+      if (generation_.load() == generation) {
+        break;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Forget the last written image so the next flush writes again.
+   *
+   * Call after the expander lost its outputs (reset, brownout) or after
+   * another path wrote OUTPUT_PORT_0/1.
+   */
+  void Invalidate() noexcept {
+    invalidate_.store(true);
+    generation_.fetch_add(1);
+  }
+
+  /// Number of images actually written to the bus.
+  [[nodiscard]] uint32_t Writes() const noexcept {
+    return writes_.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr uint32_t pack(uint16_t value, uint16_t mask) noexcept {
+    return (static_cast<uint32_t>(mask) << 16) | (value & mask);
+  }
+
+  std::atomic<uint32_t> layers_[Layers]{};     // mask << 16 | value
+  std::atomic<uint8_t> priorities_[Layers]{};
+  std::atomic<uint16_t> base_;
+  std::atomic<uint32_t> generation_{0};
+  std::atomic<uint32_t> writes_{0};
+  std::atomic<bool> flushing_{false};
+  std::atomic<bool> invalidate_{false};
+  // Owned by the caller holding flushing_.
+  uint16_t written_image_ = 0;
+  bool written_valid_ = false;
+};
+
+} // namespace pcal95555
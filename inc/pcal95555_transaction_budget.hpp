@@ -0,0 +1,119 @@
+/**
+ * @file pcal95555_transaction_budget.hpp
+ * @brief Compile-time I2C transaction budgets for the PCAL95555 driver
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * The driver core is constexpr, so an API call can be run during constant
+ * evaluation against a recording bus and its I2C round trips counted by the
+ * compiler. The driver's own budgets, one static_assert per public
+ * operation, are in src/pcal95555_transaction_budget.cpp: a change to
+ * pcal95555.ipp that adds a transaction fails that translation unit instead
+ * of slipping through review. They are kept out of this header so code that
+ * includes the driver does not pay for them at compile time.
+ *
+ * Include this header to pin application-level sequences the same way:
+ * @code
+ * static_assert(pcal95555::budget::CountTransactions([](auto& drv) {
+ *   drv.WritePins({{0, true}, {9, false}});
+ * }) == pcal95555::budget::TransactionCount{1, 1});
+ * @endcode
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pcal95555.hpp"
+
+namespace pcal95555::budget {
+
+/**
+ * @brief Number of bus transactions issued by an operation.
+ *
+ * One Read() or Write() call on the I2C interface is one transaction,
+ * whatever its length (a register-pair auto-increment transfer counts once).
+ */
+struct TransactionCount {
+  uint32_t reads = 0;   ///< Read() calls (register address write + repeated-start read)
+  uint32_t writes = 0;  ///< Write() calls
+
+  /// Total round trips on the bus.
+  [[nodiscard]] constexpr uint32_t total() const noexcept { return reads + writes; }
+
+  constexpr bool operator==(const TransactionCount&) const noexcept = default;
+};
+
+/**
+ * @brief Register-file model of the expander that counts transactions.
+ *
+ * Usable in constant evaluation. Every register acknowledges, so the bus
+ * behaves like a PCAL9555A; reads of registers >= 0x40 NACK when
+ * `agile_io` is false, like a standard PCA9555.
+ */
+class CountingBus : public I2cInterface<CountingBus> {
+public:
+  constexpr bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    (void)addr;
+    ++count.writes;
+    if (!acks(reg)) {
+      return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+      regs[static_cast<uint8_t>(reg + i)] = data[i];
+    }
+    return true;
+  }
+
+  constexpr bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    (void)addr;
+    ++count.reads;
+    if (!acks(reg)) {
+      return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = regs[static_cast<uint8_t>(reg + i)];
+    }
+    return true;
+  }
+
+  constexpr bool EnsureInitialized() noexcept { return true; }
+
+  std::array<uint8_t, 256> regs{};  ///< Register file indexed by address
+  TransactionCount count{};         ///< Transactions since construction / last reset
+  bool agile_io = true;             ///< false = behave like a PCA9555
+
+private:
+  [[nodiscard]] constexpr bool acks(uint8_t reg) const noexcept { return agile_io || reg < 0x40; }
+};
+
+/**
+ * @brief Count the transactions an operation issues on an initialized driver.
+ *
+ * The driver is constructed with an explicit chip variant and initialized
+ * before counting starts, so only the bus traffic of @p op is reported.
+ *
+ * @param op Callable taking `PCAL95555<CountingBus>&`.
+ * @param variant Chip variant to model (PCAL9555A or PCA9555).
+ * @return Reads and writes issued by @p op.
+ */
+template <typename Op>
+consteval TransactionCount CountTransactions(Op op, ChipVariant variant = ChipVariant::PCAL9555A) {
+  CountingBus bus;
+  bus.agile_io = (variant != ChipVariant::PCA9555);
+  PCAL95555<CountingBus> drv(&bus, 0x20, variant);
+  drv.EnsureInitialized();
+  bus.count = {};
+  op(drv);
+  return bus.count;
+}
+
+// ============================================================================
+// Named budgets (used by src/pcal95555_transaction_budget.cpp)
+// ============================================================================
+
+/// Single read-modify-write of one register: one read, one write.
+inline constexpr TransactionCount kSingleRmw{1, 1};
+/// Read of one register or register pair, nothing written.
+inline constexpr TransactionCount kSingleRead{1, 0};
+
+} // namespace pcal95555::budget
@@ -0,0 +1,246 @@
+/**
+ * @file pcal95555_vector_runner.hpp
+ * @brief Stimulus/response test vectors for production fixtures
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * A fixture drives a board under test through one or more expanders and
+ * checks its reaction on the inputs. Each TestVector holds, per device, the
+ * output image to apply, the input image expected back and a compare mask,
+ * plus the settle time the board needs between stimulus and response.
+ *
+ * VectorRunner executes a table of vectors back to back. Per vector and
+ * device it issues at most one paired output write (WriteAllOutputs()) and
+ * one paired input read (ReadAllInputs()):
+ *
+ *  - a write is skipped when the device's output image did not change since
+ *    the previous vector;
+ *  - the settle time is a deadline counted from the last write of the
+ *    vector, not a fixed sleep, so bus time spent on other devices already
+ *    counts, and a vector that writes nothing waits only for what is left
+ *    of the previous deadline;
+ *  - a device whose compare mask is 0, or whose write failed, is not read.
+ *
+ * A device fails a vector when `(expected ^ actual) & compare_mask` is not
+ * zero, or when its write or read fails. Mismatches are reported through a
+ * callback as they happen; VectorRunStats summarizes the run, including
+ * vectors per second.
+ *
+ * Not thread-safe: run a table from one task, with the lock that already
+ * serializes the bus held or taken by the bus implementation.
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "pcal95555_inline_callback.hpp"
+
+namespace pcal95555 {
+
+/**
+ * @brief One stimulus/response step for @p Devices expanders.
+ */
+template <size_t Devices = 1>
+struct TestVector {
+  std::array<uint16_t, Devices> outputs{};       ///< Output image applied to each device
+  uint32_t settle_us = 0;                        ///< Time from the last write to the reads
+  std::array<uint16_t, Devices> expected{};      ///< Expected input image of each device
+  std::array<uint16_t, Devices> compare_mask{};  ///< Pins compared per device; 0 = device not read
+};
+
+/**
+ * @brief A failed comparison (or bus error) of one device in one vector.
+ */
+struct VectorMismatch {
+  uint32_t index = 0;     ///< Vector index in the table
+  uint8_t device = 0;     ///< Device index in the runner
+  uint16_t expected = 0;  ///< Expected input image
+  uint16_t actual = 0;    ///< Input image read (0 on bus error)
+  uint16_t mask = 0;      ///< Compare mask; failing pins = (expected ^ actual) & mask
+  bool bus_error = false; ///< The write or read of this device failed
+};
+
+/**
+ * @brief Clock and policy of a VectorRunner.
+ */
+struct VectorRunnerConfig {
+  uint64_t (*now_us)() noexcept = nullptr;           ///< Monotonic microseconds; needed for settle deadlines and rates
+  void (*sleep_us)(uint32_t us) noexcept = nullptr;  ///< Waits for the rest of a deadline (else busy-waits on now_us)
+  bool stop_on_fail = false;                         ///< End the run after the first failing vector
+  bool skip_unchanged_writes = true;                 ///< Do not rewrite an output image already on the device
+};
+
+/**
+ * @brief Summary of one VectorRunner::Run().
+ */
+struct VectorRunStats {
+  uint32_t vectors = 0;         ///< Vectors executed
+  uint32_t failed = 0;          ///< Vectors with at least one mismatch or bus error
+  uint32_t mismatches = 0;      ///< Failed device comparisons (including bus errors)
+  uint32_t bus_errors = 0;      ///< Failed writes and reads
+  uint32_t writes = 0;          ///< Output writes issued
+  uint32_t skipped_writes = 0;  ///< Output writes skipped: image unchanged
+  uint32_t reads = 0;           ///< Input reads issued
+  uint64_t settle_wait_us = 0;  ///< Time spent waiting for settle deadlines
+  uint64_t elapsed_us = 0;      ///< Duration of the run (needs now_us)
+  uint32_t vectors_per_sec = 0; ///< vectors / elapsed (needs now_us)
+  bool aborted = false;         ///< stop_on_fail ended the run early
+};
+
+/**
+ * @brief Runs tables of TestVector against @p Devices drivers.
+ *
+ * @tparam Driver  PCAL95555<...> (anything with WriteAllOutputs(uint16_t) and
+ *                 ReadAllInputs(uint16_t&) returning bool).
+ * @tparam Devices Number of expanders a vector spans.
+ *
+ * @code
+ * pcal95555::VectorRunner<Driver, 2> runner({&stim, &sense}, {.now_us = NowUs, .sleep_us = SleepUs});
+ * runner.SetMismatchCallback([](const pcal95555::VectorMismatch& m) { LogMismatch(m); });
+ * const auto stats = runner.Run(kVectors);
+ * @endcode
+ */
+template <typename Driver, size_t Devices = 1>
+class VectorRunner {
+  static_assert(Devices >= 1 && Devices <= 255, "VectorRunner supports 1-255 devices");
+
+public:
+  using Vector = TestVector<Devices>;
+  /// Invoked for every failed device comparison, during the run.
+  using MismatchCallback = InlineCallback<void(const VectorMismatch&)>;
+
+  VectorRunner(const std::array<Driver*, Devices>& devices, const VectorRunnerConfig& config = {}) noexcept
+      : devices_(devices), config_(config) {}
+
+  void SetMismatchCallback(MismatchCallback callback) noexcept { on_mismatch_ = std::move(callback); }
+
+  /**
+   * @brief Forget the output images written so far.
+   *
+   * Call this when something else wrote the outputs between runs, so the
+   * next vector rewrites every device.
+   */
+  void Invalidate() noexcept { written_valid_.fill(false); }
+
+  /**
+   * @brief Execute @p vectors in order, back to back.
+   * @return Summary of the run (also kept for LastRun()).
+   */
+  VectorRunStats Run(std::span<const Vector> vectors) noexcept {
+    VectorRunStats stats{};
+    const uint64_t start = now();
+    for (size_t i = 0; i < vectors.size(); ++i) {
+      const Vector& vector = vectors[i];
+      bool failed = false;
+      std::array<bool, Devices> write_failed{};
+      for (size_t d = 0; d < Devices; ++d) {
+        if (config_.skip_unchanged_writes && written_valid_[d] && written_[d] == vector.outputs[d]) {
+          ++stats.skipped_writes;
+          continue;
+        }
+        if (devices_[d] == nullptr || !devices_[d]->WriteAllOutputs(vector.outputs[d])) {
+          ++stats.bus_errors;
+          written_valid_[d] = false;
+          write_failed[d] = true;
+          failed |= report(stats, i, d, vector, 0, true);
+          continue;
+        }
+        ++stats.writes;
+        written_[d] = vector.outputs[d];
+        written_valid_[d] = true;
+        last_write_us_ = now();
+        wrote_since_settle_ = true;
+      }
+      settle(stats, vector.settle_us);
+      for (size_t d = 0; d < Devices; ++d) {
+        if (vector.compare_mask[d] == 0 || write_failed[d]) {
+          continue;
+        }
+        uint16_t actual = 0;
+        if (devices_[d] == nullptr || !devices_[d]->ReadAllInputs(actual)) {
+          ++stats.bus_errors;
+          failed |= report(stats, i, d, vector, 0, true);
+          continue;
+        }
+        ++stats.reads;
+        if (((vector.expected[d] ^ actual) & vector.compare_mask[d]) != 0) {
+          failed |= report(stats, i, d, vector, actual, false);
+        }
+      }
+      ++stats.vectors;
+      if (failed) {
+        ++stats.failed;
+        if (config_.stop_on_fail) {
+          stats.aborted = i + 1 < vectors.size();
+          break;
+        }
+      }
+    }
+    if (config_.now_us != nullptr) {
+      stats.elapsed_us = now() - start;
+      if (stats.elapsed_us != 0) {
+        stats.vectors_per_sec = static_cast<uint32_t>(uint64_t{stats.vectors} * 1000000U / stats.elapsed_us);
+      }
+    }
+    last_ = stats;
+    return stats;
+  }
+
+  /// Summary of the most recent Run().
+  [[nodiscard]] const VectorRunStats& LastRun() const noexcept { return last_; }
+
+private:
+  [[nodiscard]] uint64_t now() const noexcept { return config_.now_us != nullptr ? config_.now_us() : 0; }
+
+  /// Wait until @p settle_us after the last write. Without a clock, sleep the
+  /// full settle time after a vector that wrote; without either, do not wait.
+  void settle(VectorRunStats& stats, uint32_t settle_us) noexcept {
+    if (settle_us == 0) {
+      wrote_since_settle_ = false;
+      return;
+    }
+    if (config_.now_us == nullptr) {
+      if (wrote_since_settle_ && config_.sleep_us != nullptr) {
+        config_.sleep_us(settle_us);
+        stats.settle_wait_us += settle_us;
+      }
+      wrote_since_settle_ = false;
+      return;
+    }
+    wrote_since_settle_ = false;
+    const uint64_t deadline = last_write_us_ + settle_us;
+    uint64_t t = config_.now_us();
+    const uint64_t wait_start = t;
+    while (t < deadline) {
+      if (config_.sleep_us != nullptr) {
+        config_.sleep_us(static_cast<uint32_t>(deadline - t));
+      }
+      t = config_.now_us();
+    }
+    stats.settle_wait_us += t - wait_start;
+  }
+
+  /// Count and report a failed comparison; returns true so callers can mark the vector.
+  bool report(VectorRunStats& stats, size_t index, size_t device, const Vector& vector, uint16_t actual,
+              bool bus_error) noexcept {
+    ++stats.mismatches;
+    if (on_mismatch_) {
+      on_mismatch_(VectorMismatch{static_cast<uint32_t>(index), static_cast<uint8_t>(device),
+                                  vector.expected[device], actual, vector.compare_mask[device], bus_error});
+    }
+    return true;
+  }
+
+  std::array<Driver*, Devices> devices_;
+  VectorRunnerConfig config_;
+  MismatchCallback on_mismatch_{};
+  std::array<uint16_t, Devices> written_{};
+  std::array<bool, Devices> written_valid_{};
+  uint64_t last_write_us_ = 0;
+  bool wrote_since_settle_ = false;
+  VectorRunStats last_{};
+};
+
+}  // namespace pcal95555
@@ -15,7 +15,7 @@
 
 // Constructor: store I2C bus and pin levels (lazy initialization)
 template <typename I2cType>
-pcal95555::PCAL95555<I2cType>::PCAL95555(I2cType* bus, bool a0_level, bool a1_level, bool a2_level,
+constexpr pcal95555::PCAL95555<I2cType>::PCAL95555(I2cType* bus, bool a0_level, bool a1_level, bool a2_level,
                                           ChipVariant variant)
     : i2c_(bus), previous_pin_states_(0), initialized_(false),
       a0_level_(a0_level), a1_level_(a1_level), a2_level_(a2_level),
@@ -24,18 +24,12 @@ pcal95555::PCAL95555<I2cType>::PCAL95555(I2cType* bus, bool a0_level, bool a1_le
   address_bits_ = (a0_level ? 1 : 0) | ((a1_level ? 1 : 0) << 1) | ((a2_level ? 1 : 0) << 2);
   dev_addr_ = calculateAddress(address_bits_);
 
-  // Initialize pin callbacks array
-  for (auto& callback : pin_callbacks_) {
-    callback.registered = false;
-    callback.edge = InterruptEdge::Both;
-  }
-
   // No initialization here - use EnsureInitialized() when ready
 }
 
 // Constructor: store I2C bus and calculate pin levels from address (lazy initialization)
 template <typename I2cType>
-pcal95555::PCAL95555<I2cType>::PCAL95555(I2cType* bus, uint8_t address, ChipVariant variant)
+constexpr pcal95555::PCAL95555<I2cType>::PCAL95555(I2cType* bus, uint8_t address, ChipVariant variant)
     : i2c_(bus), previous_pin_states_(0), initialized_(false),
       chip_variant_(ChipVariant::Unknown), user_variant_(variant) {
   // Validate address range (0x20 to 0x27)
@@ -62,18 +56,43 @@ pcal95555::PCAL95555<I2cType>::PCAL95555(I2cType* bus, uint8_t address, ChipVari
   a1_level_ = (address_bits_ & 0x02) != 0;
   a2_level_ = (address_bits_ & 0x04) != 0;
 
-  // Initialize pin callbacks array
-  for (auto& callback : pin_callbacks_) {
-    callback.registered = false;
-    callback.edge = InterruptEdge::Both;
+  // No initialization here - use EnsureInitialized() when ready
+}
+
+// Move: copy all state, point the bus's interrupt handler at the new instance, reset the source
+template <typename I2cType>
+pcal95555::PCAL95555<I2cType>::PCAL95555(PCAL95555&& other) noexcept
+    : PCAL95555(static_cast<const PCAL95555&>(other)) {
+  takeInterruptHandler(other);
+  other.resetMovedFrom();
+}
+
+template <typename I2cType>
+pcal95555::PCAL95555<I2cType>& pcal95555::PCAL95555<I2cType>::operator=(PCAL95555&& other) noexcept {
+  if (this != &other) {
+    // Our own registration would otherwise keep calling us with the state copied below
+    const bool released = releaseInterruptHandler();
+    *this = static_cast<const PCAL95555&>(other);
+    takeInterruptHandler(other);
+    other.resetMovedFrom();
+    if (!released) {
+      setError(Error::InterruptBindFail);
+    }
   }
+  return *this;
+}
 
-  // No initialization here - use EnsureInitialized() when ready
+// The bus must never call into a destroyed driver
+template <typename I2cType>
+constexpr pcal95555::PCAL95555<I2cType>::~PCAL95555() noexcept {
+  if (interrupt_bound_) {
+    (void)releaseInterruptHandler();
+  }
 }
 
 // Ensure initialization (lazy initialization)
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::EnsureInitialized() noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::EnsureInitialized() noexcept {
   if (initialized_) {
     return true;  // Already initialized
   }
@@ -82,7 +101,7 @@ bool pcal95555::PCAL95555<I2cType>::EnsureInitialized() noexcept {
 
 // Perform actual initialization
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::initialize() noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::initialize() noexcept {
   // Ensure I2C bus is initialized and ready
   if (!i2c_->EnsureInitialized()) {
     setError(Error::I2CReadFail);
@@ -116,9 +135,12 @@ bool pcal95555::PCAL95555<I2cType>::initialize() noexcept {
     // Auto-detect by probing an Agile I/O register
     detectChipVariant();
   }
+  selectInterruptEngine();
+  rememberIdentity();
   
   // Initialize previous pin states for edge detection
   previous_pin_states_ = readPinStates();
+  baseline_stale_ = false;
   
   // Mark as initialized
   initialized_ = true;
@@ -127,25 +149,27 @@ bool pcal95555::PCAL95555<I2cType>::initialize() noexcept {
 
 // Configure retry count
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::SetRetries(int retries) noexcept {
+constexpr void pcal95555::PCAL95555<I2cType>::SetRetries(int retries) noexcept {
   retries_ = retries;
 }
 
 // Low-level write with retries
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::writeRegister(uint8_t reg, uint8_t value) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::writeRegister(uint8_t reg, uint8_t value) noexcept {
   for (int attempt = 0; attempt <= retries_; ++attempt) {
     if (i2c_->Write(dev_addr_, reg, &value, 1)) {
+      shadowStore(reg, value);
       clearError(Error::I2CWriteFail);
       return true;
     }
   }
   setError(Error::I2CWriteFail);
+  forgetIdentity();
   return false;
 }
 // Low-level read with retries
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::readRegister(uint8_t reg, uint8_t& value) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::readRegister(uint8_t reg, uint8_t& value) noexcept {
   for (int attempt = 0; attempt <= retries_; ++attempt) {
     if (i2c_->Read(dev_addr_, reg, &value, 1)) {
       clearError(Error::I2CReadFail);
@@ -153,12 +177,48 @@ bool pcal95555::PCAL95555<I2cType>::readRegister(uint8_t reg, uint8_t& value) no
     }
   }
   setError(Error::I2CReadFail);
+  forgetIdentity();
+  return false;
+}
+
+// Paired write: the chip auto-increments within a register pair, so one
+// transfer of two bytes updates reg0 and reg0 + 1
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::writeRegisterPair(uint8_t reg0, uint8_t val0, uint8_t val1) noexcept {
+  const uint8_t data[2] = {val0, val1};
+  for (int attempt = 0; attempt <= retries_; ++attempt) {
+    if (i2c_->Write(dev_addr_, reg0, data, 2)) {
+      shadowStore(reg0, val0);
+      shadowStore(static_cast<uint8_t>(reg0 + 1), val1);
+      clearError(Error::I2CWriteFail);
+      return true;
+    }
+  }
+  setError(Error::I2CWriteFail);
+  forgetIdentity();
+  return false;
+}
+
+// Paired read: one transfer returns reg0 and reg0 + 1
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::readRegisterPair(uint8_t reg0, uint8_t& val0, uint8_t& val1) noexcept {
+  uint8_t data[2] = {0, 0};
+  for (int attempt = 0; attempt <= retries_; ++attempt) {
+    if (i2c_->Read(dev_addr_, reg0, data, 2)) {
+      val0 = data[0];
+      val1 = data[1];
+      clearError(Error::I2CReadFail);
+      return true;
+    }
+  }
+  setError(Error::I2CReadFail);
+  forgetIdentity();
   return false;
 }
 
 // Reset all registers to defaults as per datasheet.
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::ResetToDefault() noexcept {
+constexpr void pcal95555::PCAL95555<I2cType>::ResetToDefault() noexcept {
   if (!EnsureInitialized()) {
     return;
   }
@@ -194,7 +254,7 @@ void pcal95555::PCAL95555<I2cType>::ResetToDefault() noexcept {
 
 // Initialize using compile-time configuration
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::InitFromConfig() noexcept {
+constexpr void pcal95555::PCAL95555<I2cType>::InitFromConfig() noexcept {
   if (!EnsureInitialized()) {
     return;
   }
@@ -224,7 +284,7 @@ void pcal95555::PCAL95555<I2cType>::InitFromConfig() noexcept {
 }
 
 // Set or clear a bit in a register byte
-static uint8_t updateBit(uint8_t regVal, uint8_t bit, bool set) noexcept {
+static constexpr uint8_t updateBit(uint8_t regVal, uint8_t bit, bool set) noexcept {
   if (set) {
     return regVal | (1 << bit);
   }
@@ -234,8 +294,11 @@ static uint8_t updateBit(uint8_t regVal, uint8_t bit, bool set) noexcept {
 // ---- Internal R-M-W helpers ----
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::readDualPort(uint8_t reg0, uint8_t reg1,
+constexpr bool pcal95555::PCAL95555<I2cType>::readDualPort(uint8_t reg0, uint8_t reg1,
                                                   uint8_t& val0, uint8_t& val1) noexcept {
+  if (reg1 == reg0 + 1) {
+    return readRegisterPair(reg0, val0, val1);
+  }
   if (!readRegister(reg0, val0)) {
     return false;
   }
@@ -243,8 +306,11 @@ bool pcal95555::PCAL95555<I2cType>::readDualPort(uint8_t reg0, uint8_t reg1,
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::writeDualPort(uint8_t reg0, uint8_t reg1,
+constexpr bool pcal95555::PCAL95555<I2cType>::writeDualPort(uint8_t reg0, uint8_t reg1,
                                                    uint8_t val0, uint8_t val1) noexcept {
+  if (reg1 == reg0 + 1) {
+    return writeRegisterPair(reg0, val0, val1);
+  }
   if (!writeRegister(reg0, val0)) {
     return false;
   }
@@ -252,7 +318,7 @@ bool pcal95555::PCAL95555<I2cType>::writeDualPort(uint8_t reg0, uint8_t reg1,
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::modifySinglePinRegister(uint8_t reg0, uint8_t reg1,
+constexpr bool pcal95555::PCAL95555<I2cType>::modifySinglePinRegister(uint8_t reg0, uint8_t reg1,
                                                              uint8_t pin, bool bit_value) noexcept {
   uint8_t reg = (pin < 8) ? reg0 : reg1;
   uint8_t bit = pin % 8;
@@ -265,28 +331,129 @@ bool pcal95555::PCAL95555<I2cType>::modifySinglePinRegister(uint8_t reg0, uint8_
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::modifyDualPortByMask(uint8_t reg0, uint8_t reg1,
+constexpr bool pcal95555::PCAL95555<I2cType>::modifyDualPortByMask(uint8_t reg0, uint8_t reg1,
                                                           uint16_t mask, bool bit_value) noexcept {
+  return bit_value ? updateDualPortMasks(reg0, reg1, mask, 0) : updateDualPortMasks(reg0, reg1, 0, mask);
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::updateDualPortMasks(uint8_t reg0, uint8_t reg1,
+                                                         uint16_t set_mask, uint16_t clear_mask) noexcept {
   uint8_t val0 = 0;
   uint8_t val1 = 0;
   if (!readDualPort(reg0, reg1, val0, val1)) {
     return false;
   }
-  for (int bit = 0; bit < 8; ++bit) {
-    if ((mask & (1U << bit)) != 0U) {
-      val0 = updateBit(val0, bit, bit_value);
+  val0 = static_cast<uint8_t>((val0 | (set_mask & 0xFF)) & ~(clear_mask & 0xFF));
+  val1 = static_cast<uint8_t>((val1 | (set_mask >> 8)) & ~(clear_mask >> 8));
+  return writeDualPort(reg0, reg1, val0, val1);
+}
+
+template <typename I2cType>
+template <typename PairIt, typename ToBit>
+constexpr bool pcal95555::PCAL95555<I2cType>::applyPinBatch(uint8_t reg0, uint8_t reg1, PairIt first,
+                                                   PairIt last, ToBit to_bit) noexcept {
+  // Fold the batch first, so a bad pin is rejected before any bus transaction
+  uint16_t mask = 0;
+  uint16_t bits = 0;
+  for (; first != last; ++first) {
+    const auto& config = *first;
+    if (!isValidPin(config.first)) {
+      setError(Error::InvalidPin);
+      return false;
     }
-    if ((mask & (1U << (bit + 8))) != 0U) {
-      val1 = updateBit(val1, bit, bit_value);
+    const auto bit = static_cast<uint16_t>(1U << config.first);
+    mask |= bit;
+    bits = to_bit(config.second) ? static_cast<uint16_t>(bits | bit) : static_cast<uint16_t>(bits & ~bit);
+  }
+  clearError(Error::InvalidPin);
+  return updateDualPortMasks(reg0, reg1, bits, static_cast<uint16_t>(mask & ~bits));
+}
+
+// ---- Shadow-backed register images (drive strength, pulls) ----
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::loadImagePair(uint8_t reg0, uint8_t& val0,
+                                                   uint8_t& val1) noexcept {
+  const uint8_t reg1 = static_cast<uint8_t>(reg0 + 1);
+  const int index0 = shadowIndex(reg0);
+  const int index1 = shadowIndex(reg1);
+  if (index0 < 0 || index1 < 0) {
+    return readRegisterPair(reg0, val0, val1);
+  }
+  const uint32_t both = (1UL << index0) | (1UL << index1);
+  if ((shadow_valid_ & both) == both) {
+    val0 = shadow_[index0];
+    val1 = shadow_[index1];
+    return true;
+  }
+  if (!readRegisterPair(reg0, val0, val1)) {
+    return false;
+  }
+  shadowStore(reg0, val0);
+  shadowStore(reg1, val1);
+  return true;
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::updateImagePair(uint8_t reg0, uint16_t mask,
+                                                     uint16_t bits) noexcept {
+  if (mask == 0) {
+    return true;
+  }
+  const int index0 = shadowIndex(reg0);
+  const int index1 = shadowIndex(static_cast<uint8_t>(reg0 + 1));
+  const uint32_t both = (index0 >= 0 && index1 >= 0) ? ((1UL << index0) | (1UL << index1)) : 0;
+  const bool cached = both != 0 && (shadow_valid_ & both) == both;
+  // A full mask overwrites everything, so an unloaded pair is not read first
+  const bool known = cached || mask != 0xFFFF;
+  uint8_t val0 = 0;
+  uint8_t val1 = 0;
+  if (known && !loadImagePair(reg0, val0, val1)) {
+    return false;
+  }
+  const auto old_image = static_cast<uint16_t>((val1 << 8) | val0);
+  const auto image = static_cast<uint16_t>((old_image & ~mask) | (bits & mask));
+  if (known && image == old_image) {
+    return true;  // the chip already holds it
+  }
+  return writeRegisterPair(reg0, static_cast<uint8_t>(image & 0xFF), static_cast<uint8_t>(image >> 8));
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::updateDriveImage(uint32_t mask, uint32_t bits) noexcept {
+  if (!updateImagePair(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_0), static_cast<uint16_t>(mask & 0xFFFF),
+                       static_cast<uint16_t>(bits & 0xFFFF))) {
+    return false;
+  }
+  return updateImagePair(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_2), static_cast<uint16_t>(mask >> 16),
+                         static_cast<uint16_t>(bits >> 16));
+}
+
+template <typename I2cType>
+template <typename PairIt, typename ToBit>
+constexpr bool pcal95555::PCAL95555<I2cType>::applyImageBatch(uint8_t reg0, PairIt first, PairIt last,
+                                                     ToBit to_bit) noexcept {
+  uint16_t mask = 0;
+  uint16_t bits = 0;
+  for (; first != last; ++first) {
+    const auto& config = *first;
+    if (!isValidPin(config.first)) {
+      setError(Error::InvalidPin);
+      return false;
     }
+    const auto bit = static_cast<uint16_t>(1U << config.first);
+    mask |= bit;
+    bits = to_bit(config.second) ? static_cast<uint16_t>(bits | bit) : static_cast<uint16_t>(bits & ~bit);
   }
-  return writeDualPort(reg0, reg1, val0, val1);
+  clearError(Error::InvalidPin);
+  return updateImagePair(reg0, mask, bits);
 }
 
 // ---- Direction configuration ----
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetPinDirection(uint8_t pin, GPIODir dir) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPinDirection(uint8_t pin, GPIODir dir) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -301,7 +468,7 @@ bool pcal95555::PCAL95555<I2cType>::SetPinDirection(uint8_t pin, GPIODir dir) no
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetMultipleDirections(uint16_t mask, GPIODir dir) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetMultipleDirections(uint16_t mask, GPIODir dir) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -313,36 +480,48 @@ bool pcal95555::PCAL95555<I2cType>::SetMultipleDirections(uint16_t mask, GPIODir
 
 // Configure direction for multiple pins with individual settings
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetDirections(std::initializer_list<std::pair<uint8_t, GPIODir>> configs) noexcept {
+template <typename PairIt>
+  requires std::input_iterator<PairIt>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDirections(PairIt first, PairIt last) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
-  uint8_t port0 = 0;
-  uint8_t port1 = 0;
-  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0),
-                     static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_1), port0, port1)) {
+  return applyPinBatch(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0),
+                       static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_1), first, last,
+                       [](GPIODir dir) { return dir == GPIODir::Input; });
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDirections(std::initializer_list<std::pair<uint8_t, GPIODir>> configs) noexcept {
+  return SetDirections(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDirections(std::span<const std::pair<uint8_t, GPIODir>> configs) noexcept {
+  return SetDirections(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+template <pcal95555::PinGroupType... Groups>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDirections() noexcept {
+  static_assert(sizeof...(Groups) > 0, "SetDirections<>() needs at least one In<>/Out<> group");
+  static_assert(((Groups::role == PinRole::Input || Groups::role == PinRole::Output) && ...),
+                "SetDirections<>() only accepts In<...> and Out<...> groups");
+  constexpr uint16_t kInputs = kPinGroupMask<PinRole::Input, Groups...>;
+  constexpr uint16_t kOutputs = kPinGroupMask<PinRole::Output, Groups...>;
+  static_assert((kInputs & kOutputs) == 0, "A pin is listed both as input and output");
+
+  if (!EnsureInitialized()) {
     return false;
   }
-  for (const auto& config : configs) {
-    if (config.first >= 16) {
-      setError(Error::InvalidPin);
-      return false;
-    }
-    uint8_t bit = config.first % 8;
-    if (config.first < 8) {
-      port0 = updateBit(port0, bit, (config.second == GPIODir::Input));
-    } else {
-      port1 = updateBit(port1, bit, (config.second == GPIODir::Input));
-    }
-  }
-  clearError(Error::InvalidPin);
-  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0),
-                        static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_1), port0, port1);
+  // CONFIG bit: 1 = input, 0 = output
+  return updateDualPortMasks(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0),
+                             static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_1), kInputs, kOutputs);
 }
 
 // Read input port registers and return bit
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::ReadPin(uint8_t pin) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::ReadPin(uint8_t pin) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -362,7 +541,7 @@ bool pcal95555::PCAL95555<I2cType>::ReadPin(uint8_t pin) noexcept {
 
 // Write output port registers
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::WritePin(uint8_t pin, bool value) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::WritePin(uint8_t pin, bool value) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -378,7 +557,7 @@ bool pcal95555::PCAL95555<I2cType>::WritePin(uint8_t pin, bool value) noexcept {
 
 // Set multiple outputs via bitmask
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetMultipleOutputs(uint16_t mask, bool value) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetMultipleOutputs(uint16_t mask, bool value) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -388,8 +567,25 @@ bool pcal95555::PCAL95555<I2cType>::SetMultipleOutputs(uint16_t mask, bool value
                                mask, value);
 }
 
+// Write the complete output image: one paired write, no read-back
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::TogglePin(uint8_t pin) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::WriteAllOutputs(uint16_t outputs) noexcept {
+  if (!EnsureInitialized()) {
+    return false;
+  }
+  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0),
+                       static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_1),
+                       static_cast<uint8_t>(outputs & 0xFF), static_cast<uint8_t>(outputs >> 8));
+}
+
+template <typename I2cType>
+template <size_t Layers>
+bool pcal95555::PCAL95555<I2cType>::ComposeOutputs(OutputCompositor<Layers>& compositor) noexcept {
+  return compositor.Flush([this](uint16_t image) { return WriteAllOutputs(image); });
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::TogglePin(uint8_t pin) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -411,36 +607,65 @@ bool pcal95555::PCAL95555<I2cType>::TogglePin(uint8_t pin) noexcept {
 
 // Write multiple pins
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::WritePins(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept {
+template <typename PairIt>
+  requires std::input_iterator<PairIt>
+constexpr bool pcal95555::PCAL95555<I2cType>::WritePins(PairIt first, PairIt last) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
-  uint8_t port0 = 0;
-  uint8_t port1 = 0;
-  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0),
-                     static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_1), port0, port1)) {
+  return applyPinBatch(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0),
+                       static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_1), first, last,
+                       [](bool value) { return value; });
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::WritePins(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept {
+  return WritePins(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::WritePins(std::span<const std::pair<uint8_t, bool>> configs) noexcept {
+  return WritePins(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+template <pcal95555::PinGroupType... Groups>
+constexpr bool pcal95555::PCAL95555<I2cType>::WritePins() noexcept {
+  static_assert(sizeof...(Groups) > 0, "WritePins<>() needs at least one High<>/Low<> group");
+  static_assert(((Groups::role == PinRole::High || Groups::role == PinRole::Low) && ...),
+                "WritePins<>() only accepts High<...> and Low<...> groups; use "
+                "WritePins<Pins<...>>(values) for runtime levels");
+  constexpr uint16_t kHigh = kPinGroupMask<PinRole::High, Groups...>;
+  constexpr uint16_t kLow = kPinGroupMask<PinRole::Low, Groups...>;
+  static_assert((kHigh & kLow) == 0, "A pin is listed both HIGH and LOW");
+
+  if (!EnsureInitialized()) {
     return false;
   }
-  for (const auto& config : configs) {
-    if (config.first >= 16) {
-      setError(Error::InvalidPin);
-      return false;
-    }
-    uint8_t bit = config.first % 8;
-    if (config.first < 8) {
-      port0 = updateBit(port0, bit, config.second);
-    } else {
-      port1 = updateBit(port1, bit, config.second);
-    }
+  return updateDualPortMasks(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0),
+                             static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_1), kHigh, kLow);
+}
+
+template <typename I2cType>
+template <pcal95555::PinGroupType PinSet>
+constexpr bool pcal95555::PCAL95555<I2cType>::WritePins(uint16_t values) noexcept {
+  static_assert(PinSet::role == PinRole::Any, "WritePins<PinSet>(values) expects a Pins<...> group");
+  constexpr uint16_t kMask = PinSet::mask;
+
+  if (!EnsureInitialized()) {
+    return false;
   }
-  clearError(Error::InvalidPin);
-  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0),
-                        static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_1), port0, port1);
+  return updateDualPortMasks(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0),
+                             static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_1),
+                             static_cast<uint16_t>(values & kMask),
+                             static_cast<uint16_t>(~values & kMask));
 }
 
-// Read multiple pins (zero heap allocation — uses stack-based PinReadResult)
+// Read multiple pins (zero heap allocation — PinReadResult is two bitmasks)
 template <typename I2cType>
-pcal95555::PinReadResult pcal95555::PCAL95555<I2cType>::ReadPins(std::initializer_list<uint8_t> pins) noexcept {
+template <typename PinIt>
+  requires std::input_iterator<PinIt>
+constexpr pcal95555::PinReadResult pcal95555::PCAL95555<I2cType>::ReadPins(PinIt first, PinIt last) noexcept {
   PinReadResult results;
   if (!EnsureInitialized()) {
     return results;  // Return empty results if not initialized
@@ -449,40 +674,64 @@ pcal95555::PinReadResult pcal95555::PCAL95555<I2cType>::ReadPins(std::initialize
   // Read both input port registers once
   uint8_t port0 = 0;
   uint8_t port1 = 0;
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0), port0)) {
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0),
+                    static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port0, port1)) {
     // On failure, return empty results
     return results;
   }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port1)) {
-    return results;
-  }
 
-  // Extract values for each requested pin (skip duplicates)
-  for (uint8_t pin : pins) {
-    if (results.contains(pin)) continue;  // Deduplicate repeated pins
-
-    if (pin >= 16) {
-      // Invalid pin - add with false value
-      results.push_back(pin, false);
+  // Collect the requested pins as a mask; duplicates collapse naturally
+  bool invalid_pin = false;
+  for (; first != last; ++first) {
+    const auto pin = *first;
+    if (!isValidPin(pin)) {
+      invalid_pin = true;
       continue;
     }
+    results.requested = static_cast<uint16_t>(results.requested | (1U << static_cast<uint8_t>(pin)));
+  }
+  results.values = static_cast<uint16_t>(((port1 << 8) | port0) & results.requested);
 
-    uint8_t bit = pin % 8;
-    bool value = false;
-    if (pin < 8) {
-      value = (port0 & (1 << bit)) != 0;
-    } else {
-      value = (port1 & (1 << bit)) != 0;
-    }
-    results.push_back(pin, value);
+  if (invalid_pin) {
+    setError(Error::InvalidPin);
+  } else {
+    clearError(Error::InvalidPin);
   }
+  return results;
+}
+
+template <typename I2cType>
+constexpr pcal95555::PinReadResult pcal95555::PCAL95555<I2cType>::ReadPins(std::initializer_list<uint8_t> pins) noexcept {
+  return ReadPins(pins.begin(), pins.end());
+}
+
+template <typename I2cType>
+constexpr pcal95555::PinReadResult pcal95555::PCAL95555<I2cType>::ReadPins(std::span<const uint8_t> pins) noexcept {
+  return ReadPins(pins.begin(), pins.end());
+}
 
+template <typename I2cType>
+template <pcal95555::PinGroupType PinSet>
+constexpr pcal95555::PinReadResult pcal95555::PCAL95555<I2cType>::ReadPins() noexcept {
+  static_assert(PinSet::role == PinRole::Any, "ReadPins<PinSet>() expects a Pins<...> group");
+  PinReadResult results;
+  if (!EnsureInitialized()) {
+    return results;
+  }
+  uint8_t port0 = 0;
+  uint8_t port1 = 0;
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0),
+                    static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port0, port1)) {
+    return results;
+  }
+  results.requested = PinSet::mask;
+  results.values = static_cast<uint16_t>(((port1 << 8) | port0) & PinSet::mask);
   return results;
 }
 
 // Pull-up/down control
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetPullEnable(uint8_t pin, bool enable) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullEnable(uint8_t pin, bool enable) noexcept {
   if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
@@ -491,13 +740,12 @@ bool pcal95555::PCAL95555<I2cType>::SetPullEnable(uint8_t pin, bool enable) noex
     return false;
   }
   clearError(Error::InvalidPin);
-  return modifySinglePinRegister(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0),
-                                  static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_1),
-                                  pin, enable);
+  const auto bit = static_cast<uint16_t>(1U << pin);
+  return updateImagePair(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0), bit, enable ? bit : 0);
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetPullDirection(uint8_t pin, bool pull_up) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullDirection(uint8_t pin, bool pull_up) noexcept {
   if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
@@ -506,72 +754,57 @@ bool pcal95555::PCAL95555<I2cType>::SetPullDirection(uint8_t pin, bool pull_up)
     return false;
   }
   clearError(Error::InvalidPin);
-  return modifySinglePinRegister(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0),
-                                  static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_1),
-                                  pin, pull_up);
+  const auto bit = static_cast<uint16_t>(1U << pin);
+  return updateImagePair(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0), bit, pull_up ? bit : 0);
 }
 
 // Configure pull enable for multiple pins
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetPullEnables(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept {
+template <typename PairIt>
+  requires std::input_iterator<PairIt>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullEnables(PairIt first, PairIt last) noexcept {
   if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
-  uint8_t port0 = 0;
-  uint8_t port1 = 0;
-  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0),
-                     static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_1), port0, port1)) {
-    return false;
-  }
-  for (const auto& config : configs) {
-    if (config.first >= 16) {
-      setError(Error::InvalidPin);
-      return false;
-    }
-    uint8_t bit = config.first % 8;
-    if (config.first < 8) {
-      port0 = updateBit(port0, bit, config.second);
-    } else {
-      port1 = updateBit(port1, bit, config.second);
-    }
-  }
-  clearError(Error::InvalidPin);
-  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0),
-                        static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_1), port0, port1);
+  return applyImageBatch(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0), first, last,
+                         [](bool enable) { return enable; });
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullEnables(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept {
+  return SetPullEnables(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullEnables(std::span<const std::pair<uint8_t, bool>> configs) noexcept {
+  return SetPullEnables(configs.begin(), configs.end());
 }
 
 // Configure pull direction for multiple pins
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetPullDirections(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept {
+template <typename PairIt>
+  requires std::input_iterator<PairIt>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullDirections(PairIt first, PairIt last) noexcept {
   if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
-  uint8_t port0 = 0;
-  uint8_t port1 = 0;
-  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0),
-                     static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_1), port0, port1)) {
-    return false;
-  }
-  for (const auto& config : configs) {
-    if (config.first >= 16) {
-      setError(Error::InvalidPin);
-      return false;
-    }
-    uint8_t bit = config.first % 8;
-    if (config.first < 8) {
-      port0 = updateBit(port0, bit, config.second);
-    } else {
-      port1 = updateBit(port1, bit, config.second);
-    }
-  }
-  clearError(Error::InvalidPin);
-  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0),
-                        static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_1), port0, port1);
+  return applyImageBatch(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0), first, last,
+                         [](bool pull_up) { return pull_up; });
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullDirections(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept {
+  return SetPullDirections(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullDirections(std::span<const std::pair<uint8_t, bool>> configs) noexcept {
+  return SetPullDirections(configs.begin(), configs.end());
 }
 
 // Read pull configuration from hardware
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::GetPullConfiguration(uint16_t& enable_mask,
+constexpr bool pcal95555::PCAL95555<I2cType>::GetPullConfiguration(uint16_t& enable_mask,
                                                           uint16_t& direction_mask) noexcept {
   if (!EnsureInitialized()) {
     return false;
@@ -581,16 +814,12 @@ bool pcal95555::PCAL95555<I2cType>::GetPullConfiguration(uint16_t& enable_mask,
   }
 
   uint8_t en0 = 0, en1 = 0, sel0 = 0, sel1 = 0;
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0), en0)) {
-    return false;
-  }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_1), en1)) {
-    return false;
-  }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0), sel0)) {
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0),
+                    static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_1), en0, en1)) {
     return false;
   }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_1), sel1)) {
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0),
+                    static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_1), sel0, sel1)) {
     return false;
   }
 
@@ -599,102 +828,47 @@ bool pcal95555::PCAL95555<I2cType>::GetPullConfiguration(uint16_t& enable_mask,
   return true;
 }
 
-// Drive strength (2 bits per pin)
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetDriveStrength(uint8_t pin, DriveStrength level) noexcept {
-  if (!EnsureInitialized()) {
-    return false;
-  }
-  if (!requireAgileIO()) {
-    return false;
-  }
-  if (pin >= 16) {
-    setError(Error::InvalidPin);
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPulls(uint16_t mask, bool enable, bool pull_up) noexcept {
+  if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
-  clearError(Error::InvalidPin);
-  uint8_t base = (pin < 8) ? static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_0) : static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_2);
-  uint8_t index = pin % 8;
-  uint8_t reg = base + ((index >= 4) ? 1 : 0);
-  uint8_t bit = (index % 4) * 2; // each pin uses 2 bits
-  uint8_t val = 0;
-  if (!readRegister(reg, val)) {
+  // Select the direction before enabling, so no pin sees the wrong resistor
+  if (enable && !updateImagePair(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0), mask, pull_up ? mask : 0)) {
     return false;
   }
-  // Clear the two bits and set the new level
-  val &= ~(0x3 << bit);
-  val |= (uint8_t(level) << bit);
-  return writeRegister(reg, val);
+  return updateImagePair(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0), mask, enable ? mask : 0);
 }
 
-// Configure drive strength for multiple pins
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetDriveStrengths(std::initializer_list<std::pair<uint8_t, DriveStrength>> configs) noexcept {
-  if (!EnsureInitialized()) {
-    return false;
-  }
-  if (!requireAgileIO()) {
-    return false;
-  }
-  // Read all drive strength registers (4 registers total)
-  uint8_t ds0 = 0, ds1 = 0, ds2 = 0, ds3 = 0;
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_0), ds0)) {
-    return false;
-  }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_1), ds1)) {
-    return false;
-  }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_2), ds2)) {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPullImage(const PullImage& image) noexcept {
+  if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_3), ds3)) {
+  if (!updateImagePair(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0), 0xFFFF, image.pull_up)) {
     return false;
   }
+  return updateImagePair(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0), 0xFFFF, image.enable);
+}
 
-  // Update values for each pin
-  for (const auto& config : configs) {
-    uint8_t pin = config.first;
-    DriveStrength level = config.second;
-
-    if (pin >= 16) {
-      setError(Error::InvalidPin);
-      return false;
-    }
-
-    uint8_t index = pin % 8;
-    uint8_t reg_offset = (index >= 4) ? 1 : 0;
-    uint8_t bit = (index % 4) * 2; // each pin uses 2 bits
-
-    uint8_t* reg_ptr = nullptr;
-    if (pin < 8) {
-      reg_ptr = (reg_offset == 0) ? &ds0 : &ds1;
-    } else {
-      reg_ptr = (reg_offset == 0) ? &ds2 : &ds3;
-    }
-
-    // Clear the two bits and set the new level
-    *reg_ptr &= ~(0x3 << bit);
-    *reg_ptr |= (uint8_t(level) << bit);
-  }
-
-  clearError(Error::InvalidPin);
-
-  // Write back all registers
-  if (!writeRegister(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_0), ds0)) {
-    return false;
-  }
-  if (!writeRegister(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_1), ds1)) {
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::GetPullImage(PullImage& image) noexcept {
+  if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
-  if (!writeRegister(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_2), ds2)) {
+  uint8_t en0 = 0, en1 = 0, sel0 = 0, sel1 = 0;
+  if (!loadImagePair(static_cast<uint8_t>(Pcal95555Reg::PULL_ENABLE_0), en0, en1) ||
+      !loadImagePair(static_cast<uint8_t>(Pcal95555Reg::PULL_SELECT_0), sel0, sel1)) {
     return false;
   }
-  return writeRegister(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_3), ds3);
+  image.enable = static_cast<uint16_t>((en1 << 8) | en0);
+  image.pull_up = static_cast<uint16_t>((sel1 << 8) | sel0);
+  return true;
 }
 
-// Configure interrupt for a single pin
+// Drive strength (2 bits per pin, packed image: pin N in bits 2N+1:2N)
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::ConfigureInterrupt(uint8_t pin, InterruptState state) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDriveStrength(uint8_t pin, DriveStrength level) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -706,17 +880,105 @@ bool pcal95555::PCAL95555<I2cType>::ConfigureInterrupt(uint8_t pin, InterruptSta
     return false;
   }
   clearError(Error::InvalidPin);
+  const uint8_t shift = pin * 2;
+  return updateDriveImage(0x3UL << shift, static_cast<uint32_t>(level) << shift);
+}
 
-  // Read current mask
-  uint8_t mask0 = 0;
-  uint8_t mask1 = 0;
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_0), mask0)) {
+// Configure drive strength for multiple pins
+template <typename I2cType>
+template <typename PairIt>
+  requires std::input_iterator<PairIt>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDriveStrengths(PairIt first, PairIt last) noexcept {
+  if (!EnsureInitialized()) {
     return false;
   }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_1), mask1)) {
+  if (!requireAgileIO()) {
     return false;
   }
-
+  // Collect the fields of every pin, then touch only the register pairs they fall in
+  uint32_t mask = 0;
+  uint32_t bits = 0;
+  for (; first != last; ++first) {
+    const auto& config = *first;
+    if (!isValidPin(config.first)) {
+      setError(Error::InvalidPin);
+      return false;
+    }
+    const auto pin = static_cast<uint8_t>(config.first);
+    const uint8_t shift = pin * 2;
+    mask |= 0x3UL << shift;
+    bits = (bits & ~(0x3UL << shift)) | (static_cast<uint32_t>(config.second) << shift);
+  }
+  clearError(Error::InvalidPin);
+  return updateDriveImage(mask, bits);
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDriveStrengths(std::initializer_list<std::pair<uint8_t, DriveStrength>> configs) noexcept {
+  return SetDriveStrengths(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDriveStrengths(std::span<const std::pair<uint8_t, DriveStrength>> configs) noexcept {
+  return SetDriveStrengths(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetMultipleDriveStrengths(uint16_t mask, DriveStrength level) noexcept {
+  if (!EnsureInitialized() || !requireAgileIO()) {
+    return false;
+  }
+  // Level replicated into every field, then cut down to the pins in mask
+  const uint32_t bits = static_cast<uint32_t>(level) * 0x55555555UL;
+  return updateDriveImage(driveFieldMask(mask), bits);
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetDriveImage(uint32_t image) noexcept {
+  if (!EnsureInitialized() || !requireAgileIO()) {
+    return false;
+  }
+  return updateDriveImage(0xFFFFFFFFUL, image);
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::GetDriveImage(uint32_t& image) noexcept {
+  if (!EnsureInitialized() || !requireAgileIO()) {
+    return false;
+  }
+  uint8_t ds0 = 0, ds1 = 0, ds2 = 0, ds3 = 0;
+  if (!loadImagePair(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_0), ds0, ds1) ||
+      !loadImagePair(static_cast<uint8_t>(Pcal95555Reg::DRIVE_STRENGTH_2), ds2, ds3)) {
+    return false;
+  }
+  image = static_cast<uint32_t>(ds0) | (static_cast<uint32_t>(ds1) << 8) | (static_cast<uint32_t>(ds2) << 16) |
+          (static_cast<uint32_t>(ds3) << 24);
+  return true;
+}
+
+// Configure interrupt for a single pin
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::ConfigureInterrupt(uint8_t pin, InterruptState state) noexcept {
+  if (!EnsureInitialized()) {
+    return false;
+  }
+  if (!requireAgileIO()) {
+    return false;
+  }
+  if (pin >= 16) {
+    setError(Error::InvalidPin);
+    return false;
+  }
+  clearError(Error::InvalidPin);
+
+  // Read current mask
+  uint8_t mask0 = 0;
+  uint8_t mask1 = 0;
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_0),
+                    static_cast<uint8_t>(Pcal95555Reg::INT_MASK_1), mask0, mask1)) {
+    return false;
+  }
+
   // Combine into 16-bit mask
   uint16_t mask = (uint16_t(mask1) << 8) | mask0;
 
@@ -733,68 +995,74 @@ bool pcal95555::PCAL95555<I2cType>::ConfigureInterrupt(uint8_t pin, InterruptSta
 
 // Configure interrupts for multiple pins
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::ConfigureInterrupts(std::initializer_list<std::pair<uint8_t, InterruptState>> configs) noexcept {
+template <typename PairIt>
+  requires std::input_iterator<PairIt>
+constexpr bool pcal95555::PCAL95555<I2cType>::ConfigureInterrupts(PairIt first, PairIt last) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
   if (!requireAgileIO()) {
     return false;
   }
+  // Collect the pins first, so a bad pin is rejected before the mask is read
+  uint16_t touched = 0;
+  uint16_t disabled = 0;  // 0 = enabled, 1 = disabled
+  for (; first != last; ++first) {
+    const auto& config = *first;
+    if (!isValidPin(config.first)) {
+      setError(Error::InvalidPin);
+      return false;
+    }
+    const auto bit = static_cast<uint16_t>(1U << config.first);
+    touched |= bit;
+    disabled = (config.second == InterruptState::Enabled) ? static_cast<uint16_t>(disabled & ~bit)
+                                                          : static_cast<uint16_t>(disabled | bit);
+  }
+  clearError(Error::InvalidPin);
+
   // Read current mask
   uint8_t mask0 = 0;
   uint8_t mask1 = 0;
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_0), mask0)) {
-    return false;
-  }
-  if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_1), mask1)) {
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_0),
+                    static_cast<uint8_t>(Pcal95555Reg::INT_MASK_1), mask0, mask1)) {
     return false;
   }
+  auto mask = static_cast<uint16_t>((uint16_t(mask1) << 8) | mask0);
+  mask = static_cast<uint16_t>((mask & ~touched) | disabled);
 
-  // Combine into 16-bit mask
-  uint16_t mask = (uint16_t(mask1) << 8) | mask0;
-
-  // Update mask for each pin configuration
-  for (const auto& config : configs) {
-    uint8_t pin = config.first;
-    InterruptState state = config.second;
-
-    if (pin >= 16) {
-      setError(Error::InvalidPin);
-      return false;
-    }
-
-    // Update the bit for this pin (0 = enabled, 1 = disabled)
-    if (state == InterruptState::Enabled) {
-      mask &= ~(1U << pin);  // Clear bit (enable interrupt)
-    } else {
-      mask |= (1U << pin);   // Set bit (disable interrupt)
-    }
-  }
+  // Write back once for all pins
+  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_0),
+                       static_cast<uint8_t>(Pcal95555Reg::INT_MASK_1), static_cast<uint8_t>(mask & 0xFF),
+                       static_cast<uint8_t>(mask >> 8));
+}
 
-  clearError(Error::InvalidPin);
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::ConfigureInterrupts(std::initializer_list<std::pair<uint8_t, InterruptState>> configs) noexcept {
+  return ConfigureInterrupts(configs.begin(), configs.end());
+}
 
-  // Write back once for all pins
-  return ConfigureInterruptMask(mask);
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::ConfigureInterrupts(std::span<const std::pair<uint8_t, InterruptState>> configs) noexcept {
+  return ConfigureInterrupts(configs.begin(), configs.end());
 }
 
 // Interrupt mask (low-level method)
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::ConfigureInterruptMask(uint16_t mask) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::ConfigureInterruptMask(uint16_t mask) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
   if (!requireAgileIO()) {
     return false;
   }
-  if (!writeRegister(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_0), uint8_t(mask & 0xFF))) {
-    return false;
-  }
-  return writeRegister(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_1), uint8_t((mask >> 8) & 0xFF));
+  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::INT_MASK_0),
+                       static_cast<uint8_t>(Pcal95555Reg::INT_MASK_1), uint8_t(mask & 0xFF),
+                       uint8_t((mask >> 8) & 0xFF));
 }
 
 // Read interrupt status (and clear)
 template <typename I2cType>
-uint16_t pcal95555::PCAL95555<I2cType>::GetInterruptStatus() noexcept {
+constexpr uint16_t pcal95555::PCAL95555<I2cType>::GetInterruptStatus() noexcept {
   if (!EnsureInitialized()) {
     return 0;
   }
@@ -803,14 +1071,14 @@ uint16_t pcal95555::PCAL95555<I2cType>::GetInterruptStatus() noexcept {
   }
   uint8_t low_byte = 0;
   uint8_t high_byte = 0;
-  readRegister(static_cast<uint8_t>(Pcal95555Reg::INT_STATUS_0), low_byte);
-  readRegister(static_cast<uint8_t>(Pcal95555Reg::INT_STATUS_1), high_byte);
+  readDualPort(static_cast<uint8_t>(Pcal95555Reg::INT_STATUS_0),
+               static_cast<uint8_t>(Pcal95555Reg::INT_STATUS_1), low_byte, high_byte);
   return uint16_t(high_byte) << 8 | low_byte;
 }
 
 // Output mode configuration (ODEN bits)
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetOutputMode(bool port_0_open_drain, bool port_1_open_drain) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetOutputMode(bool port_0_open_drain, bool port_1_open_drain) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -824,7 +1092,7 @@ bool pcal95555::PCAL95555<I2cType>::SetOutputMode(bool port_0_open_drain, bool p
 // Register pin interrupt callback
 template <typename I2cType>
 bool pcal95555::PCAL95555<I2cType>::RegisterPinInterrupt(uint8_t pin, InterruptEdge edge,
-                                                         std::function<void(uint8_t, bool)> callback) {
+                                                         PinCallback callback) {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -838,13 +1106,24 @@ bool pcal95555::PCAL95555<I2cType>::RegisterPinInterrupt(uint8_t pin, InterruptE
     return false;  // Invalid callback
   }
 
-  pin_callbacks_[pin].callback = callback;
-  pin_callbacks_[pin].edge = edge;
-  pin_callbacks_[pin].registered = true;
+  if ((running_pins_ & (1U << pin)) != 0) {
+    // Called from this pin's callback: overwriting it now would destroy the
+    // running closure. callPin() installs the new one once it returns.
+    if (pending_pin_ >= 0 && pending_pin_ != static_cast<int8_t>(pin)) {
+      return false;  // Another running pin already has a replacement pending
+    }
+    pending_pin_ = static_cast<int8_t>(pin);
+    pending_pin_callback_ = PinInterruptCallback{callback, edge, true};
+  } else {
+    pin_callbacks_[pin].callback = callback;
+    pin_callbacks_[pin].edge = edge;
+    pin_callbacks_[pin].registered = true;
+  }
 
   // Read current pin state for edge detection
   uint16_t current_states = readPinStates();
   previous_pin_states_ = current_states;
+  baseline_stale_ = false;
 
   return true;
 }
@@ -862,19 +1141,92 @@ bool pcal95555::PCAL95555<I2cType>::UnregisterPinInterrupt(uint8_t pin) noexcept
   }
   clearError(Error::InvalidPin);
 
-  if (!pin_callbacks_[pin].registered) {
+  const bool pending = pending_pin_ == static_cast<int8_t>(pin);
+  if (!pin_callbacks_[pin].registered && !pending) {
     return false;  // No callback registered
   }
 
+  if (pending) {
+    pending_pin_ = -1;
+    pending_pin_callback_ = PinInterruptCallback{};
+  }
   pin_callbacks_[pin].registered = false;
-  pin_callbacks_[pin].callback = nullptr;
+  if ((running_pins_ & (1U << pin)) != 0) {
+    // Called from this pin's callback: it is destroyed once it returns (callPin())
+    retired_pins_ = static_cast<uint16_t>(retired_pins_ | (1U << pin));
+  } else {
+    pin_callbacks_[pin].callback = nullptr;
+  }
   return true;
 }
 
 // Set global interrupt callback
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::SetInterruptCallback(const std::function<void(uint16_t)>& callback) noexcept {
-  irq_callback_ = callback;
+void pcal95555::PCAL95555<I2cType>::SetInterruptCallback(const IrqCallback& callback) noexcept {
+  if (running_irq_) {
+    // Called from the global callback: callIrq() installs this one once it returns
+    pending_irq_ = callback;
+    irq_pending_ = true;
+  } else {
+    irq_callback_ = callback;
+  }
+}
+
+// Add an interrupt subscriber
+template <typename I2cType>
+int pcal95555::PCAL95555<I2cType>::Subscribe(uint16_t pin_mask, InterruptEdge edge,
+                                             SubscriberCallback callback) noexcept {
+  if (!EnsureInitialized()) {
+    return -1;
+  }
+  if (pin_mask == 0) {
+    setError(Error::InvalidMask);
+    return -1;
+  }
+  clearError(Error::InvalidMask);
+  if (!callback) {
+    return -1;  // Invalid callback
+  }
+
+  const auto free_slots = static_cast<uint32_t>(~(subscriber_slots_ | retired_slots_) &
+                                                ((uint64_t{1} << kMaxSubscribers) - 1));
+  if (free_slots == 0) {
+    return -1;  // Table full
+  }
+  const int slot = std::countr_zero(free_slots);
+  Subscriber& sub = subscribers_[static_cast<size_t>(slot)];
+  sub.callback = callback;
+  sub.rising_mask = (edge == InterruptEdge::Falling) ? 0 : pin_mask;
+  sub.falling_mask = (edge == InterruptEdge::Rising) ? 0 : pin_mask;
+  subscriber_slots_ |= 1U << slot;
+
+  // Read current pin state for edge detection
+  previous_pin_states_ = readPinStates();
+  baseline_stale_ = false;
+  return slot;
+}
+
+// Remove an interrupt subscriber
+template <typename I2cType>
+bool pcal95555::PCAL95555<I2cType>::Unsubscribe(int handle) noexcept {
+  if (handle < 0 || static_cast<size_t>(handle) >= kMaxSubscribers ||
+      (subscriber_slots_ & (1U << handle)) == 0) {
+    return false;
+  }
+  subscriber_slots_ &= ~(1U << handle);
+  if (delivery_depth_ != 0) {
+    // Called from a callback: the slot's callable may be the one running.
+    // It is destroyed once delivery returns (deliverDeferred()).
+    retired_slots_ |= 1U << handle;
+  } else {
+    subscribers_[static_cast<size_t>(handle)] = Subscriber{};
+  }
+  return true;
+}
+
+template <typename I2cType>
+constexpr size_t pcal95555::PCAL95555<I2cType>::GetSubscriberCount() const noexcept {
+  return static_cast<size_t>(std::popcount(subscriber_slots_));
 }
 
 // Register interrupt handler with I2C interface
@@ -883,103 +1235,381 @@ bool pcal95555::PCAL95555<I2cType>::RegisterInterruptHandler() noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
-  // Register this driver's HandleInterrupt method with the I2C interface
-  return i2c_->RegisterInterruptHandler([this]() {
-    HandleInterrupt();
-  });
+  return bindInterruptHandler();
+}
+
+// Register this driver's HandleInterrupt method with the I2C interface
+template <typename I2cType>
+bool pcal95555::PCAL95555<I2cType>::bindInterruptHandler() noexcept {
+  if (!i2c_->RegisterInterruptHandler([this]() { HandleInterrupt(); })) {
+    return false;
+  }
+  interrupt_bound_ = true;
+  return true;
+}
+
+// Move the source's registration to this instance; the source stays bound if the bus refuses
+template <typename I2cType>
+void pcal95555::PCAL95555<I2cType>::takeInterruptHandler(PCAL95555& other) noexcept {
+  interrupt_bound_ = false;
+  if (!other.interrupt_bound_) {
+    return;
+  }
+  if (bindInterruptHandler()) {
+    other.interrupt_bound_ = false;
+  } else {
+    setError(Error::InterruptBindFail);
+  }
+}
+
+// The interface has no unregister call: replace our handler with one that does nothing
+template <typename I2cType>
+bool pcal95555::PCAL95555<I2cType>::releaseInterruptHandler() noexcept {
+  if (!interrupt_bound_) {
+    return true;
+  }
+  if (!i2c_->RegisterInterruptHandler([]() {})) {
+    return false;
+  }
+  interrupt_bound_ = false;
+  return true;
+}
+
+// A refused rebind leaves the source bound: keep that, so its destructor still releases it
+template <typename I2cType>
+void pcal95555::PCAL95555<I2cType>::resetMovedFrom() noexcept {
+  const bool bound = interrupt_bound_;
+  const PCAL95555 fresh(i2c_, dev_addr_, user_variant_);
+  *this = fresh;
+  interrupt_bound_ = bound;
 }
 
 // Read current pin states (private helper)
 template <typename I2cType>
-uint16_t pcal95555::PCAL95555<I2cType>::readPinStates() noexcept {
+constexpr uint16_t pcal95555::PCAL95555<I2cType>::readPinStates() noexcept {
   uint8_t port0 = 0;
   uint8_t port1 = 0;
-  readRegister(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0), port0);
-  readRegister(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port1);
+  readDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0),
+               static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port0, port1);
   return (uint16_t(port1) << 8) | port0;
 }
 
 // Read all 16 pin input states (public API)
 template <typename I2cType>
-uint16_t pcal95555::PCAL95555<I2cType>::ReadAllInputs() noexcept {
+constexpr uint16_t pcal95555::PCAL95555<I2cType>::ReadAllInputs() noexcept {
   if (!EnsureInitialized()) {
     return 0;
   }
   return readPinStates();
 }
 
+// Read all 16 pin input states with an explicit success result
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::ReadAllInputs(uint16_t& inputs) noexcept {
+  if (!EnsureInitialized()) {
+    return false;
+  }
+  uint8_t port0 = 0;
+  uint8_t port1 = 0;
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0),
+                    static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port0, port1)) {
+    return false;
+  }
+  inputs = static_cast<uint16_t>((uint16_t(port1) << 8) | port0);
+  return true;
+}
+
+// Read all inputs and feed them to a triggered capture
+template <typename I2cType>
+template <size_t Bytes>
+constexpr bool pcal95555::PCAL95555<I2cType>::SampleInputs(InputCapture<Bytes>& capture,
+                                                           uint64_t now_us) noexcept {
+  const CaptureState state = capture.State();
+  if (state != CaptureState::Armed && state != CaptureState::Triggered) {
+    return false;
+  }
+  if (!EnsureInitialized()) {
+    return false;
+  }
+  uint8_t port0 = 0;
+  uint8_t port1 = 0;
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0),
+                    static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port0, port1)) {
+    return false;
+  }
+  capture.Sample(static_cast<uint16_t>((uint16_t(port1) << 8) | port0), now_us);
+  return true;
+}
+
 // Handle interrupt - read status, check conditions, call callbacks
 template <typename I2cType>
 void pcal95555::PCAL95555<I2cType>::HandleInterrupt() noexcept {
-  if (!EnsureInitialized()) {
-    return;
+  (void)serviceInterrupt();
+}
+
+template <typename I2cType>
+bool pcal95555::PCAL95555<I2cType>::ServiceInterrupts(InterruptModerator& moderator, uint64_t now_us,
+                                                      bool edge) noexcept {
+  if (!moderator.ShouldService(now_us, edge)) {
+    return false;
   }
+  moderator.Serviced(now_us, serviceInterrupt());
+  return true;
+}
 
-  uint16_t interrupt_status = 0;
+template <typename I2cType>
+uint16_t pcal95555::PCAL95555<I2cType>::serviceInterrupt() noexcept {
+  // Every pass reads the bus, backlog or not: the read is what releases INT,
+  // and INT only produces another edge (another pass) once it was released.
+  uint16_t found = 0;
+  if (callback_budget_ != 0 ? initialized_ : EnsureInitialized()) {  // bounded passes never lazily initialize
+    if constexpr (CONFIG_PCAL95555_SERVICE_ENGINE == 1) {
+      found = serviceByDiff();
+    } else if constexpr (CONFIG_PCAL95555_SERVICE_ENGINE == 2) {
+      found = serviceByStatus();
+    } else {
+      found = interrupt_engine_ == InterruptEngine::StatusLatch ? serviceByStatus() : serviceByDiff();
+    }
+  }
+  if (HasDeferredEvents()) {
+    deliverDeferred();
+  }
+  return found;
+}
 
-  if (chip_variant_ == ChipVariant::PCAL9555A) {
-    // PCAL9555A: read hardware interrupt status register
-    interrupt_status = GetInterruptStatus();
-  } else {
-    // PCA9555: No hardware interrupt status registers.
-    // Fall back to change-detection by comparing current vs previous pin states.
-    uint16_t current_states = readPinStates();
-    interrupt_status = current_states ^ previous_pin_states_;
-    // Note: previous_pin_states_ is updated at the end of this method
+// PCA9555 engine: the inputs are the only source, so one paired read and a diff
+template <typename I2cType>
+uint16_t pcal95555::PCAL95555<I2cType>::serviceByDiff() noexcept {
+  uint8_t port0 = 0;
+  uint8_t port1 = 0;
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0),
+                    static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port0, port1)) {
+    return 0;  // keep previous_pin_states_: a failed read is not an edge
   }
+  const auto states = static_cast<uint16_t>((uint16_t(port1) << 8) | port0);
+  if (baseline_stale_) {
+    // First service at a new address: nothing to diff against yet
+    previous_pin_states_ = states;
+    baseline_stale_ = false;
+  }
+  const auto changed = static_cast<uint16_t>(states ^ previous_pin_states_);
+  queueEvents(changed, static_cast<uint16_t>(changed & states), static_cast<uint16_t>(changed & ~states), states);
+  return changed;
+}
 
-  // Read current pin states
-  uint16_t current_states = readPinStates();
+// PCAL9555A engine: INT_STATUS names the pins that fired, even those that
+// already returned to their previous level; the input read then clears the
+// interrupt (and returns the latched level on latched pins)
+template <typename I2cType>
+uint16_t pcal95555::PCAL95555<I2cType>::serviceByStatus() noexcept {
+  uint8_t status0 = 0;
+  uint8_t status1 = 0;
+  // The input read below is what releases INT, so it runs even if this fails
+  const bool have_status = readDualPort(static_cast<uint8_t>(Pcal95555Reg::INT_STATUS_0),
+                                        static_cast<uint8_t>(Pcal95555Reg::INT_STATUS_1), status0, status1);
+  uint8_t port0 = 0;
+  uint8_t port1 = 0;
+  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0),
+                    static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1), port0, port1)) {
+    return 0;  // keep previous_pin_states_: a failed read is not an edge
+  }
+  // Without INT_STATUS only level changes are visible, as with InputDiff
+  const auto flagged = have_status ? static_cast<uint16_t>((uint16_t(status1) << 8) | status0) : uint16_t{0};
+  const auto states = static_cast<uint16_t>((uint16_t(port1) << 8) | port0);
+  if (baseline_stale_) {
+    // First service at a new address: take each flagged pin as having changed once
+    previous_pin_states_ = static_cast<uint16_t>(states ^ flagged);
+    baseline_stale_ = false;
+  }
+  const uint16_t previous = previous_pin_states_;
+  const auto changed = static_cast<uint16_t>(states ^ previous);
+  // Flagged but back at the previous level: the pin toggled twice
+  const auto pulsed = static_cast<uint16_t>(flagged & ~changed);
+  // Changed but not flagged (after the status read, masked, or no status at
+  // all): an ordinary single edge, as the input read already cleared it
+  const auto status = static_cast<uint16_t>(flagged | changed);
+  const auto rising = static_cast<uint16_t>((changed & states) | pulsed);
+  const auto falling = static_cast<uint16_t>((changed & ~states) | pulsed);
+  queueEvents(status, rising, falling, states);
+  return status;
+}
 
-  // Call global callback if registered
-  if (irq_callback_) {
-    irq_callback_(interrupt_status);
+template <typename I2cType>
+void pcal95555::PCAL95555<I2cType>::queueEvents(uint16_t status, uint16_t rising, uint16_t falling,
+                                                uint16_t states) noexcept {
+  const uint16_t previous = previous_pin_states_;
+  const auto pins = static_cast<uint16_t>(rising | falling);
+  // Edge detection moves on now; deferred callbacks use the levels saved above
+  previous_pin_states_ = states;
+  // Records are built in place: going through a local copy cost ~10 ns per service (interrupt_engines)
+  if (!HasDeferredEvents()) {
+    deferred_ = DeferredEvents{status, rising, falling, states, previous, pins, 0, subscriber_slots_,
+                               static_cast<bool>(irq_callback_)};
+  } else if ((status | pins) == 0) {
+    return;  // nothing new to queue behind the backlog
+  } else if (!queued_.Pending()) {
+    queued_ = DeferredEvents{status, rising, falling, states, previous, pins, 0, subscriber_slots_,
+                             static_cast<bool>(irq_callback_)};
+  } else {
+    // Nothing of queued_ is delivered yet, so it absorbs the new service.
+    // A pin with edges both ways replays as a pulse ending at its current level.
+    DeferredEvents& q = queued_;
+    q.status = static_cast<uint16_t>(q.status | status);
+    q.rising = static_cast<uint16_t>(q.rising | rising);
+    q.falling = static_cast<uint16_t>(q.falling | falling);
+    const auto both = static_cast<uint16_t>(q.rising & q.falling);
+    q.previous = static_cast<uint16_t>(~(states ^ both));
+    q.states = states;
+    q.pins = static_cast<uint16_t>(q.rising | q.falling);
+    q.slots = subscriber_slots_;
+    q.irq = q.irq || static_cast<bool>(irq_callback_);
   }
+}
 
-  // Process each pin that triggered an interrupt
-  for (uint8_t pin = 0; pin < 16; ++pin) {
-    // Check if this pin triggered an interrupt
-    if ((interrupt_status & (1U << pin)) == 0) {
-      continue;  // Pin didn't trigger interrupt
+template <typename I2cType>
+void pcal95555::PCAL95555<I2cType>::deliverDeferred() noexcept {
+  ++delivery_depth_;
+  deliverCallbacks();
+  if (--delivery_depth_ == 0) {
+    // Subscribers removed from inside a callback are only destroyed now
+    while (retired_slots_ != 0) {
+      subscribers_[static_cast<size_t>(std::countr_zero(retired_slots_))] = Subscriber{};
+      retired_slots_ &= retired_slots_ - 1;
     }
+  }
+}
+
+template <typename I2cType>
+void pcal95555::PCAL95555<I2cType>::deliverCallbacks() noexcept {
+  uint32_t left = deliverRecord(callback_budget_ != 0 ? callback_budget_ : UINT32_MAX);
+  while (!deferred_.Pending() && queued_.Pending()) {
+    deferred_ = queued_;
+    queued_ = DeferredEvents{};
+    left = deliverRecord(left);
+  }
+}
 
-    // Check if callback is registered for this pin
-    if (!pin_callbacks_[pin].registered || !pin_callbacks_[pin].callback) {
-      continue;  // No callback registered
+template <typename I2cType>
+uint32_t pcal95555::PCAL95555<I2cType>::deliverRecord(uint32_t left) noexcept {
+  DeferredEvents& ev = deferred_;
+
+  // Global callback. Each entry is marked done before its call, so a
+  // callback that runs another pass does not see it again.
+  if (ev.irq) {
+    if (left == 0) {
+      return 0;
     }
+    ev.irq = false;
+    if (irq_callback_) {
+      --left;
+      callIrq(ev.status);
+    }
+  }
 
-    // Determine edge type
-    bool previous_state = (previous_pin_states_ & (1U << pin)) != 0;
-    bool current_state = (current_states & (1U << pin)) != 0;
-    bool rising_edge = !previous_state && current_state;
-    bool falling_edge = previous_state && !current_state;
-
-    // Check if edge matches registered condition
-    bool should_call = false;
-    switch (pin_callbacks_[pin].edge) {
-      case InterruptEdge::Rising:
-        should_call = rising_edge;
-        break;
-      case InterruptEdge::Falling:
-        should_call = falling_edge;
-        break;
-      case InterruptEdge::Both:
-        should_call = rising_edge || falling_edge;
-        break;
+  // Per-pin callbacks, only for pins with an edge
+  while (ev.pins != 0) {
+    const auto pin = static_cast<uint8_t>(std::countr_zero(ev.pins));
+    const auto bit = static_cast<uint16_t>(1U << pin);
+    const PinInterruptCallback& entry = pin_callbacks_[pin];
+    const bool previous = (ev.previous & bit) != 0;
+    // Edge away from the previous level first, then (pulse) the edge back
+    const bool away = ((previous ? ev.falling : ev.rising) & bit) != 0 && (ev.back & bit) == 0;
+    const bool back = ((previous ? ev.rising : ev.falling) & bit) != 0;
+    const auto calls = [&entry](bool level) {
+      return entry.registered && static_cast<bool>(entry.callback) &&
+             (static_cast<uint8_t>(entry.edge) &
+              static_cast<uint8_t>(level ? InterruptEdge::Rising : InterruptEdge::Falling)) != 0;
+    };
+    const bool call_away = away && calls(!previous);
+    bool call_back = back && calls(previous);
+    if (call_away) {
+      if (left == 0) {
+        return 0;
+      }
+      --left;
+      if (call_back) {
+        ev.back = static_cast<uint16_t>(ev.back | bit);
+      } else {
+        ev.pins = static_cast<uint16_t>(ev.pins & ~bit);
+      }
+      callPin(pin, !previous);
+      if (call_back && !calls(previous)) {
+        // The callback unregistered or replaced itself: the edge back goes to the current entry only
+        call_back = false;
+        ev.back = static_cast<uint16_t>(ev.back & ~bit);
+        ev.pins = static_cast<uint16_t>(ev.pins & ~bit);
+      }
+    }
+    if (call_back) {
+      if (left == 0) {
+        return 0;
+      }
+      --left;
+      ev.back = static_cast<uint16_t>(ev.back & ~bit);
+      ev.pins = static_cast<uint16_t>(ev.pins & ~bit);
+      callPin(pin, previous);
+    }
+    if (!call_away && !call_back) {
+      ev.pins = static_cast<uint16_t>(ev.pins & ~bit);
     }
+  }
 
-    // Call callback if condition matches
-    if (should_call) {
-      pin_callbacks_[pin].callback(pin, current_state);
+  // Fan out to subscribers: one AND per slot, one call per matching slot
+  while (ev.slots != 0) {
+    const auto slot = static_cast<size_t>(std::countr_zero(ev.slots));
+    const Subscriber& sub = subscribers_[slot];
+    const PinEvents events{static_cast<uint16_t>(ev.rising & sub.rising_mask),
+                           static_cast<uint16_t>(ev.falling & sub.falling_mask), ev.states};
+    const bool call = (subscriber_slots_ & (1UL << slot)) != 0 && (events.rising | events.falling) != 0;
+    if (call && left == 0) {
+      return 0;
+    }
+    ev.slots &= ev.slots - 1;
+    if (call) {
+      --left;
+      sub.callback(events);
     }
   }
+  return left;
+}
 
-  // Update previous states for next interrupt
-  previous_pin_states_ = current_states;
+// Changes made to the entry while its callback runs are applied once the outermost call returns
+template <typename I2cType>
+void pcal95555::PCAL95555<I2cType>::callPin(uint8_t pin, bool state) noexcept {
+  const auto bit = static_cast<uint16_t>(1U << pin);
+  const uint16_t running = running_pins_;
+  running_pins_ = static_cast<uint16_t>(running_pins_ | bit);
+  pin_callbacks_[pin].callback(pin, state);
+  running_pins_ = running;
+  if ((running & bit) != 0) {
+    return;  // An outer call of this pin is still running
+  }
+  if ((retired_pins_ & bit) != 0) {
+    retired_pins_ = static_cast<uint16_t>(retired_pins_ & ~bit);
+    pin_callbacks_[pin].callback = nullptr;
+  }
+  if (pending_pin_ == static_cast<int8_t>(pin)) {
+    pending_pin_ = -1;
+    pin_callbacks_[pin] = pending_pin_callback_;
+    pending_pin_callback_ = PinInterruptCallback{};
+  }
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetPinPolarity(uint8_t pin, Polarity polarity) noexcept {
+void pcal95555::PCAL95555<I2cType>::callIrq(uint16_t status) noexcept {
+  const bool running = running_irq_;
+  running_irq_ = true;
+  irq_callback_(status);
+  running_irq_ = running;
+  if (!running && irq_pending_) {
+    irq_pending_ = false;
+    irq_callback_ = pending_irq_;
+    pending_irq_ = nullptr;
+  }
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPinPolarity(uint8_t pin, Polarity polarity) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -994,7 +1624,7 @@ bool pcal95555::PCAL95555<I2cType>::SetPinPolarity(uint8_t pin, Polarity polarit
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetMultiplePolarities(uint16_t mask, Polarity polarity) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetMultiplePolarities(uint16_t mask, Polarity polarity) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
@@ -1005,35 +1635,29 @@ bool pcal95555::PCAL95555<I2cType>::SetMultiplePolarities(uint16_t mask, Polarit
 
 // Configure polarity for multiple pins with individual settings
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::SetPolarities(std::initializer_list<std::pair<uint8_t, Polarity>> configs) noexcept {
+template <typename PairIt>
+  requires std::input_iterator<PairIt>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPolarities(PairIt first, PairIt last) noexcept {
   if (!EnsureInitialized()) {
     return false;
   }
-  uint8_t port0 = 0;
-  uint8_t port1 = 0;
-  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::POLARITY_INV_0),
-                     static_cast<uint8_t>(Pcal95555Reg::POLARITY_INV_1), port0, port1)) {
-    return false;
-  }
-  for (const auto& config : configs) {
-    if (config.first >= 16) {
-      setError(Error::InvalidPin);
-      return false;
-    }
-    uint8_t bit = config.first % 8;
-    if (config.first < 8) {
-      port0 = updateBit(port0, bit, (config.second == Polarity::Inverted));
-    } else {
-      port1 = updateBit(port1, bit, (config.second == Polarity::Inverted));
-    }
-  }
-  clearError(Error::InvalidPin);
-  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::POLARITY_INV_0),
-                        static_cast<uint8_t>(Pcal95555Reg::POLARITY_INV_1), port0, port1);
+  return applyPinBatch(static_cast<uint8_t>(Pcal95555Reg::POLARITY_INV_0),
+                       static_cast<uint8_t>(Pcal95555Reg::POLARITY_INV_1), first, last,
+                       [](Polarity polarity) { return polarity == Polarity::Inverted; });
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::EnableInputLatch(uint8_t pin, bool enable) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPolarities(std::initializer_list<std::pair<uint8_t, Polarity>> configs) noexcept {
+  return SetPolarities(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::SetPolarities(std::span<const std::pair<uint8_t, Polarity>> configs) noexcept {
+  return SetPolarities(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::EnableInputLatch(uint8_t pin, bool enable) noexcept {
   if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
@@ -1048,7 +1672,7 @@ bool pcal95555::PCAL95555<I2cType>::EnableInputLatch(uint8_t pin, bool enable) n
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::EnableMultipleInputLatches(uint16_t mask, bool enable) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::EnableMultipleInputLatches(uint16_t mask, bool enable) noexcept {
   if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
@@ -1060,83 +1684,93 @@ bool pcal95555::PCAL95555<I2cType>::EnableMultipleInputLatches(uint16_t mask, bo
 
 // Configure input latch for multiple pins with individual settings
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::EnableInputLatches(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept {
+template <typename PairIt>
+  requires std::input_iterator<PairIt>
+constexpr bool pcal95555::PCAL95555<I2cType>::EnableInputLatches(PairIt first, PairIt last) noexcept {
   if (!EnsureInitialized() || !requireAgileIO()) {
     return false;
   }
-  uint8_t port0 = 0;
-  uint8_t port1 = 0;
-  if (!readDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_LATCH_0),
-                     static_cast<uint8_t>(Pcal95555Reg::INPUT_LATCH_1), port0, port1)) {
-    return false;
-  }
-  for (const auto& config : configs) {
-    if (config.first >= 16) {
-      setError(Error::InvalidPin);
-      return false;
-    }
-    uint8_t bit = config.first % 8;
-    if (config.first < 8) {
-      port0 = updateBit(port0, bit, config.second);
-    } else {
-      port1 = updateBit(port1, bit, config.second);
-    }
-  }
-  clearError(Error::InvalidPin);
-  return writeDualPort(static_cast<uint8_t>(Pcal95555Reg::INPUT_LATCH_0),
-                        static_cast<uint8_t>(Pcal95555Reg::INPUT_LATCH_1), port0, port1);
+  return applyPinBatch(static_cast<uint8_t>(Pcal95555Reg::INPUT_LATCH_0),
+                       static_cast<uint8_t>(Pcal95555Reg::INPUT_LATCH_1), first, last,
+                       [](bool enable) { return enable; });
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::EnableInputLatches(std::initializer_list<std::pair<uint8_t, bool>> configs) noexcept {
+  return EnableInputLatches(configs.begin(), configs.end());
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::EnableInputLatches(std::span<const std::pair<uint8_t, bool>> configs) noexcept {
+  return EnableInputLatches(configs.begin(), configs.end());
 }
 
 template <typename I2cType>
-uint16_t pcal95555::PCAL95555<I2cType>::GetErrorFlags() const noexcept {
+constexpr uint16_t pcal95555::PCAL95555<I2cType>::GetErrorFlags() const noexcept {
   return error_flags_;
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::HasError(Error e) const noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::HasError(Error e) const noexcept {
   return (error_flags_ & static_cast<uint16_t>(e)) != 0;
 }
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::HasAnyError() const noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::HasAnyError() const noexcept {
   return error_flags_ != 0;
 }
 
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::ClearError(Error e) noexcept {
+constexpr void pcal95555::PCAL95555<I2cType>::ClearError(Error e) noexcept {
   error_flags_ &= ~static_cast<uint16_t>(e);
 }
 
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::ClearErrorFlags(uint16_t mask) noexcept {
+constexpr void pcal95555::PCAL95555<I2cType>::ClearErrorFlags(uint16_t mask) noexcept {
   error_flags_ &= ~mask;
 }
 
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::setError(Error error_code) noexcept {
+constexpr void pcal95555::PCAL95555<I2cType>::setError(Error error_code) noexcept {
   error_flags_ |= static_cast<uint16_t>(error_code);
 }
 
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::clearError(Error error_code) noexcept {
+constexpr void pcal95555::PCAL95555<I2cType>::clearError(Error error_code) noexcept {
   error_flags_ &= ~static_cast<uint16_t>(error_code);
 }
 
 // Check if chip supports Agile I/O (PCAL9555A features)
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::HasAgileIO() const noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::HasAgileIO() const noexcept {
   return chip_variant_ == ChipVariant::PCAL9555A;
 }
 
 // Get detected chip variant
 template <typename I2cType>
-ChipVariant pcal95555::PCAL95555<I2cType>::GetChipVariant() const noexcept {
+constexpr ChipVariant pcal95555::PCAL95555<I2cType>::GetChipVariant() const noexcept {
   return chip_variant_;
 }
 
+template <typename I2cType>
+constexpr InterruptEngine pcal95555::PCAL95555<I2cType>::GetInterruptEngine() const noexcept {
+  if constexpr (CONFIG_PCAL95555_SERVICE_ENGINE != 0) {
+    return static_cast<InterruptEngine>(CONFIG_PCAL95555_SERVICE_ENGINE);
+  } else {
+    return interrupt_engine_;
+  }
+}
+
+// Choose the interrupt engine once, so the service path never tests the variant
+template <typename I2cType>
+constexpr void pcal95555::PCAL95555<I2cType>::selectInterruptEngine() noexcept {
+  interrupt_engine_ =
+      chip_variant_ == ChipVariant::PCAL9555A ? InterruptEngine::StatusLatch : InterruptEngine::InputDiff;
+}
+
 // Guard helper: require Agile I/O support
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::requireAgileIO() noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::requireAgileIO() noexcept {
   if (chip_variant_ != ChipVariant::PCAL9555A) {
     setError(Error::UnsupportedFeature);
     return false;
@@ -1147,7 +1781,7 @@ bool pcal95555::PCAL95555<I2cType>::requireAgileIO() noexcept {
 // Detect chip variant by probing OUTPUT_CONF register (0x4F)
 // Uses a 3-step sandwich: standard read -> probe -> standard read
 template <typename I2cType>
-void pcal95555::PCAL95555<I2cType>::detectChipVariant() noexcept {
+constexpr void pcal95555::PCAL95555<I2cType>::detectChipVariant() noexcept {
   // Use single-shot (no retries) for the probe to avoid spamming the bus
   int saved_retries = retries_;
   retries_ = 0;
@@ -1197,20 +1831,20 @@ void pcal95555::PCAL95555<I2cType>::detectChipVariant() noexcept {
 
 // Get current I2C address
 template <typename I2cType>
-uint8_t pcal95555::PCAL95555<I2cType>::GetAddress() const noexcept {
+constexpr uint8_t pcal95555::PCAL95555<I2cType>::GetAddress() const noexcept {
   return dev_addr_;
 }
 
 // Get current A2-A0 address bits
 template <typename I2cType>
-uint8_t pcal95555::PCAL95555<I2cType>::GetAddressBits() const noexcept {
+constexpr uint8_t pcal95555::PCAL95555<I2cType>::GetAddressBits() const noexcept {
   return address_bits_;
 }
 
 // ---- Shared ChangeAddress implementation ----
 
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::changeAddressImpl(uint8_t new_bits) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::changeAddressImpl(uint8_t new_bits, bool use_cache) noexcept {
   uint8_t new_addr = calculateAddress(new_bits);
   bool a0_level = (new_bits & 0x01) != 0;
   bool a1_level = (new_bits & 0x02) != 0;
@@ -1229,6 +1863,27 @@ bool pcal95555::PCAL95555<I2cType>::changeAddressImpl(uint8_t new_bits) noexcept
   // Reset initialization flag since address changed
   initialized_ = false;
 
+  // The shadowed register image, pending events and edge baseline belonged
+  // to the previous device; the first service re-seeds the baseline. Armed
+  // safe states are kept per address and follow address_bits_.
+  shadowInvalidate();
+  deferred_ = DeferredEvents{};
+  queued_ = DeferredEvents{};
+  baseline_stale_ = true;
+
+  // Verified before, and no transaction has failed there since
+  const ChipVariant known = use_cache ? static_cast<ChipVariant>((identity_cache_ >> (new_bits * 2)) & 0x3)
+                                      : ChipVariant::Unknown;
+  if (known != ChipVariant::Unknown) {
+    // Trusted without I/O: the chip counts as initialized from here on
+    (void)gpio_set;
+    chip_variant_ = known;
+    clearError(Error::InvalidAddress);
+    selectInterruptEngine();
+    initialized_ = true;
+    return true;
+  }
+
   // Verify communication at new address
   uint8_t test_value = 0;
   if (!readRegister(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0), test_value)) {
@@ -1247,6 +1902,8 @@ bool pcal95555::PCAL95555<I2cType>::changeAddressImpl(uint8_t new_bits) noexcept
   } else {
     detectChipVariant();
   }
+  selectInterruptEngine();
+  rememberIdentity();
 
   initialized_ = true;
   return true;
@@ -1254,7 +1911,7 @@ bool pcal95555::PCAL95555<I2cType>::changeAddressImpl(uint8_t new_bits) noexcept
 
 // Change address by setting A2-A0 pins via GPIO
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::ChangeAddress(bool a0_level, bool a1_level, bool a2_level) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::ChangeAddress(bool a0_level, bool a1_level, bool a2_level) noexcept {
   uint8_t new_bits = (a0_level ? 1U : 0U)
                    | ((a1_level ? 1U : 0U) << 1)
                    | ((a2_level ? 1U : 0U) << 2);
@@ -1263,7 +1920,7 @@ bool pcal95555::PCAL95555<I2cType>::ChangeAddress(bool a0_level, bool a1_level,
 
 // Change address using address value directly
 template <typename I2cType>
-bool pcal95555::PCAL95555<I2cType>::ChangeAddress(uint8_t address) noexcept {
+constexpr bool pcal95555::PCAL95555<I2cType>::ChangeAddress(uint8_t address) noexcept {
   constexpr uint8_t BASE_ADDRESS = 0x20;
   constexpr uint8_t MAX_ADDRESS = 0x27;
 
@@ -1276,4 +1933,298 @@ bool pcal95555::PCAL95555<I2cType>::ChangeAddress(uint8_t address) noexcept {
   return changeAddressImpl(new_bits);
 }
 
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::RetargetAddress(uint8_t address) noexcept {
+  if (address < 0x20 || address > 0x27) {
+    setError(Error::InvalidAddress);
+    return false;
+  }
+  return changeAddressImpl(static_cast<uint8_t>(address - 0x20), true);
+}
+
+template <typename I2cType>
+constexpr pcal95555::ChipVariant pcal95555::PCAL95555<I2cType>::GetCachedVariant(uint8_t address) const noexcept {
+  if (address < 0x20 || address > 0x27) {
+    return ChipVariant::Unknown;
+  }
+  return static_cast<ChipVariant>((identity_cache_ >> ((address - 0x20) * 2)) & 0x3);
+}
+
+template <typename I2cType>
+constexpr void pcal95555::PCAL95555<I2cType>::ClearIdentityCache() noexcept {
+  identity_cache_ = 0;
+}
+
+template <typename I2cType>
+constexpr void pcal95555::PCAL95555<I2cType>::rememberIdentity() noexcept {
+  const auto shift = static_cast<uint16_t>(address_bits_ * 2);
+  identity_cache_ = static_cast<uint16_t>((identity_cache_ & ~(0x3U << shift)) |
+                                          (static_cast<uint16_t>(chip_variant_) << shift));
+}
+
+// ---- Register shadow and configuration scrubber ----
+
+template <typename I2cType>
+constexpr void pcal95555::PCAL95555<I2cType>::shadowStore(uint8_t reg, uint8_t value) noexcept {
+  const int index = shadowIndex(reg);
+  if (index >= 0) {
+    shadow_[index] = value;
+    shadow_valid_ |= (1UL << index);
+  }
+}
+
+template <typename I2cType>
+constexpr void pcal95555::PCAL95555<I2cType>::shadowInvalidate() noexcept {
+  shadow_valid_ = 0;
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::ArmEmergencyStop(const SafeState& state) noexcept {
+  const auto bit = static_cast<uint8_t>(1U << address_bits_);
+  estop_images_[address_bits_] = {static_cast<uint8_t>(state.outputs & 0xFF), static_cast<uint8_t>(state.outputs >> 8),
+                                  static_cast<uint8_t>(state.directions & 0xFF),
+                                  static_cast<uint8_t>(state.directions >> 8)};
+  estop_directions_ =
+      static_cast<uint8_t>(state.write_directions ? (estop_directions_ | bit) : (estop_directions_ & ~bit));
+  estop_armed_ = static_cast<uint8_t>(estop_armed_ | bit);
+  return EnsureInitialized();
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::IsEmergencyStopArmed() const noexcept {
+  return ((estop_armed_ >> address_bits_) & 1U) != 0;
+}
+
+// Safe state: paired OUTPUT write, then optionally the paired CONFIG write. Nothing else.
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::EmergencyStop() noexcept {
+  if (!IsEmergencyStopArmed()) {
+    return false;
+  }
+  const std::array<uint8_t, 4>& image = estop_images_[address_bits_];
+  i2c_->SetUrgent(true);
+  bool ok = writeRegisterPair(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0), image[0], image[1]);
+  if (((estop_directions_ >> address_bits_) & 1U) != 0) {
+    ok = writeRegisterPair(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0), image[2], image[3]) && ok;
+  }
+  i2c_->SetUrgent(false);
+  return ok;
+}
+
+template <typename I2cType>
+constexpr void pcal95555::PCAL95555<I2cType>::SetScrubRate(uint32_t max_reads_per_sec) noexcept {
+  scrub_interval_us_ = (max_reads_per_sec > 0) ? (1000000U / max_reads_per_sec) : 0U;
+}
+
+template <typename I2cType>
+constexpr pcal95555::ScrubStats pcal95555::PCAL95555<I2cType>::GetScrubStats() const noexcept {
+  return scrub_stats_;
+}
+
+template <typename I2cType>
+constexpr void pcal95555::PCAL95555<I2cType>::ResetScrubStats() noexcept {
+  scrub_stats_ = ScrubStats{};
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::ScrubTick(uint64_t now_us) noexcept {
+  constexpr auto kEntries = static_cast<uint8_t>(kScrubTable.size());
+  constexpr auto kOutputConf = static_cast<uint8_t>(Pcal95555Reg::OUTPUT_CONF);
+
+  if (scrub_interval_us_ == 0 || !EnsureInitialized()) {
+    return false;
+  }
+  if (scrub_started_ && (now_us - scrub_last_us_) < scrub_interval_us_) {
+    ++scrub_stats_.budget_deferrals;
+    return false;
+  }
+
+  // Next entry with at least one shadowed register; unwritten ones are skipped for free
+  uint8_t reg0 = 0;
+  bool single = false;
+  uint32_t valid0 = 0;
+  uint32_t valid1 = 0;
+  bool found = false;
+  for (uint8_t n = 0; n < kEntries && !found; ++n) {
+    reg0 = kScrubTable[scrub_cursor_];
+    scrub_cursor_ = static_cast<uint8_t>((scrub_cursor_ + 1) % kEntries);
+    single = (reg0 == kOutputConf);
+    valid0 = shadow_valid_ & (1UL << shadowIndex(reg0));
+    valid1 = single ? 0 : (shadow_valid_ & (1UL << shadowIndex(static_cast<uint8_t>(reg0 + 1))));
+    found = (valid0 | valid1) != 0;
+  }
+  if (!found) {
+    return false;
+  }
+
+  scrub_started_ = true;
+  scrub_last_us_ = now_us;
+
+  const auto reg1 = static_cast<uint8_t>(reg0 + 1);
+  uint8_t actual0 = 0;
+  uint8_t actual1 = 0;
+  const bool read_ok = single ? readRegister(reg0, actual0) : readRegisterPair(reg0, actual0, actual1);
+  if (!read_ok) {
+    ++scrub_stats_.read_failures;
+    return false;
+  }
+  ++scrub_stats_.checks;
+
+  // Every scrub table entry is shadowed; the checks keep the indices provably in range
+  const int index0 = shadowIndex(reg0);
+  const int index1 = single ? -1 : shadowIndex(reg1);
+  const uint8_t expected0 = index0 >= 0 ? shadow_[index0] : 0;
+  const uint8_t expected1 = index1 >= 0 ? shadow_[index1] : 0;
+  const bool diff0 = (valid0 != 0) && (actual0 != expected0);
+  const bool diff1 = (valid1 != 0) && (actual1 != expected1);
+  if (!diff0 && !diff1) {
+    return true;
+  }
+
+  // Re-apply only what differs
+  ++scrub_stats_.mismatches;
+  bool repaired = false;
+  if (diff0 && diff1) {
+    repaired = writeRegisterPair(reg0, expected0, expected1);
+  } else if (diff0) {
+    repaired = writeRegister(reg0, expected0);
+  } else {
+    repaired = writeRegister(reg1, expected1);
+  }
+  if (repaired) {
+    ++scrub_stats_.repairs;
+  } else {
+    ++scrub_stats_.repair_failures;
+  }
+  return true;
+}
+
+// ---- Unchecked fast path ----
+
+template <typename I2cType>
+typename pcal95555::PCAL95555<I2cType>::UncheckedView
+constexpr pcal95555::PCAL95555<I2cType>::Unchecked() noexcept {
+  return UncheckedView(*this);
+}
+
+// Single bus transfer: no retries, no error flags
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::read(uint8_t reg, uint8_t& value) noexcept {
+  return drv_.i2c_->Read(drv_.dev_addr_, reg, &value, 1);
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::write(uint8_t reg, uint8_t value) noexcept {
+  if (!drv_.i2c_->Write(drv_.dev_addr_, reg, &value, 1)) {
+    return false;
+  }
+  drv_.shadowStore(reg, value);  // keep the scrubber's expected image current
+  return true;
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::readPair(uint8_t reg0, uint8_t& val0, uint8_t& val1) noexcept {
+  uint8_t data[2] = {0, 0};
+  if (!drv_.i2c_->Read(drv_.dev_addr_, reg0, data, 2)) {
+    return false;
+  }
+  val0 = data[0];
+  val1 = data[1];
+  return true;
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::writePair(uint8_t reg0, uint8_t val0, uint8_t val1) noexcept {
+  const uint8_t data[2] = {val0, val1};
+  if (!drv_.i2c_->Write(drv_.dev_addr_, reg0, data, 2)) {
+    return false;
+  }
+  drv_.shadowStore(reg0, val0);
+  drv_.shadowStore(static_cast<uint8_t>(reg0 + 1), val1);
+  return true;
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::modifyBit(uint8_t reg0, uint8_t reg1,
+                                                              uint8_t pin, bool bit_value) noexcept {
+  pin &= 0x0F;
+  uint8_t reg = (pin < 8) ? reg0 : reg1;
+  uint8_t val = 0;
+  if (!read(reg, val)) {
+    return false;
+  }
+  return write(reg, updateBit(val, pin % 8, bit_value));
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::modifyMask(uint8_t reg0, uint16_t mask,
+                                                               bool bit_value) noexcept {
+  uint8_t val0 = 0;
+  uint8_t val1 = 0;
+  if (!readPair(reg0, val0, val1)) {
+    return false;
+  }
+  auto mask0 = static_cast<uint8_t>(mask & 0xFF);
+  auto mask1 = static_cast<uint8_t>(mask >> 8);
+  val0 = bit_value ? static_cast<uint8_t>(val0 | mask0) : static_cast<uint8_t>(val0 & ~mask0);
+  val1 = bit_value ? static_cast<uint8_t>(val1 | mask1) : static_cast<uint8_t>(val1 & ~mask1);
+  return writePair(reg0, val0, val1);
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::SetPinDirection(uint8_t pin, GPIODir dir) noexcept {
+  return modifyBit(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0),
+                   static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_1), pin, (dir == GPIODir::Input));
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::SetMultipleDirections(uint16_t mask, GPIODir dir) noexcept {
+  return modifyMask(static_cast<uint8_t>(Pcal95555Reg::CONFIG_PORT_0), mask, (dir == GPIODir::Input));
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::WritePin(uint8_t pin, bool value) noexcept {
+  return modifyBit(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0),
+                   static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_1), pin, value);
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::TogglePin(uint8_t pin) noexcept {
+  pin &= 0x0F;
+  uint8_t reg = (pin < 8) ? static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0)
+                          : static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_1);
+  uint8_t val = 0;
+  if (!read(reg, val)) {
+    return false;
+  }
+  return write(reg, static_cast<uint8_t>(val ^ (1U << (pin % 8))));
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::SetMultipleOutputs(uint16_t mask, bool value) noexcept {
+  return modifyMask(static_cast<uint8_t>(Pcal95555Reg::OUTPUT_PORT_0), mask, value);
+}
+
+template <typename I2cType>
+constexpr bool pcal95555::PCAL95555<I2cType>::UncheckedView::ReadPin(uint8_t pin) noexcept {
+  pin &= 0x0F;
+  uint8_t reg = (pin < 8) ? static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0)
+                          : static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_1);
+  uint8_t val = 0;
+  if (!read(reg, val)) {
+    return false;
+  }
+  return (val & (1U << (pin % 8))) != 0;
+}
+
+template <typename I2cType>
+constexpr uint16_t pcal95555::PCAL95555<I2cType>::UncheckedView::ReadAllInputs() noexcept {
+  uint8_t port0 = 0;
+  uint8_t port1 = 0;
+  if (!readPair(static_cast<uint8_t>(Pcal95555Reg::INPUT_PORT_0), port0, port1)) {
+    return 0;
+  }
+  return static_cast<uint16_t>(port0 | (port1 << 8));
+}
+
 #endif // PCAL95555_IMPL
@@ -0,0 +1,163 @@
+/**
+ * @file pcal95555_transaction_budget.cpp
+ * @brief Compile-time I2C transaction budgets of every public PCAL95555 API
+ *
+ * Nothing in this file runs: each static_assert executes one API call in
+ * constant evaluation against budget::CountingBus and pins its bus cost, so
+ * a change to pcal95555.ipp that adds a round trip fails to compile here.
+ * The checks live in this one translation unit rather than in a header so
+ * they do not slow down every file that includes the driver. The root
+ * CMakeLists.txt compiles it when HF_PCAL95555_CHECK_TRANSACTION_BUDGET is ON
+ * (the default for a top-level build).
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include "pcal95555.hpp"
+#include "pcal95555_transaction_budget.hpp"
+
+namespace pcal95555::budget {
+
+// -- Lazy initialization (counted from a fresh driver) --
+static_assert(
+    [] {
+      CountingBus bus;
+      PCAL95555<CountingBus> drv(&bus, 0x20, ChipVariant::PCAL9555A);
+      drv.EnsureInitialized();
+      drv.EnsureInitialized();  // second call is free
+      return bus.count;
+    }() == TransactionCount{2, 0},
+    "EnsureInitialized(): probe + input snapshot, once");
+
+// -- Direction --
+static_assert(CountTransactions([](auto& d) { d.SetPinDirection(3, GPIODir::Output); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.SetMultipleDirections(0x0F0F, GPIODir::Output); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) {
+                d.SetDirections({{0, GPIODir::Output}, {9, GPIODir::Output}, {15, GPIODir::Input}});
+              }) == kSingleRmw,
+              "SetDirections(): one paired read + one paired write for any number of pins");
+static_assert(CountTransactions([](auto& d) { d.template SetDirections<Out<0, 9>, In<15>>(); }) == kSingleRmw);
+
+// -- Outputs --
+static_assert(CountTransactions([](auto& d) { d.WritePin(4, true); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.TogglePin(12); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.SetMultipleOutputs(0x8001, true); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.WriteAllOutputs(0x1234); }) == TransactionCount{0, 1},
+              "WriteAllOutputs(): one paired write, no read-back");
+static_assert(CountTransactions([](auto& d) { d.WritePins({{0, true}, {9, false}}); }) == kSingleRmw,
+              "WritePins(): one paired read + one paired write");
+static_assert(CountTransactions([](auto& d) { d.template WritePins<High<0, 1>, Low<8>>(); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.template WritePins<Pins<2, 10>>(0xFFFF); }) == kSingleRmw);
+
+// -- Emergency stop: the writes only, no read-back --
+static_assert(CountTransactions([](auto& d) {
+                d.ArmEmergencyStop({.outputs = 0x0000});
+                d.EmergencyStop();
+              }) == TransactionCount{0, 1},
+              "EmergencyStop(): one paired OUTPUT write");
+static_assert(CountTransactions([](auto& d) {
+                d.ArmEmergencyStop({.outputs = 0x0000, .directions = 0xFF00, .write_directions = true});
+                d.EmergencyStop();
+              }) == TransactionCount{0, 2},
+              "EmergencyStop() with directions: paired OUTPUT write + paired CONFIG write");
+static_assert(CountTransactions([](auto& d) {
+                d.ArmEmergencyStop({.outputs = 0x0000});
+                d.RetargetAddress(0x21);
+                d.EmergencyStop();
+                d.RetargetAddress(0x20);
+                d.EmergencyStop();
+              }) == TransactionCount{1, 1},
+              "EmergencyStop() across retargets: nothing armed at 0x21, 0x20 keeps its armed state");
+
+// -- Inputs --
+static_assert(CountTransactions([](auto& d) { d.ReadPin(7); }) == kSingleRead);
+static_assert(CountTransactions([](auto& d) { d.ReadAllInputs(); }) == kSingleRead);
+static_assert(CountTransactions([](auto& d) {
+                uint16_t inputs = 0;
+                d.ReadAllInputs(inputs);
+              }) == kSingleRead);
+static_assert(CountTransactions([](auto& d) { d.ReadPins({1, 8, 15}); }) == kSingleRead,
+              "ReadPins(): both input ports in one transfer");
+static_assert(CountTransactions([](auto& d) { d.template ReadPins<Pins<0, 15>>(); }) == kSingleRead);
+static_assert(CountTransactions([](auto& d) {
+                InputCapture<64> capture;
+                capture.Arm({});
+                d.SampleInputs(capture, 0);
+              }) == kSingleRead,
+              "SampleInputs(): one paired input read per sample");
+
+// -- Polarity, latch, pulls, interrupts --
+static_assert(CountTransactions([](auto& d) { d.SetPinPolarity(2, Polarity::Inverted); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) {
+                d.SetPolarities({{2, Polarity::Inverted}, {11, Polarity::Normal}});
+              }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.EnableInputLatches({{1, true}, {14, true}}); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.SetPullEnables({{0, true}, {8, true}}); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.SetPullDirections({{0, true}, {8, false}}); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) {
+                d.SetPullEnables({{0, true}, {8, true}});
+                d.SetPullEnable(3, true);
+                d.SetPullEnable(3, true);
+              }) == TransactionCount{1, 2},
+              "Pull image: loaded once, then one paired write per change, none when unchanged");
+static_assert(CountTransactions([](auto& d) {
+                d.SetPullImage({.enable = 0x00FF, .pull_up = 0x000F});
+                d.SetPulls(0x0300, true, false);
+                PullImage image;
+                d.GetPullImage(image);
+              }) == TransactionCount{0, 3},
+              "SetPullImage(): no read-back; SetPulls() and GetPullImage() served from the image");
+
+// -- Drive strength: packed 32-bit image, pins 0-7 and 8-15 in separate register pairs --
+static_assert(CountTransactions([](auto& d) { d.SetDriveStrength(5, DriveStrength::Level1); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) {
+                d.SetDriveStrengths({{0, DriveStrength::Level1}, {9, DriveStrength::Level2}});
+              }) == TransactionCount{2, 2});
+static_assert(CountTransactions([](auto& d) {
+                d.SetDriveImage(0xFFFFFFFF);
+                d.SetDriveStrength(2, DriveStrength::Level0);
+                d.SetMultipleDriveStrengths(0x0F00, DriveStrength::Level2);
+                uint32_t image = 0;
+                d.GetDriveImage(image);
+              }) == TransactionCount{0, 4},
+              "Drive image: one paired write per affected pair, nothing read back");
+static_assert(CountTransactions([](auto& d) {
+                d.ConfigureInterrupts({{0, InterruptState::Enabled}, {8, InterruptState::Enabled}});
+              }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.ConfigureInterruptMask(0xFF00); }) ==
+              TransactionCount{0, 1});
+static_assert(CountTransactions([](auto& d) { d.GetInterruptStatus(); }) == kSingleRead);
+
+// -- Unchecked fast path --
+static_assert(CountTransactions([](auto& d) { d.Unchecked().TogglePin(5); }) == kSingleRmw);
+static_assert(CountTransactions([](auto& d) { d.Unchecked().ReadAllInputs(); }) == kSingleRead);
+
+// -- Address changes --
+static_assert(CountTransactions([](auto& d) { d.ChangeAddress(uint8_t{0x21}); }) == kSingleRead,
+              "ChangeAddress() with a forced variant: one verification read");
+static_assert(CountTransactions([](auto& d) {
+                d.RetargetAddress(0x21);
+                d.RetargetAddress(0x20);
+                d.RetargetAddress(0x21);
+              }) == kSingleRead,
+              "RetargetAddress(): verified addresses switch without bus traffic");
+
+// -- Batches with a pin outside 0-15 are rejected without touching the bus --
+static_assert(CountTransactions([](auto& d) { d.SetDirections({{0, GPIODir::Output}, {16, GPIODir::Input}}); }) ==
+              TransactionCount{});
+static_assert(CountTransactions([](auto& d) { d.WritePins({{0, true}, {16, false}}); }) == TransactionCount{});
+static_assert(CountTransactions([](auto& d) { d.SetPolarities({{16, Polarity::Inverted}}); }) ==
+              TransactionCount{});
+static_assert(CountTransactions([](auto& d) { d.EnableInputLatches({{1, true}, {16, true}}); }) ==
+              TransactionCount{});
+static_assert(CountTransactions([](auto& d) { d.SetPullEnables({{0, true}, {16, true}}); }) == TransactionCount{});
+static_assert(CountTransactions([](auto& d) {
+                d.ConfigureInterrupts({{0, InterruptState::Enabled}, {16, InterruptState::Enabled}});
+              }) == TransactionCount{});
+
+// -- PCA9555: Agile I/O calls are rejected without touching the bus --
+static_assert(CountTransactions([](auto& d) { d.SetPullEnable(0, true); }, ChipVariant::PCA9555) ==
+              TransactionCount{});
+
+
+} // namespace pcal95555::budget